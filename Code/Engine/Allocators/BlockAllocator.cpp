@@ -160,25 +160,25 @@ bool BlockAllocator::AllocateChunk()
 		return false;
 	}
 
-	if (m_chunkLock.try_lock()) 
-	{
-		//Allocate a chunk of memory if the base allocator is able to 
-		size_t chunkSize = m_blocksPerChunk * m_blockSize + sizeof(Block_T);
-
-		Chunck_T* chunk = (Chunck_T*)m_base->Allocate(chunkSize);
-		if (chunk == nullptr) 
-		{
-			return false;
-		}
+	//Held for the whole allocation, a try_lock here was never released so the second chunk could never be made
+	std::scoped_lock chunkLock(m_chunkLock);
 
-		//Track this chunk so we can free this later
-		chunk->next = m_chunkList;
-		m_chunkList = chunk;
+	//Allocate a chunk of memory if the base allocator is able to 
+	size_t chunkSize = m_blocksPerChunk * m_blockSize + sizeof(Block_T);
 
-		//Break up newly allocated chunk
-		BreakUpChunk(chunk + 1);
+	Chunck_T* chunk = (Chunck_T*)m_base->Allocate(chunkSize);
+	if (chunk == nullptr) 
+	{
+		return false;
 	}
 
+	//Track this chunk so we can free this later
+	chunk->next = m_chunkList;
+	m_chunkList = chunk;
+
+	//Break up newly allocated chunk
+	BreakUpChunk(chunk + 1);
+
 	return true;
 }
 
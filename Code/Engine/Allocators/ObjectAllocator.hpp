@@ -1,13 +1,22 @@
 #pragma once
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Allocators/BlockAllocator.hpp"
+#include <new>
+#include <utility>
 
+//------------------------------------------------------------------------------------------------------------------------------
+// Block allocator sized for one OBJ per block. Create constructs in place and Destroy runs the destructor before the block
+// goes back on the free list, so the memory of destroyed objects gets reused without going back to the base allocator
 //------------------------------------------------------------------------------------------------------------------------------
 template <typename OBJ>
 class ObjectAllocator : private BlockAllocator
 {
 public:
-	void Initialize(InternalAllocator* parent, uint blocksPerChunk)
+	bool Initialize(InternalAllocator* parent, uint blocksPerChunk)
 	{
-		return BlockAllocator::Initialize(parent, sizeof(OBJ), alignof(OBJ), blocksPerChunk);
+		//Free blocks hold the free list link so a block can't be smaller than one
+		size_t blockSize = (sizeof(OBJ) < sizeof(Block_T)) ? sizeof(Block_T) : sizeof(OBJ);
+		return BlockAllocator::Initialize(parent, blockSize, alignof(OBJ), blocksPerChunk);
 	}
 
 	void Deinitialize()
@@ -15,23 +24,13 @@ public:
 		BlockAllocator::Deinitialize();
 	}
 
-	virtual void* Allocate(size_t size)
-	{
-		return BlockAllocator::Allocate(size);
-	}
-
-	virtual void* Free(void* ptr)
-	{
-		return BlockAllocator::Free(ptr);
-	}
-
 	template <typename ...ARGS>
-	OBJ* Create(ARGS ...args)
+	OBJ* Create(ARGS&& ...args)
 	{
-		void* mem = Allocate(sizeof(OBJ));
+		void* mem = BlockAllocator::Allocate(sizeof(OBJ));
 		if (mem != nullptr)
 		{
-			return new(mem) OBJ(std::forward(args)...);
+			return new(mem) OBJ(std::forward<ARGS>(args)...);
 		}
 		else
 		{
@@ -41,6 +40,12 @@ public:
 
 	void Destroy(OBJ* object)
 	{
-		Free(object);
+		if (object == nullptr)
+		{
+			return;
+		}
+
+		object->~OBJ();
+		BlockAllocator::Free(object);
 	}
-};
\ No newline at end of file
+};
@@ -0,0 +1,166 @@
+#include "Engine/Allocators/SlabAllocator.hpp"
+#include <intrin.h>
+#include <malloc.h>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------------------------------------------------------
+typedef uint8_t byte;
+static SlabAllocator* gSlabAllocator = nullptr;
+
+//------------------------------------------------------------------------------------------------------------------------------
+static inline uint GetSlabSizeClass(size_t size)
+{
+	if (size <= ((size_t)1U << SLAB_MIN_BLOCK_SIZE_BITS))
+	{
+		return 0U;
+	}
+
+	//Round up to the next power of 2
+	//_BitScanReverse64 only exists on x64, size_t is 32 bits on Win32 anyway
+	unsigned long highestBit;
+#if defined(_WIN64)
+	_BitScanReverse64(&highestBit, (uint64_t)(size - 1U));
+#else
+	_BitScanReverse(&highestBit, (unsigned long)(size - 1U));
+#endif
+	return (uint)highestBit + 1U - SLAB_MIN_BLOCK_SIZE_BITS;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+SlabAllocator::SlabAllocator()
+{
+	for (uint sizeClassIndex = 0; sizeClassIndex < SLAB_SIZE_CLASS_COUNT; ++sizeClassIndex)
+	{
+		m_sizeClasses[sizeClassIndex].m_blockSize = (size_t)1U << (SLAB_MIN_BLOCK_SIZE_BITS + sizeClassIndex);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+SlabAllocator::~SlabAllocator()
+{
+	Deinitialize();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void* SlabAllocator::Allocate(size_t size)
+{
+	if (size > SLAB_MAX_BLOCK_SIZE)
+	{
+		return nullptr;
+	}
+
+	uint sizeClassIndex = GetSlabSizeClass(size);
+	SlabSizeClass_T& sizeClass = m_sizeClasses[sizeClassIndex];
+
+	std::scoped_lock lock(sizeClass.m_lock);
+
+	if (sizeClass.m_freeBlocks == nullptr && !AllocateChunk(sizeClassIndex))
+	{
+		return nullptr;
+	}
+
+	SlabBlock_T* block = sizeClass.m_freeBlocks;
+	sizeClass.m_freeBlocks = block->next;
+	return block;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void SlabAllocator::Free(void* ptr)
+{
+	if (ptr == nullptr)
+	{
+		return;
+	}
+
+	//The chunk header tells us which class the block belongs to
+	SlabChunk_T* chunk = (SlabChunk_T*)((uintptr_t)ptr & ~(uintptr_t)(SLAB_CHUNK_SIZE - 1U));
+	SlabSizeClass_T& sizeClass = m_sizeClasses[chunk->m_sizeClass];
+
+	SlabBlock_T* block = (SlabBlock_T*)ptr;
+
+	std::scoped_lock lock(sizeClass.m_lock);
+	block->next = sizeClass.m_freeBlocks;
+	sizeClass.m_freeBlocks = block;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void SlabAllocator::Deinitialize()
+{
+	for (uint sizeClassIndex = 0; sizeClassIndex < SLAB_SIZE_CLASS_COUNT; ++sizeClassIndex)
+	{
+		SlabSizeClass_T& sizeClass = m_sizeClasses[sizeClassIndex];
+		std::scoped_lock lock(sizeClass.m_lock);
+
+		while (sizeClass.m_chunkList != nullptr)
+		{
+			SlabChunk_T* chunk = sizeClass.m_chunkList;
+			sizeClass.m_chunkList = chunk->next;
+			_aligned_free(chunk);
+		}
+
+		sizeClass.m_freeBlocks = nullptr;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool SlabAllocator::AllocateChunk(uint sizeClassIndex)
+{
+	//Called with the class lock held. Chunks come straight from the OS heap, the blocks are what gets tracked
+	SlabChunk_T* chunk = (SlabChunk_T*)_aligned_malloc(SLAB_CHUNK_SIZE, SLAB_CHUNK_SIZE);
+	if (chunk == nullptr)
+	{
+		return false;
+	}
+
+	SlabSizeClass_T& sizeClass = m_sizeClasses[sizeClassIndex];
+	chunk->m_sizeClass = sizeClassIndex;
+	chunk->next = sizeClass.m_chunkList;
+	sizeClass.m_chunkList = chunk;
+
+	//Thread the blocks back to front so they come out in address order
+	byte* blocksStart = (byte*)chunk + SLAB_CHUNK_HEADER_SIZE;
+	size_t blockCount = (SLAB_CHUNK_SIZE - SLAB_CHUNK_HEADER_SIZE) / sizeClass.m_blockSize;
+
+	SlabBlock_T* head = sizeClass.m_freeBlocks;
+	for (size_t blockIndex = blockCount; blockIndex > 0U; --blockIndex)
+	{
+		SlabBlock_T* block = (SlabBlock_T*)(blocksStart + (blockIndex - 1U) * sizeClass.m_blockSize);
+		block->next = head;
+		head = block;
+	}
+
+	sizeClass.m_freeBlocks = head;
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+SlabAllocator* SlabAllocator::CreateInstance()
+{
+	if (gSlabAllocator == nullptr)
+	{
+		gSlabAllocator = new SlabAllocator();
+	}
+
+	return gSlabAllocator;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void SlabAllocator::DestroyInstance()
+{
+	if (gSlabAllocator != nullptr)
+	{
+		delete gSlabAllocator;
+		gSlabAllocator = nullptr;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+SlabAllocator* SlabAllocator::GetInstance()
+{
+	if (gSlabAllocator == nullptr)
+	{
+		CreateInstance();
+	}
+
+	return gSlabAllocator;
+}
@@ -0,0 +1,67 @@
+#pragma once
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Allocators/InternalAllocator.hpp"
+#include <mutex>
+
+typedef unsigned int uint;
+
+//------------------------------------------------------------------------------------------------------------------------------
+constexpr size_t SLAB_CHUNK_SIZE = 64U * 1024U;			//Chunks are aligned to their size so a block finds its chunk by masking
+constexpr size_t SLAB_CHUNK_HEADER_SIZE = 64U;			//Keeps the first block cache line aligned
+constexpr uint SLAB_MIN_BLOCK_SIZE_BITS = 4U;
+constexpr uint SLAB_SIZE_CLASS_COUNT = 8U;				//16 B up to 2 KiB in powers of 2
+constexpr size_t SLAB_MAX_BLOCK_SIZE = (size_t)1U << (SLAB_MIN_BLOCK_SIZE_BITS + SLAB_SIZE_CLASS_COUNT - 1U);
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct SlabBlock_T
+{
+	SlabBlock_T* next;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct SlabChunk_T
+{
+	SlabChunk_T* next;
+	uint m_sizeClass;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct alignas(64) SlabSizeClass_T
+{
+	std::mutex		m_lock;
+	SlabBlock_T*	m_freeBlocks = nullptr;
+	SlabChunk_T*	m_chunkList = nullptr;
+	size_t			m_blockSize = 0U;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Thread safe small object allocator, meant as the backend for global operator new (see MemTrackSetGlobalAllocator).
+// Sizes round up to a power of 2 size class and every class carves blocks out of its own chunks, so Free needs no size
+// and there is no per block header. Each class has its own lock so threads only contend on the same size.
+// Sizes over SLAB_MAX_BLOCK_SIZE return nullptr, callers fall back to something else
+//------------------------------------------------------------------------------------------------------------------------------
+class SlabAllocator : public InternalAllocator
+{
+public:
+	SlabAllocator();
+	~SlabAllocator();
+
+	//Interface methods, blocks are at least 16 byte aligned
+	virtual void*				Allocate(size_t size) final;
+	virtual void				Free(void* ptr) final;
+
+	//Returns every chunk to the OS, only safe once nothing allocated from here is alive
+	void						Deinitialize();
+
+	//------------------------------------------------------------------------------------------------------------------------------
+	//Static methods
+	static	SlabAllocator*		CreateInstance();
+	static	void				DestroyInstance();
+	static	SlabAllocator*		GetInstance();
+
+private:
+	bool						AllocateChunk(uint sizeClassIndex);
+
+private:
+	SlabSizeClass_T				m_sizeClasses[SLAB_SIZE_CLASS_COUNT];
+};
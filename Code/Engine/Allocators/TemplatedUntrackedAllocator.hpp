@@ -25,10 +25,10 @@ struct TemplatedUntrackedAllocator
 	typedef std::true_type  propagate_on_container_move_assignment;   // when moving - does the allocator local state move with it?
 	typedef std::true_type  is_always_equal;                          // can optimize some containers (allocator of this type is always equal to others of its type)                         
 
-	T* allocate(size_t byte_size) 
+	T* allocate(size_t count) 
 	{ 
-		UNUSED(byte_size);
-		return (T*) ::malloc(sizeof(T)); 
+		//Containers ask for arrays too (hash buckets, string storage), not just single nodes
+		return (T*) ::malloc(count * sizeof(T)); 
 	}
 
 	void deallocate(T* ptr, size_t byte_size) 
@@ -48,4 +48,7 @@ template<typename T, class U>
 bool operator!=(TemplatedUntrackedAllocator<T> const&, TemplatedUntrackedAllocator<U> const&)
 { 
 	return false; 
-}
\ No newline at end of file
+}
+
+// For strings owned by the memory tracking systems themselves
+typedef std::basic_string<char, std::char_traits<char>, TemplatedUntrackedAllocator<char>> UntrackedString;
\ No newline at end of file
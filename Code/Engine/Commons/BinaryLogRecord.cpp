@@ -0,0 +1,420 @@
+#include "Engine/Commons/BinaryLogRecord.hpp"
+#include "Engine/Commons/UnitTest.hpp"
+#include <algorithm>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct LogArgValue_T
+{
+	eLogArgType			type = NUM_LOG_ARG_TYPES;
+	int64_t				signedValue = 0;
+	uint64_t			unsignedValue = 0;
+	double				doubleValue = 0.0;
+	const char*			stringValue = nullptr;
+	uint16_t			stringLength = 0;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Records can come from a truncated or corrupt file so nothing is read past readEnd
+static bool ReadLogArgBytes(const byte*& readHead, const byte* readEnd, void* outValue, size_t size)
+{
+	if ((size_t)(readEnd - readHead) < size)
+	{
+		return false;
+	}
+
+	memcpy(outValue, readHead, size);
+	readHead += size;
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Reads the value of the next stored argument, returns false if the record ran out of arguments or is cut short
+//------------------------------------------------------------------------------------------------------------------------------
+static bool ReadLogArg(const byte*& readHead, const byte* readEnd, LogArgValue_T& outValue)
+{
+	uint8_t argType;
+	if (!ReadLogArgBytes(readHead, readEnd, &argType, sizeof(uint8_t)))
+	{
+		return false;
+	}
+
+	outValue.type = (eLogArgType)argType;
+	bool isValid = false;
+
+	switch (outValue.type)
+	{
+	case LOG_ARG_INT32:
+	{
+		int32_t value;
+		isValid = ReadLogArgBytes(readHead, readEnd, &value, sizeof(int32_t));
+
+		outValue.signedValue = value;
+		outValue.unsignedValue = (uint64_t)value;
+		outValue.doubleValue = (double)value;
+	}
+	break;
+	case LOG_ARG_UINT32:
+	{
+		uint32_t value;
+		isValid = ReadLogArgBytes(readHead, readEnd, &value, sizeof(uint32_t));
+
+		outValue.signedValue = value;
+		outValue.unsignedValue = value;
+		outValue.doubleValue = (double)value;
+	}
+	break;
+	case LOG_ARG_INT64:
+	{
+		int64_t value;
+		isValid = ReadLogArgBytes(readHead, readEnd, &value, sizeof(int64_t));
+
+		outValue.signedValue = value;
+		outValue.unsignedValue = (uint64_t)value;
+		outValue.doubleValue = (double)value;
+	}
+	break;
+	case LOG_ARG_UINT64:
+	case LOG_ARG_POINTER:
+	{
+		uint64_t value;
+		isValid = ReadLogArgBytes(readHead, readEnd, &value, sizeof(uint64_t));
+
+		outValue.signedValue = (int64_t)value;
+		outValue.unsignedValue = value;
+		outValue.doubleValue = (double)value;
+	}
+	break;
+	case LOG_ARG_DOUBLE:
+	{
+		isValid = ReadLogArgBytes(readHead, readEnd, &outValue.doubleValue, sizeof(double));
+
+		outValue.signedValue = (int64_t)outValue.doubleValue;
+		outValue.unsignedValue = (uint64_t)outValue.signedValue;
+	}
+	break;
+	case LOG_ARG_CHAR:
+	{
+		uint8_t value;
+		isValid = ReadLogArgBytes(readHead, readEnd, &value, sizeof(uint8_t));
+
+		outValue.signedValue = (char)value;
+		outValue.unsignedValue = value;
+		outValue.doubleValue = (double)outValue.signedValue;
+	}
+	break;
+	case LOG_ARG_STRING:
+	{
+		isValid = ReadLogArgBytes(readHead, readEnd, &outValue.stringLength, sizeof(uint16_t))
+			&& (size_t)(readEnd - readHead) >= outValue.stringLength;
+
+		if (isValid)
+		{
+			outValue.stringValue = (const char*)readHead;
+			readHead += outValue.stringLength;
+		}
+	}
+	break;
+	default:
+		break;
+	}
+
+	if (!isValid)
+	{
+		//Corrupt or cut short, stop reading the record
+		readHead = readEnd;
+		return false;
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+int AdvanceLogFormatCursor(LogFormatCursor_T& cursor, int64_t starValue)
+{
+	const char*& formatHead = cursor.formatHead;
+	if (formatHead == nullptr)
+	{
+		return -1;
+	}
+
+	while (*formatHead != '\0')
+	{
+		if (!cursor.isInConversion)
+		{
+			if (*formatHead == '%' && formatHead[1] == '%')
+			{
+				formatHead += 2;
+			}
+			else if (*formatHead == '%')
+			{
+				formatHead++;
+				cursor.isInConversion = true;
+				cursor.isInPrecision = false;
+				cursor.precision = -1;
+			}
+			else
+			{
+				formatHead++;
+			}
+			continue;
+		}
+
+		char specChar = *formatHead;
+		formatHead++;
+
+		if (specChar == '*')
+		{
+			//A negative star precision counts as none, same as printf
+			if (cursor.isInPrecision)
+			{
+				cursor.precision = (starValue >= 0) ? (int)std::min(starValue, (int64_t)INT_MAX) : -1;
+			}
+			return -1;
+		}
+		else if (specChar == '.')
+		{
+			cursor.isInPrecision = true;
+			cursor.precision = 0;
+		}
+		else if (specChar >= '0' && specChar <= '9')
+		{
+			if (cursor.isInPrecision && cursor.precision < INT_MAX / 10)
+			{
+				cursor.precision = cursor.precision * 10 + (specChar - '0');
+			}
+		}
+		else if (specChar == 'I')
+		{
+			//MSVC I32/I64 length modifiers, their digits are not a width
+			if ((formatHead[0] == '6' && formatHead[1] == '4') || (formatHead[0] == '3' && formatHead[1] == '2'))
+			{
+				formatHead += 2;
+			}
+		}
+		else if (strchr("-+ #hljztL", specChar) == nullptr)
+		{
+			//The conversion itself, the argument is the value
+			cursor.isInConversion = false;
+			return cursor.precision;
+		}
+	}
+
+	return -1;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void FormatBinaryLogRecord(std::string& out, const char* format, const byte* argData, uint numArgs, size_t argBytes)
+{
+	const byte* readHead = argData;
+	const byte* readEnd = argData + argBytes;
+	uint argsRead = 0;
+
+	const char* formatHead = format;
+	while (*formatHead != '\0')
+	{
+		if (*formatHead != '%')
+		{
+			out += *formatHead;
+			formatHead++;
+			continue;
+		}
+
+		if (formatHead[1] == '%')
+		{
+			out += '%';
+			formatHead += 2;
+			continue;
+		}
+
+		//Copy flags, width and precision into our own conversion spec
+		char spec[48];
+		size_t specLength = 0;
+		spec[specLength++] = '%';
+		formatHead++;
+
+		while (*formatHead != '\0' && strchr("-+ #0123456789.*", *formatHead) != nullptr && specLength < 24)
+		{
+			if (*formatHead == '*')
+			{
+				//Star widths are stored as an argument of their own
+				LogArgValue_T widthArg;
+				if (argsRead < numArgs && ReadLogArg(readHead, readEnd, widthArg))
+				{
+					argsRead++;
+					specLength += snprintf(spec + specLength, sizeof(spec) - specLength, "%d", (int)widthArg.signedValue);
+				}
+			}
+			else
+			{
+				spec[specLength++] = *formatHead;
+			}
+
+			formatHead++;
+		}
+
+		//Skip the length modifiers, including the MSVC I32/I64 ones
+		while (*formatHead != '\0' && strchr("hljztL", *formatHead) != nullptr)
+		{
+			formatHead++;
+		}
+		if (*formatHead == 'I')
+		{
+			formatHead++;
+			if ((formatHead[0] == '6' && formatHead[1] == '4') || (formatHead[0] == '3' && formatHead[1] == '2'))
+			{
+				formatHead += 2;
+			}
+		}
+
+		char conversion = *formatHead;
+		if (conversion == '\0')
+		{
+			break;
+		}
+		formatHead++;
+
+		LogArgValue_T arg;
+		if (argsRead >= numArgs || !ReadLogArg(readHead, readEnd, arg))
+		{
+			out += "<missing>";
+			continue;
+		}
+		argsRead++;
+
+		char buffer[MAX_LOG_STRING_ARG_LENGTH + 64];
+		int written = 0;
+
+		switch (conversion)
+		{
+		case 'd':
+		case 'i':
+		{
+			spec[specLength] = 'l';
+			spec[specLength + 1] = 'l';
+			spec[specLength + 2] = conversion;
+			spec[specLength + 3] = '\0';
+			written = snprintf(buffer, sizeof(buffer), spec, (long long)arg.signedValue);
+		}
+		break;
+		case 'u':
+		case 'x':
+		case 'X':
+		case 'o':
+		{
+			spec[specLength] = 'l';
+			spec[specLength + 1] = 'l';
+			spec[specLength + 2] = conversion;
+			spec[specLength + 3] = '\0';
+			written = snprintf(buffer, sizeof(buffer), spec, (unsigned long long)arg.unsignedValue);
+		}
+		break;
+		case 'c':
+		{
+			spec[specLength] = 'c';
+			spec[specLength + 1] = '\0';
+			written = snprintf(buffer, sizeof(buffer), spec, (int)arg.signedValue);
+		}
+		break;
+		case 'f':
+		case 'F':
+		case 'e':
+		case 'E':
+		case 'g':
+		case 'G':
+		case 'a':
+		case 'A':
+		{
+			spec[specLength] = conversion;
+			spec[specLength + 1] = '\0';
+			written = snprintf(buffer, sizeof(buffer), spec, arg.doubleValue);
+		}
+		break;
+		case 'p':
+		{
+			written = snprintf(buffer, sizeof(buffer), "0x%016llX", (unsigned long long)arg.unsignedValue);
+		}
+		break;
+		case 's':
+		default:
+		{
+			if (arg.type == LOG_ARG_STRING)
+			{
+				//The stored string is not null terminated, so keep the flags and width but pass the precision as an argument
+				//capped at the stored length. A negative precision (from a star) counts as none
+				int precision = (int)arg.stringLength;
+				char* precisionStart = (char*)memchr(spec, '.', specLength);
+				if (precisionStart != nullptr)
+				{
+					long specPrecision = strtol(precisionStart + 1, nullptr, 10);
+					if (specPrecision >= 0 && specPrecision < precision)
+					{
+						precision = (int)specPrecision;
+					}
+					specLength = (size_t)(precisionStart - spec);
+				}
+
+				spec[specLength] = '.';
+				spec[specLength + 1] = '*';
+				spec[specLength + 2] = 's';
+				spec[specLength + 3] = '\0';
+				written = snprintf(buffer, sizeof(buffer), spec, precision, arg.stringValue);
+			}
+			else
+			{
+				written = snprintf(buffer, sizeof(buffer), "%lld", (long long)arg.signedValue);
+			}
+		}
+		break;
+		}
+
+		if (written > 0)
+		{
+			out.append(buffer, ((size_t)written < sizeof(buffer)) ? (size_t)written : sizeof(buffer) - 1);
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// UNIT TEST
+//------------------------------------------------------------------------------------------------------------------------------
+// Captures and formats the way LogBinaryf and the log thread do, without a log system
+template <typename ...ARGS>
+static std::string FormatLogArgsForTest(const char* format, const ARGS&... args)
+{
+	size_t captureLengths[sizeof...(ARGS) + 1U] = {};
+	GetLogArgCaptureLengths(captureLengths, format, args...);
+
+	std::vector<byte> argData(GetLogArgsEncodedSize(captureLengths, args...));
+	EncodeLogArgs(argData.data(), captureLengths, args...);
+
+	std::string text;
+	FormatBinaryLogRecord(text, format, argData.data(), (uint)sizeof...(ARGS), argData.size());
+	return text;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+UNITTEST("StringPrecisionAndWidth", "LogSystem", 100)
+{
+	//No null terminator, only the precision says where the string ends
+	const char unterminated[5] = { 'a', 'b', 'c', 'd', 'e' };
+	size_t captureLengths[3] = {};
+	GetLogArgCaptureLengths(captureLengths, "%.*s %s", 3, unterminated, "abc");
+
+	CONFIRM(captureLengths[1] == 3 && captureLengths[2] == 3);
+	CONFIRM(FormatLogArgsForTest("[%.*s]", 5, unterminated) == "[abcde]");
+
+	CONFIRM(FormatLogArgsForTest("[%.3s]", "abcdef") == "[abc]");
+	CONFIRM(FormatLogArgsForTest("[%.10s]", "abc") == "[abc]");
+	CONFIRM(FormatLogArgsForTest("[%.*s]", 3, "abcdef") == "[abc]");
+	CONFIRM(FormatLogArgsForTest("[%.*s]", -1, "abc") == "[abc]");
+	CONFIRM(FormatLogArgsForTest("[%8s]", "abc") == "[     abc]");
+	CONFIRM(FormatLogArgsForTest("[%-8.2s]", "abc") == "[ab      ]");
+	CONFIRM(FormatLogArgsForTest("[%10.*s]", 2, "abc") == "[        ab]");
+	CONFIRM(FormatLogArgsForTest("[%-20.5s|%d]", "abcdefgh", 7) == "[abcde               |7]");
+	CONFIRM(FormatLogArgsForTest("[%*s|%.2f]", 5, "ab", 1.5) == "[   ab|1.50]");
+	return true;
+}
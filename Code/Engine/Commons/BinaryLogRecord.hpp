@@ -0,0 +1,242 @@
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <type_traits>
+
+//------------------------------------------------------------------------------------------------------------------------------
+typedef uint8_t byte;
+typedef unsigned int uint;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Binary log records keep the caller down to a few memcpys. The caller stores the format string pointer,
+// a type tag per argument and the raw argument bytes. Formatting happens on the log thread or offline.
+//------------------------------------------------------------------------------------------------------------------------------
+enum eLogArgType : uint8_t
+{
+	LOG_ARG_INT32,
+	LOG_ARG_UINT32,
+	LOG_ARG_INT64,
+	LOG_ARG_UINT64,
+	LOG_ARG_DOUBLE,
+	LOG_ARG_CHAR,
+	LOG_ARG_STRING,
+	LOG_ARG_POINTER,
+
+	NUM_LOG_ARG_TYPES
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Follows the LogObject_T of a binary record in the ring buffer, the encoded arguments follow this header
+//------------------------------------------------------------------------------------------------------------------------------
+struct LogBinaryHeader_T
+{
+	const char*			format;			//Only the pointer is stored so this must be a string literal
+	uint16_t			numArgs;
+	uint16_t			argBytes;
+};
+
+//Strings are copied into the record, anything longer than this is truncated
+constexpr size_t MAX_LOG_STRING_ARG_LENGTH = 1024;
+//argBytes is 16 bits in the header and in deferred files, a record with more is formatted on the caller instead
+constexpr size_t MAX_LOG_RECORD_ARG_BYTES = UINT16_MAX;
+
+//------------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+constexpr eLogArgType GetLogArgType()
+{
+	typedef typename std::decay<T>::type ArgType;
+
+	if constexpr (std::is_same<ArgType, char*>::value || std::is_same<ArgType, const char*>::value)
+	{
+		return LOG_ARG_STRING;
+	}
+	else if constexpr (std::is_pointer<ArgType>::value || std::is_null_pointer<ArgType>::value)
+	{
+		return LOG_ARG_POINTER;
+	}
+	else if constexpr (std::is_floating_point<ArgType>::value)
+	{
+		return LOG_ARG_DOUBLE;
+	}
+	else if constexpr (std::is_same<ArgType, char>::value)
+	{
+		return LOG_ARG_CHAR;
+	}
+	else if constexpr (std::is_enum<ArgType>::value)
+	{
+		return LOG_ARG_INT32;
+	}
+	else
+	{
+		static_assert(std::is_integral<ArgType>::value, "Unsupported argument type for a binary log record");
+
+		if constexpr (sizeof(ArgType) <= sizeof(int32_t))
+		{
+			return std::is_signed<ArgType>::value ? LOG_ARG_INT32 : LOG_ARG_UINT32;
+		}
+		else
+		{
+			return std::is_signed<ArgType>::value ? LOG_ARG_INT64 : LOG_ARG_UINT64;
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Follows the format while the arguments are captured so each one knows the precision it will be printed with.
+// A %.*s buffer doesn't have to be null terminated, so a string is never read past its precision
+//------------------------------------------------------------------------------------------------------------------------------
+struct LogFormatCursor_T
+{
+	const char*			formatHead = nullptr;
+	bool				isInConversion = false;			//Stopped on a '*' part way through a conversion spec
+	bool				isInPrecision = false;
+	int					precision = -1;					//Of the conversion being read, -1 when it has none
+};
+
+// Moves past the part of the format the next argument is read by. Returns the precision of the conversion when the argument
+// is the converted value and -1 when it has none or the argument fills a '*'. starValue is used in case it fills a '*'
+int AdvanceLogFormatCursor(LogFormatCursor_T& cursor, int64_t starValue);
+
+//------------------------------------------------------------------------------------------------------------------------------
+// How much of a string is stored, capped by the precision it is printed with and by MAX_LOG_STRING_ARG_LENGTH
+inline size_t GetLogStringArgLength(const char* value, int precision)
+{
+	if (value == nullptr)
+	{
+		return 0;
+	}
+
+	size_t maxLength = (precision >= 0 && (size_t)precision < MAX_LOG_STRING_ARG_LENGTH) ? (size_t)precision : MAX_LOG_STRING_ARG_LENGTH;
+	return strnlen(value, maxLength);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Bytes of the argument read at capture, only strings have a length that depends on the format
+template <typename T>
+size_t GetLogArgCaptureLength(LogFormatCursor_T& cursor, const T& value)
+{
+	constexpr eLogArgType argType = GetLogArgType<T>();
+
+	if constexpr (argType == LOG_ARG_STRING)
+	{
+		return GetLogStringArgLength(value, AdvanceLogFormatCursor(cursor, 0));
+	}
+	else if constexpr (argType == LOG_ARG_POINTER || argType == LOG_ARG_DOUBLE)
+	{
+		AdvanceLogFormatCursor(cursor, 0);
+		return 0;
+	}
+	else
+	{
+		AdvanceLogFormatCursor(cursor, (int64_t)value);
+		return 0;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+size_t GetLogArgEncodedSize(const T& value, size_t captureLength)
+{
+	constexpr eLogArgType argType = GetLogArgType<T>();
+
+	if constexpr (argType == LOG_ARG_STRING)
+	{
+		return sizeof(eLogArgType) + sizeof(uint16_t) + captureLength;
+	}
+	else if constexpr (argType == LOG_ARG_INT32 || argType == LOG_ARG_UINT32)
+	{
+		return sizeof(eLogArgType) + sizeof(uint32_t);
+	}
+	else if constexpr (argType == LOG_ARG_CHAR)
+	{
+		return sizeof(eLogArgType) + sizeof(char);
+	}
+	else
+	{
+		//64 bit integers, doubles and pointers
+		return sizeof(eLogArgType) + sizeof(uint64_t);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+byte* EncodeLogArg(byte* writeHead, const T& value, size_t captureLength)
+{
+	constexpr eLogArgType argType = GetLogArgType<T>();
+	*writeHead = argType;
+	writeHead++;
+
+	if constexpr (argType == LOG_ARG_STRING)
+	{
+		uint16_t length = (uint16_t)captureLength;
+		memcpy(writeHead, &length, sizeof(uint16_t));
+		memcpy(writeHead + sizeof(uint16_t), value, length);
+		return writeHead + sizeof(uint16_t) + length;
+	}
+	else if constexpr (argType == LOG_ARG_POINTER)
+	{
+		uint64_t address = (uint64_t)(uintptr_t)value;
+		memcpy(writeHead, &address, sizeof(uint64_t));
+		return writeHead + sizeof(uint64_t);
+	}
+	else if constexpr (argType == LOG_ARG_DOUBLE)
+	{
+		double widened = (double)value;
+		memcpy(writeHead, &widened, sizeof(double));
+		return writeHead + sizeof(double);
+	}
+	else if constexpr (argType == LOG_ARG_CHAR)
+	{
+		*writeHead = (byte)value;
+		return writeHead + 1;
+	}
+	else if constexpr (argType == LOG_ARG_INT32 || argType == LOG_ARG_UINT32)
+	{
+		uint32_t bits = (uint32_t)value;
+		memcpy(writeHead, &bits, sizeof(uint32_t));
+		return writeHead + sizeof(uint32_t);
+	}
+	else
+	{
+		uint64_t bits = (uint64_t)value;
+		memcpy(writeHead, &bits, sizeof(uint64_t));
+		return writeHead + sizeof(uint64_t);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Fills one capture length per argument, the sizing and the encoding both read them so they always agree
+template <typename ...ARGS>
+void GetLogArgCaptureLengths(size_t* outCaptureLengths, const char* format, const ARGS&... args)
+{
+	LogFormatCursor_T cursor;
+	cursor.formatHead = format;
+
+	size_t argIndex = 0;
+	((outCaptureLengths[argIndex++] = GetLogArgCaptureLength(cursor, args)), ...);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+template <typename ...ARGS>
+size_t GetLogArgsEncodedSize(const size_t* captureLengths, const ARGS&... args)
+{
+	size_t encodedSize = 0;
+	size_t argIndex = 0;
+	((encodedSize += GetLogArgEncodedSize(args, captureLengths[argIndex++])), ...);
+	return encodedSize;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+template <typename ...ARGS>
+byte* EncodeLogArgs(byte* writeHead, const size_t* captureLengths, const ARGS&... args)
+{
+	size_t argIndex = 0;
+	((writeHead = EncodeLogArg(writeHead, args, captureLengths[argIndex++])), ...);
+	return writeHead;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Walks the printf style format and formats each conversion with the argument stored for it.
+// Length modifiers in the format are ignored, the stored type decides how the value is read back.
+void FormatBinaryLogRecord(std::string& out, const char* format, const byte* argData, uint numArgs, size_t argBytes);
@@ -1,9 +1,14 @@
 #include "Engine/Commons/Callstack.hpp"
+#include "Engine/Allocators/TemplatedUntrackedAllocator.hpp"
+#include "Engine/Commons/EngineCommon.hpp"
 #include "Engine/Commons/ErrorWarningAssert.hpp"
 
 #define WIN32_LEAN_AND_MEAN		// Always #define this before #including <windows.h>
 #include <windows.h>			// #include this (massive, platform-specific) header in very few places
 #include <DbgHelp.h>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
 
 #if ( defined( _WIN64 ))
 #pragma comment( lib, "ThirdParty/WinDbg/dbghelp.lib" )
@@ -19,45 +24,389 @@ Callstack CallstackGet(uint skip_frames /*= 0*/)
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-std::vector<std::string> GetCallstackToString(Callstack const& callStack)
+// Interned callstacks. Everything here is plain data so it is usable before static constructors run,
+// and all memory comes straight from malloc since TrackAllocation interns from inside operator new
+//------------------------------------------------------------------------------------------------------------------------------
+struct InternedCallstack_T
 {
-	HANDLE pHandle = GetCurrentProcess();
+	unsigned long	m_hash;
+	uint			m_depth;
+	void**			m_frames;
+};
 
-	SymInitialize(pHandle, nullptr, true);
-	std::vector<std::string> callStackStrings;
-	
-	PIMAGEHLP_SYMBOL64 symbol = (PIMAGEHLP_SYMBOL64)malloc(sizeof(PIMAGEHLP_SYMBOL64) + (TRACE_MAX_FUNCTION_NAME_LENGTH - 1) * sizeof(TCHAR));
-	memset(symbol, 0, sizeof(PIMAGEHLP_SYMBOL64) + (TRACE_MAX_FUNCTION_NAME_LENGTH - 1) * sizeof(TCHAR));
-	symbol->MaxNameLength = TRACE_MAX_FUNCTION_NAME_LENGTH;
-	symbol->SizeOfStruct = sizeof(PIMAGEHLP_SYMBOL64);
-	PDWORD64 displacement = 0;
-	IMAGEHLP_LINE64 *line = (IMAGEHLP_LINE64 *)malloc(sizeof(IMAGEHLP_LINE64));
-	memset(line, 0, sizeof(IMAGEHLP_LINE64));
-	line->SizeOfStruct = sizeof(IMAGEHLP_LINE64);
-
-	for (uint stackTraceIndex = 0; stackTraceIndex < callStack.m_depth - 2; ++stackTraceIndex)
-	{
-		bool symResult = SymGetSymFromAddr64(pHandle, (DWORD64)callStack.m_trace[stackTraceIndex], displacement, (PIMAGEHLP_SYMBOL64)symbol);
-		if (symResult)
-		{
-			DWORD pdwDisplacement = 0;
-			bool lineResult = SymGetLineFromAddr64(pHandle, (DWORD64)callStack.m_trace[stackTraceIndex], &pdwDisplacement, line);
-			if (lineResult)
+constexpr uint CALLSTACK_FRAME_CHUNK_SIZE = 64U * 1024U;	//Frames are packed into chunks of this many pointers
+constexpr uint INITIAL_CALLSTACK_SLOT_COUNT = 4096U;		//Power of 2, grows to stay at most half full
+
+static std::shared_mutex	gCallstackTableLock;
+static InternedCallstack_T*	gInternedCallstacks = nullptr;		//Indexed by id - 1
+static uint					gInternedCallstackCount = 0U;
+static uint					gInternedCallstackCapacity = 0U;
+static CallstackId*			gCallstackSlots = nullptr;			//Open addressing on the hash, 0 marks an empty slot
+static uint					gCallstackSlotCount = 0U;
+static void**				gCallstackFrameChunk = nullptr;
+static uint					gCallstackFrameChunkUsed = CALLSTACK_FRAME_CHUNK_SIZE;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// DbgHelp is single threaded, every Sym* call goes through this lock
+static std::mutex gSymbolLock;
+static bool gSymbolsInitialized = false;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Resolved symbols by address. Entries are never removed so references stay valid after the lock is released
+struct CachedSymbol_T
+{
+	UntrackedString		m_functionName;
+	UntrackedString		m_sourceLocation;		//filepath.cpp(line,offset), empty if there is no line info
+};
+
+typedef std::unordered_map<void*, CachedSymbol_T, std::hash<void*>, std::equal_to<void*>, TemplatedUntrackedAllocator<std::pair<void* const, CachedSymbol_T>>> SymbolCacheMap;
+
+static std::shared_mutex gSymbolCacheLock;
+
+//------------------------------------------------------------------------------------------------------------------------------
+static SymbolCacheMap& GetSymbolCache()
+{
+	static SymbolCacheMap symbolCache;
+	return symbolCache;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static void InitializeSymbols()
+{
+	if (!gSymbolsInitialized)
+	{
+		SymSetOptions(SymGetOptions() | SYMOPT_UNDNAME | SYMOPT_DEFERRED_LOADS);
+		SymInitialize(GetCurrentProcess(), nullptr, true);
+		gSymbolsInitialized = true;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static unsigned long HashCallstackTrace(void* const* trace, uint depth)
+{
+	//FNV-1a over the frame addresses, folded down to the same width CaptureStackBackTrace gives us
+	uint64_t hash = 14695981039346656037ULL;
+	for (uint frameIndex = 0; frameIndex < depth; ++frameIndex)
+	{
+		hash ^= (uint64_t)trace[frameIndex];
+		hash *= 1099511628211ULL;
+	}
+
+	return (unsigned long)(hash ^ (hash >> 32));
+}
+
+#if ( defined( _WIN64 ))
+//------------------------------------------------------------------------------------------------------------------------------
+// Kept apart from CallstackGetForThread since __try can't share a function with objects that need unwinding
+static uint WalkThreadContext(CONTEXT* context, void** outTrace, uint maxDepth)
+{
+	uint depth = 0;
+
+	//A suspended thread can be anywhere, mid prologue or on a stack we misread, so a bad read ends the walk
+	__try
+	{
+		//Unwind using the function tables in the image, no dbghelp or heap use while the target is suspended
+		while (context->Rip != 0 && depth < maxDepth)
+		{
+			outTrace[depth] = (void*)context->Rip;
+			depth++;
+
+			DWORD64 imageBase = 0;
+			PRUNTIME_FUNCTION function = RtlLookupFunctionEntry(context->Rip, &imageBase, nullptr);
+			if (function == nullptr)
 			{
-				//DebuggerPrintf("CallStack Function at index %d is %s in %s, address 0x%0X\n", stackTraceIndex, symbol->Name, line->FileName, (uint)symbol->Address);
-				DebuggerPrintf("%s(%d):%s \n", line->FileName, line->LineNumber, symbol->Name);
-				callStackStrings.push_back(line->FileName);
+				//Leaf function, the return address is sitting on top of the stack
+				context->Rip = *(DWORD64*)context->Rsp;
+				context->Rsp += sizeof(DWORD64);
 			}
 			else
 			{
-				DebuggerPrintf("Error from SymGetSymFromAddr64: %lu.\n", GetLastError());
+				void* handlerData = nullptr;
+				DWORD64 establisherFrame = 0;
+				RtlVirtualUnwind(UNW_FLAG_NHANDLER, imageBase, context->Rip, function, context, &handlerData, &establisherFrame, nullptr);
 			}
 		}
+	}
+	__except (EXCEPTION_EXECUTE_HANDLER)
+	{
+		//Keep the frames we got before the fault
+	}
+
+	return depth;
+}
+#endif
+
+//------------------------------------------------------------------------------------------------------------------------------
+Callstack CallstackGetForThread(void* threadHandle)
+{
+	Callstack stackTraceObject;
+
+#if ( defined( _WIN64 ))
+	CONTEXT context;
+	memset(&context, 0, sizeof(CONTEXT));
+	context.ContextFlags = CONTEXT_FULL;
+	if (!GetThreadContext((HANDLE)threadHandle, &context))
+	{
+		return stackTraceObject;
+	}
+
+	stackTraceObject.m_depth = WalkThreadContext(&context, stackTraceObject.m_trace, MAX_TRACE);
+	stackTraceObject.m_hash = HashCallstackTrace(stackTraceObject.m_trace, stackTraceObject.m_depth);
+#else
+	UNUSED(threadHandle);
+#endif
+
+	return stackTraceObject;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static uint GetCallstackSlot(unsigned long hash)
+{
+	//CaptureStackBackTrace's hash is a plain sum of the frames so mix it before using the low bits
+	return (uint)hash * 2654435761U;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Caller holds gCallstackTableLock (shared or exclusive)
+static CallstackId FindInternedCallstack(Callstack const& callstack)
+{
+	if (gCallstackSlotCount == 0U)
+	{
+		return INVALID_CALLSTACK_ID;
+	}
+
+	uint slotMask = gCallstackSlotCount - 1U;
+	for (uint slotIndex = GetCallstackSlot(callstack.m_hash) & slotMask; ; slotIndex = (slotIndex + 1U) & slotMask)
+	{
+		CallstackId callstackId = gCallstackSlots[slotIndex];
+		if (callstackId == INVALID_CALLSTACK_ID)
+		{
+			return INVALID_CALLSTACK_ID;
+		}
+
+		//Different stacks can share a hash so the frames have the final say
+		const InternedCallstack_T& interned = gInternedCallstacks[callstackId - 1U];
+		if (interned.m_hash == callstack.m_hash && interned.m_depth == callstack.m_depth
+			&& memcmp(interned.m_frames, callstack.m_trace, callstack.m_depth * sizeof(void*)) == 0)
+		{
+			return callstackId;
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Caller holds gCallstackTableLock exclusively
+static void InsertCallstackSlot(CallstackId callstackId)
+{
+	uint slotMask = gCallstackSlotCount - 1U;
+	uint slotIndex = GetCallstackSlot(gInternedCallstacks[callstackId - 1U].m_hash) & slotMask;
+	while (gCallstackSlots[slotIndex] != INVALID_CALLSTACK_ID)
+	{
+		slotIndex = (slotIndex + 1U) & slotMask;
+	}
+
+	gCallstackSlots[slotIndex] = callstackId;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+CallstackId CallstackIntern(Callstack const& cs)
+{
+	if (cs.m_depth == 0U)
+	{
+		return INVALID_CALLSTACK_ID;
+	}
+
+	{
+		std::shared_lock<std::shared_mutex> readLock(gCallstackTableLock);
+		CallstackId callstackId = FindInternedCallstack(cs);
+		if (callstackId != INVALID_CALLSTACK_ID)
+		{
+			return callstackId;
+		}
+	}
+
+	std::unique_lock<std::shared_mutex> writeLock(gCallstackTableLock);
+
+	//Another thread may have added it between the two locks
+	CallstackId callstackId = FindInternedCallstack(cs);
+	if (callstackId != INVALID_CALLSTACK_ID)
+	{
+		return callstackId;
+	}
+
+	if (gInternedCallstackCount == gInternedCallstackCapacity)
+	{
+		uint newCapacity = (gInternedCallstackCapacity == 0U) ? INITIAL_CALLSTACK_SLOT_COUNT / 2U : gInternedCallstackCapacity * 2U;
+		InternedCallstack_T* newEntries = (InternedCallstack_T*)::realloc(gInternedCallstacks, newCapacity * sizeof(InternedCallstack_T));
+		if (newEntries == nullptr)
+		{
+			return INVALID_CALLSTACK_ID;
+		}
+
+		gInternedCallstacks = newEntries;
+		gInternedCallstackCapacity = newCapacity;
+	}
+
+	if ((gInternedCallstackCount + 1U) * 2U > gCallstackSlotCount)
+	{
+		uint newSlotCount = (gCallstackSlotCount == 0U) ? INITIAL_CALLSTACK_SLOT_COUNT : gCallstackSlotCount * 2U;
+		CallstackId* newSlots = (CallstackId*)::calloc(newSlotCount, sizeof(CallstackId));
+		if (newSlots == nullptr)
+		{
+			return INVALID_CALLSTACK_ID;
+		}
+
+		::free(gCallstackSlots);
+		gCallstackSlots = newSlots;
+		gCallstackSlotCount = newSlotCount;
+
+		for (CallstackId existingId = 1U; existingId <= gInternedCallstackCount; ++existingId)
+		{
+			InsertCallstackSlot(existingId);
+		}
+	}
+
+	if (gCallstackFrameChunkUsed + cs.m_depth > CALLSTACK_FRAME_CHUNK_SIZE)
+	{
+		//Old chunks stay alive, interned entries point into them
+		void** newChunk = (void**)::malloc(CALLSTACK_FRAME_CHUNK_SIZE * sizeof(void*));
+		if (newChunk == nullptr)
+		{
+			return INVALID_CALLSTACK_ID;
+		}
+
+		gCallstackFrameChunk = newChunk;
+		gCallstackFrameChunkUsed = 0U;
+	}
+
+	InternedCallstack_T& interned = gInternedCallstacks[gInternedCallstackCount];
+	interned.m_hash = cs.m_hash;
+	interned.m_depth = cs.m_depth;
+	interned.m_frames = gCallstackFrameChunk + gCallstackFrameChunkUsed;
+	memcpy(interned.m_frames, cs.m_trace, cs.m_depth * sizeof(void*));
+	gCallstackFrameChunkUsed += cs.m_depth;
+
+	gInternedCallstackCount++;
+	callstackId = gInternedCallstackCount;
+	InsertCallstackSlot(callstackId);
+
+	return callstackId;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+Callstack CallstackGetFromId(CallstackId callstackId)
+{
+	Callstack callstack;
+
+	std::shared_lock<std::shared_mutex> readLock(gCallstackTableLock);
+	if (callstackId == INVALID_CALLSTACK_ID || callstackId > gInternedCallstackCount)
+	{
+		return callstack;
+	}
+
+	const InternedCallstack_T& interned = gInternedCallstacks[callstackId - 1U];
+	callstack.m_hash = interned.m_hash;
+	callstack.m_depth = interned.m_depth;
+	memcpy(callstack.m_trace, interned.m_frames, interned.m_depth * sizeof(void*));
+
+	return callstack;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint CallstackGetInternedCount()
+{
+	std::shared_lock<std::shared_mutex> readLock(gCallstackTableLock);
+	return gInternedCallstackCount;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static const CachedSymbol_T& ResolveSymbol(void* address)
+{
+	{
+		std::shared_lock<std::shared_mutex> readLock(gSymbolCacheLock);
+		SymbolCacheMap::const_iterator itr = GetSymbolCache().find(address);
+		if (itr != GetSymbolCache().end())
+		{
+			return itr->second;
+		}
+	}
+
+	CachedSymbol_T resolved;
+	{
+		std::scoped_lock<std::mutex> symbolLock(gSymbolLock);
+		InitializeSymbols();
+
+		char symbolBuffer[sizeof(SYMBOL_INFO) + TRACE_MAX_FUNCTION_NAME_LENGTH * sizeof(TCHAR)];
+		memset(symbolBuffer, 0, sizeof(symbolBuffer));
+
+		PSYMBOL_INFO symbol = (PSYMBOL_INFO)symbolBuffer;
+		symbol->SizeOfStruct = sizeof(SYMBOL_INFO);
+		symbol->MaxNameLen = TRACE_MAX_FUNCTION_NAME_LENGTH;
+
+		DWORD64 displacement = 0;
+		if (SymFromAddr(GetCurrentProcess(), (DWORD64)address, &displacement, symbol))
+		{
+			resolved.m_functionName = symbol->Name;
+		}
 		else
 		{
-			DebuggerPrintf("Error from SymFromAddr: %lu.\n", GetLastError());
+			char addressString[32];
+			snprintf(addressString, sizeof(addressString), "0x%016llX", (unsigned long long)address);
+			resolved.m_functionName = addressString;
+		}
+
+		IMAGEHLP_LINE64 line;
+		memset(&line, 0, sizeof(IMAGEHLP_LINE64));
+		line.SizeOfStruct = sizeof(IMAGEHLP_LINE64);
+
+		DWORD lineDisplacement = 0;
+		if (SymGetLineFromAddr64(GetCurrentProcess(), (DWORD64)address, &lineDisplacement, &line))
+		{
+			char lineString[32];
+			snprintf(lineString, sizeof(lineString), "(%lu,%lu)", (unsigned long)line.LineNumber, (unsigned long)lineDisplacement);
+			resolved.m_sourceLocation = line.FileName;
+			resolved.m_sourceLocation += lineString;
+		}
+	}
+
+	//If another thread resolved the same address first we keep theirs
+	std::unique_lock<std::shared_mutex> writeLock(gSymbolCacheLock);
+	return GetSymbolCache().emplace(address, std::move(resolved)).first->second;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+std::string GetCallstackSymbolName(void* address)
+{
+	return std::string(ResolveSymbol(address).m_functionName.c_str());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+std::vector<std::string> GetCallstackToString(Callstack const& callStack)
+{
+	std::vector<std::string> callStackStrings;
+
+	//The last 2 frames are the OS thread entry points
+	uint numFrames = (callStack.m_depth > 2U) ? callStack.m_depth - 2U : callStack.m_depth;
+	callStackStrings.reserve(numFrames);
+
+	for (uint stackTraceIndex = 0; stackTraceIndex < numFrames; ++stackTraceIndex)
+	{
+		const CachedSymbol_T& symbol = ResolveSymbol(callStack.m_trace[stackTraceIndex]);
+		if (symbol.m_sourceLocation.empty())
+		{
+			callStackStrings.emplace_back(symbol.m_functionName.c_str());
+		}
+		else
+		{
+			callStackStrings.emplace_back(Stringf("%s: %s", symbol.m_sourceLocation.c_str(), symbol.m_functionName.c_str()));
 		}
 	}
 
 	return callStackStrings;
 }
+
+//------------------------------------------------------------------------------------------------------------------------------
+std::vector<std::string> GetCallstackToString(CallstackId callstackId)
+{
+	return GetCallstackToString(CallstackGetFromId(callstackId));
+}
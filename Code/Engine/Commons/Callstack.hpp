@@ -1,4 +1,6 @@
 #pragma once
+#include <stdint.h>
+#include <string>
 #include <vector>
 
 #define MAX_TRACE 64
@@ -14,13 +16,36 @@ public:
 	unsigned long m_hash = 0;
 };
 
+//------------------------------------------------------------------------------------------------------------------------------
+// Callstacks can be interned so long lived records (tracked allocations, log entries) carry a 32 bit id instead of a full trace.
+// Identical stacks share one entry, storage is untracked and ids stay valid for the lifetime of the process
+typedef uint32_t CallstackId;
+constexpr CallstackId INVALID_CALLSTACK_ID = 0U;
+
 // skip frames is the number of frames from where we are to skip (ie, ignore)
 Callstack CallstackGet(uint skip_frames = 0);
 
+// Safe to call from inside operator new, the table never goes through tracked allocations
+CallstackId CallstackIntern(Callstack const& cs);
+Callstack CallstackGetFromId(CallstackId callstackId);
+uint CallstackGetInternedCount();
+
+// Walks the stack of another thread from its saved register context
+// The thread must be suspended by the caller (SuspendThread) for the duration of the call
+// Does not allocate, so a target holding the heap lock is fine, and a fault mid walk just ends the stack early.
+// It is not lock free: RtlLookupFunctionEntry takes the loader's function table lock, so a target suspended while it
+// loads or unloads a module deadlocks the walk. Only sample threads that don't load modules at runtime
+Callstack CallstackGetForThread(void* threadHandle);
+
+// Returns the undecorated function name for a code address (or the address as hex if no symbol is found)
+// Resolved addresses are cached so each one only goes through DbgHelp once
+std::string GetCallstackSymbolName(void* address);
+
 // Convert a callstack to strings
 // with one string per line
 // Strings should return in this format...
 // filepath.cpp(line,offset): function_name
 // for example
 // Engine/Image.cpp(127,8): Image::LoadFromFile
-std::vector<std::string> GetCallstackToString(Callstack const& cs);
\ No newline at end of file
+std::vector<std::string> GetCallstackToString(Callstack const& cs);
+std::vector<std::string> GetCallstackToString(CallstackId callstackId);
@@ -1,9 +1,13 @@
 #include "Engine/Commons/LogSystem.hpp"
+#include "Engine/Commons/UnitTest.hpp"
+#include "Engine/Core/BlockCompressor.hpp"
 #include "Engine/Core/FileUtils.hpp"
 #include "Engine/Core/Time.hpp"
 #include "Engine/Core/WindowContext.hpp"
+#include <algorithm>
 #include <fstream>
 #include <stdarg.h>
+#include <stdio.h>
 
 LogSystem* g_LogSystem = nullptr;
 
@@ -11,6 +15,9 @@ LogSystem* g_LogSystem = nullptr;
 LogSystem::LogSystem(const char* fileName)
 {
 	m_filename = fileName;
+
+	//Everything logs until a filter is disabled
+	SetAllFiltersEnabled(true);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
@@ -20,25 +27,76 @@ LogSystem::~LogSystem()
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-static void LogThread()
+static std::string GetLogEntryText(double timeSeconds, const char* filter, const char* message)
 {
-	if (g_LogSystem == nullptr)
-		return;
+	std::string logWriteString("\n\n Log Entry: ");
+	logWriteString += "\n\t Time: ";
+	logWriteString += std::to_string(timeSeconds);
+	logWriteString += "Filter: ";
+	logWriteString += filter;
+	logWriteString += "\n\t Message: ";
+	logWriteString += message;
+	return logWriteString;
+}
 
-	if (g_LogSystem->m_fileStream == nullptr)
+//------------------------------------------------------------------------------------------------------------------------------
+static void ProcessLogRecord(LogObject_T* log)
+{
+	if (log->recordType == LOG_RECORD_BINARY)
 	{
-		// See if a file exists, if not create one
-		g_LogSystem->m_fileStream = CreateFileWriteBuffer(g_LogSystem->m_filename);
-		if (g_LogSystem->m_fileStream == nullptr)
+		if (g_LogSystem->m_deferFormatting && g_LogSystem->m_logHooks.empty())
 		{
-			ERROR_AND_DIE("Could not create log file");
+			//Nobody needs the text right now, leave the formatting to the decoder
+			g_LogSystem->WriteDeferredEntry(*log);
 			return;
 		}
+
+		//Format once and hand the same text to the file and the hooks
+		const LogBinaryHeader_T* header = (const LogBinaryHeader_T*)(log + 1);
+		std::string line;
+		FormatBinaryLogRecord(line, header->format, (const byte*)(header + 1), header->numArgs, header->argBytes);
+
+		LogObject_T formattedLog = *log;
+		formattedLog.recordType = LOG_RECORD_TEXT;
+		formattedLog.line = &line[0];
+
+		if (g_LogSystem->m_deferFormatting)
+		{
+			g_LogSystem->WriteDeferredEntry(*log);
+		}
+		else
+		{
+			g_LogSystem->WriteToLogFromBuffer(formattedLog);
+		}
+
+		g_LogSystem->RunAllHooks(&formattedLog);
+	}
+	else
+	{
+		if (g_LogSystem->m_deferFormatting)
+		{
+			g_LogSystem->WriteDeferredEntry(*log);
+		}
+		else
+		{
+			g_LogSystem->WriteToLogFromBuffer(*log);
+		}
+
+		g_LogSystem->RunAllHooks(log);
 	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static void LogThread()
+{
+	if (g_LogSystem == nullptr)
+		return;
 
-	//Log that we have initialized
-	std::string initString = "Log Initialized";
-	g_LogSystem->m_fileStream->write(initString.c_str(), initString.length());
+	if (!g_LogSystem->OpenLogSegment())
+	{
+		ERROR_AND_DIE("Could not create log file");
+		return;
+	}
 
 	// wait for information to write to log while running
 	while (g_LogSystem->IsRunning())
@@ -51,26 +109,30 @@ static void LogThread()
 		LogObject_T *log = (LogObject_T*)g_LogSystem->m_messages.TryLockRead(&outSize);
 		while (log != nullptr)
 		{
-			g_LogSystem->WriteToLogFromBuffer(*log);
-			g_LogSystem->RunAllHooks(log);
+			ProcessLogRecord(log);
 			g_LogSystem->m_messages.UnlockRead(log);
 			log = (LogObject_T*)g_LogSystem->m_messages.TryLockRead(&outSize);
 		}
 
+		//Only rotate between records so an entry never straddles two segments
+		if (g_LogSystem->IsRotationDue())
+		{
+			g_LogSystem->RotateLogSegment();
+		}
+
 		//Check for log flush
 		if (g_LogSystem->m_flushRequested)
 		{
 			log = (LogObject_T*)g_LogSystem->m_messages.TryLockRead(&outSize);
 			while (log != nullptr)
 			{
-				g_LogSystem->WriteToLogFromBuffer(*log);
-				g_LogSystem->RunAllHooks(log);
+				ProcessLogRecord(log);
 				g_LogSystem->m_messages.UnlockRead(log);
 				log = (LogObject_T*)g_LogSystem->m_messages.TryLockRead(&outSize);
 			}
 
 			// flush the file
-			g_LogSystem->m_fileStream->flush();
+			g_LogSystem->m_fileWriter.Flush();
 
 			g_LogSystem->m_flushRequested = false;
 		}
@@ -78,16 +140,31 @@ static void LogThread()
 	}
 
 	
-	// flush the file
-	g_LogSystem->m_fileStream->flush();
-	// close the file
-	g_LogSystem->m_fileStream->close();
+	// flush and close the file, the last segment stays uncompressed so it can be read right away
+	g_LogSystem->m_fileWriter.Close();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static void LogCompressThread()
+{
+	if (g_LogSystem == nullptr)
+		return;
+
+	//Keep going until shutdown, then take one last pass so no closed segment is left behind
+	bool isCompressing = true;
+	while (isCompressing)
+	{
+		g_LogSystem->m_compressSemaphore.Acquire();
+		isCompressing = g_LogSystem->m_isCompressing;
+
+		g_LogSystem->CompressClosedSegments();
+	}
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
 void LogSystem::WriteToLogFromBuffer(const LogObject_T& log)
 {
-	bool result = g_LogSystem->m_fileStream->is_open();
+	bool result = g_LogSystem->m_fileWriter.IsOpen();
 	if (!result)
 	{
 		ERROR_AND_DIE("The log file stream was closed but LogThread is trying to write to file");
@@ -95,17 +172,11 @@ void LogSystem::WriteToLogFromBuffer(const LogObject_T& log)
 
 	// write it
 	// buffer is the c_str of the message
-	std::string logWriteString("\n\n Log Entry: ");
-	logWriteString += "\n\t Time: ";
-	logWriteString += std::to_string(GetHPCToSeconds(log.hpcTime));
-	logWriteString += "Filter: ";
-	logWriteString += log.filter;
-	logWriteString += "\n\t Message: ";
-	logWriteString += log.line;
-	if (log.callstack.m_depth != 0)
+	std::string logWriteString = GetLogEntryText(GetHPCToSeconds(log.hpcTime), log.filter, log.line);
+	if (log.callstackId != INVALID_CALLSTACK_ID)
 	{
 		logWriteString += "\n\t Callstack: \n\t ";
-		std::vector<std::string> callStackStrings = GetCallstackToString(log.callstack);
+		std::vector<std::string> callStackStrings = GetCallstackToString(log.callstackId);
 		std::vector<std::string>::iterator stringsItr = callStackStrings.begin();
 		while (stringsItr != callStackStrings.end())
 		{
@@ -115,7 +186,7 @@ void LogSystem::WriteToLogFromBuffer(const LogObject_T& log)
 		}
 	}
 
-	g_LogSystem->m_fileStream->write(logWriteString.c_str(), logWriteString.length());
+	g_LogSystem->m_fileWriter.Write(logWriteString.c_str(), logWriteString.length());
 
 	log.~LogObject_T();
 }
@@ -131,11 +202,20 @@ void LogSystem::LogSystemInit()
 	//Get system date and time
 	std::string systemDateTime = "ExecutionLog" + GetDateTime();
 	completeFilePath += systemDateTime;
-	completeFilePath += ".bin";
 
-	m_filename = completeFilePath;
+	//Segments share the base name, the first one keeps the plain .bin name
+	m_baseFilename = completeFilePath;
+	m_segmentIndex = 0U;
+	m_filename = GetSegmentFileName(m_segmentIndex);
 	m_semaphore.Create(0, 1);
-	m_messages.InitializeBuffer(2048);
+	m_messages.InitializeBuffer(LOG_MESSAGE_BUFFER_BYTES);
+
+	if (m_compressRotatedSegments)
+	{
+		m_compressSemaphore.Create(0, 1);
+		m_isCompressing = true;
+		m_compressThread = std::thread(LogCompressThread);
+	}
 
 	// last thing I do before returning
 	m_thread = std::thread(LogThread);
@@ -156,6 +236,14 @@ void LogSystem::LogSystemShutDown()
 	SignalWork();
 
 	m_thread.join();
+
+	//The log thread is done rotating so the queue only shrinks from here
+	if (m_compressThread.joinable())
+	{
+		m_isCompressing = false;
+		m_compressSemaphore.Release(1);
+		m_compressThread.join();
+	}
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
@@ -177,23 +265,31 @@ void LogSystem::Logf(char const* filter, char const* format, ...)
 	
 	va_list args;
 	va_start(args, format);
+
+	//Measuring consumes the list, the write needs its own copy
+	va_list writeArgs;
+	va_copy(writeArgs, args);
 	size_t msgLength = vsnprintf(nullptr, 0, format, args) + 1U;
 	//The 1U is added to account for the null termination character
 
 	size_t filterLength = strlen(filter) + 1U;
 
+	//LockWrite never returns for a record bigger than the ring, vsnprintf cuts the message to what fits
+	msgLength = std::min(msgLength, g_LogSystem->m_messages.GetMaxWriteSize() - logObjSize - filterLength);
+
 	size_t totalSize = logObjSize + msgLength + filterLength;
 	void* buffer = g_LogSystem->m_messages.LockWrite(totalSize);
 
 	LogObject_T* log = (LogObject_T*)buffer;
+	log->recordType = LOG_RECORD_TEXT;
 	log->hpcTime = GetCurrentTimeHPC();
-	log->callstack = CallstackGet(2);
-	log->callstack.m_depth = 0;
+	log->callstackId = INVALID_CALLSTACK_ID;
 	log->line = (char*)buffer + logObjSize;
 	log->filter = (char*)buffer + logObjSize + msgLength;
 
-	vsnprintf(log->line, msgLength, format, args);
+	vsnprintf(log->line, msgLength, format, writeArgs);
 	memcpy(log->filter, filter, filterLength);
+	va_end(writeArgs);
 	va_end(args);
 
 	m_messages.UnlockWrite(buffer);
@@ -220,22 +316,31 @@ void LogSystem::LogCallstackf(char const* filter, char const* format, ...)
 
 	va_list args;
 	va_start(args, format);
+
+	//Measuring consumes the list, the write needs its own copy
+	va_list writeArgs;
+	va_copy(writeArgs, args);
 	size_t msgLength = vsnprintf(nullptr, 0, format, args) + 1U;
 	//The 1U is added to account for the null termination character
 
 	size_t filterLength = strlen(filter) + 1U;
 
+	//LockWrite never returns for a record bigger than the ring, vsnprintf cuts the message to what fits
+	msgLength = std::min(msgLength, g_LogSystem->m_messages.GetMaxWriteSize() - logObjSize - filterLength);
+
 	size_t totalSize = logObjSize + msgLength + filterLength;
 	void* buffer = g_LogSystem->m_messages.LockWrite(totalSize);
 
 	LogObject_T* log = (LogObject_T*)buffer;
+	log->recordType = LOG_RECORD_TEXT;
 	log->hpcTime = GetCurrentTimeHPC();
-	log->callstack = CallstackGet(2);
+	log->callstackId = CallstackIntern(CallstackGet(2));
 	log->line = (char*)buffer + logObjSize;
 	log->filter = (char*)buffer + logObjSize + msgLength;
 
-	vsnprintf(log->line, msgLength, format, args);
+	vsnprintf(log->line, msgLength, format, writeArgs);
 	memcpy(log->filter, filter, filterLength);
+	va_end(writeArgs);
 	va_end(args);
 
 	g_LogSystem->RunAllHooks(log);
@@ -264,39 +369,141 @@ void LogSystem::RunAllHooks(const LogObject_T* logObj)
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-bool LogSystem::CheckAgainstFilter(const char* filterToCheck)
+static uint32_t GetLogFilterHash(const char* filter)
 {
-	if (g_LogSystem == nullptr)
-		return false;
+	//FNV-1a, 0 is reserved for empty slots
+	uint32_t hash = 2166136261U;
+	while (*filter != '\0')
+	{
+		hash ^= (uint8_t)*filter;
+		hash *= 16777619U;
+		filter++;
+	}
 
-	std::scoped_lock lock(m_filterMutex);
-	if (m_filterMode == true)
+	return (hash == 0U) ? 1U : hash;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint16_t LogSystem::FindFilterId(const char* filter) const
+{
+	uint32_t hash = GetLogFilterHash(filter);
+
+	for (uint probe = 0; probe < MAX_LOG_FILTERS; ++probe)
 	{
-		//we are in white list mode so we should not write this log if filter exists in set
-		if (m_filterSet.find(filterToCheck) != m_filterSet.end())
+		uint slotIndex = (hash + probe) & (MAX_LOG_FILTERS - 1U);
+		uint32_t slotHash = m_filterSlots[slotIndex].hash.load(std::memory_order_acquire);
+
+		if (slotHash == 0U)
 		{
-			//We found this filter in the set so we shouldn't write
-			return false;
+			//Hit an empty slot, this filter was never interned
+			return INVALID_LOG_FILTER_ID;
 		}
-		else
+
+		if (slotHash == hash && strcmp(m_filterSlots[slotIndex].name, filter) == 0)
 		{
-			//We didn't find it in the set so this filter is writable
-			return true;
+			return (uint16_t)slotIndex;
 		}
 	}
-	else
+
+	return INVALID_LOG_FILTER_ID;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint16_t LogSystem::InternFilter(const char* filter)
+{
+	uint16_t filterId = FindFilterId(filter);
+	if (filterId != INVALID_LOG_FILTER_ID)
 	{
-		//we are in black list mode so we should write this log if filter exists in set
-		if (m_filterSet.find(filterToCheck) != m_filterSet.end())
-		{
-			//We found the filter in the set so we should write this message to log
-			return true;
-		}
-		else
+		return filterId;
+	}
+
+	std::scoped_lock lock(m_filterInternLock);
+
+	//Someone may have interned it while we waited on the lock
+	filterId = FindFilterId(filter);
+	if (filterId != INVALID_LOG_FILTER_ID)
+	{
+		return filterId;
+	}
+
+	//A cut down name could match a different filter sharing its prefix, so long names are never interned
+	size_t filterLength = strlen(filter);
+	if (filterLength >= MAX_LOG_FILTER_NAME_LENGTH)
+	{
+		return INVALID_LOG_FILTER_ID;
+	}
+
+	uint32_t hash = GetLogFilterHash(filter);
+	for (uint probe = 0; probe < MAX_LOG_FILTERS; ++probe)
+	{
+		uint slotIndex = (hash + probe) & (MAX_LOG_FILTERS - 1U);
+		LogFilterSlot_T& slot = m_filterSlots[slotIndex];
+
+		if (slot.hash.load(std::memory_order_relaxed) == 0U)
 		{
-			return false;
+			memcpy(slot.name, filter, filterLength + 1U);
+
+			//Publish the slot only once the name is in place, readers check the hash first
+			slot.hash.store(hash, std::memory_order_release);
+			return (uint16_t)slotIndex;
 		}
 	}
+
+	//Table is full, this filter follows the enable/disable all state
+	return INVALID_LOG_FILTER_ID;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool LogSystem::IsFilterEnabled(uint16_t filterId) const
+{
+	if (filterId == INVALID_LOG_FILTER_ID)
+	{
+		return m_filtersEnabledByDefault.load(std::memory_order_relaxed);
+	}
+
+	uint64_t bits = m_enabledFilterBits[filterId / 64U].load(std::memory_order_relaxed);
+	return (bits & (1ULL << (filterId % 64U))) != 0U;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void LogSystem::SetFilterEnabled(uint16_t filterId, bool isEnabled)
+{
+	if (filterId == INVALID_LOG_FILTER_ID)
+	{
+		return;
+	}
+
+	uint64_t mask = 1ULL << (filterId % 64U);
+	if (isEnabled)
+	{
+		m_enabledFilterBits[filterId / 64U].fetch_or(mask, std::memory_order_relaxed);
+	}
+	else
+	{
+		m_enabledFilterBits[filterId / 64U].fetch_and(~mask, std::memory_order_relaxed);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void LogSystem::SetAllFiltersEnabled(bool isEnabled)
+{
+	m_filtersEnabledByDefault.store(isEnabled, std::memory_order_relaxed);
+
+	uint64_t allBits = isEnabled ? ~0ULL : 0ULL;
+	for (uint wordIndex = 0; wordIndex < MAX_LOG_FILTERS / 64U; ++wordIndex)
+	{
+		m_enabledFilterBits[wordIndex].store(allBits, std::memory_order_relaxed);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool LogSystem::CheckAgainstFilter(const char* filterToCheck) const
+{
+	if (g_LogSystem == nullptr)
+		return false;
+
+	//Filters that were never enabled or disabled by name aren't interned and follow the default
+	return IsFilterEnabled(FindFilterId(filterToCheck));
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
@@ -305,9 +512,7 @@ void LogSystem::LogEnableAll()
 	if (g_LogSystem == nullptr)
 		return;
 
-	std::scoped_lock lock(m_filterMutex);
-	m_filterMode = true;
-	m_filterSet.clear();
+	SetAllFiltersEnabled(true);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
@@ -316,9 +521,7 @@ void LogSystem::LogDisableAll()
 	if (g_LogSystem == nullptr)
 		return;
 
-	std::scoped_lock lock(m_filterMutex);
-	m_filterMode = false;
-	m_filterSet.clear();
+	SetAllFiltersEnabled(false);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
@@ -327,20 +530,7 @@ void LogSystem::LogEnable(char const* filter)
 	if (g_LogSystem == nullptr)
 		return;
 
-	std::scoped_lock lock(m_filterMutex);
-	if (m_filterMode == false)
-	{
-		//We have blacklisted things so enabling a specific filter makes sense
-		m_filterSet.insert(filter);
-	}
-	else
-	{
-		std::set<std::string>::iterator itr = m_filterSet.find(filter);
-		if (itr != m_filterSet.end())
-		{
-			m_filterSet.erase(itr);
-		}
-	}
+	SetFilterEnabled(InternFilter(filter), true);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
@@ -349,20 +539,7 @@ void LogSystem::LogDisable(char const* filter)
 	if (g_LogSystem == nullptr)
 		return;
 
-	std::scoped_lock lock(m_filterMutex);
-	if (m_filterMode == true)
-	{
-		//We have white-listed things so disabling a specific filter makes sense
-		m_filterSet.insert(filter);
-	}
-	else
-	{
-		std::set<std::string>::iterator itr = m_filterSet.find(filter);
-		if (itr != m_filterSet.end())
-		{
-			m_filterSet.erase(itr);
-		}
-	}
+	SetFilterEnabled(InternFilter(filter), false);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
@@ -407,4 +584,379 @@ void LogSystem::LogUnhook(LogHookCallback cb)
 	m_logHooks.erase(itr);
 }
 
+//------------------------------------------------------------------------------------------------------------------------------
+void LogSystem::SetRotation(uint64_t maxSegmentBytes, double maxSegmentSeconds, bool compressRotatedSegments)
+{
+	m_maxSegmentBytes = maxSegmentBytes;
+	m_maxSegmentSeconds = maxSegmentSeconds;
+	m_compressRotatedSegments = compressRotatedSegments;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+std::string LogSystem::GetSegmentFileName(uint segmentIndex) const
+{
+	if (segmentIndex == 0U)
+	{
+		return m_baseFilename + ".bin";
+	}
+
+	return Stringf("%s_%u.bin", m_baseFilename.c_str(), segmentIndex);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool LogSystem::OpenLogSegment()
+{
+	if (!m_fileWriter.Open(m_filename))
+	{
+		return false;
+	}
+
+	m_segmentStartTime = GetCurrentTimeSeconds();
+
+	//Every segment stands on its own, deferred segments get their own header and string table
+	if (m_deferFormatting)
+	{
+		m_deferredFormatIds.clear();
+		m_deferredFilterIds.clear();
+		m_nextDeferredStringId = 0U;
+
+		WriteDeferredHeader();
+	}
+	else if (m_segmentIndex == 0U)
+	{
+		std::string initString = "Log Initialized";
+		m_fileWriter.Write(initString.c_str(), initString.length());
+	}
+	else
+	{
+		std::string continueString = Stringf("Log Continued (segment %u)", m_segmentIndex);
+		m_fileWriter.Write(continueString.c_str(), continueString.length());
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool LogSystem::IsRotationDue() const
+{
+	if (m_maxSegmentBytes != 0U && m_fileWriter.GetBytesWritten() >= m_maxSegmentBytes)
+	{
+		return true;
+	}
+
+	return m_maxSegmentSeconds > 0.0 && GetCurrentTimeSeconds() - m_segmentStartTime >= m_maxSegmentSeconds;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void LogSystem::RotateLogSegment()
+{
+	m_fileWriter.Close();
+	std::string closedSegment = m_filename;
+
+	m_segmentIndex++;
+	m_filename = GetSegmentFileName(m_segmentIndex);
+	if (!OpenLogSegment())
+	{
+		ERROR_AND_DIE("Could not create log segment");
+		return;
+	}
 
+	//Hand it off, compressing a full segment here would stall the log thread and let the ring fill up
+	if (m_compressRotatedSegments)
+	{
+		{
+			std::scoped_lock lock(m_compressLock);
+			m_segmentsToCompress.push_back(closedSegment);
+		}
+
+		m_compressSemaphore.Release(1);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void LogSystem::CompressClosedSegments()
+{
+	std::vector<std::string> closedSegments;
+	{
+		std::scoped_lock lock(m_compressLock);
+		closedSegments.swap(m_segmentsToCompress);
+	}
+
+	for (size_t segmentIndex = 0; segmentIndex < closedSegments.size(); ++segmentIndex)
+	{
+		const std::string& closedSegment = closedSegments[segmentIndex];
+		std::string compressedSegment = closedSegment + COMPRESSED_LOG_SEGMENT_EXTENSION;
+		if (CompressFileToBlockStream(closedSegment, compressedSegment))
+		{
+			remove(closedSegment.c_str());
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static void WriteLogBytes(BufferedFileWriter& writer, const void* data, size_t byteSize)
+{
+	writer.Write(data, byteSize);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void LogSystem::WriteDeferredHeader()
+{
+	WriteLogBytes(m_fileWriter, BINARY_LOG_MAGIC, sizeof(BINARY_LOG_MAGIC));
+	WriteLogBytes(m_fileWriter, &BINARY_LOG_VERSION, sizeof(BINARY_LOG_VERSION));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint32_t LogSystem::GetDeferredStringId(const char* string, bool internByAddress)
+{
+	//Format strings are literals so their address identifies them, filters are copied into the ring so we go by content
+	uint32_t stringId = 0U;
+	if (internByAddress)
+	{
+		std::map<const void*, uint32_t>::iterator itr = m_deferredFormatIds.find(string);
+		if (itr != m_deferredFormatIds.end())
+		{
+			return itr->second;
+		}
+
+		stringId = m_nextDeferredStringId++;
+		m_deferredFormatIds[string] = stringId;
+	}
+	else
+	{
+		std::map<std::string, uint32_t>::iterator itr = m_deferredFilterIds.find(string);
+		if (itr != m_deferredFilterIds.end())
+		{
+			return itr->second;
+		}
+
+		stringId = m_nextDeferredStringId++;
+		m_deferredFilterIds[string] = stringId;
+	}
+
+	//First time we see this string, define it before any entry references it
+	eLogChunkType chunkType = LOG_CHUNK_STRING;
+	uint16_t length = (uint16_t)strlen(string);
+	WriteLogBytes(m_fileWriter, &chunkType, sizeof(chunkType));
+	WriteLogBytes(m_fileWriter, &stringId, sizeof(stringId));
+	WriteLogBytes(m_fileWriter, &length, sizeof(length));
+	WriteLogBytes(m_fileWriter, string, length);
+
+	return stringId;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void LogSystem::WriteDeferredEntry(const LogObject_T& log)
+{
+	double timeSeconds = GetHPCToSeconds(log.hpcTime);
+	uint32_t filterId = GetDeferredStringId(log.filter, false);
+
+	if (log.recordType == LOG_RECORD_BINARY)
+	{
+		const LogBinaryHeader_T* header = (const LogBinaryHeader_T*)(&log + 1);
+		uint32_t formatId = GetDeferredStringId(header->format, true);
+
+		eLogChunkType chunkType = LOG_CHUNK_BINARY_ENTRY;
+		WriteLogBytes(m_fileWriter, &chunkType, sizeof(chunkType));
+		WriteLogBytes(m_fileWriter, &timeSeconds, sizeof(timeSeconds));
+		WriteLogBytes(m_fileWriter, &filterId, sizeof(filterId));
+		WriteLogBytes(m_fileWriter, &formatId, sizeof(formatId));
+		WriteLogBytes(m_fileWriter, &header->numArgs, sizeof(header->numArgs));
+		WriteLogBytes(m_fileWriter, &header->argBytes, sizeof(header->argBytes));
+		WriteLogBytes(m_fileWriter, header + 1, header->argBytes);
+	}
+	else
+	{
+		std::string line = log.line;
+		if (log.callstackId != INVALID_CALLSTACK_ID)
+		{
+			//Symbols only resolve in this process so the callstack is written out as text
+			line += "\n\t Callstack: \n\t ";
+			std::vector<std::string> callStackStrings = GetCallstackToString(log.callstackId);
+			for (size_t stringIndex = 0; stringIndex < callStackStrings.size(); ++stringIndex)
+			{
+				line += callStackStrings[stringIndex];
+				line += "\n\t ";
+			}
+		}
+
+		eLogChunkType chunkType = LOG_CHUNK_TEXT_ENTRY;
+		uint32_t length = (uint32_t)line.length();
+		WriteLogBytes(m_fileWriter, &chunkType, sizeof(chunkType));
+		WriteLogBytes(m_fileWriter, &timeSeconds, sizeof(timeSeconds));
+		WriteLogBytes(m_fileWriter, &filterId, sizeof(filterId));
+		WriteLogBytes(m_fileWriter, &length, sizeof(length));
+		WriteLogBytes(m_fileWriter, line.c_str(), length);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+static bool ReadLogValue(const char*& readHead, const char* readEnd, T& outValue)
+{
+	if (readHead + sizeof(T) > readEnd)
+	{
+		return false;
+	}
+
+	memcpy(&outValue, readHead, sizeof(T));
+	readHead += sizeof(T);
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool LogSystem::DecodeBinaryLogFile(const std::string& binaryFile, const std::string& textFile)
+{
+	char* fileData = nullptr;
+	unsigned long fileSize = CreateFileReadBuffer(binaryFile, &fileData);
+
+	//Rotated segments are compressed, inflate them first
+	std::vector<char> decompressedData;
+	const char* logData = fileData;
+	size_t logSize = fileSize;
+	bool isCompressed = IsBlockStream(fileData, fileSize);
+	if (isCompressed)
+	{
+		if (!DecompressBlockStream(fileData, fileSize, decompressedData))
+		{
+			delete[] fileData;
+			return false;
+		}
+
+		logData = decompressedData.data();
+		logSize = decompressedData.size();
+	}
+
+	bool isBinaryLog = logSize >= sizeof(BINARY_LOG_MAGIC) + sizeof(BINARY_LOG_VERSION) && memcmp(logData, BINARY_LOG_MAGIC, sizeof(BINARY_LOG_MAGIC)) == 0;
+	if (!isBinaryLog && !isCompressed)
+	{
+		delete[] fileData;
+		return false;
+	}
+
+	std::ofstream* textStream = CreateTextFileWriteBuffer(textFile);
+	if (textStream == nullptr || !textStream->is_open())
+	{
+		delete textStream;
+		delete[] fileData;
+		return false;
+	}
+
+	//Segments written without deferred formatting are already text once inflated
+	if (!isBinaryLog)
+	{
+		textStream->write(logData, logSize);
+		textStream->close();
+
+		delete textStream;
+		delete[] fileData;
+		return true;
+	}
+
+	const char* readHead = logData + sizeof(BINARY_LOG_MAGIC) + sizeof(BINARY_LOG_VERSION);
+	const char* readEnd = logData + logSize;
+
+	std::map<uint32_t, std::string> strings;
+	bool isValid = true;
+
+	while (readHead < readEnd && isValid)
+	{
+		eLogChunkType chunkType = (eLogChunkType)*readHead;
+		readHead++;
+
+		switch (chunkType)
+		{
+		case LOG_CHUNK_STRING:
+		{
+			uint32_t stringId;
+			uint16_t length;
+			isValid = ReadLogValue(readHead, readEnd, stringId) && ReadLogValue(readHead, readEnd, length) && (readHead + length <= readEnd);
+			if (isValid)
+			{
+				strings[stringId] = std::string(readHead, length);
+				readHead += length;
+			}
+		}
+		break;
+		case LOG_CHUNK_BINARY_ENTRY:
+		{
+			double timeSeconds;
+			uint32_t filterId;
+			uint32_t formatId;
+			uint16_t numArgs;
+			uint16_t argBytes;
+			isValid = ReadLogValue(readHead, readEnd, timeSeconds) && ReadLogValue(readHead, readEnd, filterId) && ReadLogValue(readHead, readEnd, formatId)
+				&& ReadLogValue(readHead, readEnd, numArgs) && ReadLogValue(readHead, readEnd, argBytes) && (readHead + argBytes <= readEnd);
+			if (isValid)
+			{
+				std::string message;
+				FormatBinaryLogRecord(message, strings[formatId].c_str(), (const byte*)readHead, numArgs, argBytes);
+				readHead += argBytes;
+
+				std::string entry = GetLogEntryText(timeSeconds, strings[filterId].c_str(), message.c_str());
+				textStream->write(entry.c_str(), entry.length());
+			}
+		}
+		break;
+		case LOG_CHUNK_TEXT_ENTRY:
+		{
+			double timeSeconds;
+			uint32_t filterId;
+			uint32_t length;
+			isValid = ReadLogValue(readHead, readEnd, timeSeconds) && ReadLogValue(readHead, readEnd, filterId) && ReadLogValue(readHead, readEnd, length) && (readHead + length <= readEnd);
+			if (isValid)
+			{
+				std::string message(readHead, length);
+				readHead += length;
+
+				std::string entry = GetLogEntryText(timeSeconds, strings[filterId].c_str(), message.c_str());
+				textStream->write(entry.c_str(), entry.length());
+			}
+		}
+		break;
+		default:
+			isValid = false;
+			break;
+		}
+	}
+
+	textStream->close();
+	delete textStream;
+	delete[] fileData;
+
+	//A truncated tail (the game crashed mid write) still decodes everything before it
+	return isValid;
+}
+
+
+//------------------------------------------------------------------------------------------------------------------------------
+// UNIT TEST
+//------------------------------------------------------------------------------------------------------------------------------
+UNITTEST("RecordLargerThanRing", "LogSystem", 100)
+{
+	//No log thread, the test reads the ring itself. Two full length strings don't fit in the ring as a binary record
+	LogSystem* previousLogSystem = g_LogSystem;
+	LogSystem testLogSystem("");
+	testLogSystem.m_semaphore.Create(0, 1);
+	testLogSystem.m_messages.InitializeBuffer(LOG_MESSAGE_BUFFER_BYTES);
+	g_LogSystem = &testLogSystem;
+
+	std::string longString(MAX_LOG_STRING_ARG_LENGTH, 'x');
+	testLogSystem.LogBinaryf("Test", "%s|%s", longString.c_str(), longString.c_str());
+
+	size_t recordSize = 0;
+	LogObject_T* log = (LogObject_T*)testLogSystem.m_messages.TryLockRead(&recordSize);
+	bool isTextRecord = (log != nullptr && log->recordType == LOG_RECORD_TEXT);
+	bool isCutToFit = isTextRecord && recordSize <= testLogSystem.m_messages.GetMaxWriteSize()
+		&& strncmp(log->line, longString.c_str(), longString.length()) == 0 && strcmp(log->filter, "Test") == 0;
+
+	if (log != nullptr)
+	{
+		testLogSystem.m_messages.UnlockRead(log);
+	}
+	g_LogSystem = previousLogSystem;
+
+	CONFIRM(isTextRecord);
+	CONFIRM(isCutToFit);
+	return true;
+}
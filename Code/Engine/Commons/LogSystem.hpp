@@ -1,19 +1,68 @@
 #pragma once
+#include "Engine/Commons/BinaryLogRecord.hpp"
 #include "Engine/Commons/Callstack.hpp"
 #include <thread>
 #include "Engine/Core/Async/MPSCAsyncRingBuffer.hpp"
 #include "Engine/Core/Async/Semaphores.hpp"
-#include <set>
-#include <shared_mutex>
+#include "Engine/Core/BufferedFileWriter.hpp"
+#include "Engine/Core/Time.hpp"
+#include <atomic>
+#include <map>
+#include <mutex>
 
+//------------------------------------------------------------------------------------------------------------------------------
+enum eLogRecordType : uint8_t
+{
+	LOG_RECORD_TEXT,		//line holds the formatted message
+	LOG_RECORD_BINARY,		//a LogBinaryHeader_T and the encoded arguments follow the LogObject_T
+};
 
 //------------------------------------------------------------------------------------------------------------------------------
 struct LogObject_T
 {
+	eLogRecordType		recordType;
 	uint64_t			hpcTime;
 	char*				filter;
 	char*				line;
-	Callstack			callstack;
+	CallstackId			callstackId;		//INVALID_CALLSTACK_ID when the record has no callstack
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Chunks of a log file written with deferred formatting, see LogSystem::DecodeBinaryLogFile
+//------------------------------------------------------------------------------------------------------------------------------
+enum eLogChunkType : uint8_t
+{
+	LOG_CHUNK_STRING,			// id, length, characters. Format strings and filters are written once and referenced by id
+	LOG_CHUNK_BINARY_ENTRY,		// time, filter id, format id, arg count, arg bytes, encoded args
+	LOG_CHUNK_TEXT_ENTRY,		// time, filter id, length, characters
+
+	NUM_LOG_CHUNK_TYPES
+};
+
+constexpr char		BINARY_LOG_MAGIC[4] = { 'B', 'L', 'O', 'G' };
+constexpr uint32_t	BINARY_LOG_VERSION = 1U;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Rotation defaults, a limit of 0 turns that trigger off
+constexpr uint64_t	DEFAULT_LOG_SEGMENT_MAX_BYTES = 256ULL * 1024ULL * 1024ULL;
+constexpr double	DEFAULT_LOG_SEGMENT_MAX_SECONDS = 60.0 * 60.0;
+constexpr char		COMPRESSED_LOG_SEGMENT_EXTENSION[] = ".lzb";
+
+//Every record goes through this ring, text is cut and binary records are formatted on the caller to fit in it
+constexpr size_t	LOG_MESSAGE_BUFFER_BYTES = 2048U;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Filters are interned into a fixed table and their enabled state lives in a bitset indexed by the filter id.
+// Checking a filter is a hash probe and a bit test, no locks and no allocations
+//------------------------------------------------------------------------------------------------------------------------------
+constexpr uint		MAX_LOG_FILTERS = 256U;					//Power of 2, filters past this follow the enable/disable all state
+constexpr uint		MAX_LOG_FILTER_NAME_LENGTH = 64U;				//Including the null, longer names also follow the enable/disable all state
+constexpr uint16_t	INVALID_LOG_FILTER_ID = 0xFFFF;
+
+struct LogFilterSlot_T
+{
+	std::atomic<uint32_t>	hash = 0U;								//0 marks an empty slot, stored after the name is written
+	char					name[MAX_LOG_FILTER_NAME_LENGTH] = {};
 };
 
 //------------------------------------------------------------------------------------------------------------------------------
@@ -29,7 +78,7 @@ public:
 	MPSCRingBuffer		m_messages;
 	Semaphore			m_semaphore;
 
-	std::ofstream*		m_fileStream = nullptr;
+	BufferedFileWriter	m_fileWriter;
 
 	bool				m_isRunning = true;
 
@@ -40,11 +89,32 @@ public:
 	void				Logf(char const* filter, char const* format, ...);
 	void				LogCallstackf(char const* filter, char const* format, ...);
 
+	// Producer side is a few memcpys: the format pointer and the raw arguments are stored and formatted later.
+	// The format string must outlive the log system (use a string literal) since only its address is kept
+	template <typename ...ARGS>
+	void				LogBinaryf(char const* filter, char const* format, ARGS const&... args);
+
+	// Deferred formatting writes binary records straight to the file and skips formatting on the log thread.
+	// Must be set before LogSystemInit, the resulting file is turned into text with DecodeBinaryLogFile.
+	// Compressed segments decode too, a compressed text segment is just inflated back to its text
+	void				SetDeferredFormatting(bool deferFormatting)		{ m_deferFormatting = deferFormatting; }
+	bool				IsFormattingDeferred() const					{ return m_deferFormatting; }
+	static bool			DecodeBinaryLogFile(const std::string& binaryFile, const std::string& textFile);
+
+	// The log is split into segments once the current one passes maxSegmentBytes or has been open for maxSegmentSeconds.
+	// Closed segments are compressed on their own thread so the log thread keeps draining. Must be set before LogSystemInit
+	void				SetRotation(uint64_t maxSegmentBytes, double maxSegmentSeconds, bool compressRotatedSegments = true);
+
 	void				RunAllHooks(const LogObject_T* logObj);
 	void				WaitForWork()			{ m_semaphore.Acquire(); }
 	void				SignalWork()			{ m_semaphore.Release(1); }
 
-	bool				CheckAgainstFilter(const char* filterToCheck);
+	bool				CheckAgainstFilter(const char* filterToCheck) const;
+
+	// Filter ids are stable for the lifetime of the log system
+	uint16_t			InternFilter(const char* filter);
+	uint16_t			FindFilterId(const char* filter) const;
+	bool				IsFilterEnabled(uint16_t filterId) const;
 
 	// Filtering
 	void				LogEnableAll();  // all messages log
@@ -72,7 +142,110 @@ public:
 
 	std::vector<LogHookCallback>	m_logHooks;
 
-	std::shared_mutex		m_filterMutex;
-	std::set<std::string>	m_filterSet;
-	bool					m_filterMode = true;	//If true, white-list(Enabled) all and ignore filters in the set, if false blacklist(Disable) all and only allow elements in the set
-};
\ No newline at end of file
+	//Filter state, readers never lock. Interning takes m_filterInternLock so two threads can't claim the same slot
+	void					SetFilterEnabled(uint16_t filterId, bool isEnabled);
+	void					SetAllFiltersEnabled(bool isEnabled);
+
+	LogFilterSlot_T			m_filterSlots[MAX_LOG_FILTERS];
+	std::atomic<uint64_t>	m_enabledFilterBits[MAX_LOG_FILTERS / 64U];		//Unused ids carry the enable/disable all state
+	std::atomic<bool>		m_filtersEnabledByDefault = true;
+	std::mutex				m_filterInternLock;
+
+	//Rotation state, only touched by the log thread after LogSystemInit
+	bool					OpenLogSegment();
+	void					RotateLogSegment();
+	bool					IsRotationDue() const;
+	std::string				GetSegmentFileName(uint segmentIndex) const;
+
+	std::string				m_baseFilename;
+	uint					m_segmentIndex = 0U;
+	double					m_segmentStartTime = 0.0;
+	uint64_t				m_maxSegmentBytes = DEFAULT_LOG_SEGMENT_MAX_BYTES;
+	double					m_maxSegmentSeconds = DEFAULT_LOG_SEGMENT_MAX_SECONDS;
+	bool					m_compressRotatedSegments = true;
+
+	//Compression state, the log thread queues closed segments and the compress thread empties the queue
+	void					CompressClosedSegments();
+
+	std::thread				m_compressThread;
+	Semaphore				m_compressSemaphore;
+	std::mutex				m_compressLock;
+	std::vector<std::string>	m_segmentsToCompress;
+	std::atomic<bool>		m_isCompressing = false;
+
+	//Deferred formatting state, only touched by the log thread
+	void					WriteDeferredHeader();
+	void					WriteDeferredEntry(const LogObject_T& log);
+	uint32_t				GetDeferredStringId(const char* string, bool internByAddress);
+
+	bool										m_deferFormatting = false;
+	std::map<const void*, uint32_t>				m_deferredFormatIds;
+	std::map<std::string, uint32_t>				m_deferredFilterIds;
+	uint32_t									m_nextDeferredStringId = 0U;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Skips the log call, including evaluating its arguments, when the filter is disabled.
+// The filter id is cached in a function static so the filter must be the same string every time this line runs
+//------------------------------------------------------------------------------------------------------------------------------
+extern LogSystem* g_LogSystem;
+
+#define LOG_IF_ENABLED( filter, ... )																			\
+	do																											\
+	{																											\
+		if (g_LogSystem != nullptr)																				\
+		{																										\
+			static const uint16_t sLogFilterId = g_LogSystem->InternFilter(filter);								\
+			if (g_LogSystem->IsFilterEnabled(sLogFilterId))														\
+			{																									\
+				g_LogSystem->Logf(filter, __VA_ARGS__);															\
+			}																									\
+		}																										\
+	} while (0)
+
+//------------------------------------------------------------------------------------------------------------------------------
+template <typename ...ARGS>
+void LogSystem::LogBinaryf(char const* filter, char const* format, ARGS const&... args)
+{
+	if (!CheckAgainstFilter(filter))
+	{
+		return;
+	}
+
+	//One extra so a record without arguments still has an array
+	size_t captureLengths[sizeof...(ARGS) + 1U] = {};
+	GetLogArgCaptureLengths(captureLengths, format, args...);
+
+	size_t argBytes = GetLogArgsEncodedSize(captureLengths, args...);
+	size_t filterLength = strlen(filter) + 1U;
+	size_t totalSize = sizeof(LogObject_T) + sizeof(LogBinaryHeader_T) + argBytes + filterLength;
+
+	if (argBytes > MAX_LOG_RECORD_ARG_BYTES || totalSize > m_messages.GetMaxWriteSize())
+	{
+		//Too big for the header or for the ring, pay for formatting now. Logf cuts the text down to what the ring holds
+		Logf(filter, format, args...);
+		return;
+	}
+
+	void* buffer = m_messages.LockWrite(totalSize);
+
+	LogObject_T* log = (LogObject_T*)buffer;
+	log->recordType = LOG_RECORD_BINARY;
+	log->hpcTime = GetCurrentTimeHPC();
+	log->line = nullptr;
+	log->callstackId = INVALID_CALLSTACK_ID;
+
+	LogBinaryHeader_T* header = (LogBinaryHeader_T*)(log + 1);
+	header->format = format;
+	header->numArgs = (uint16_t)sizeof...(ARGS);
+	header->argBytes = (uint16_t)argBytes;
+
+	byte* argData = (byte*)(header + 1);
+	EncodeLogArgs(argData, captureLengths, args...);
+
+	log->filter = (char*)(argData + argBytes);
+	memcpy(log->filter, filter, filterLength);
+
+	m_messages.UnlockWrite(buffer);
+	SignalWork();
+}
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "Engine/Allocators/InternalAllocator.hpp"
 #include "Engine/Commons/EngineCommon.hpp"
 #include "Engine/Commons/Profiler/ProfilerReport.hpp"
+#include "Engine/Commons/Profiler/ProfilerSampler.hpp"
 #include "Engine/Core/MemTracking.hpp"
 #include "Engine/Core/Time.hpp"
 #include "Engine/Renderer/ImGUISystem.hpp"
@@ -42,11 +43,15 @@ Profiler::~Profiler()
 bool Profiler::ProfilerInitialize()
 {
 	g_eventSystem->SubscribeEventCallBackFn("ProfilerReport", Command_ProfilerReport);
+	g_eventSystem->SubscribeEventCallBackFn("ProfilerSampleStart", ProfilerSampler::Command_StartSampling);
+	g_eventSystem->SubscribeEventCallBackFn("ProfilerSampleStop", ProfilerSampler::Command_StopSampling);
+	g_eventSystem->SubscribeEventCallBackFn("ProfilerSampleWrite", ProfilerSampler::Command_WriteSamples);
 
 	Profiler* profiler = CreateInstance();
 	profiler->ProfilerAllocation(profiler->m_AllowedSize);
 
 	gProfileReporter->CreateInstance();
+	ProfilerSampler::CreateInstance();
 
 	return true;
 }
@@ -54,6 +59,7 @@ bool Profiler::ProfilerInitialize()
 //------------------------------------------------------------------------------------------------------------------------------
 void Profiler::ProfilerShutdown()
 {
+	ProfilerSampler::DestroyInstance();
 	ProfilerFree();
 	return DestroyInstance();
 }
@@ -306,7 +312,7 @@ void Profiler::MakeAllocationsWindow()
 	if (m_isPaused)
 	{
 		ProfilerReport* reporter = gProfileReporter->GetInstance();
-		reporter->DrawTreeViewAsImGUIWidget(m_reportFrameNum);
+		reporter->DrawAllocationViewAsImGUIWidget((uint)m_reportFrameNum);
 	}
 
 	/*
@@ -525,11 +531,12 @@ ProfilerSample_T* Profiler::AllocateNode()
 
 	if (node != nullptr)
 	{
-		node->m_allocationSizeInBytes = tTotalBytesAllocated;
-		node->m_allocCount = tTotalAllocations;
+		//Filled in by ProfilerRecordAllocation/ProfilerRecordFree while the scope is open
+		node->m_allocationSizeInBytes = 0;
+		node->m_allocCount = 0;
 		
-		node->m_freeCount = tTotalFrees;
-		node->m_freeSizeInBytes = tTotalBytesFreed;
+		node->m_freeCount = 0;
+		node->m_freeSizeInBytes = 0;
 
 		node->m_refCount = 1;
 	}
@@ -542,12 +549,6 @@ ProfilerSample_T* Profiler::AllocateNode()
 //------------------------------------------------------------------------------------------------------------------------------
 void Profiler::FreeNode(ProfilerSample_T* node)
 {
-	node->m_allocationSizeInBytes = tTotalBytesAllocated - node->m_allocationSizeInBytes;
-	node->m_allocCount = tTotalAllocations - node->m_allocCount;
-
-	node->m_freeCount = tTotalFrees - node->m_freeCount;
-	node->m_freeSizeInBytes = tTotalBytesFreed - node->m_freeSizeInBytes;
-
 	BlockAllocator* instance = gBlockAllocator->GetInstance();
 	instance->Free(node);
 }
@@ -561,6 +562,31 @@ STATIC bool Profiler::Command_ProfilerReport(EventArgs& args)
 	return true;
 }
 
+//------------------------------------------------------------------------------------------------------------------------------
+void ProfilerRecordAllocation(size_t byteSize)
+{
+	//Only this thread touches its open nodes, they are published to m_History after the root is popped
+	ProfilerSample_T* node = tActiveNode;
+	while (node != nullptr)
+	{
+		node->m_allocCount++;
+		node->m_allocationSizeInBytes += byteSize;
+		node = node->m_parent;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void ProfilerRecordFree(size_t byteSize)
+{
+	ProfilerSample_T* node = tActiveNode;
+	while (node != nullptr)
+	{
+		node->m_freeCount++;
+		node->m_freeSizeInBytes += byteSize;
+		node = node->m_parent;
+	}
+}
+
 #else
 bool			Profiler::ProfilerInitialize() { return false; };
 void			Profiler::ProfilerShutdown() {};
@@ -608,4 +634,7 @@ void						ProfilerReleaseTree(ProfilerSample_T* node)
 {
 	UNUSED(node);
 }
+
+void			ProfilerRecordAllocation(size_t byteSize) { UNUSED(byteSize); }
+void			ProfilerRecordFree(size_t byteSize) { UNUSED(byteSize); }
 #endif
\ No newline at end of file
@@ -93,6 +93,12 @@ private:
 	float									m_reportFrameNum = 0;
 };
 
+//------------------------------------------------------------------------------------------------------------------------------
+// Called by the mem tracker on every tracked allocation/free. Charges the bytes to every scope that is open
+// on the calling thread so each node reports what was allocated beneath it (inclusive of its children)
+void ProfilerRecordAllocation(size_t byteSize);
+void ProfilerRecordFree(size_t byteSize);
+
 // EXTRA -> more important to the job system for tracking timing across threads
 // manually construct a tree without relying on thread_local storage; 
 // profile_handle_t ProfilePush( char const* tag, profile_handle_t parent = nullptr ); // attaches, starts, and returns a new node to parent
@@ -2,11 +2,15 @@
 //------------------------------------------------------------------------------------------------------------------------------
 #include "Engine/Commons/EngineCommon.hpp"
 #include "Engine/Commons/Profiler/Profiler.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/MemTracking.hpp"
 #include "Engine/Core/NamedProperties.hpp"
 #include "Engine/Core/Time.hpp"
 #include "Engine/Core/WindowContext.hpp"
 #include "Engine/Renderer/ImGUISystem.hpp"
 #include "ThirdParty/imGUI/imgui_internal.h"
+#include <algorithm>
+#include <map>
 #include <string.h>
 
 ProfilerReport* gProfileReporter = nullptr;
@@ -47,6 +51,7 @@ ProfilerReportNode* ProfilerReport::GetRoot()
 void ProfilerReport::InitializeReporter()
 {
 	g_eventSystem->SubscribeEventCallBackFn("ProfilerReportFrame", Command_ProfilerReportFrame);
+	g_eventSystem->SubscribeEventCallBackFn("ProfilerAllocReport", Command_ProfilerAllocationReport);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
@@ -117,6 +122,92 @@ void ProfilerReport::DrawFlatViewAsImGUIWidget(uint history)
 	TODO("Flat View");
 }
 
+//------------------------------------------------------------------------------------------------------------------------------
+void ProfilerReport::DrawAllocationViewAsImGUIWidget(uint history)
+{
+	std::vector<ProfilerAllocationEntry_T> entries;
+	GetAllocationReport(entries, history);
+
+	ImGui::Begin("Allocation View Window");
+	ImGui::SetWindowPos(ImVec2(50, 350));
+	ImGui::SetWindowSize(ImVec2(1650, 450));
+
+	ImGui::Columns(5, "Allocation View", true);
+	ImGui::Text("Label");					ImGui::NextColumn();
+	ImGui::Text("Calls");					ImGui::NextColumn();
+	ImGui::Text("Self Allocations");		ImGui::NextColumn();
+	ImGui::Text("Self Bytes");				ImGui::NextColumn();
+	ImGui::Text("Frees");					ImGui::NextColumn();
+	ImGui::Separator();
+
+	for (size_t entryIndex = 0; entryIndex < entries.size(); ++entryIndex)
+	{
+		const ProfilerAllocationEntry_T& entry = entries[entryIndex];
+
+		ImGui::Text("%s", entry.m_label);									ImGui::NextColumn();
+		ImGui::Text("%u", entry.m_numCalls);								ImGui::NextColumn();
+		ImGui::Text("%llu", (unsigned long long)entry.m_selfAllocationCount);	ImGui::NextColumn();
+		ImGui::Text("%llu", (unsigned long long)entry.m_selfAllocationSize);	ImGui::NextColumn();
+		ImGui::Text("%llu", (unsigned long long)entry.m_freeCount);			ImGui::NextColumn();
+	}
+
+	ImGui::Columns(1);
+	ImGui::End();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static void AccumulateAllocationEntries(const ProfilerReportNode& node, std::map<std::string, ProfilerAllocationEntry_T>& entries)
+{
+	ProfilerAllocationEntry_T& entry = entries[node.m_label];
+	strcpy_s(entry.m_label, node.m_label);
+
+	entry.m_numCalls += node.m_numCalls;
+	entry.m_selfAllocationCount += node.m_selfAllocationCount;
+	entry.m_selfAllocationSize += node.m_selfAllocationSize;
+	entry.m_freeCount += node.m_freeCount;
+	entry.m_freedSize += node.m_freedSize;
+
+	for (size_t childIndex = 0; childIndex < node.m_children.size(); ++childIndex)
+	{
+		AccumulateAllocationEntries(node.m_children[childIndex], entries);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static bool AllocationEntrySortFunction(ProfilerAllocationEntry_T const& a, ProfilerAllocationEntry_T const& b)
+{
+	return (a.m_selfAllocationSize > b.m_selfAllocationSize);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool ProfilerReport::GetAllocationReport(std::vector<ProfilerAllocationEntry_T>& outEntries, uint history /*= 1*/)
+{
+	outEntries.clear();
+
+	Profiler* profiler = gProfiler->GetInstance();
+	ProfilerSample_T* sample = profiler->ProfilerAcquirePreviousTreeForCallingThread(history);
+	if (sample == nullptr)
+	{
+		return false;
+	}
+
+	GenerateTreeFromFrame(sample);
+
+	std::map<std::string, ProfilerAllocationEntry_T> entries;
+	AccumulateAllocationEntries(*m_root, entries);
+
+	outEntries.reserve(entries.size());
+	std::map<std::string, ProfilerAllocationEntry_T>::iterator itr = entries.begin();
+	while (itr != entries.end())
+	{
+		outEntries.push_back(itr->second);
+		itr++;
+	}
+
+	std::sort(outEntries.begin(), outEntries.end(), AllocationEntrySortFunction);
+	return true;
+}
+
 //------------------------------------------------------------------------------------------------------------------------------
 STATIC bool ProfilerReport::Command_ProfilerReportFrame(EventArgs& args)
 {
@@ -128,6 +219,31 @@ STATIC bool ProfilerReport::Command_ProfilerReportFrame(EventArgs& args)
 	return true;
 }
 
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool ProfilerReport::Command_ProfilerAllocationReport(EventArgs& args)
+{
+	uint history = args.GetValue("History", 1);
+	int numEntries = args.GetValue("Count", 10);
+
+	std::vector<ProfilerAllocationEntry_T> entries;
+	if (!gProfileReporter->GetAllocationReport(entries, history))
+	{
+		g_devConsole->PrintString(Rgba::RED, "No profiled frame exists for that history");
+		return false;
+	}
+
+	g_devConsole->PrintString(Rgba::YELLOW, "Scopes by allocated bytes (self)");
+	for (int entryIndex = 0; entryIndex < numEntries && entryIndex < (int)entries.size(); ++entryIndex)
+	{
+		const ProfilerAllocationEntry_T& entry = entries[entryIndex];
+
+		std::string sizeString = GetSizeString(entry.m_selfAllocationSize);
+		g_devConsole->PrintString(Rgba::WHITE, Stringf("%s | calls: %u | allocations: %llu | %s", entry.m_label, entry.m_numCalls, (unsigned long long)entry.m_selfAllocationCount, sizeString.c_str()));
+	}
+
+	return true;
+}
+
 //------------------------------------------------------------------------------------------------------------------------------
 ProfilerReportNode::ProfilerReportNode(ProfilerSample_T* node, ProfilerReportNode* parent)
 {
@@ -154,12 +270,9 @@ ProfilerReportNode::ProfilerReportNode(ProfilerSample_T* node, ProfilerReportNod
 	{
 		GetChildrenFromSampleRoot(node->m_lastChild, this);
 	}
-	else if (node->m_prevSibling != nullptr)
-	{
-		GetChildrenFromSampleRoot(node->m_prevSibling, this->m_parent);
-	}
 
 	GetSelfTime();
+	GetSelfAllocations();
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
@@ -171,9 +284,18 @@ ProfilerReportNode::~ProfilerReportNode()
 //------------------------------------------------------------------------------------------------------------------------------
 void ProfilerReportNode::GetChildrenFromSampleRoot(ProfilerSample_T* root, ProfilerReportNode* parent)
 {
-	if (root != nullptr)
+	//Samples link their children from the last one backwards through m_prevSibling
+	size_t numChildren = 0;
+	for (ProfilerSample_T* child = root; child != nullptr; child = child->m_prevSibling)
 	{
-		parent->m_children.emplace_back(ProfilerReportNode(root, parent));
+		numChildren++;
+	}
+
+	//Reserve first so every child is built in place and the m_parent pointers below it stay valid
+	parent->m_children.reserve(parent->m_children.size() + numChildren);
+	for (ProfilerSample_T* child = root; child != nullptr; child = child->m_prevSibling)
+	{
+		parent->m_children.emplace_back(child, parent);
 	}
 }
 
@@ -239,3 +361,16 @@ void ProfilerReportNode::GetSelfTime()
 
 	m_selfTime -= childrenTime;
 }
+
+//------------------------------------------------------------------------------------------------------------------------------
+void ProfilerReportNode::GetSelfAllocations()
+{
+	m_selfAllocationCount = m_allocationCount;
+	m_selfAllocationSize = m_allocationSize;
+
+	for (size_t childIndex = 0; childIndex < m_children.size(); ++childIndex)
+	{
+		m_selfAllocationCount -= m_children[childIndex].m_allocationCount;
+		m_selfAllocationSize -= m_children[childIndex].m_allocationSize;
+	}
+}
@@ -19,11 +19,16 @@ public:
 	void					SortBySelfTime();
 
 	void					GetSelfTime();
+	void					GetSelfAllocations();
 
 	ProfilerReportNode*		m_parent = nullptr;
 
+	//Allocations include everything allocated by the children, self values exclude them
 	uint64_t				m_allocationCount = 0U;
 	size_t					m_allocationSize = 0;
+
+	uint64_t				m_selfAllocationCount = 0U;
+	size_t					m_selfAllocationSize = 0U;
 	
 	uint64_t				m_freeCount = 0U;
 	size_t					m_freedSize = 0U;
@@ -50,6 +55,21 @@ public:
 	std::vector<ProfilerReportNode>		m_children;
 };
 
+//------------------------------------------------------------------------------------------------------------------------------
+// One row of the allocation view, every node with the same label in a frame is merged into one entry
+//------------------------------------------------------------------------------------------------------------------------------
+struct ProfilerAllocationEntry_T
+{
+	char					m_label[64];
+	uint					m_numCalls = 0U;
+
+	uint64_t				m_selfAllocationCount = 0U;
+	size_t					m_selfAllocationSize = 0U;
+
+	uint64_t				m_freeCount = 0U;
+	size_t					m_freedSize = 0U;
+};
+
 //------------------------------------------------------------------------------------------------------------------------------
 class ProfilerReport
 {
@@ -66,6 +86,10 @@ public:
 
 	void					DrawTreeViewAsImGUIWidget(uint history);
 	void					DrawFlatViewAsImGUIWidget(uint history);
+	void					DrawAllocationViewAsImGUIWidget(uint history);
+
+	// Flat list of scopes for a frame, largest self allocation volume first
+	bool					GetAllocationReport(std::vector<ProfilerAllocationEntry_T>& outEntries, uint history = 1);
 
 private:
 	void					InitializeReporter();
@@ -74,6 +98,7 @@ private:
 	void					GenerateFlatFromFrame(ProfilerSample_T* root);
 
 	static bool				Command_ProfilerReportFrame(EventArgs& args);
+	static bool				Command_ProfilerAllocationReport(EventArgs& args);
 
 	ProfilerReportNode*		m_root = nullptr;
 };
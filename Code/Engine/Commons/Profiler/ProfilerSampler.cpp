@@ -0,0 +1,377 @@
+#include "Engine/Commons/Profiler/ProfilerSampler.hpp"
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Commons/EngineCommon.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/NamedProperties.hpp"
+#include "Engine/Core/Time.hpp"
+#include <chrono>
+#include <fstream>
+
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Game/EngineBuildPreferences.hpp"
+
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+
+ProfilerSampler* gProfilerSampler = nullptr;
+
+#if defined(PROFILING_ENABLED)
+//------------------------------------------------------------------------------------------------------------------------------
+ProfilerSampler::ProfilerSampler()
+{
+
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+ProfilerSampler::~ProfilerSampler()
+{
+	StopSampling();
+
+	std::scoped_lock<std::mutex> threadsLock(m_sampledThreadsLock);
+	for (size_t threadIndex = 0; threadIndex < m_sampledThreads.size(); ++threadIndex)
+	{
+		::CloseHandle((HANDLE)m_sampledThreads[threadIndex].m_threadHandle);
+	}
+	m_sampledThreads.clear();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool ProfilerSampler::StartSampling(uint samplesPerSecond /*= DEFAULT_PROFILER_SAMPLES_PER_SECOND*/)
+{
+	if (m_isRunning)
+	{
+		return false;
+	}
+
+	SetSampleRate(samplesPerSecond);
+
+	m_isRunning = true;
+	m_thread = std::thread(SamplerThread);
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void ProfilerSampler::StopSampling()
+{
+	if (!m_isRunning)
+	{
+		return;
+	}
+
+	m_isRunning = false;
+	m_thread.join();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void ProfilerSampler::SetSampleRate(uint samplesPerSecond)
+{
+	if (samplesPerSecond == 0U)
+	{
+		samplesPerSecond = 1U;
+	}
+	else if (samplesPerSecond > MAX_PROFILER_SAMPLES_PER_SECOND)
+	{
+		samplesPerSecond = MAX_PROFILER_SAMPLES_PER_SECOND;
+	}
+
+	m_samplesPerSecond = samplesPerSecond;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void ProfilerSampler::RegisterCallingThread()
+{
+	std::thread::id callingThread = std::this_thread::get_id();
+
+	std::scoped_lock<std::mutex> threadsLock(m_sampledThreadsLock);
+	for (size_t threadIndex = 0; threadIndex < m_sampledThreads.size(); ++threadIndex)
+	{
+		if (m_sampledThreads[threadIndex].m_threadID == callingThread)
+		{
+			return;
+		}
+	}
+
+	//GetCurrentThread is a pseudo handle so we need a real one the sampler thread can use
+	HANDLE threadHandle = ::OpenThread(THREAD_SUSPEND_RESUME | THREAD_GET_CONTEXT | THREAD_QUERY_INFORMATION, FALSE, ::GetCurrentThreadId());
+	if (threadHandle == nullptr)
+	{
+		ERROR_RECOVERABLE("Could not open a handle to the calling thread for the sampling profiler");
+		return;
+	}
+
+	SampledThread_T sampledThread;
+	sampledThread.m_threadHandle = threadHandle;
+	sampledThread.m_threadID = callingThread;
+	m_sampledThreads.push_back(sampledThread);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void ProfilerSampler::UnregisterCallingThread()
+{
+	std::thread::id callingThread = std::this_thread::get_id();
+
+	std::scoped_lock<std::mutex> threadsLock(m_sampledThreadsLock);
+	for (size_t threadIndex = 0; threadIndex < m_sampledThreads.size(); ++threadIndex)
+	{
+		if (m_sampledThreads[threadIndex].m_threadID == callingThread)
+		{
+			::CloseHandle((HANDLE)m_sampledThreads[threadIndex].m_threadHandle);
+			m_sampledThreads.erase(m_sampledThreads.begin() + threadIndex);
+			return;
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void ProfilerSampler::ClearSamples()
+{
+	std::scoped_lock<std::mutex> samplesLock(m_samplesLock);
+	m_samples.clear();
+	m_totalSampleCount = 0U;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint ProfilerSampler::GetUniqueStackCount()
+{
+	std::scoped_lock<std::mutex> samplesLock(m_samplesLock);
+	return (uint)m_samples.size();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool ProfilerSampler::WriteFoldedStacks(const std::string& fileName)
+{
+	std::vector<SampledCallstack_T> samples;
+	{
+		std::scoped_lock<std::mutex> samplesLock(m_samplesLock);
+		samples.reserve(m_samples.size());
+
+		std::map<unsigned long, SampledCallstack_T>::iterator itr = m_samples.begin();
+		while (itr != m_samples.end())
+		{
+			samples.push_back(itr->second);
+			itr++;
+		}
+	}
+
+	std::ofstream* fileStream = CreateTextFileWriteBuffer(fileName);
+	if (fileStream == nullptr || !fileStream->is_open())
+	{
+		delete fileStream;
+		return false;
+	}
+
+	//The same few hundred functions show up in every stack, resolve each address once
+	std::map<void*, std::string> symbolNames;
+
+	for (size_t sampleIndex = 0; sampleIndex < samples.size(); ++sampleIndex)
+	{
+		const Callstack& callstack = samples[sampleIndex].m_callstack;
+
+		//Folded stacks go from the root down, the trace is stored leaf first
+		std::string foldedLine;
+		for (int frameIndex = (int)callstack.m_depth - 1; frameIndex >= 0; --frameIndex)
+		{
+			void* address = callstack.m_trace[frameIndex];
+
+			std::map<void*, std::string>::iterator symbol = symbolNames.find(address);
+			if (symbol == symbolNames.end())
+			{
+				symbol = symbolNames.insert(std::make_pair(address, GetCallstackSymbolName(address))).first;
+			}
+
+			foldedLine += symbol->second;
+			if (frameIndex > 0)
+			{
+				foldedLine += ";";
+			}
+		}
+
+		foldedLine += Stringf(" %u\n", samples[sampleIndex].m_hitCount);
+		fileStream->write(foldedLine.c_str(), foldedLine.length());
+	}
+
+	fileStream->close();
+	delete fileStream;
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC void ProfilerSampler::SamplerThread()
+{
+	while (gProfilerSampler != nullptr && gProfilerSampler->IsSampling())
+	{
+		gProfilerSampler->SampleRegisteredThreads();
+
+		//The OS scheduler quantum limits how fine this can get, rates above ~1kHz need timeBeginPeriod(1) by the game
+		uint sleepMicroSeconds = 1000000U / gProfilerSampler->GetSampleRate();
+		std::this_thread::sleep_for(std::chrono::microseconds(sleepMicroSeconds));
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void ProfilerSampler::SampleRegisteredThreads()
+{
+	std::scoped_lock<std::mutex> threadsLock(m_sampledThreadsLock);
+
+	for (size_t threadIndex = 0; threadIndex < m_sampledThreads.size(); ++threadIndex)
+	{
+		HANDLE threadHandle = (HANDLE)m_sampledThreads[threadIndex].m_threadHandle;
+
+		if (::SuspendThread(threadHandle) == (DWORD)-1)
+		{
+			continue;
+		}
+
+		//Nothing between suspend and resume may allocate or lock, the target could be holding that lock
+		Callstack callstack = CallstackGetForThread(threadHandle);
+
+		::ResumeThread(threadHandle);
+
+		if (callstack.m_depth > 0)
+		{
+			RecordSample(callstack);
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void ProfilerSampler::RecordSample(const Callstack& callstack)
+{
+	std::scoped_lock<std::mutex> samplesLock(m_samplesLock);
+
+	//Walk forward on the rare hash collision so distinct stacks never get merged
+	unsigned long key = callstack.m_hash;
+	std::map<unsigned long, SampledCallstack_T>::iterator itr = m_samples.find(key);
+	while (itr != m_samples.end())
+	{
+		const Callstack& existing = itr->second.m_callstack;
+		if (existing.m_depth == callstack.m_depth && memcmp(existing.m_trace, callstack.m_trace, sizeof(void*) * callstack.m_depth) == 0)
+		{
+			break;
+		}
+
+		key++;
+		itr = m_samples.find(key);
+	}
+
+	if (itr == m_samples.end())
+	{
+		SampledCallstack_T newSample;
+		newSample.m_callstack = callstack;
+		itr = m_samples.insert(std::make_pair(key, newSample)).first;
+	}
+
+	itr->second.m_hitCount++;
+	m_totalSampleCount++;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC ProfilerSampler* ProfilerSampler::CreateInstance()
+{
+	if (gProfilerSampler == nullptr)
+	{
+		gProfilerSampler = new ProfilerSampler();
+	}
+
+	return gProfilerSampler;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC void ProfilerSampler::DestroyInstance()
+{
+	if (gProfilerSampler != nullptr)
+	{
+		delete gProfilerSampler;
+		gProfilerSampler = nullptr;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC ProfilerSampler* ProfilerSampler::GetInstance()
+{
+	if (gProfilerSampler == nullptr)
+	{
+		CreateInstance();
+	}
+
+	return gProfilerSampler;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool ProfilerSampler::Command_StartSampling(EventArgs& args)
+{
+	int samplesPerSecond = (int)DEFAULT_PROFILER_SAMPLES_PER_SECOND;
+	samplesPerSecond = args.GetValue("Rate", samplesPerSecond);
+
+	ProfilerSampler* sampler = GetInstance();
+
+	//The console runs on the main thread, sample it by default
+	sampler->RegisterCallingThread();
+
+	if (sampler->StartSampling((uint)samplesPerSecond))
+	{
+		g_devConsole->PrintString(Rgba::GREEN, Stringf("Sampling profiler started at %u samples per second", sampler->GetSampleRate()));
+	}
+	else
+	{
+		g_devConsole->PrintString(Rgba::YELLOW, "Sampling profiler is already running");
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool ProfilerSampler::Command_StopSampling(EventArgs& args)
+{
+	UNUSED(args);
+
+	ProfilerSampler* sampler = GetInstance();
+	sampler->StopSampling();
+
+	g_devConsole->PrintString(Rgba::GREEN, Stringf("Sampling profiler stopped. %u samples in %u unique stacks", sampler->GetTotalSampleCount(), sampler->GetUniqueStackCount()));
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool ProfilerSampler::Command_WriteSamples(EventArgs& args)
+{
+	std::string fileName = LOG_PATH + std::string("ProfilerSamples") + GetDateTime() + ".folded";
+	fileName = args.GetValue("File", fileName);
+
+	ProfilerSampler* sampler = GetInstance();
+	if (sampler->WriteFoldedStacks(fileName))
+	{
+		g_devConsole->PrintString(Rgba::GREEN, Stringf("Wrote %u unique stacks to %s", sampler->GetUniqueStackCount(), fileName.c_str()));
+	}
+	else
+	{
+		g_devConsole->PrintString(Rgba::RED, Stringf("Could not write samples to %s", fileName.c_str()));
+	}
+
+	return true;
+}
+
+#else
+ProfilerSampler::ProfilerSampler() {}
+ProfilerSampler::~ProfilerSampler() {}
+
+bool			ProfilerSampler::StartSampling(uint samplesPerSecond) { UNUSED(samplesPerSecond); return false; }
+void			ProfilerSampler::StopSampling() {}
+void			ProfilerSampler::SetSampleRate(uint samplesPerSecond) { UNUSED(samplesPerSecond); }
+
+void			ProfilerSampler::RegisterCallingThread() {}
+void			ProfilerSampler::UnregisterCallingThread() {}
+
+void			ProfilerSampler::ClearSamples() {}
+uint			ProfilerSampler::GetUniqueStackCount() { return 0U; }
+bool			ProfilerSampler::WriteFoldedStacks(const std::string& fileName) { UNUSED(fileName); return false; }
+
+ProfilerSampler*	ProfilerSampler::CreateInstance() { return nullptr; }
+void				ProfilerSampler::DestroyInstance() {}
+ProfilerSampler*	ProfilerSampler::GetInstance() { return nullptr; }
+
+bool			ProfilerSampler::Command_StartSampling(EventArgs& args) { UNUSED(args); return false; }
+bool			ProfilerSampler::Command_StopSampling(EventArgs& args) { UNUSED(args); return false; }
+bool			ProfilerSampler::Command_WriteSamples(EventArgs& args) { UNUSED(args); return false; }
+#endif
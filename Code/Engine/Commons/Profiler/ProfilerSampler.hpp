@@ -0,0 +1,87 @@
+#pragma once
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Commons/Callstack.hpp"
+#include "Engine/Core/EventSystems.hpp"
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <thread>
+
+//------------------------------------------------------------------------------------------------------------------------------
+constexpr uint DEFAULT_PROFILER_SAMPLES_PER_SECOND = 1000U;
+constexpr uint MAX_PROFILER_SAMPLES_PER_SECOND = 10000U;
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct SampledThread_T
+{
+	void*					m_threadHandle = nullptr;
+	std::thread::id			m_threadID;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct SampledCallstack_T
+{
+	Callstack				m_callstack;
+	uint					m_hitCount = 0;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Statistical profiler that periodically interrupts the registered threads and records where they are.
+// Unlike ProfilerPush/Pop it needs no instrumentation, so it shows where time goes between scopes.
+// Stacks are deduplicated by their hash and written out in the folded-stack format that flame graph tools read:
+// outermost_function;...;innermost_function hitCount
+//------------------------------------------------------------------------------------------------------------------------------
+class ProfilerSampler
+{
+public:
+	ProfilerSampler();
+	~ProfilerSampler();
+
+	//------------------------------------------------------------------------------------------------------------------------------
+	//Methods
+	bool			StartSampling(uint samplesPerSecond = DEFAULT_PROFILER_SAMPLES_PER_SECOND);
+	void			StopSampling();
+	bool			IsSampling() const				{ return m_isRunning; }
+
+	void			SetSampleRate(uint samplesPerSecond);
+	uint			GetSampleRate() const			{ return m_samplesPerSecond; }
+
+	// Threads opt-in to being sampled, this registers/unregisters the calling thread
+	void			RegisterCallingThread();
+	void			UnregisterCallingThread();
+
+	void			ClearSamples();
+	uint			GetTotalSampleCount() const		{ return m_totalSampleCount; }
+	uint			GetUniqueStackCount();
+	bool			WriteFoldedStacks(const std::string& fileName);
+
+	//------------------------------------------------------------------------------------------------------------------------------
+	// Static Methods
+	static	ProfilerSampler*	CreateInstance();
+	static	void				DestroyInstance();
+	static	ProfilerSampler*	GetInstance();
+
+	//------------------------------------------------------------------------------------------------------------------------------
+	// Dev Console Events
+	static	bool				Command_StartSampling(EventArgs& args);
+	static	bool				Command_StopSampling(EventArgs& args);
+	static	bool				Command_WriteSamples(EventArgs& args);
+
+private:
+	static	void				SamplerThread();
+	void						SampleRegisteredThreads();
+	void						RecordSample(const Callstack& callstack);
+
+	std::thread								m_thread;
+	std::atomic<bool>						m_isRunning = false;
+	std::atomic<uint>						m_samplesPerSecond = DEFAULT_PROFILER_SAMPLES_PER_SECOND;
+
+	std::vector<SampledThread_T>			m_sampledThreads;
+	std::mutex								m_sampledThreadsLock;
+
+	std::map<unsigned long, SampledCallstack_T>	m_samples;
+	std::mutex								m_samplesLock;
+	std::atomic<uint>						m_totalSampleCount = 0U;
+};
+
+extern ProfilerSampler* gProfilerSampler;
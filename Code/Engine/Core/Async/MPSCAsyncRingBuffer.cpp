@@ -122,6 +122,14 @@ size_t MPSCRingBuffer::GetWritableSpace() const
 	return remaining;
 }
 
+//------------------------------------------------------------------------------------------------------------------------------
+// A write takes its size plus two meta entries, one for itself and one that becomes the next write's (or the skip marker)
+size_t MPSCRingBuffer::GetMaxWriteSize() const
+{
+	size_t metaDataSize = sizeof(RingBufferMeta_T);
+	return (m_byteSize > 2 * metaDataSize) ? m_byteSize - 2 * metaDataSize : 0U;
+}
+
 //------------------------------------------------------------------------------------------------------------------------------
 void MPSCRingBuffer::UnlockWrite(void* ptr)
 {
@@ -35,6 +35,8 @@ class MPSCRingBuffer
 		void			UnlockWrite(void* ptr);
 
 		size_t			GetWritableSpace() const;
+		//The biggest write that can ever be locked, LockWrite on anything bigger waits forever
+		size_t			GetMaxWriteSize() const;
 		
 		void*			TryLockRead(size_t* outSize);
 		void*			LockRead(size_t* outSize);
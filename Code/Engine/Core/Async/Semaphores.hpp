@@ -5,7 +5,7 @@ typedef unsigned int uint;
 
 class Semaphore
 {
-	HANDLE		m_semaphore;
+	HANDLE		m_semaphore = nullptr;		//Default constructed ones may never be created, Destroy skips them
 
 public:
 	Semaphore();
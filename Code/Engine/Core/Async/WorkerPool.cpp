@@ -0,0 +1,102 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Core/Async/WorkerPool.hpp"
+
+//------------------------------------------------------------------------------------------------------------------------------
+WorkerPool::WorkerPool(uint workerCount)
+{
+	m_workerCount = (workerCount == 0U) ? 1U : workerCount;
+
+	for (uint workerIndex = 1U; workerIndex < m_workerCount; ++workerIndex)
+	{
+		m_threads.emplace_back(&WorkerPool::WorkerThread, this, workerIndex);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+		m_isShuttingDown = true;
+	}
+	m_workReady.notify_all();
+
+	for (std::thread& thread : m_threads)
+	{
+		thread.join();
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void WorkerPool::ParallelFor(uint itemCount, const WorkerRangeCallback& callback)
+{
+	if (itemCount == 0U)
+	{
+		return;
+	}
+
+	//Not worth waking anyone for a single worker's share
+	if (m_threads.empty() || itemCount < m_workerCount)
+	{
+		callback(0U, 0U, itemCount);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+		m_callback = &callback;
+		m_itemCount = itemCount;
+		m_pendingWorkers = (uint)m_threads.size();
+		m_generation++;
+	}
+	m_workReady.notify_all();
+
+	RunSlice(0U);
+
+	std::unique_lock<std::mutex> lock(m_lock);
+	m_workDone.wait(lock, [this]() { return m_pendingWorkers == 0U; });
+	m_callback = nullptr;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void WorkerPool::RunSlice(uint workerIndex)
+{
+	uint startIndex = (uint)(((uint64_t)m_itemCount * workerIndex) / m_workerCount);
+	uint endIndex = (uint)(((uint64_t)m_itemCount * (workerIndex + 1U)) / m_workerCount);
+	if (startIndex < endIndex)
+	{
+		(*m_callback)(workerIndex, startIndex, endIndex);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void WorkerPool::WorkerThread(uint workerIndex)
+{
+	uint seenGeneration = 0U;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_lock);
+			m_workReady.wait(lock, [&]() { return m_isShuttingDown || m_generation != seenGeneration; });
+			if (m_isShuttingDown)
+			{
+				return;
+			}
+
+			seenGeneration = m_generation;
+		}
+
+		RunSlice(workerIndex);
+
+		bool isLastWorker;
+		{
+			std::lock_guard<std::mutex> lock(m_lock);
+			isLastWorker = (--m_pendingWorkers == 0U);
+		}
+
+		if (isLastWorker)
+		{
+			m_workDone.notify_one();
+		}
+	}
+}
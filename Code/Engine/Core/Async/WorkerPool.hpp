@@ -0,0 +1,49 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------------
+typedef unsigned int uint;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// (workerIndex, startIndex, endIndex), each worker gets one contiguous range of the items
+typedef std::function<void(uint, uint, uint)> WorkerRangeCallback;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Fixed set of threads that sleep between jobs. ParallelFor splits a range of items into one slice per worker and blocks
+// until every slice is done, the calling thread works the first slice itself so a pool of N workers owns N - 1 threads.
+// Only one ParallelFor can run at a time
+//------------------------------------------------------------------------------------------------------------------------------
+class WorkerPool
+{
+public:
+	explicit WorkerPool(uint workerCount);
+	~WorkerPool();
+
+	uint						GetWorkerCount() const		{ return m_workerCount; }
+
+	void						ParallelFor(uint itemCount, const WorkerRangeCallback& callback);
+
+private:
+	void						WorkerThread(uint workerIndex);
+	void						RunSlice(uint workerIndex);
+
+private:
+	uint						m_workerCount = 1U;
+	std::vector<std::thread>	m_threads;
+
+	std::mutex					m_lock;
+	std::condition_variable		m_workReady;
+	std::condition_variable		m_workDone;
+
+	//Current job, written under m_lock before the generation is bumped
+	const WorkerRangeCallback*	m_callback = nullptr;
+	uint						m_itemCount = 0U;
+	uint						m_generation = 0U;
+	uint						m_pendingWorkers = 0U;
+	bool						m_isShuttingDown = false;
+};
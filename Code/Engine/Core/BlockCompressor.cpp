@@ -0,0 +1,335 @@
+#include "Engine/Core/BlockCompressor.hpp"
+#include "Engine/Core/BufferedFileWriter.hpp"
+#include <fstream>
+#include <string.h>
+
+//------------------------------------------------------------------------------------------------------------------------------
+constexpr size_t	LZ_MIN_MATCH = 4U;
+constexpr size_t	LZ_MAX_OFFSET = 65535U;
+constexpr size_t	LZ_LAST_LITERALS = 5U;		//The last 5 bytes are always literals
+constexpr size_t	LZ_MATCH_FIND_LIMIT = 12U;	//The last match has to start at least 12 bytes before the end
+constexpr uint32_t	LZ_HASH_BITS = 12U;
+constexpr uint32_t	LZ_SKIP_TRIGGER = 6U;		//Every 64 misses in a row we start skipping further ahead
+
+//------------------------------------------------------------------------------------------------------------------------------
+static inline uint32_t ReadSequence(const byte* position)
+{
+	uint32_t sequence;
+	memcpy(&sequence, position, sizeof(uint32_t));
+	return sequence;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static inline uint32_t HashSequence(uint32_t sequence)
+{
+	return (sequence * 2654435761U) >> (32U - LZ_HASH_BITS);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static inline byte* WriteExtraLength(byte* writeHead, size_t length)
+{
+	while (length >= 255U)
+	{
+		*writeHead++ = 255U;
+		length -= 255U;
+	}
+
+	*writeHead++ = (byte)length;
+	return writeHead;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static inline byte* WriteSequence(byte* writeHead, const byte* literals, size_t literalLength, size_t offset, size_t matchLength)
+{
+	byte* token = writeHead++;
+	size_t extraMatchLength = matchLength - LZ_MIN_MATCH;
+
+	*token = (byte)(((literalLength < 15U) ? literalLength : 15U) << 4);
+	if (literalLength >= 15U)
+	{
+		writeHead = WriteExtraLength(writeHead, literalLength - 15U);
+	}
+
+	memcpy(writeHead, literals, literalLength);
+	writeHead += literalLength;
+
+	*writeHead++ = (byte)(offset & 0xFF);
+	*writeHead++ = (byte)(offset >> 8);
+
+	*token |= (byte)((extraMatchLength < 15U) ? extraMatchLength : 15U);
+	if (extraMatchLength >= 15U)
+	{
+		writeHead = WriteExtraLength(writeHead, extraMatchLength - 15U);
+	}
+
+	return writeHead;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+size_t GetCompressedBlockBound(size_t sourceSize)
+{
+	return sourceSize + (sourceSize / 255U) + 16U;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+size_t CompressBlock(const byte* source, size_t sourceSize, byte* dest, size_t destCapacity)
+{
+	if (destCapacity < GetCompressedBlockBound(sourceSize))
+	{
+		return 0;
+	}
+
+	const byte* readHead = source;
+	const byte* anchor = source;
+	const byte* sourceEnd = source + sourceSize;
+	byte* writeHead = dest;
+
+	if (sourceSize > LZ_MATCH_FIND_LIMIT)
+	{
+		const byte* matchFindLimit = sourceEnd - LZ_MATCH_FIND_LIMIT;
+		const byte* matchExtendLimit = sourceEnd - LZ_LAST_LITERALS;
+
+		//Positions are stored relative to the source, stale or colliding entries are caught by comparing the bytes
+		uint32_t hashTable[1U << LZ_HASH_BITS];
+		memset(hashTable, 0, sizeof(hashTable));
+
+		uint32_t missCount = 0U;
+		while (readHead <= matchFindLimit)
+		{
+			uint32_t sequence = ReadSequence(readHead);
+			uint32_t hash = HashSequence(sequence);
+			const byte* candidate = source + hashTable[hash];
+			hashTable[hash] = (uint32_t)(readHead - source);
+
+			if (candidate >= readHead || (size_t)(readHead - candidate) > LZ_MAX_OFFSET || ReadSequence(candidate) != sequence)
+			{
+				readHead += 1U + (missCount++ >> LZ_SKIP_TRIGGER);
+				continue;
+			}
+			missCount = 0U;
+
+			//Grow the match backwards into the pending literals, then forwards as far as it goes
+			while (readHead > anchor && candidate > source && readHead[-1] == candidate[-1])
+			{
+				readHead--;
+				candidate--;
+			}
+
+			const byte* matchEnd = readHead + LZ_MIN_MATCH;
+			const byte* candidateEnd = candidate + LZ_MIN_MATCH;
+			while (matchEnd < matchExtendLimit && *matchEnd == *candidateEnd)
+			{
+				matchEnd++;
+				candidateEnd++;
+			}
+
+			writeHead = WriteSequence(writeHead, anchor, (size_t)(readHead - anchor), (size_t)(readHead - candidate), (size_t)(matchEnd - readHead));
+
+			readHead = matchEnd;
+			anchor = readHead;
+
+			//Seed the table inside the match so the next sequence can find it
+			const byte* seedPosition = readHead - 2;
+			hashTable[HashSequence(ReadSequence(seedPosition))] = (uint32_t)(seedPosition - source);
+		}
+	}
+
+	//Whatever is left goes out as the final literal run
+	size_t literalLength = (size_t)(sourceEnd - anchor);
+	*writeHead++ = (byte)(((literalLength < 15U) ? literalLength : 15U) << 4);
+	if (literalLength >= 15U)
+	{
+		writeHead = WriteExtraLength(writeHead, literalLength - 15U);
+	}
+
+	memcpy(writeHead, anchor, literalLength);
+	writeHead += literalLength;
+
+	return (size_t)(writeHead - dest);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static inline bool ReadExtraLength(const byte*& readHead, const byte* readEnd, size_t& length)
+{
+	byte value;
+	do
+	{
+		if (readHead >= readEnd)
+		{
+			return false;
+		}
+
+		value = *readHead++;
+		length += value;
+	} while (value == 255U);
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+size_t DecompressBlock(const byte* source, size_t sourceSize, byte* dest, size_t destCapacity)
+{
+	const byte* readHead = source;
+	const byte* readEnd = source + sourceSize;
+	byte* writeHead = dest;
+	byte* writeEnd = dest + destCapacity;
+
+	while (readHead < readEnd)
+	{
+		byte token = *readHead++;
+
+		size_t literalLength = token >> 4;
+		if (literalLength == 15U && !ReadExtraLength(readHead, readEnd, literalLength))
+		{
+			return 0;
+		}
+
+		if (literalLength > (size_t)(readEnd - readHead) || literalLength > (size_t)(writeEnd - writeHead))
+		{
+			return 0;
+		}
+
+		memcpy(writeHead, readHead, literalLength);
+		readHead += literalLength;
+		writeHead += literalLength;
+
+		//The last sequence has no match
+		if (readHead == readEnd)
+		{
+			break;
+		}
+
+		if (readEnd - readHead < 2)
+		{
+			return 0;
+		}
+
+		size_t offset = (size_t)readHead[0] | ((size_t)readHead[1] << 8);
+		readHead += 2;
+		if (offset == 0U || offset > (size_t)(writeHead - dest))
+		{
+			return 0;
+		}
+
+		size_t matchLength = token & 0x0F;
+		if (matchLength == 15U && !ReadExtraLength(readHead, readEnd, matchLength))
+		{
+			return 0;
+		}
+		matchLength += LZ_MIN_MATCH;
+
+		if (matchLength > (size_t)(writeEnd - writeHead))
+		{
+			return 0;
+		}
+
+		//Matches may overlap what they are writing (offset < length repeats a pattern) so copy forwards a byte at a time
+		const byte* match = writeHead - offset;
+		for (size_t byteIndex = 0; byteIndex < matchLength; ++byteIndex)
+		{
+			writeHead[byteIndex] = match[byteIndex];
+		}
+		writeHead += matchLength;
+	}
+
+	return (size_t)(writeHead - dest);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool IsBlockStream(const char* data, size_t dataSize)
+{
+	return dataSize >= sizeof(BLOCK_STREAM_MAGIC) + sizeof(BLOCK_STREAM_VERSION) && memcmp(data, BLOCK_STREAM_MAGIC, sizeof(BLOCK_STREAM_MAGIC)) == 0;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool CompressFileToBlockStream(const std::string& sourceFile, const std::string& destFile)
+{
+	std::ifstream sourceStream(sourceFile, std::ios::binary);
+	if (!sourceStream.is_open())
+	{
+		return false;
+	}
+
+	BufferedFileWriter writer;
+	if (!writer.Open(destFile))
+	{
+		return false;
+	}
+
+	writer.Write(BLOCK_STREAM_MAGIC, sizeof(BLOCK_STREAM_MAGIC));
+	writer.Write(&BLOCK_STREAM_VERSION, sizeof(BLOCK_STREAM_VERSION));
+
+	std::vector<byte> rawBlock(BLOCK_STREAM_BLOCK_SIZE);
+	std::vector<byte> compressedBlock(GetCompressedBlockBound(BLOCK_STREAM_BLOCK_SIZE));
+
+	while (sourceStream)
+	{
+		sourceStream.read((char*)rawBlock.data(), BLOCK_STREAM_BLOCK_SIZE);
+		uint32_t rawSize = (uint32_t)sourceStream.gcount();
+		if (rawSize == 0U)
+		{
+			break;
+		}
+
+		size_t compressedSize = CompressBlock(rawBlock.data(), rawSize, compressedBlock.data(), compressedBlock.size());
+		if (compressedSize == 0U || compressedSize >= rawSize)
+		{
+			//Didn't shrink, a stored size equal to the raw size tells the reader to copy it
+			writer.Write(&rawSize, sizeof(rawSize));
+			writer.Write(&rawSize, sizeof(rawSize));
+			writer.Write(rawBlock.data(), rawSize);
+		}
+		else
+		{
+			uint32_t storedSize = (uint32_t)compressedSize;
+			writer.Write(&rawSize, sizeof(rawSize));
+			writer.Write(&storedSize, sizeof(storedSize));
+			writer.Write(compressedBlock.data(), compressedSize);
+		}
+	}
+
+	writer.Close();
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool DecompressBlockStream(const char* data, size_t dataSize, std::vector<char>& outData)
+{
+	if (!IsBlockStream(data, dataSize))
+	{
+		return false;
+	}
+
+	const char* readHead = data + sizeof(BLOCK_STREAM_MAGIC) + sizeof(BLOCK_STREAM_VERSION);
+	const char* readEnd = data + dataSize;
+
+	while (readEnd - readHead >= (ptrdiff_t)(2 * sizeof(uint32_t)))
+	{
+		uint32_t rawSize;
+		uint32_t storedSize;
+		memcpy(&rawSize, readHead, sizeof(uint32_t));
+		memcpy(&storedSize, readHead + sizeof(uint32_t), sizeof(uint32_t));
+		readHead += 2 * sizeof(uint32_t);
+
+		if (storedSize > (size_t)(readEnd - readHead) || storedSize > rawSize)
+		{
+			return false;
+		}
+
+		size_t writeOffset = outData.size();
+		outData.resize(writeOffset + rawSize);
+
+		if (storedSize == rawSize)
+		{
+			memcpy(outData.data() + writeOffset, readHead, rawSize);
+		}
+		else if (DecompressBlock((const byte*)readHead, storedSize, (byte*)outData.data() + writeOffset, rawSize) != rawSize)
+		{
+			return false;
+		}
+
+		readHead += storedSize;
+	}
+
+	return readHead == readEnd;
+}
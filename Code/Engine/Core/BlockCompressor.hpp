@@ -0,0 +1,33 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------------
+typedef uint8_t byte;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// LZ4 style block compression, no dependencies. Greedy hash matching with a 64KB window, fast enough to run on the log thread.
+// A block is a list of sequences: token (literal length << 4 | match length - 4), extra length bytes, literals,
+// 2 byte little endian offset, extra match length bytes. The last sequence is literals only
+//------------------------------------------------------------------------------------------------------------------------------
+size_t				GetCompressedBlockBound(size_t sourceSize);
+
+// Returns the compressed size or 0 if destCapacity is smaller than GetCompressedBlockBound(sourceSize)
+size_t				CompressBlock(const byte* source, size_t sourceSize, byte* dest, size_t destCapacity);
+
+// Returns the decompressed size or 0 if the block is malformed or doesn't fit in destCapacity
+size_t				DecompressBlock(const byte* source, size_t sourceSize, byte* dest, size_t destCapacity);
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Block streams split a file into independently compressed blocks:
+// magic, version, then per block: raw size, stored size, data. Blocks that don't shrink are stored as is
+//------------------------------------------------------------------------------------------------------------------------------
+constexpr char		BLOCK_STREAM_MAGIC[4] = { 'L', 'Z', 'B', 'K' };
+constexpr uint32_t	BLOCK_STREAM_VERSION = 1U;
+constexpr size_t	BLOCK_STREAM_BLOCK_SIZE = 256U * 1024U;
+
+bool				IsBlockStream(const char* data, size_t dataSize);
+bool				CompressFileToBlockStream(const std::string& sourceFile, const std::string& destFile);
+bool				DecompressBlockStream(const char* data, size_t dataSize, std::vector<char>& outData);
@@ -0,0 +1,94 @@
+#include "Engine/Core/BufferedFileWriter.hpp"
+#include <malloc.h>
+#include <string.h>
+
+//------------------------------------------------------------------------------------------------------------------------------
+BufferedFileWriter::BufferedFileWriter(size_t bufferSize)
+{
+	m_bufferSize = bufferSize;
+	m_buffer = (char*)_aligned_malloc(m_bufferSize, FILE_WRITE_BUFFER_ALIGNMENT);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+BufferedFileWriter::~BufferedFileWriter()
+{
+	Close();
+
+	_aligned_free(m_buffer);
+	m_buffer = nullptr;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool BufferedFileWriter::Open(const std::string& fileName, bool append)
+{
+	Close();
+
+	//Has to happen before open, we do our own buffering
+	m_fileStream.rdbuf()->pubsetbuf(nullptr, 0);
+	m_fileStream.open(fileName, std::ios::binary | (append ? std::ios::app : std::ios::trunc));
+
+	m_bufferUsed = 0U;
+	m_bytesWritten = 0U;
+	return m_fileStream.is_open();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void BufferedFileWriter::Close()
+{
+	if (!m_fileStream.is_open())
+	{
+		return;
+	}
+
+	Flush();
+	m_fileStream.close();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void BufferedFileWriter::Write(const void* data, size_t byteSize)
+{
+	m_bytesWritten += byteSize;
+
+	const char* readHead = (const char*)data;
+	while (byteSize > 0U)
+	{
+		if (m_bufferUsed == 0U && byteSize >= m_bufferSize)
+		{
+			//Bigger than the buffer, copying it first would only cost us
+			m_fileStream.write(readHead, byteSize);
+			return;
+		}
+
+		size_t copySize = m_bufferSize - m_bufferUsed;
+		copySize = (byteSize < copySize) ? byteSize : copySize;
+
+		memcpy(m_buffer + m_bufferUsed, readHead, copySize);
+		m_bufferUsed += copySize;
+		readHead += copySize;
+		byteSize -= copySize;
+
+		if (m_bufferUsed == m_bufferSize)
+		{
+			WriteBufferToFile();
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void BufferedFileWriter::Flush()
+{
+	WriteBufferToFile();
+	m_fileStream.flush();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void BufferedFileWriter::WriteBufferToFile()
+{
+	if (m_bufferUsed == 0U)
+	{
+		return;
+	}
+
+	m_fileStream.write(m_buffer, m_bufferUsed);
+	m_bufferUsed = 0U;
+}
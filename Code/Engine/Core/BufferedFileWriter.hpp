@@ -0,0 +1,39 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+#include <stdint.h>
+#include <fstream>
+#include <string>
+
+//------------------------------------------------------------------------------------------------------------------------------
+constexpr size_t DEFAULT_FILE_WRITE_BUFFER_SIZE = 1024U * 1024U;
+constexpr size_t FILE_WRITE_BUFFER_ALIGNMENT = 4096U;		//Page aligned so full buffer writes map cleanly onto the OS
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Gathers small writes into one large aligned buffer and hands the file whole buffers at a time.
+// The stream's own buffering is turned off so every write that reaches the OS is a full buffer (or a flush)
+//------------------------------------------------------------------------------------------------------------------------------
+class BufferedFileWriter
+{
+public:
+	explicit BufferedFileWriter(size_t bufferSize = DEFAULT_FILE_WRITE_BUFFER_SIZE);
+	~BufferedFileWriter();
+
+	bool			Open(const std::string& fileName, bool append = false);
+	void			Close();
+	bool			IsOpen() const				{ return m_fileStream.is_open(); }
+
+	void			Write(const void* data, size_t byteSize);
+	void			Flush();
+
+	// Includes bytes still sitting in the buffer
+	uint64_t		GetBytesWritten() const		{ return m_bytesWritten; }
+
+private:
+	void			WriteBufferToFile();
+
+	std::ofstream	m_fileStream;
+	char*			m_buffer = nullptr;
+	size_t			m_bufferSize = 0U;
+	size_t			m_bufferUsed = 0U;
+	uint64_t		m_bytesWritten = 0U;
+};
@@ -307,6 +307,10 @@ void DevConsole::Startup()
 	g_eventSystem->SubscribeEventCallBackFn( "Clear", Command_Clear );
 	g_eventSystem->SubscribeEventCallBackFn( "TrackMemory", Command_MemTracking);
 	g_eventSystem->SubscribeEventCallBackFn( "LogMemory", Command_MemLog);
+	g_eventSystem->SubscribeEventCallBackFn( "MemSnapshot", Command_MemSnapshot);
+	g_eventSystem->SubscribeEventCallBackFn( "MemDiff", Command_MemDiff);
+	g_eventSystem->SubscribeEventCallBackFn( "MemHistogram", Command_MemHistogram);
+	g_eventSystem->SubscribeEventCallBackFn( "MemHistogramExport", Command_MemHistogramExport);
 
 	g_eventSystem->SubscribeEventCallBackFn("EnableAllLogs", Command_EnableAllLogFilters);
 	g_eventSystem->SubscribeEventCallBackFn("DisableAllLogs", Command_DisableAllLogfilters);
@@ -314,6 +318,7 @@ void DevConsole::Startup()
 	g_eventSystem->SubscribeEventCallBackFn("DisableLogFilter", Command_DisableLogFilter);
 	g_eventSystem->SubscribeEventCallBackFn("FlushLog", Command_FlushLogSystem);
 	g_eventSystem->SubscribeEventCallBackFn("Logf", Command_Logf);
+	g_eventSystem->SubscribeEventCallBackFn("DecodeLog", Command_DecodeLog);
 
 	m_currentInput.clear();
 }
@@ -340,6 +345,8 @@ void DevConsole::UpdateConsole(float deltaTime)
 void DevConsole::EndFrame()
 {
 	m_frameCount++;
+
+	MemTrackEndFrame();
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
@@ -560,6 +567,22 @@ void DevConsole::GetVertsForDevConsoleMemTracker(std::vector<Vertex_PCU>& textVe
 		memTrackingBox.m_maxBounds += Vec2(0.f, lineHeight);
 		m_consoleFont->AddVertsForTextInBox2D(textVerts, memTrackingBox, lineHeight, textString, Rgba::GREEN, 1.f, Vec2::ALIGN_LEFT_BOTTOM);
 
+	#elif (MEM_TRACKING == MEM_TRACK_SAMPLED)
+		textString = "Tracking Mode: Sampled";
+		uint numAllocations = (uint)gTotalAllocations;
+		numAllocationsText = Stringf("Total Allocation count: %u", numAllocations);
+		totalBytesAllocatedText = "Estimated " + GetSizeString(gTotalBytesAllocated);
+
+		m_consoleFont->AddVertsForTextInBox2D(textVerts, memTrackingBox, lineHeight, totalBytesAllocatedText, Rgba::GREEN, 1.f, Vec2::ALIGN_LEFT_BOTTOM);
+
+		memTrackingBox.m_minBounds += Vec2(0.f, lineHeight);
+		memTrackingBox.m_maxBounds += Vec2(0.f, lineHeight);
+		m_consoleFont->AddVertsForTextInBox2D(textVerts, memTrackingBox, lineHeight, numAllocationsText, Rgba::GREEN, 1.f, Vec2::ALIGN_LEFT_BOTTOM);
+
+		memTrackingBox.m_minBounds += Vec2(0.f, lineHeight);
+		memTrackingBox.m_maxBounds += Vec2(0.f, lineHeight);
+		m_consoleFont->AddVertsForTextInBox2D(textVerts, memTrackingBox, lineHeight, textString, Rgba::GREEN, 1.f, Vec2::ALIGN_LEFT_BOTTOM);
+
 	#endif
 #else
 	textString = "Tracking is Off";
@@ -634,6 +657,132 @@ STATIC bool DevConsole::Command_MemLog(EventArgs& args)
 	return true;
 }
 
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool DevConsole::Command_MemSnapshot(EventArgs& args)
+{
+	std::string snapshotName = Stringf("Frame%d", g_devConsole->GetFrameCount());
+	snapshotName = args.GetValue("Name", snapshotName);
+
+	if (MemTrackTakeSnapshot(snapshotName))
+	{
+		g_devConsole->PrintString(Rgba::GREEN, "Took heap snapshot " + snapshotName);
+	}
+	else
+	{
+		g_devConsole->PrintString(Rgba::RED, "Heap snapshots need MEM_TRACK_VERBOSE or MEM_TRACK_SAMPLED");
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool DevConsole::Command_MemDiff(EventArgs& args)
+{
+	std::string fromName;
+	fromName = args.GetValue("From", fromName);
+
+	//Without a To we compare against the heap as it is now
+	std::string toName;
+	toName = args.GetValue("To", toName);
+
+	int maxEntries = 10;
+	maxEntries = args.GetValue("Count", maxEntries);
+
+	std::vector<MemTrackDiffEntry_T> diff;
+	if (!MemTrackDiffSnapshots(fromName, toName, diff))
+	{
+		g_devConsole->PrintString(Rgba::RED, "Could not diff heap snapshot " + fromName + " (missing snapshot or tracking mode has no snapshots)");
+		return false;
+	}
+
+	int64_t totalByteDelta = 0;
+	int64_t totalAllocationDelta = 0;
+	for (size_t entryIndex = 0; entryIndex < diff.size(); ++entryIndex)
+	{
+		totalByteDelta += diff[entryIndex].m_byteDelta;
+		totalAllocationDelta += diff[entryIndex].m_allocationDelta;
+	}
+
+	std::string toText = toName.empty() ? "now" : toName;
+	g_devConsole->PrintString(Rgba::WHITE, Stringf("Heap diff %s -> %s: %+lld bytes, %+lld allocations over %u callstacks", fromName.c_str(), toText.c_str(), totalByteDelta, totalAllocationDelta, (uint)diff.size()));
+
+	DebuggerPrintf("===== BEGIN HEAP DIFF %s -> %s =====", fromName.c_str(), toText.c_str());
+	for (size_t entryIndex = 0; entryIndex < diff.size(); ++entryIndex)
+	{
+		const MemTrackDiffEntry_T& entry = diff[entryIndex];
+		if ((int)entryIndex < maxEntries)
+		{
+			Rgba printColor = (entry.m_byteDelta > 0) ? Rgba::RED : Rgba::GREEN;
+			g_devConsole->PrintString(printColor, Stringf("%+lld B, %+lld allocs: %s", entry.m_byteDelta, entry.m_allocationDelta, MemTrackGetCallsiteName(entry.m_callstackId).c_str()));
+		}
+
+		//The full list and callstacks go to the debugger output
+		DebuggerPrintf("\n %+lld bytes, %+lld allocations \n", entry.m_byteDelta, entry.m_allocationDelta);
+		std::vector<std::string> callStackString = GetCallstackToString(entry.m_callstackId);
+		for (size_t lineIndex = 0; lineIndex < callStackString.size(); ++lineIndex)
+		{
+			DebuggerPrintf("%s \n", callStackString[lineIndex].c_str());
+		}
+	}
+	DebuggerPrintf("===== END HEAP DIFF =====");
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool DevConsole::Command_MemHistogram(EventArgs& args)
+{
+	int framesAgo = 0;
+	framesAgo = args.GetValue("FramesAgo", framesAgo);
+
+	MemFrameHistogram_T histogram;
+	if (framesAgo < 0 || !MemTrackGetFrameHistogram(histogram, (uint)framesAgo))
+	{
+		g_devConsole->PrintString(Rgba::RED, Stringf("No allocation histogram for %d frames ago", framesAgo));
+		return false;
+	}
+
+	uint totalCount = 0U;
+	uint64_t totalBytes = 0U;
+	for (uint bucketIndex = 0; bucketIndex < MEM_HISTOGRAM_BUCKET_COUNT; ++bucketIndex)
+	{
+		totalCount += histogram.m_allocationCounts[bucketIndex];
+		totalBytes += histogram.m_allocationBytes[bucketIndex];
+	}
+
+	g_devConsole->PrintString(Rgba::WHITE, Stringf("Frame %llu: %u allocations, %s", (unsigned long long)histogram.m_frameIndex, totalCount, GetSizeString((size_t)totalBytes).c_str()));
+	for (uint bucketIndex = 0; bucketIndex < MEM_HISTOGRAM_BUCKET_COUNT; ++bucketIndex)
+	{
+		if (histogram.m_allocationCounts[bucketIndex] == 0U)
+		{
+			continue;
+		}
+
+		g_devConsole->PrintString(Rgba::WHITE, Stringf("  >= %llu B: %u allocations, %llu bytes", (unsigned long long)MemHistogramGetBucketMinSize(bucketIndex),
+			histogram.m_allocationCounts[bucketIndex], (unsigned long long)histogram.m_allocationBytes[bucketIndex]));
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool DevConsole::Command_MemHistogramExport(EventArgs& args)
+{
+	std::string fileName = LOG_PATH + std::string("MemHistogram") + GetDateTime() + ".csv";
+	fileName = args.GetValue("File", fileName);
+
+	if (MemTrackExportHistograms(fileName))
+	{
+		g_devConsole->PrintString(Rgba::GREEN, "Allocation histograms written to " + fileName);
+	}
+	else
+	{
+		g_devConsole->PrintString(Rgba::RED, "Could not write " + fileName);
+	}
+
+	return true;
+}
+
 //------------------------------------------------------------------------------------------------------------------------------
 STATIC bool DevConsole::Command_EnableAllLogFilters(EventArgs& args)
 {
@@ -686,3 +835,30 @@ STATIC bool DevConsole::Command_Logf(EventArgs& args)
 	g_LogSystem->Logf(filterText.c_str(), messageText.c_str());
 	return true;
 }
+
+//------------------------------------------------------------------------------------------------------------------------------
+STATIC bool DevConsole::Command_DecodeLog(EventArgs& args)
+{
+	//Defaults to the log this session is writing
+	std::string binaryFile = g_LogSystem->m_filename;
+	binaryFile = args.GetValue("File", binaryFile);
+
+	std::string textFile = binaryFile + ".txt";
+	textFile = args.GetValue("Output", textFile);
+
+	if (binaryFile == g_LogSystem->m_filename)
+	{
+		g_LogSystem->LogFlush();
+	}
+
+	if (LogSystem::DecodeBinaryLogFile(binaryFile, textFile))
+	{
+		g_devConsole->PrintString(Rgba::GREEN, "Decoded log written to " + textFile);
+	}
+	else
+	{
+		g_devConsole->PrintString(Rgba::RED, "Could not decode " + binaryFile + " (not a deferred format log or truncated)");
+	}
+
+	return true;
+}
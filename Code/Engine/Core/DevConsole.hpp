@@ -66,6 +66,10 @@ public:
 	static bool		Command_Clear(EventArgs& args);
 	static bool		Command_MemTracking(EventArgs& args);
 	static bool		Command_MemLog(EventArgs& args);
+	static bool		Command_MemSnapshot(EventArgs& args);
+	static bool		Command_MemDiff(EventArgs& args);
+	static bool		Command_MemHistogram(EventArgs& args);
+	static bool		Command_MemHistogramExport(EventArgs& args);
 
 	static bool		Command_EnableAllLogFilters(EventArgs& args);
 	static bool		Command_DisableAllLogfilters(EventArgs& args);
@@ -73,6 +77,7 @@ public:
 	static bool		Command_DisableLogFilter(EventArgs& args);
 	static bool		Command_FlushLogSystem(EventArgs& args);
 	static bool		Command_Logf(EventArgs& args);
+	static bool		Command_DecodeLog(EventArgs& args);
 	//Uses ExecuteCommandLine for now
 	static bool		Command_Exec(EventArgs& args);
 
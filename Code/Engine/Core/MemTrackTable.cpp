@@ -0,0 +1,190 @@
+#include "Engine/Core/MemTrackTable.hpp"
+#include <immintrin.h>
+#include <malloc.h>
+
+//------------------------------------------------------------------------------------------------------------------------------
+static inline uint64_t HashAllocationAddress(const void* allocation)
+{
+	//Allocations are at least 16 byte aligned so the low bits carry nothing, mix the rest (murmur finalizer)
+	uint64_t hash = (uint64_t)allocation >> 4;
+	hash ^= hash >> 33;
+	hash *= 0xFF51AFD7ED558CCDULL;
+	hash ^= hash >> 33;
+	hash *= 0xC4CEB9FE1A85EC53ULL;
+	hash ^= hash >> 33;
+	return hash;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static inline uint GetShardIndex(uint64_t hash)
+{
+	//Top bits pick the shard, the low bits pick the slot inside it
+	return (uint)(hash >> (64U - MEM_TRACK_SHARD_BITS));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void MemTrackTable::LockShard(MemTrackShard_T& shard)
+{
+	while (shard.m_lock.exchange(true, std::memory_order_acquire))
+	{
+		//Spin on a plain load so waiting threads don't keep stealing the cache line
+		while (shard.m_lock.load(std::memory_order_relaxed))
+		{
+			_mm_pause();
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void MemTrackTable::UnlockShard(MemTrackShard_T& shard)
+{
+	shard.m_lock.store(false, std::memory_order_release);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool MemTrackTable::GrowShard(MemTrackShard_T& shard)
+{
+	uint newCapacity = (shard.m_capacity == 0U) ? MEM_TRACK_INITIAL_SHARD_CAPACITY : shard.m_capacity * 2U;
+	MemTrackInfo_T* newSlots = (MemTrackInfo_T*)::calloc(newCapacity, sizeof(MemTrackInfo_T));
+	if (newSlots == nullptr)
+	{
+		return false;
+	}
+
+	uint newMask = newCapacity - 1U;
+	for (uint slotIndex = 0; slotIndex < shard.m_capacity; ++slotIndex)
+	{
+		const MemTrackInfo_T& existing = shard.m_slots[slotIndex];
+		if (existing.m_originalPointer == nullptr)
+		{
+			continue;
+		}
+
+		uint newIndex = (uint)HashAllocationAddress(existing.m_originalPointer) & newMask;
+		while (newSlots[newIndex].m_originalPointer != nullptr)
+		{
+			newIndex = (newIndex + 1U) & newMask;
+		}
+
+		newSlots[newIndex] = existing;
+	}
+
+	::free(shard.m_slots);
+	shard.m_slots = newSlots;
+	shard.m_capacity = newCapacity;
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void MemTrackTable::Insert(const MemTrackInfo_T& info)
+{
+	uint64_t hash = HashAllocationAddress(info.m_originalPointer);
+	MemTrackShard_T& shard = m_shards[GetShardIndex(hash)];
+
+	LockShard(shard);
+
+	//Keep shards at most 3/4 full so probe runs stay short
+	if ((shard.m_count + 1U) * 4U > shard.m_capacity * 3U && !GrowShard(shard))
+	{
+		UnlockShard(shard);
+		return;
+	}
+
+	uint slotMask = shard.m_capacity - 1U;
+	uint slotIndex = (uint)hash & slotMask;
+	while (shard.m_slots[slotIndex].m_originalPointer != nullptr && shard.m_slots[slotIndex].m_originalPointer != info.m_originalPointer)
+	{
+		slotIndex = (slotIndex + 1U) & slotMask;
+	}
+
+	if (shard.m_slots[slotIndex].m_originalPointer == nullptr)
+	{
+		shard.m_count++;
+	}
+	shard.m_slots[slotIndex] = info;
+
+	UnlockShard(shard);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool MemTrackTable::Remove(void* allocation, MemTrackInfo_T& outInfo)
+{
+	uint64_t hash = HashAllocationAddress(allocation);
+	MemTrackShard_T& shard = m_shards[GetShardIndex(hash)];
+
+	LockShard(shard);
+
+	if (shard.m_count == 0U)
+	{
+		UnlockShard(shard);
+		return false;
+	}
+
+	uint slotMask = shard.m_capacity - 1U;
+	uint slotIndex = (uint)hash & slotMask;
+	while (shard.m_slots[slotIndex].m_originalPointer != allocation)
+	{
+		if (shard.m_slots[slotIndex].m_originalPointer == nullptr)
+		{
+			UnlockShard(shard);
+			return false;
+		}
+
+		slotIndex = (slotIndex + 1U) & slotMask;
+	}
+
+	outInfo = shard.m_slots[slotIndex];
+
+	//Backward shift deletion, pull later entries of the probe run into the hole so lookups never need tombstones
+	uint holeIndex = slotIndex;
+	uint scanIndex = slotIndex;
+	while (true)
+	{
+		scanIndex = (scanIndex + 1U) & slotMask;
+		void* scanPointer = shard.m_slots[scanIndex].m_originalPointer;
+		if (scanPointer == nullptr)
+		{
+			break;
+		}
+
+		//Entries whose home slot lies cyclically in (hole, scan] must stay where they are
+		uint homeIndex = (uint)HashAllocationAddress(scanPointer) & slotMask;
+		bool isHomeAfterHole = (holeIndex <= scanIndex) ? (holeIndex < homeIndex && homeIndex <= scanIndex) : (holeIndex < homeIndex || homeIndex <= scanIndex);
+		if (isHomeAfterHole)
+		{
+			continue;
+		}
+
+		shard.m_slots[holeIndex] = shard.m_slots[scanIndex];
+		holeIndex = scanIndex;
+	}
+
+	shard.m_slots[holeIndex].m_originalPointer = nullptr;
+	shard.m_count--;
+
+	UnlockShard(shard);
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void MemTrackTable::Snapshot(MemTrackInfoList& outAllocations)
+{
+	for (uint shardIndex = 0; shardIndex < MEM_TRACK_SHARD_COUNT; ++shardIndex)
+	{
+		MemTrackShard_T& shard = m_shards[shardIndex];
+
+		LockShard(shard);
+
+		//Reserving here can't recurse into the table, the list uses the untracked allocator
+		outAllocations.reserve(outAllocations.size() + shard.m_count);
+		for (uint slotIndex = 0; slotIndex < shard.m_capacity; ++slotIndex)
+		{
+			if (shard.m_slots[slotIndex].m_originalPointer != nullptr)
+			{
+				outAllocations.push_back(shard.m_slots[slotIndex]);
+			}
+		}
+
+		UnlockShard(shard);
+	}
+}
@@ -0,0 +1,46 @@
+#pragma once
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Allocators/TemplatedUntrackedAllocator.hpp"
+#include "Engine/Core/MemTracking.hpp"
+#include <atomic>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------------
+constexpr uint MEM_TRACK_SHARD_BITS = 6U;
+constexpr uint MEM_TRACK_SHARD_COUNT = 1U << MEM_TRACK_SHARD_BITS;
+constexpr uint MEM_TRACK_INITIAL_SHARD_CAPACITY = 256U;		//Power of 2, shards allocate on their first insert
+
+typedef std::vector<MemTrackInfo_T, TemplatedUntrackedAllocator<MemTrackInfo_T>> MemTrackInfoList;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Each shard sits on its own cache line so threads hitting different shards don't fight over the lock word
+//------------------------------------------------------------------------------------------------------------------------------
+struct alignas(64) MemTrackShard_T
+{
+	std::atomic<bool>	m_lock = false;
+	MemTrackInfo_T*		m_slots = nullptr;		//Keyed on m_originalPointer, nullptr marks an empty slot
+	uint				m_capacity = 0U;
+	uint				m_count = 0U;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Live allocations for MEM_TRACK_VERBOSE. Allocations are spread over shards by their address bits and each shard is a
+// linear probing table behind a spinlock, so threads only contend when they touch the same shard at the same time.
+// All storage comes from malloc, the table must never call back into tracked allocations
+//------------------------------------------------------------------------------------------------------------------------------
+class MemTrackTable
+{
+public:
+	void			Insert(const MemTrackInfo_T& info);
+	bool			Remove(void* allocation, MemTrackInfo_T& outInfo);
+
+	// Copies the live allocations one shard at a time, only the shard being copied is locked
+	void			Snapshot(MemTrackInfoList& outAllocations);
+
+private:
+	void			LockShard(MemTrackShard_T& shard);
+	void			UnlockShard(MemTrackShard_T& shard);
+	bool			GrowShard(MemTrackShard_T& shard);
+
+	MemTrackShard_T	m_shards[MEM_TRACK_SHARD_COUNT];
+};
@@ -1,5 +1,6 @@
 #include "Engine/Core/MemTracking.hpp"
 #include "Engine/Allocators/TemplatedUntrackedAllocator.hpp"
+#include "Engine/Core/MemTrackTable.hpp"
 #include "Engine/Commons/EngineCommon.hpp"
 #include "Game/EngineBuildPreferences.hpp"
 #include <malloc.h>
@@ -8,9 +9,15 @@
 #include "Engine/Math/RandomNumberGenerator.hpp"
 #include "Engine/Commons/UnitTest.hpp"
 #include "Engine/Commons/Profiler/ProfileLogScope.hpp"
+#include "Engine/Commons/Profiler/Profiler.hpp"
+#include "Engine/Core/Time.hpp"
 #include <chrono>
+#include <fstream>
+#include <intrin.h>
+#include <math.h>
 #include <thread>
 #include <map>
+#include <new>
 
 using namespace std::chrono_literals;
 
@@ -25,19 +32,145 @@ std::map<void*,		// key
 */
 
 //------------------------------------------------------------------------------------------------------------------------------
-std::mutex& GetMemTrackerLock()
+MemTrackTable& GetMemTrackTable()
 {
-	static std::mutex trackerLock;
-	return trackerLock;
+	static MemTrackTable memTrackTable;
+	return memTrackTable;
+}
+
+
+#if defined(MEM_TRACKING) && (MEM_TRACKING == MEM_TRACK_SAMPLED)
+//------------------------------------------------------------------------------------------------------------------------------
+// Sampling state. The fast path is one subtract on a thread local, everything else only runs for sampled allocations
+//------------------------------------------------------------------------------------------------------------------------------
+struct SampledSiteTotals_T
+{
+	double m_estimatedBytes = 0.0;
+	double m_estimatedAllocations = 0.0;
+};
+
+typedef std::map<CallstackId, SampledSiteTotals_T, std::less<CallstackId>, TemplatedUntrackedAllocator<std::pair<CallstackId const, SampledSiteTotals_T>>> SampledSiteMap;
+
+//Counts sampled allocations per address bucket so frees of unsampled memory (nearly all of them) skip the table
+constexpr uint MEM_TRACK_SAMPLE_FILTER_BITS = 15U;
+static std::atomic<uint> gSampledAddressFilter[1U << MEM_TRACK_SAMPLE_FILTER_BITS];
+
+static thread_local int64_t tBytesUntilNextSample = 0;
+static thread_local uint64_t tSampleRandomState = 0U;
+
+//------------------------------------------------------------------------------------------------------------------------------
+static std::mutex& GetSampledSiteLock()
+{
+	static std::mutex sampledSiteLock;
+	return sampledSiteLock;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static SampledSiteMap& GetSampledSiteMap()
+{
+	static SampledSiteMap sampledSiteMap;
+	return sampledSiteMap;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static double GetSamplingStartTime()
+{
+	static double samplingStartTime = GetCurrentTimeSeconds();
+	return samplingStartTime;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static inline uint GetSampledFilterIndex(void* allocation)
+{
+	return (uint)((((uint64_t)allocation >> 4) * 0x9E3779B97F4A7C15ULL) >> (64U - MEM_TRACK_SAMPLE_FILTER_BITS));
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-std::map<void*,	MemTrackInfo_T,	std::less<void*>, TemplatedUntrackedAllocator<std::pair<void* const, MemTrackInfo_T>>>& GetMemTrakingMap()
+static int64_t DrawSampleInterval()
 {
-	static std::map<void*, MemTrackInfo_T, std::less<void*>, TemplatedUntrackedAllocator<std::pair<void* const, MemTrackInfo_T>>> memTrackerMap;
-	return memTrackerMap;
+	//xorshift64*, seeded per thread. Exponential gaps between samples make this a Poisson process over the bytes allocated
+	tSampleRandomState ^= tSampleRandomState >> 12;
+	tSampleRandomState ^= tSampleRandomState << 25;
+	tSampleRandomState ^= tSampleRandomState >> 27;
+	uint64_t randomBits = tSampleRandomState * 2685821657736338717ULL;
+
+	double uniform = ((double)(randomBits >> 11) + 1.0) * (1.0 / 9007199254740992.0);
+	return (int64_t)(-log(uniform) * (double)MEM_TRACK_SAMPLE_BYTES) + 1;
 }
 
+//------------------------------------------------------------------------------------------------------------------------------
+static double GetSampleWeight(size_t byteSize)
+{
+	//An allocation of s bytes is sampled with probability 1 - e^(-s/T), each sample stands in for 1/p allocations
+	double sampleBytes = (byteSize == 0U) ? 1.0 : (double)byteSize;
+	return 1.0 / (1.0 - exp(-sampleBytes / (double)MEM_TRACK_SAMPLE_BYTES));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static size_t GetSampleEstimatedBytes(size_t byteSize)
+{
+	//Rounded the same way on alloc and free so the live estimate returns to where it started
+	return (size_t)((double)byteSize * GetSampleWeight(byteSize) + 0.5);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static void SampleAllocation(void* allocation, size_t byteSize)
+{
+	if (tSampleRandomState == 0U)
+	{
+		//First allocation on this thread, start its sampling process instead of sampling right away
+		tSampleRandomState = (GetCurrentTimeHPC() ^ (uint64_t)&tSampleRandomState) | 1U;
+		tBytesUntilNextSample += DrawSampleInterval();
+		if (tBytesUntilNextSample > 0)
+		{
+			return;
+		}
+	}
+
+	tBytesUntilNextSample = DrawSampleInterval();
+
+	if (allocation == nullptr)
+	{
+		return;
+	}
+
+	MemTrackInfo_T info;
+	info.m_originalPointer = allocation;
+	info.m_byteSize = byteSize;
+	info.m_callstackId = CallstackIntern(CallstackGet(2));
+
+	GetMemTrackTable().Insert(info);
+	gSampledAddressFilter[GetSampledFilterIndex(allocation)].fetch_add(1U, std::memory_order_relaxed);
+
+	gTotalBytesAllocated += GetSampleEstimatedBytes(byteSize);
+
+	double weight = GetSampleWeight(byteSize);
+	GetSamplingStartTime();
+	{
+		std::scoped_lock lock(GetSampledSiteLock());
+		SampledSiteTotals_T& totals = GetSampledSiteMap()[info.m_callstackId];
+		totals.m_estimatedBytes += (double)byteSize * weight;
+		totals.m_estimatedAllocations += weight;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static void UntrackSampledAllocation(void* allocation)
+{
+	std::atomic<uint>& filterCount = gSampledAddressFilter[GetSampledFilterIndex(allocation)];
+	if (filterCount.load(std::memory_order_relaxed) == 0U)
+	{
+		return;
+	}
+
+	MemTrackInfo_T info;
+	if (GetMemTrackTable().Remove(allocation, info))
+	{
+		filterCount.fetch_sub(1U, std::memory_order_relaxed);
+		gTotalBytesAllocated -= GetSampleEstimatedBytes(info.m_byteSize);
+	}
+}
+#endif
 
 //------------------------------------------------------------------------------------------------------------------------------
 std::string GetSizeString(size_t byte_count)
@@ -77,20 +210,81 @@ void UntrackedFree(void* ptr)
 	return ::free(ptr);
 }
 
+//------------------------------------------------------------------------------------------------------------------------------
+// Frame histograms. The frame being recorded is a set of atomic counters, completed frames go into a ring
+//------------------------------------------------------------------------------------------------------------------------------
+static std::atomic<uint> gFrameAllocationCounts[MEM_HISTOGRAM_BUCKET_COUNT];
+static std::atomic<uint64_t> gFrameAllocationBytes[MEM_HISTOGRAM_BUCKET_COUNT];
+
+static std::mutex gFrameHistogramLock;
+static MemFrameHistogram_T gFrameHistogramHistory[MEM_HISTOGRAM_HISTORY_LENGTH];
+static uint64_t gFrameHistogramsRecorded = 0U;
+
+//------------------------------------------------------------------------------------------------------------------------------
+static inline uint GetMemHistogramBucket(size_t byteSize)
+{
+	if (byteSize <= 1U)
+	{
+		return 0U;
+	}
+
+	//_BitScanReverse64 only exists on x64, Win32 scans the two halves
+	unsigned long highestBit;
+#if defined(_WIN64)
+	_BitScanReverse64(&highestBit, (uint64_t)byteSize);
+#else
+	uint64_t wideSize = (uint64_t)byteSize;
+	if (!_BitScanReverse(&highestBit, (unsigned long)(wideSize >> 32)))
+	{
+		_BitScanReverse(&highestBit, (unsigned long)wideSize);
+	}
+	else
+	{
+		highestBit += 32U;
+	}
+#endif
+	return (highestBit < MEM_HISTOGRAM_BUCKET_COUNT - 1U) ? (uint)highestBit : MEM_HISTOGRAM_BUCKET_COUNT - 1U;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static inline void RecordFrameAllocation(size_t byteSize)
+{
+	uint bucketIndex = GetMemHistogramBucket(byteSize);
+	gFrameAllocationCounts[bucketIndex].fetch_add(1U, std::memory_order_relaxed);
+	gFrameAllocationBytes[bucketIndex].fetch_add(byteSize, std::memory_order_relaxed);
+}
+
 //------------------------------------------------------------------------------------------------------------------------------
 void* TrackedAlloc(size_t byte_count)
+{
+	void* allocation = ::malloc(byte_count);
+	MemTrackRecordAlloc(allocation, byte_count);
+	return allocation;
+}
+
+//------------------------------------------------------------------------
+void TrackedFree(void* ptr)
+{
+	//Untrack before freeing, once freed another thread can get the same address back and track it
+	MemTrackRecordFree(ptr);
+	::free(ptr);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void MemTrackRecordAlloc(void* allocation, size_t byte_count)
 {
 	// One suggestion and example on how to break up this function
 	// based on build config; 
-#if !defined(MEM_TRACKING)
-	return UntrackedAlloc(byte_count);
-#else
+#if defined(MEM_TRACKING)
+	if (allocation == nullptr)
+		return;
+
 	#if (MEM_TRACKING == MEM_TRACK_ALLOC_COUNT)
 		++gTotalAllocations;
 		++tTotalAllocations;
 
-		void* allocation = ::malloc(byte_count);
-		return allocation;
+		ProfilerRecordAllocation(byte_count);
+		RecordFrameAllocation(byte_count);
 	#elif (MEM_TRACKING == MEM_TRACK_VERBOSE)
 		++gTotalAllocations;
 		gTotalBytesAllocated += byte_count;
@@ -98,29 +292,59 @@ void* TrackedAlloc(size_t byte_count)
 		++tTotalAllocations;
 		tTotalBytesAllocated += byte_count;
 
-		void* allocation = ::malloc(byte_count);
+		ProfilerRecordAllocation(byte_count);
+		RecordFrameAllocation(byte_count);
+
 		TrackAllocation(allocation, byte_count);
-		return allocation;
+	#elif (MEM_TRACKING == MEM_TRACK_SAMPLED)
+		++gTotalAllocations;
+		++tTotalAllocations;
+
+		ProfilerRecordAllocation(byte_count);
+		RecordFrameAllocation(byte_count);
+
+		//Fast path, most allocations never get past this
+		tBytesUntilNextSample -= (int64_t)byte_count;
+		if (tBytesUntilNextSample <= 0)
+		{
+			SampleAllocation(allocation, byte_count);
+		}
 	#endif
+#else
+	UNUSED(allocation);
+	UNUSED(byte_count);
 #endif
 }
 
-//------------------------------------------------------------------------
-void TrackedFree(void* ptr)
+//------------------------------------------------------------------------------------------------------------------------------
+void MemTrackRecordFree(void* allocation)
 {
-#if (MEM_TRACKING == MEM_TRACK_ALLOC_COUNT)
-	if (ptr == nullptr)
+#if defined(MEM_TRACKING)
+	if (allocation == nullptr)
 		return;
 
-	--gTotalAllocations;
-	--tTotalAllocations;
-	return ::free(ptr);
-#elif (MEM_TRACKING == MEM_TRACK_VERBOSE)
-	--gTotalAllocations;
+	#if (MEM_TRACKING == MEM_TRACK_ALLOC_COUNT)
+		--gTotalAllocations;
+		--tTotalAllocations;
+
+		//The size is not known in this mode so only the count is attributed
+		ProfilerRecordFree(0U);
+	#elif (MEM_TRACKING == MEM_TRACK_VERBOSE)
+		--gTotalAllocations;
+
+		++tTotalFrees;
 
-	++tTotalFrees;
+		UntrackAllocation(allocation);
+	#elif (MEM_TRACKING == MEM_TRACK_SAMPLED)
+		--gTotalAllocations;
+		--tTotalAllocations;
 
-	UntrackAllocation(ptr);
+		ProfilerRecordFree(0U);
+
+		UntrackSampledAllocation(allocation);
+	#endif
+#else
+	UNUSED(allocation);
 #endif
 }
 
@@ -128,33 +352,28 @@ void TrackedFree(void* ptr)
 void TrackAllocation(void* allocation, size_t byte_count)
 {
 #if (MEM_TRACKING == MEM_TRACK_VERBOSE)
-	Callstack callstack = CallstackGet();
+	CallstackId callstackId = CallstackIntern(CallstackGet());
 	
 	MemTrackInfo_T info;
 
 	info.m_byteSize = byte_count;
-	info.m_callstack = callstack;
+	info.m_callstackId = callstackId;
 	info.m_originalPointer = allocation;
-	{
-		std::scoped_lock lock(GetMemTrackerLock());
-		GetMemTrakingMap()[allocation] = info;
-	}
+
+	GetMemTrackTable().Insert(info);
 #endif
 }
 
 //------------------------------------------------------------------------
 void UntrackAllocation(void* allocation)
 {
+	MemTrackInfo_T info;
+	bool wasTracked = GetMemTrackTable().Remove(allocation, info);
+	if (wasTracked)
 	{
-		std::scoped_lock lock(GetMemTrackerLock());
-		auto mapIterator = GetMemTrakingMap().find(allocation);
-		::free(allocation);
-		if (mapIterator != GetMemTrakingMap().end())
-		{
-			gTotalBytesAllocated -= mapIterator->second.m_byteSize;
-			tTotalBytesFreed += mapIterator->second.m_byteSize;
-			GetMemTrakingMap().erase(mapIterator);
-		}
+		gTotalBytesAllocated -= info.m_byteSize;
+		tTotalBytesFreed += info.m_byteSize;
+		ProfilerRecordFree(info.m_byteSize);
 	}
 }
 
@@ -191,48 +410,48 @@ void MemTrackLogLiveAllocations()
 	#if (MEM_TRACKING == MEM_TRACK_VERBOSE)
 		//Create a thread safe copy of the map but use callstack as key and pair of num allocations and alloc size as value
 
-		std::map<unsigned long, LogTrackInfo_T, std::less<unsigned long>, TemplatedUntrackedAllocator<std::pair<unsigned long const, LogTrackInfo_T>>> memLoggerMap;
+		std::map<CallstackId, LogTrackInfo_T, std::less<CallstackId>, TemplatedUntrackedAllocator<std::pair<CallstackId const, LogTrackInfo_T>>> memLoggerMap;
 
-		std::map<unsigned long, LogTrackInfo_T, std::less<unsigned long>, TemplatedUntrackedAllocator<std::pair<unsigned long const, LogTrackInfo_T>>>::iterator memLoggerIterator;
-		std::map<void*, MemTrackInfo_T, std::less<void*>, TemplatedUntrackedAllocator<std::pair<void* const, MemTrackInfo_T>>>::iterator memTrackerIterator;
+		std::map<CallstackId, LogTrackInfo_T, std::less<CallstackId>, TemplatedUntrackedAllocator<std::pair<CallstackId const, LogTrackInfo_T>>>::iterator memLoggerIterator;
 
 		size_t totalAllocationSize = 0;
 		uint totalAllocations = 0;
 
-		memTrackerIterator = GetMemTrakingMap().begin();
+		//Shards are copied one at a time, everyone else keeps allocating while we work on the copy
+		MemTrackInfoList liveAllocations;
+		GetMemTrackTable().Snapshot(liveAllocations);
+
+		MemTrackInfoList::iterator memTrackerIterator = liveAllocations.begin();
+		while (memTrackerIterator != liveAllocations.end())
 		{
-			std::scoped_lock lock(GetMemTrackerLock());
-			while (memTrackerIterator != GetMemTrakingMap().end())
+			memLoggerIterator = memLoggerMap.find(memTrackerIterator->m_callstackId);
+			if (memLoggerIterator == memLoggerMap.end())
 			{
-				memLoggerIterator = memLoggerMap.find(memTrackerIterator->second.m_callstack.m_hash);
-				if (memLoggerIterator == memLoggerMap.end())
-				{
-					//This hash doesn't exist in the map
-					LogTrackInfo_T info;
-					info.m_allocationSizeInBytes = memTrackerIterator->second.m_byteSize;
-					info.m_numAllocations = 1;
-					info.m_callstack = memTrackerIterator->second.m_callstack;
-
-					memLoggerMap[memTrackerIterator->second.m_callstack.m_hash] = info;
-				}
-				else
-				{
-					//Hash exists in map so update data (except the callstack as it will be the same)
-					memLoggerIterator->second.m_allocationSizeInBytes += memTrackerIterator->second.m_byteSize;
-					++memLoggerIterator->second.m_numAllocations;
-				}
-
-				totalAllocationSize += memTrackerIterator->second.m_byteSize;
-				totalAllocations++;
-				memTrackerIterator++;
+				//This callstack doesn't exist in the map
+				LogTrackInfo_T info;
+				info.m_allocationSizeInBytes = memTrackerIterator->m_byteSize;
+				info.m_numAllocations = 1;
+				info.m_callstackId = memTrackerIterator->m_callstackId;
+
+				memLoggerMap[memTrackerIterator->m_callstackId] = info;
 			}
+			else
+			{
+				//Callstack exists in map so update data (except the callstack as it will be the same)
+				memLoggerIterator->second.m_allocationSizeInBytes += memTrackerIterator->m_byteSize;
+				++memLoggerIterator->second.m_numAllocations;
+			}
+
+			totalAllocationSize += memTrackerIterator->m_byteSize;
+			totalAllocations++;
+			memTrackerIterator++;
 		}
 
 
 		//Sort Map
 		std::vector<LogTrackInfo_T> logVector;
 
-		std::map<unsigned long, LogTrackInfo_T, std::less<unsigned long>, TemplatedUntrackedAllocator<std::pair<unsigned long const, LogTrackInfo_T>>>::iterator logMapItr;
+		std::map<CallstackId, LogTrackInfo_T, std::less<CallstackId>, TemplatedUntrackedAllocator<std::pair<CallstackId const, LogTrackInfo_T>>>::iterator logMapItr;
 		logMapItr = memLoggerMap.begin();
 
 		while (logMapItr != memLoggerMap.end())
@@ -252,20 +471,613 @@ void MemTrackLogLiveAllocations()
 		std::vector<LogTrackInfo_T>::iterator logVecItr = logVector.begin();
 		while (logVecItr != logVector.end())
 		{
-			DebuggerPrintf("\n Num allocations for hash: %u", logVecItr->m_numAllocations);
+			DebuggerPrintf("\n Num allocations for callstack: %u", logVecItr->m_numAllocations);
 			bytesAllocated = GetSizeString(logVecItr->m_allocationSizeInBytes);
 			DebuggerPrintf("\n %s \n", bytesAllocated.c_str());
-			std::vector<std::string> callStackString = GetCallstackToString(logVecItr->m_callstack);
+
+			std::vector<std::string> callStackString = GetCallstackToString(logVecItr->m_callstackId);
+			for (size_t lineIndex = 0; lineIndex < callStackString.size(); ++lineIndex)
+			{
+				DebuggerPrintf("%s \n", callStackString[lineIndex].c_str());
+			}
 
 			logVecItr++;
 		}
 
 		DebuggerPrintf("===== END MEMORY LOG =====");
 
+	#elif (MEM_TRACKING == MEM_TRACK_SAMPLED)
+		std::vector<MemTrackSampledSite_T> sites;
+		MemTrackGetSampledSites(sites);
+
+		DebuggerPrintf("===== BEGIN SAMPLED MEMORY LOG =====");
+		DebuggerPrintf("\n Sampling 1 in every %u bytes, estimates only", (uint)MEM_TRACK_SAMPLE_BYTES);
+		DebuggerPrintf("\n Estimated live %s \n", GetSizeString(gTotalBytesAllocated).c_str());
+
+		for (size_t siteIndex = 0; siteIndex < sites.size(); ++siteIndex)
+		{
+			const MemTrackSampledSite_T& site = sites[siteIndex];
+			DebuggerPrintf("\n Estimated live allocations for callstack: %.0f (%u samples)", site.m_estimatedLiveAllocations, site.m_liveSampleCount);
+			DebuggerPrintf("\n %s", GetSizeString((size_t)site.m_estimatedLiveBytes).c_str());
+			DebuggerPrintf("\n Allocation rate: %.0f B/s, %.1f allocations/s \n", site.m_estimatedBytesPerSecond, site.m_estimatedAllocationsPerSecond);
+
+			std::vector<std::string> callStackString = GetCallstackToString(site.m_callstackId);
+			for (size_t lineIndex = 0; lineIndex < callStackString.size(); ++lineIndex)
+			{
+				DebuggerPrintf("%s \n", callStackString[lineIndex].c_str());
+			}
+		}
+
+		DebuggerPrintf("===== END SAMPLED MEMORY LOG =====");
 	#endif
 #endif
 }
 
+//------------------------------------------------------------------------------------------------------------------------------
+void MemTrackGetSampledSites(std::vector<MemTrackSampledSite_T>& outSites)
+{
+	outSites.clear();
+
+#if defined(MEM_TRACKING) && (MEM_TRACKING == MEM_TRACK_SAMPLED)
+	//Untracked like the totals map, a sampled node allocation made under the site lock would take it again
+	typedef std::map<CallstackId, MemTrackSampledSite_T, std::less<CallstackId>, TemplatedUntrackedAllocator<std::pair<CallstackId const, MemTrackSampledSite_T>>> SampledSiteReportMap;
+	SampledSiteReportMap siteMap;
+
+	//Live estimates come from the samples still in the table
+	MemTrackInfoList liveSamples;
+	GetMemTrackTable().Snapshot(liveSamples);
+
+	for (size_t sampleIndex = 0; sampleIndex < liveSamples.size(); ++sampleIndex)
+	{
+		const MemTrackInfo_T& sample = liveSamples[sampleIndex];
+		double weight = GetSampleWeight(sample.m_byteSize);
+
+		MemTrackSampledSite_T& site = siteMap[sample.m_callstackId];
+		site.m_callstackId = sample.m_callstackId;
+		site.m_liveSampleCount++;
+		site.m_estimatedLiveBytes += (double)sample.m_byteSize * weight;
+		site.m_estimatedLiveAllocations += weight;
+	}
+
+	//Rates come from everything ever sampled at each site
+	double elapsedSeconds = GetCurrentTimeSeconds() - GetSamplingStartTime();
+	double secondsDivisor = (elapsedSeconds > 0.0) ? elapsedSeconds : 1.0;
+	{
+		std::scoped_lock lock(GetSampledSiteLock());
+		SampledSiteMap::const_iterator totalsItr = GetSampledSiteMap().begin();
+		while (totalsItr != GetSampledSiteMap().end())
+		{
+			MemTrackSampledSite_T& site = siteMap[totalsItr->first];
+			site.m_callstackId = totalsItr->first;
+			site.m_estimatedBytesPerSecond = totalsItr->second.m_estimatedBytes / secondsDivisor;
+			site.m_estimatedAllocationsPerSecond = totalsItr->second.m_estimatedAllocations / secondsDivisor;
+			totalsItr++;
+		}
+	}
+
+	outSites.reserve(siteMap.size());
+	SampledSiteReportMap::const_iterator siteItr = siteMap.begin();
+	while (siteItr != siteMap.end())
+	{
+		outSites.push_back(siteItr->second);
+		siteItr++;
+	}
+
+	std::sort(outSites.begin(), outSites.end(), [](const MemTrackSampledSite_T& a, const MemTrackSampledSite_T& b)
+	{
+		return a.m_estimatedLiveBytes > b.m_estimatedLiveBytes;
+	});
+#endif
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+std::string MemTrackGetCallsiteName(CallstackId callstackId)
+{
+	//Frames that only tell us an allocation happened, not who asked for it
+	static const char* allocationFrameMarkers[] = { "MemTracking.cpp", "operator new", "TrackedAllocator", "UntrackedAllocator" };
+
+	std::vector<std::string> callStackString = GetCallstackToString(callstackId);
+	for (size_t lineIndex = 0; lineIndex < callStackString.size(); ++lineIndex)
+	{
+		bool isAllocationFrame = false;
+		for (const char* marker : allocationFrameMarkers)
+		{
+			if (callStackString[lineIndex].find(marker) != std::string::npos)
+			{
+				isAllocationFrame = true;
+				break;
+			}
+		}
+
+		if (!isAllocationFrame)
+		{
+			return callStackString[lineIndex];
+		}
+	}
+
+	return callStackString.empty() ? Stringf("Callstack %u", callstackId) : callStackString[0];
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Heap snapshots, kept in untracked memory so taking one doesn't show up in the next diff
+//------------------------------------------------------------------------------------------------------------------------------
+struct MemTrackSnapshotTotals_T
+{
+	double m_allocationCount = 0.0;
+	double m_byteCount = 0.0;
+};
+
+typedef std::map<CallstackId, MemTrackSnapshotTotals_T, std::less<CallstackId>, TemplatedUntrackedAllocator<std::pair<CallstackId const, MemTrackSnapshotTotals_T>>> MemTrackSnapshotMap;
+typedef std::map<UntrackedString, MemTrackSnapshotMap, std::less<UntrackedString>, TemplatedUntrackedAllocator<std::pair<UntrackedString const, MemTrackSnapshotMap>>> MemTrackNamedSnapshotMap;
+
+//------------------------------------------------------------------------------------------------------------------------------
+static std::mutex& GetSnapshotLock()
+{
+	static std::mutex snapshotLock;
+	return snapshotLock;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static MemTrackNamedSnapshotMap& GetNamedSnapshots()
+{
+	static MemTrackNamedSnapshotMap namedSnapshots;
+	return namedSnapshots;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static bool GetLiveHeapByCallstack(MemTrackSnapshotMap& outTotals)
+{
+#if defined(MEM_TRACKING) && ((MEM_TRACKING == MEM_TRACK_VERBOSE) || (MEM_TRACKING == MEM_TRACK_SAMPLED))
+	MemTrackInfoList liveAllocations;
+	GetMemTrackTable().Snapshot(liveAllocations);
+
+	for (size_t allocationIndex = 0; allocationIndex < liveAllocations.size(); ++allocationIndex)
+	{
+		const MemTrackInfo_T& info = liveAllocations[allocationIndex];
+
+		double weight = 1.0;
+	#if (MEM_TRACKING == MEM_TRACK_SAMPLED)
+		weight = GetSampleWeight(info.m_byteSize);
+	#endif
+
+		MemTrackSnapshotTotals_T& totals = outTotals[info.m_callstackId];
+		totals.m_allocationCount += weight;
+		totals.m_byteCount += (double)info.m_byteSize * weight;
+	}
+
+	return true;
+#else
+	UNUSED(outTotals);
+	return false;
+#endif
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool MemTrackTakeSnapshot(const std::string& name)
+{
+	MemTrackSnapshotMap liveTotals;
+	if (!GetLiveHeapByCallstack(liveTotals))
+	{
+		return false;
+	}
+
+	std::scoped_lock lock(GetSnapshotLock());
+	GetNamedSnapshots()[UntrackedString(name.c_str())] = std::move(liveTotals);
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool MemTrackHasSnapshot(const std::string& name)
+{
+	std::scoped_lock lock(GetSnapshotLock());
+	return GetNamedSnapshots().find(UntrackedString(name.c_str())) != GetNamedSnapshots().end();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void MemTrackClearSnapshots()
+{
+	std::scoped_lock lock(GetSnapshotLock());
+	GetNamedSnapshots().clear();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool MemTrackDiffSnapshots(const std::string& fromName, const std::string& toName, std::vector<MemTrackDiffEntry_T>& outDiff)
+{
+	outDiff.clear();
+
+	MemTrackSnapshotMap liveTotals;
+	if (toName.empty() && !GetLiveHeapByCallstack(liveTotals))
+	{
+		return false;
+	}
+
+	std::scoped_lock lock(GetSnapshotLock());
+
+	MemTrackNamedSnapshotMap::const_iterator fromItr = GetNamedSnapshots().find(UntrackedString(fromName.c_str()));
+	if (fromItr == GetNamedSnapshots().end())
+	{
+		return false;
+	}
+
+	const MemTrackSnapshotMap* toTotals = &liveTotals;
+	if (!toName.empty())
+	{
+		MemTrackNamedSnapshotMap::const_iterator toItr = GetNamedSnapshots().find(UntrackedString(toName.c_str()));
+		if (toItr == GetNamedSnapshots().end())
+		{
+			return false;
+		}
+
+		toTotals = &toItr->second;
+	}
+
+	const MemTrackSnapshotMap& fromTotals = fromItr->second;
+
+	//Walk both sorted maps together, a callstack missing on one side counts as zero there
+	MemTrackSnapshotMap::const_iterator fromSite = fromTotals.begin();
+	MemTrackSnapshotMap::const_iterator toSite = toTotals->begin();
+	while (fromSite != fromTotals.end() || toSite != toTotals->end())
+	{
+		MemTrackDiffEntry_T entry;
+		double allocationDelta;
+		double byteDelta;
+
+		if (toSite == toTotals->end() || (fromSite != fromTotals.end() && fromSite->first < toSite->first))
+		{
+			entry.m_callstackId = fromSite->first;
+			allocationDelta = -fromSite->second.m_allocationCount;
+			byteDelta = -fromSite->second.m_byteCount;
+			fromSite++;
+		}
+		else if (fromSite == fromTotals.end() || toSite->first < fromSite->first)
+		{
+			entry.m_callstackId = toSite->first;
+			allocationDelta = toSite->second.m_allocationCount;
+			byteDelta = toSite->second.m_byteCount;
+			toSite++;
+		}
+		else
+		{
+			entry.m_callstackId = toSite->first;
+			allocationDelta = toSite->second.m_allocationCount - fromSite->second.m_allocationCount;
+			byteDelta = toSite->second.m_byteCount - fromSite->second.m_byteCount;
+			fromSite++;
+			toSite++;
+		}
+
+		entry.m_allocationDelta = (int64_t)llround(allocationDelta);
+		entry.m_byteDelta = (int64_t)llround(byteDelta);
+		if (entry.m_allocationDelta != 0 || entry.m_byteDelta != 0)
+		{
+			outDiff.push_back(entry);
+		}
+	}
+
+	std::sort(outDiff.begin(), outDiff.end(), [](const MemTrackDiffEntry_T& a, const MemTrackDiffEntry_T& b)
+	{
+		return a.m_byteDelta > b.m_byteDelta;
+	});
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+size_t MemHistogramGetBucketMinSize(uint bucketIndex)
+{
+	return (bucketIndex == 0U) ? 0U : ((size_t)1U << bucketIndex);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void MemTrackEndFrame()
+{
+	std::scoped_lock lock(gFrameHistogramLock);
+
+	MemFrameHistogram_T& histogram = gFrameHistogramHistory[gFrameHistogramsRecorded % MEM_HISTOGRAM_HISTORY_LENGTH];
+	histogram.m_frameIndex = gFrameHistogramsRecorded;
+
+	//Counts and bytes are swapped one after the other, so an allocation racing with this can land its count in one
+	//frame and its bytes in the next. Each frame can be off by the few allocations in flight, the totals always add up
+	for (uint bucketIndex = 0; bucketIndex < MEM_HISTOGRAM_BUCKET_COUNT; ++bucketIndex)
+	{
+		histogram.m_allocationCounts[bucketIndex] = gFrameAllocationCounts[bucketIndex].exchange(0U, std::memory_order_relaxed);
+		histogram.m_allocationBytes[bucketIndex] = gFrameAllocationBytes[bucketIndex].exchange(0U, std::memory_order_relaxed);
+	}
+
+	gFrameHistogramsRecorded++;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool MemTrackGetFrameHistogram(MemFrameHistogram_T& outHistogram, uint framesAgo)
+{
+	std::scoped_lock lock(gFrameHistogramLock);
+
+	if (framesAgo >= MEM_HISTOGRAM_HISTORY_LENGTH || framesAgo >= gFrameHistogramsRecorded)
+	{
+		return false;
+	}
+
+	outHistogram = gFrameHistogramHistory[(gFrameHistogramsRecorded - 1U - framesAgo) % MEM_HISTOGRAM_HISTORY_LENGTH];
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool MemTrackExportHistograms(const std::string& fileName)
+{
+	std::ofstream exportStream(fileName, std::ios::trunc);
+	if (!exportStream.is_open())
+	{
+		return false;
+	}
+
+	exportStream << "Frame,BucketMinBytes,Count,Bytes\n";
+
+	std::scoped_lock lock(gFrameHistogramLock);
+
+	uint64_t numFrames = (gFrameHistogramsRecorded < MEM_HISTOGRAM_HISTORY_LENGTH) ? gFrameHistogramsRecorded : MEM_HISTOGRAM_HISTORY_LENGTH;
+	for (uint64_t frameIndex = gFrameHistogramsRecorded - numFrames; frameIndex < gFrameHistogramsRecorded; ++frameIndex)
+	{
+		const MemFrameHistogram_T& histogram = gFrameHistogramHistory[frameIndex % MEM_HISTOGRAM_HISTORY_LENGTH];
+		for (uint bucketIndex = 0; bucketIndex < MEM_HISTOGRAM_BUCKET_COUNT; ++bucketIndex)
+		{
+			if (histogram.m_allocationCounts[bucketIndex] == 0U)
+			{
+				continue;
+			}
+
+			exportStream << Stringf("%llu,%llu,%u,%llu\n", (unsigned long long)histogram.m_frameIndex, (unsigned long long)MemHistogramGetBucketMinSize(bucketIndex),
+				histogram.m_allocationCounts[bucketIndex], (unsigned long long)histogram.m_allocationBytes[bucketIndex]);
+		}
+	}
+
+	exportStream.close();
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Global operator new
+//------------------------------------------------------------------------------------------------------------------------------
+static std::atomic<InternalAllocator*> gGlobalAllocator = nullptr;
+
+//------------------------------------------------------------------------------------------------------------------------------
+void MemTrackSetGlobalAllocator(InternalAllocator* allocator)
+{
+	gGlobalAllocator.store(allocator, std::memory_order_release);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+InternalAllocator* MemTrackGetGlobalAllocator()
+{
+	return gGlobalAllocator.load(std::memory_order_acquire);
+}
+
+#if defined(ENGINE_ROUTE_GLOBAL_NEW)
+
+constexpr size_t GLOBAL_ALLOC_MIN_ALIGNMENT = 16U;
+
+//Sits right in front of every pointer new hands out, delete reads it to find out where the memory came from
+struct GlobalAllocHeader_T
+{
+	InternalAllocator*	m_backend;			//nullptr for malloc
+	uint32_t			m_offset;			//From the start of the backing allocation to the pointer we handed out
+	uint32_t			m_isTracked;
+};
+static_assert(sizeof(GlobalAllocHeader_T) <= GLOBAL_ALLOC_MIN_ALIGNMENT, "Global allocation header must fit in the minimum alignment");
+
+//Set while a thread is inside new or delete. Tracking and backends can allocate themselves (callstack capture, chunk growth),
+//those nested allocations go straight to malloc untracked instead of recursing
+static thread_local bool tIsInsideGlobalNew = false;
+
+//------------------------------------------------------------------------------------------------------------------------------
+static void* GlobalAlloc(size_t size, size_t alignment)
+{
+	if (alignment < GLOBAL_ALLOC_MIN_ALIGNMENT)
+	{
+		alignment = GLOBAL_ALLOC_MIN_ALIGNMENT;
+	}
+
+	//malloc is only 8 byte aligned on Win32, so leave room for the header on top of the worst case alignment padding
+	size_t padding = alignment + sizeof(GlobalAllocHeader_T);
+	if (size > SIZE_MAX - padding)
+	{
+		return nullptr;
+	}
+	size_t paddedSize = size + padding;
+
+	bool wasInsideGlobalNew = tIsInsideGlobalNew;
+	tIsInsideGlobalNew = true;
+
+	InternalAllocator* backend = wasInsideGlobalNew ? nullptr : gGlobalAllocator.load(std::memory_order_acquire);
+	void* base = (backend != nullptr) ? backend->Allocate(paddedSize) : nullptr;
+	if (base == nullptr)
+	{
+		backend = nullptr;
+		base = ::malloc(paddedSize);
+	}
+
+	void* allocation = nullptr;
+	if (base != nullptr)
+	{
+		allocation = (void*)(((uintptr_t)base + sizeof(GlobalAllocHeader_T) + alignment - 1U) & ~(uintptr_t)(alignment - 1U));
+
+		GlobalAllocHeader_T* header = (GlobalAllocHeader_T*)allocation - 1;
+		header->m_backend = backend;
+		header->m_offset = (uint32_t)((uintptr_t)allocation - (uintptr_t)base);
+		header->m_isTracked = wasInsideGlobalNew ? 0U : 1U;
+
+		if (!wasInsideGlobalNew)
+		{
+			MemTrackRecordAlloc(allocation, size);
+		}
+	}
+
+	tIsInsideGlobalNew = wasInsideGlobalNew;
+	return allocation;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static void* GlobalAllocOrThrow(size_t size, size_t alignment)
+{
+	void* allocation = GlobalAlloc(size, alignment);
+	if (allocation == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+
+	return allocation;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static void GlobalFree(void* ptr)
+{
+	if (ptr == nullptr)
+	{
+		return;
+	}
+
+	bool wasInsideGlobalNew = tIsInsideGlobalNew;
+	tIsInsideGlobalNew = true;
+
+	GlobalAllocHeader_T* header = (GlobalAllocHeader_T*)ptr - 1;
+	if (header->m_isTracked != 0U)
+	{
+		MemTrackRecordFree(ptr);
+	}
+
+	void* base = (void*)((uintptr_t)ptr - header->m_offset);
+	if (header->m_backend != nullptr)
+	{
+		header->m_backend->Free(base);
+	}
+	else
+	{
+		::free(base);
+	}
+
+	tIsInsideGlobalNew = wasInsideGlobalNew;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void* operator new(size_t size)
+{
+	return GlobalAllocOrThrow(size, GLOBAL_ALLOC_MIN_ALIGNMENT);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void* operator new[](size_t size)
+{
+	return GlobalAllocOrThrow(size, GLOBAL_ALLOC_MIN_ALIGNMENT);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	return GlobalAlloc(size, GLOBAL_ALLOC_MIN_ALIGNMENT);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+	return GlobalAlloc(size, GLOBAL_ALLOC_MIN_ALIGNMENT);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void* operator new(size_t size, std::align_val_t alignment)
+{
+	return GlobalAllocOrThrow(size, (size_t)alignment);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+	return GlobalAllocOrThrow(size, (size_t)alignment);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return GlobalAlloc(size, (size_t)alignment);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return GlobalAlloc(size, (size_t)alignment);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void operator delete(void* ptr) noexcept
+{
+	GlobalFree(ptr);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void operator delete[](void* ptr) noexcept
+{
+	GlobalFree(ptr);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void operator delete(void* ptr, size_t) noexcept
+{
+	GlobalFree(ptr);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void operator delete[](void* ptr, size_t) noexcept
+{
+	GlobalFree(ptr);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+	GlobalFree(ptr);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+	GlobalFree(ptr);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+	GlobalFree(ptr);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void operator delete[](void* ptr, std::align_val_t) noexcept
+{
+	GlobalFree(ptr);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept
+{
+	GlobalFree(ptr);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept
+{
+	GlobalFree(ptr);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	GlobalFree(ptr);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	GlobalFree(ptr);
+}
+
+#else
+
 //------------------------------------------------------------------------------------------------------------------------------
 void* operator new(size_t size)
 {
@@ -278,6 +1090,8 @@ void operator delete(void* ptr)
 	TrackedFree(ptr);
 }
 
+#endif
+
 //------------------------------------------------------------------------------------------------------------------------------
 void* operator new(size_t size, InternalAllocator& allocator)
 {
@@ -5,18 +5,38 @@
 #include <mutex>
 #include <string>
 
+//------------------------------------------------------------------------------------------------------------------------------
+// MEM_TRACK_SAMPLED only records a callstack for roughly one in every MEM_TRACK_SAMPLE_BYTES bytes allocated (Poisson sampling).
+// Each sample is weighted by the inverse of its chance of being picked so per callsite totals are unbiased estimates.
+// Games pick the mode in Game/EngineBuildPreferences.hpp alongside MEM_TRACK_ALLOC_COUNT and MEM_TRACK_VERBOSE
+#if !defined(MEM_TRACK_SAMPLED)
+	#define MEM_TRACK_SAMPLED 2
+#endif
+
+#if !defined(MEM_TRACK_SAMPLE_BYTES)
+	#define MEM_TRACK_SAMPLE_BYTES (512 * 1024)
+#endif
+
+//------------------------------------------------------------------------------------------------------------------------------
+// By default only the plain operator new/delete pair is replaced and it goes straight to TrackedAlloc.
+// Defining ENGINE_ROUTE_GLOBAL_NEW in Game/EngineBuildPreferences.hpp replaces the whole set (array, sized, aligned, nothrow)
+// so containers and over aligned types are tracked too, and lets the game plug in a backend with MemTrackSetGlobalAllocator
+
+class InternalAllocator;
+
+//Callstacks are interned, identical stacks share one entry in the callstack table
 struct MemTrackInfo_T
 {
 	void* m_originalPointer;
 	size_t m_byteSize;
-	Callstack m_callstack;
+	CallstackId m_callstackId;
 };
 
 struct LogTrackInfo_T
 {
 	uint m_numAllocations;
 	size_t m_allocationSizeInBytes;
-	Callstack m_callstack;
+	CallstackId m_callstackId;
 };
 
 // Human parse able data
@@ -36,11 +56,81 @@ void				UntrackedFree(void* ptr);
 void*				TrackedAlloc(size_t byte_count);
 void				TrackedFree(void* ptr);
 
+// Tracking without the allocation, for memory that came from somewhere other than malloc.
+// Record the free before handing the memory back, once it's back another thread can get the same address
+void				MemTrackRecordAlloc(void* allocation, size_t byte_count);
+void				MemTrackRecordFree(void* allocation);
+
 //Tracks the allocation by either adding count or adding to a tracking map 
 void				TrackAllocation(void* allocation, size_t byte_count);
 void				UntrackAllocation(void* allocation);
 
+// Backend for global operator new with ENGINE_ROUTE_GLOBAL_NEW, nullptr (the default) means malloc.
+// Every allocation remembers the backend it came from so this can change at any time, but a backend has to outlive
+// everything it handed out. Sizes the backend can't serve (Allocate returns nullptr) fall back to malloc
+void				MemTrackSetGlobalAllocator(InternalAllocator* allocator);
+InternalAllocator*	MemTrackGetGlobalAllocator();
+
+struct MemTrackSampledSite_T
+{
+	CallstackId m_callstackId;
+	uint m_liveSampleCount;
+	double m_estimatedLiveBytes;
+	double m_estimatedLiveAllocations;
+	double m_estimatedBytesPerSecond;		//Everything allocated from here since sampling started, live or not
+	double m_estimatedAllocationsPerSecond;
+};
+
 // report methods
 size_t				MemTrackGetLiveAllocationCount();
-size_t				MemTrackGetLiveByteCount();
-void				MemTrackLogLiveAllocations();
\ No newline at end of file
+size_t				MemTrackGetLiveByteCount();			//An estimate in MEM_TRACK_SAMPLED
+void				MemTrackLogLiveAllocations();
+
+// Per callsite estimates in MEM_TRACK_SAMPLED, sorted by estimated live bytes. Empty in every other mode
+void				MemTrackGetSampledSites(std::vector<MemTrackSampledSite_T>& outSites);
+
+// First frame of the callstack outside the allocation plumbing (operator new, TrackedAlloc...), for one line reports
+std::string			MemTrackGetCallsiteName(CallstackId callstackId);
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Heap snapshots capture the live heap grouped by callstack under a name so two points in time can be compared.
+// They need the live allocation table so only MEM_TRACK_VERBOSE and MEM_TRACK_SAMPLED (as estimates) support them
+//------------------------------------------------------------------------------------------------------------------------------
+struct MemTrackDiffEntry_T
+{
+	CallstackId m_callstackId;
+	int64_t m_allocationDelta;
+	int64_t m_byteDelta;
+};
+
+bool				MemTrackTakeSnapshot(const std::string& name);
+bool				MemTrackHasSnapshot(const std::string& name);
+void				MemTrackClearSnapshots();
+
+// An empty toName compares against the live heap right now. Sorted by byte growth, callstacks that didn't change are left out
+bool				MemTrackDiffSnapshots(const std::string& fromName, const std::string& toName, std::vector<MemTrackDiffEntry_T>& outDiff);
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Per frame histogram of allocation sizes, recorded in every tracking mode.
+// Bucket 0 holds 0 and 1 byte allocations, bucket i holds [2^i, 2^(i+1)) and the last bucket holds everything bigger
+//------------------------------------------------------------------------------------------------------------------------------
+constexpr uint MEM_HISTOGRAM_BUCKET_COUNT = 32U;
+constexpr uint MEM_HISTOGRAM_HISTORY_LENGTH = 300U;
+
+struct MemFrameHistogram_T
+{
+	uint64_t m_frameIndex;
+	uint m_allocationCounts[MEM_HISTOGRAM_BUCKET_COUNT];
+	uint64_t m_allocationBytes[MEM_HISTOGRAM_BUCKET_COUNT];
+};
+
+size_t				MemHistogramGetBucketMinSize(uint bucketIndex);
+
+// Closes the frame being recorded and moves it into the history, called once a frame from DevConsole::EndFrame
+void				MemTrackEndFrame();
+
+// framesAgo 0 is the last completed frame, returns false if that frame isn't in the history
+bool				MemTrackGetFrameHistogram(MemFrameHistogram_T& outHistogram, uint framesAgo = 0U);
+
+// Writes every frame in the history as csv: frame, bucket min bytes, count, bytes
+bool				MemTrackExportHistograms(const std::string& fileName);
\ No newline at end of file
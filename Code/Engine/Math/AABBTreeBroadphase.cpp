@@ -0,0 +1,775 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Math/AABBTreeBroadphase.hpp"
+#include "Engine/Commons/UnitTest.hpp"
+#include <algorithm>
+
+//------------------------------------------------------------------------------------------------------------------------------
+static inline float GetPerimeter(const Vec2& minBounds, const Vec2& maxBounds)
+{
+	return 2.f * ((maxBounds.x - minBounds.x) + (maxBounds.y - minBounds.y));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static inline void GetUnion(Vec2& outMin, Vec2& outMax, const AABBTreeNode_T& a, const AABBTreeNode_T& b)
+{
+	outMin.x = (a.m_min.x < b.m_min.x) ? a.m_min.x : b.m_min.x;
+	outMin.y = (a.m_min.y < b.m_min.y) ? a.m_min.y : b.m_min.y;
+	outMax.x = (a.m_max.x > b.m_max.x) ? a.m_max.x : b.m_max.x;
+	outMax.y = (a.m_max.y > b.m_max.y) ? a.m_max.y : b.m_max.y;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static inline float GetUnionPerimeter(const AABBTreeNode_T& a, const AABBTreeNode_T& b)
+{
+	Vec2 unionMin;
+	Vec2 unionMax;
+	GetUnion(unionMin, unionMax, a, b);
+	return GetPerimeter(unionMin, unionMax);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static inline bool DoBoundsOverlap(const AABBTreeNode_T& a, const AABBTreeNode_T& b)
+{
+	return a.m_min.x <= b.m_max.x && b.m_min.x <= a.m_max.x && a.m_min.y <= b.m_max.y && b.m_min.y <= a.m_max.y;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static inline bool DoBoundsOverlap(const Vec2& minA, const Vec2& maxA, const Vec2& minB, const Vec2& maxB)
+{
+	return minA.x <= maxB.x && minB.x <= maxA.x && minA.y <= maxB.y && minB.y <= maxA.y;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Slab test, does the segment start + t * delta for t in [0, 1] touch the box. inverseDelta is 1 / delta per axis
+static inline bool DoesSegmentHitBounds(const Vec2& start, const Vec2& delta, const Vec2& inverseDelta, const Vec2& minBounds, const Vec2& maxBounds)
+{
+	float entry = 0.f;
+	float exit = 1.f;
+
+	const float starts[2] = { start.x, start.y };
+	const float deltas[2] = { delta.x, delta.y };
+	const float inverses[2] = { inverseDelta.x, inverseDelta.y };
+	const float mins[2] = { minBounds.x, minBounds.y };
+	const float maxs[2] = { maxBounds.x, maxBounds.y };
+
+	for (int axis = 0; axis < 2; ++axis)
+	{
+		if (deltas[axis] == 0.f)
+		{
+			if (starts[axis] < mins[axis] || starts[axis] > maxs[axis])
+			{
+				return false;
+			}
+			continue;
+		}
+
+		float slabEntry = (mins[axis] - starts[axis]) * inverses[axis];
+		float slabExit = (maxs[axis] - starts[axis]) * inverses[axis];
+		if (slabEntry > slabExit)
+		{
+			float swap = slabEntry;
+			slabEntry = slabExit;
+			slabExit = swap;
+		}
+
+		entry = (slabEntry > entry) ? slabEntry : entry;
+		exit = (slabExit < exit) ? slabExit : exit;
+		if (entry > exit)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static inline bool IsContainedIn(const Vec2& innerMin, const Vec2& innerMax, const Vec2& outerMin, const Vec2& outerMax)
+{
+	return outerMin.x <= innerMin.x && outerMin.y <= innerMin.y && innerMax.x <= outerMax.x && innerMax.y <= outerMax.y;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static inline void SetFatBounds(AABBTreeNode_T& leaf, const Vec2& displacement)
+{
+	leaf.m_min = Vec2(leaf.m_tightMin.x - AABB_TREE_FAT_MARGIN, leaf.m_tightMin.y - AABB_TREE_FAT_MARGIN);
+	leaf.m_max = Vec2(leaf.m_tightMax.x + AABB_TREE_FAT_MARGIN, leaf.m_tightMax.y + AABB_TREE_FAT_MARGIN);
+
+	//Stretch ahead of the motion so a body moving steadily doesn't need reinserting every step
+	float predictX = displacement.x * AABB_TREE_DISPLACEMENT_MULTIPLIER;
+	float predictY = displacement.y * AABB_TREE_DISPLACEMENT_MULTIPLIER;
+
+	if (predictX < 0.f)
+	{
+		leaf.m_min.x += predictX;
+	}
+	else
+	{
+		leaf.m_max.x += predictX;
+	}
+
+	if (predictY < 0.f)
+	{
+		leaf.m_min.y += predictY;
+	}
+	else
+	{
+		leaf.m_max.y += predictY;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+AABBTreeBroadphase::AABBTreeBroadphase()
+{
+
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+AABBTreeBroadphase::~AABBTreeBroadphase()
+{
+
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint AABBTreeBroadphase::CreateProxy(Collider2D* collider, const AABB2& bounds, bool isStatic)
+{
+	uint leafIndex = AllocateNode();
+	AABBTreeNode_T& leaf = m_nodes[leafIndex];
+
+	leaf.m_collider = collider;
+	leaf.m_tightMin = bounds.m_minBounds;
+	leaf.m_tightMax = bounds.m_maxBounds;
+	leaf.m_isStatic = isStatic;
+	leaf.m_hasMoved = true;
+	leaf.m_height = 0;
+	SetFatBounds(leaf, Vec2::ZERO);
+
+	InsertLeaf(leafIndex);
+	return leafIndex;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void AABBTreeBroadphase::DestroyProxy(uint proxyId)
+{
+	RemoveLeaf(proxyId);
+	FreeNode(proxyId);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void AABBTreeBroadphase::MoveProxy(uint proxyId, const AABB2& bounds)
+{
+	AABBTreeNode_T& leaf = m_nodes[proxyId];
+	if (leaf.m_tightMin == bounds.m_minBounds && leaf.m_tightMax == bounds.m_maxBounds)
+	{
+		return;
+	}
+
+	Vec2 displacement = Vec2(bounds.m_minBounds.x - leaf.m_tightMin.x, bounds.m_minBounds.y - leaf.m_tightMin.y);
+	leaf.m_tightMin = bounds.m_minBounds;
+	leaf.m_tightMax = bounds.m_maxBounds;
+	leaf.m_hasMoved = true;
+
+	if (IsContainedIn(leaf.m_tightMin, leaf.m_tightMax, leaf.m_min, leaf.m_max))
+	{
+		return;
+	}
+
+	RemoveLeaf(proxyId);
+	SetFatBounds(m_nodes[proxyId], displacement);
+	InsertLeaf(proxyId);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void AABBTreeBroadphase::GetCandidatePairs(BroadphasePairList& outPairs)
+{
+	outPairs.clear();
+
+	//Dynamic leaves find everything they touch. Statics only look (for other statics) when they moved
+	uint nodeCount = (uint)m_nodes.size();
+	for (uint nodeIndex = 0; nodeIndex < nodeCount; ++nodeIndex)
+	{
+		const AABBTreeNode_T& node = m_nodes[nodeIndex];
+		if (node.m_height != 0 || (node.m_isStatic && !node.m_hasMoved))
+		{
+			continue;
+		}
+
+		QueryPairs(nodeIndex, outPairs);
+	}
+
+	for (uint nodeIndex = 0; nodeIndex < nodeCount; ++nodeIndex)
+	{
+		m_nodes[nodeIndex].m_hasMoved = false;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void AABBTreeBroadphase::QueryPairs(uint leafIndex, BroadphasePairList& outPairs)
+{
+	if (m_rootIndex == INVALID_BROADPHASE_PROXY)
+	{
+		return;
+	}
+
+	const AABBTreeNode_T& leaf = m_nodes[leafIndex];
+
+	m_queryStack.clear();
+	m_queryStack.push_back(m_rootIndex);
+
+	while (!m_queryStack.empty())
+	{
+		uint nodeIndex = m_queryStack.back();
+		m_queryStack.pop_back();
+
+		const AABBTreeNode_T& node = m_nodes[nodeIndex];
+		if (!DoBoundsOverlap(leaf, node))
+		{
+			continue;
+		}
+
+		if (node.m_height > 0)
+		{
+			m_queryStack.push_back(node.m_child1);
+			m_queryStack.push_back(node.m_child2);
+			continue;
+		}
+
+		if (nodeIndex == leafIndex)
+		{
+			continue;
+		}
+
+		//Each pair is reported by exactly one of its leaves
+		bool isReported;
+		if (leaf.m_isStatic)
+		{
+			//Moved statics only pair with statics, dynamics already found them. Two moved statics, lower index reports
+			isReported = node.m_isStatic && (!node.m_hasMoved || leafIndex < nodeIndex);
+		}
+		else
+		{
+			isReported = node.m_isStatic || leafIndex < nodeIndex;
+		}
+
+		if (isReported)
+		{
+			outPairs.push_back({ leaf.m_collider, node.m_collider });
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// A walk never holds more than the root's height plus one nodes. The tree is balanced so that fits on the stack, anything
+// taller walks on the heap instead of running off the end
+static uint* GetWalkStack(uint* localStack, std::vector<uint>& heapStack, int rootHeight)
+{
+	uint walkSize = (uint)rootHeight + 2U;
+	if (walkSize <= AABB_TREE_QUERY_STACK_SIZE)
+	{
+		return localStack;
+	}
+
+	heapStack.resize(walkSize);
+	return heapStack.data();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void AABBTreeBroadphase::QueryAABB(const AABB2& bounds, std::vector<Collider2D*>& outColliders) const
+{
+	if (m_rootIndex == INVALID_BROADPHASE_PROXY)
+	{
+		return;
+	}
+
+	uint localStack[AABB_TREE_QUERY_STACK_SIZE];
+	std::vector<uint> heapStack;
+	uint* stack = GetWalkStack(localStack, heapStack, m_nodes[m_rootIndex].m_height);
+	uint stackCount = 0U;
+	stack[stackCount++] = m_rootIndex;
+
+	while (stackCount > 0U)
+	{
+		const AABBTreeNode_T& node = m_nodes[stack[--stackCount]];
+		if (!DoBoundsOverlap(node.m_min, node.m_max, bounds.m_minBounds, bounds.m_maxBounds))
+		{
+			continue;
+		}
+
+		if (node.m_height > 0)
+		{
+			stack[stackCount++] = node.m_child1;
+			stack[stackCount++] = node.m_child2;
+			continue;
+		}
+
+		//The fat bounds are the answer. The tight ones are from before the step pushed the collider out of its contacts,
+		//so they can miss where it is now. The caller's exact test throws out the extra candidates
+		outColliders.push_back(node.m_collider);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void AABBTreeBroadphase::QueryRay(const Vec2& start, const Vec2& end, std::vector<Collider2D*>& outColliders) const
+{
+	if (m_rootIndex == INVALID_BROADPHASE_PROXY)
+	{
+		return;
+	}
+
+	Vec2 delta = end - start;
+	Vec2 inverseDelta((delta.x != 0.f) ? 1.f / delta.x : 0.f, (delta.y != 0.f) ? 1.f / delta.y : 0.f);
+
+	uint localStack[AABB_TREE_QUERY_STACK_SIZE];
+	std::vector<uint> heapStack;
+	uint* stack = GetWalkStack(localStack, heapStack, m_nodes[m_rootIndex].m_height);
+	uint stackCount = 0U;
+	stack[stackCount++] = m_rootIndex;
+
+	while (stackCount > 0U)
+	{
+		const AABBTreeNode_T& node = m_nodes[stack[--stackCount]];
+		if (!DoesSegmentHitBounds(start, delta, inverseDelta, node.m_min, node.m_max))
+		{
+			continue;
+		}
+
+		if (node.m_height > 0)
+		{
+			stack[stackCount++] = node.m_child1;
+			stack[stackCount++] = node.m_child2;
+			continue;
+		}
+
+		//Fat bounds for the same reason as QueryAABB
+		outColliders.push_back(node.m_collider);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+int AABBTreeBroadphase::GetTreeHeight() const
+{
+	return (m_rootIndex == INVALID_BROADPHASE_PROXY) ? 0 : m_nodes[m_rootIndex].m_height;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint AABBTreeBroadphase::AllocateNode()
+{
+	if (m_freeList == INVALID_BROADPHASE_PROXY)
+	{
+		m_nodes.emplace_back();
+		return (uint)m_nodes.size() - 1U;
+	}
+
+	uint nodeIndex = m_freeList;
+	m_freeList = m_nodes[nodeIndex].m_parent;
+
+	m_nodes[nodeIndex] = AABBTreeNode_T();
+	return nodeIndex;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void AABBTreeBroadphase::FreeNode(uint nodeIndex)
+{
+	AABBTreeNode_T& node = m_nodes[nodeIndex];
+	node.m_height = -1;
+	node.m_collider = nullptr;
+	node.m_parent = m_freeList;
+	m_freeList = nodeIndex;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void AABBTreeBroadphase::InsertLeaf(uint leafIndex)
+{
+	if (m_rootIndex == INVALID_BROADPHASE_PROXY)
+	{
+		m_rootIndex = leafIndex;
+		m_nodes[leafIndex].m_parent = INVALID_BROADPHASE_PROXY;
+		return;
+	}
+
+	//Walk down picking the child that grows the least, stop when making a new parent here is cheaper (perimeter heuristic)
+	uint siblingIndex = m_rootIndex;
+	while (m_nodes[siblingIndex].m_height > 0)
+	{
+		const AABBTreeNode_T& leaf = m_nodes[leafIndex];
+		const AABBTreeNode_T& node = m_nodes[siblingIndex];
+		const AABBTreeNode_T& child1 = m_nodes[node.m_child1];
+		const AABBTreeNode_T& child2 = m_nodes[node.m_child2];
+
+		float perimeter = GetPerimeter(node.m_min, node.m_max);
+		float combinedPerimeter = GetUnionPerimeter(node, leaf);
+
+		float newParentCost = 2.f * combinedPerimeter;
+		float inheritanceCost = 2.f * (combinedPerimeter - perimeter);
+
+		float cost1 = GetUnionPerimeter(child1, leaf) + inheritanceCost;
+		if (child1.m_height > 0)
+		{
+			cost1 -= GetPerimeter(child1.m_min, child1.m_max);
+		}
+
+		float cost2 = GetUnionPerimeter(child2, leaf) + inheritanceCost;
+		if (child2.m_height > 0)
+		{
+			cost2 -= GetPerimeter(child2.m_min, child2.m_max);
+		}
+
+		if (newParentCost < cost1 && newParentCost < cost2)
+		{
+			break;
+		}
+
+		siblingIndex = (cost1 < cost2) ? node.m_child1 : node.m_child2;
+	}
+
+	//Allocating can grow the node array, take references after
+	uint newParentIndex = AllocateNode();
+	uint oldParentIndex = m_nodes[siblingIndex].m_parent;
+
+	AABBTreeNode_T& newParent = m_nodes[newParentIndex];
+	newParent.m_parent = oldParentIndex;
+	newParent.m_child1 = siblingIndex;
+	newParent.m_child2 = leafIndex;
+	newParent.m_height = m_nodes[siblingIndex].m_height + 1;
+	GetUnion(newParent.m_min, newParent.m_max, m_nodes[siblingIndex], m_nodes[leafIndex]);
+
+	if (oldParentIndex == INVALID_BROADPHASE_PROXY)
+	{
+		m_rootIndex = newParentIndex;
+	}
+	else if (m_nodes[oldParentIndex].m_child1 == siblingIndex)
+	{
+		m_nodes[oldParentIndex].m_child1 = newParentIndex;
+	}
+	else
+	{
+		m_nodes[oldParentIndex].m_child2 = newParentIndex;
+	}
+
+	m_nodes[siblingIndex].m_parent = newParentIndex;
+	m_nodes[leafIndex].m_parent = newParentIndex;
+
+	RefitAncestors(newParentIndex);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void AABBTreeBroadphase::RemoveLeaf(uint leafIndex)
+{
+	if (leafIndex == m_rootIndex)
+	{
+		m_rootIndex = INVALID_BROADPHASE_PROXY;
+		return;
+	}
+
+	uint parentIndex = m_nodes[leafIndex].m_parent;
+	uint grandParentIndex = m_nodes[parentIndex].m_parent;
+	uint siblingIndex = (m_nodes[parentIndex].m_child1 == leafIndex) ? m_nodes[parentIndex].m_child2 : m_nodes[parentIndex].m_child1;
+
+	//The sibling takes the parent's place
+	if (grandParentIndex == INVALID_BROADPHASE_PROXY)
+	{
+		m_rootIndex = siblingIndex;
+		m_nodes[siblingIndex].m_parent = INVALID_BROADPHASE_PROXY;
+		FreeNode(parentIndex);
+		return;
+	}
+
+	if (m_nodes[grandParentIndex].m_child1 == parentIndex)
+	{
+		m_nodes[grandParentIndex].m_child1 = siblingIndex;
+	}
+	else
+	{
+		m_nodes[grandParentIndex].m_child2 = siblingIndex;
+	}
+
+	m_nodes[siblingIndex].m_parent = grandParentIndex;
+	FreeNode(parentIndex);
+
+	RefitAncestors(grandParentIndex);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void AABBTreeBroadphase::RefitAncestors(uint nodeIndex)
+{
+	while (nodeIndex != INVALID_BROADPHASE_PROXY)
+	{
+		nodeIndex = Balance(nodeIndex);
+
+		AABBTreeNode_T& node = m_nodes[nodeIndex];
+		const AABBTreeNode_T& child1 = m_nodes[node.m_child1];
+		const AABBTreeNode_T& child2 = m_nodes[node.m_child2];
+
+		node.m_height = 1 + ((child1.m_height > child2.m_height) ? child1.m_height : child2.m_height);
+		GetUnion(node.m_min, node.m_max, child1, child2);
+
+		nodeIndex = node.m_parent;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint AABBTreeBroadphase::Balance(uint indexA)
+{
+	//If one child of A is 2+ levels taller than the other, rotate that child up to take A's place
+	AABBTreeNode_T& nodeA = m_nodes[indexA];
+	if (nodeA.m_height < 2)
+	{
+		return indexA;
+	}
+
+	uint indexB = nodeA.m_child1;
+	uint indexC = nodeA.m_child2;
+	AABBTreeNode_T& nodeB = m_nodes[indexB];
+	AABBTreeNode_T& nodeC = m_nodes[indexC];
+
+	int balance = nodeC.m_height - nodeB.m_height;
+	if (balance > 1)
+	{
+		//C goes up, A becomes its child and keeps the shorter of C's children
+		uint indexF = nodeC.m_child1;
+		uint indexG = nodeC.m_child2;
+		AABBTreeNode_T& nodeF = m_nodes[indexF];
+		AABBTreeNode_T& nodeG = m_nodes[indexG];
+
+		nodeC.m_child1 = indexA;
+		nodeC.m_parent = nodeA.m_parent;
+		nodeA.m_parent = indexC;
+
+		if (nodeC.m_parent == INVALID_BROADPHASE_PROXY)
+		{
+			m_rootIndex = indexC;
+		}
+		else if (m_nodes[nodeC.m_parent].m_child1 == indexA)
+		{
+			m_nodes[nodeC.m_parent].m_child1 = indexC;
+		}
+		else
+		{
+			m_nodes[nodeC.m_parent].m_child2 = indexC;
+		}
+
+		if (nodeF.m_height > nodeG.m_height)
+		{
+			nodeC.m_child2 = indexF;
+			nodeA.m_child2 = indexG;
+			nodeG.m_parent = indexA;
+			GetUnion(nodeA.m_min, nodeA.m_max, nodeB, nodeG);
+			GetUnion(nodeC.m_min, nodeC.m_max, nodeA, nodeF);
+
+			nodeA.m_height = 1 + ((nodeB.m_height > nodeG.m_height) ? nodeB.m_height : nodeG.m_height);
+			nodeC.m_height = 1 + ((nodeA.m_height > nodeF.m_height) ? nodeA.m_height : nodeF.m_height);
+		}
+		else
+		{
+			nodeC.m_child2 = indexG;
+			nodeA.m_child2 = indexF;
+			nodeF.m_parent = indexA;
+			GetUnion(nodeA.m_min, nodeA.m_max, nodeB, nodeF);
+			GetUnion(nodeC.m_min, nodeC.m_max, nodeA, nodeG);
+
+			nodeA.m_height = 1 + ((nodeB.m_height > nodeF.m_height) ? nodeB.m_height : nodeF.m_height);
+			nodeC.m_height = 1 + ((nodeA.m_height > nodeG.m_height) ? nodeA.m_height : nodeG.m_height);
+		}
+
+		return indexC;
+	}
+
+	if (balance < -1)
+	{
+		//Mirror of the above with B going up
+		uint indexD = nodeB.m_child1;
+		uint indexE = nodeB.m_child2;
+		AABBTreeNode_T& nodeD = m_nodes[indexD];
+		AABBTreeNode_T& nodeE = m_nodes[indexE];
+
+		nodeB.m_child1 = indexA;
+		nodeB.m_parent = nodeA.m_parent;
+		nodeA.m_parent = indexB;
+
+		if (nodeB.m_parent == INVALID_BROADPHASE_PROXY)
+		{
+			m_rootIndex = indexB;
+		}
+		else if (m_nodes[nodeB.m_parent].m_child1 == indexA)
+		{
+			m_nodes[nodeB.m_parent].m_child1 = indexB;
+		}
+		else
+		{
+			m_nodes[nodeB.m_parent].m_child2 = indexB;
+		}
+
+		if (nodeD.m_height > nodeE.m_height)
+		{
+			nodeB.m_child2 = indexD;
+			nodeA.m_child1 = indexE;
+			nodeE.m_parent = indexA;
+			GetUnion(nodeA.m_min, nodeA.m_max, nodeC, nodeE);
+			GetUnion(nodeB.m_min, nodeB.m_max, nodeA, nodeD);
+
+			nodeA.m_height = 1 + ((nodeC.m_height > nodeE.m_height) ? nodeC.m_height : nodeE.m_height);
+			nodeB.m_height = 1 + ((nodeA.m_height > nodeD.m_height) ? nodeA.m_height : nodeD.m_height);
+		}
+		else
+		{
+			nodeB.m_child2 = indexE;
+			nodeA.m_child1 = indexD;
+			nodeD.m_parent = indexA;
+			GetUnion(nodeA.m_min, nodeA.m_max, nodeC, nodeD);
+			GetUnion(nodeB.m_min, nodeB.m_max, nodeA, nodeE);
+
+			nodeA.m_height = 1 + ((nodeC.m_height > nodeD.m_height) ? nodeC.m_height : nodeD.m_height);
+			nodeB.m_height = 1 + ((nodeA.m_height > nodeE.m_height) ? nodeA.m_height : nodeE.m_height);
+		}
+
+		return indexB;
+	}
+
+	return indexA;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// UNIT TEST
+//------------------------------------------------------------------------------------------------------------------------------
+static inline uint64_t GetTestPairKey(const BroadphasePair_T& pair)
+{
+	//Fake collider pointers are the proxy slot plus one
+	uint64_t indexA = (uint64_t)(uintptr_t)pair.m_colliderA - 1U;
+	uint64_t indexB = (uint64_t)(uintptr_t)pair.m_colliderB - 1U;
+	return (indexA < indexB) ? (indexA << 32U) | indexB : (indexB << 32U) | indexA;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+UNITTEST("AABBTreeBroadphase", "Physics", 100)
+{
+	constexpr uint NUM_PROXIES = 300U;
+	constexpr uint NUM_ROUNDS = 20U;
+	constexpr float WORLD_SIZE = 40.f;
+
+	AABBTreeBroadphase tree;
+	std::vector<AABB2> bounds(NUM_PROXIES);
+	std::vector<uint> proxyIds(NUM_PROXIES, INVALID_BROADPHASE_PROXY);
+	std::vector<bool> isStatic(NUM_PROXIES);
+
+	uint seed = 4242U;
+	for (uint slot = 0; slot < NUM_PROXIES; ++slot)
+	{
+		seed = seed * 1664525U + 1013904223U;
+		Vec2 position((float)(seed >> 8U) / 16777216.f * WORLD_SIZE, (float)(seed & 0xFFFFU) / 65536.f * WORLD_SIZE);
+		bounds[slot] = AABB2(position, position + Vec2(1.f, 1.5f));
+		isStatic[slot] = (slot % 10U == 0U);
+		proxyIds[slot] = tree.CreateProxy((Collider2D*)(uintptr_t)(slot + 1U), bounds[slot], isStatic[slot]);
+	}
+
+	bool arePairsExact = true;
+	bool areQueriesComplete = true;
+	bool areRaysComplete = true;
+	int maxTreeHeight = 0;
+
+	BroadphasePairList pairs;
+	std::vector<uint64_t> foundKeys;
+	std::vector<Collider2D*> queryResults;
+	for (uint round = 0; round < NUM_ROUNDS; ++round)
+	{
+		//Churn: small moves stay inside the fat bounds, big ones reinsert, and some proxies are destroyed and recreated
+		for (uint slot = 0; slot < NUM_PROXIES; ++slot)
+		{
+			if (isStatic[slot])
+			{
+				continue;
+			}
+
+			seed = seed * 1664525U + 1013904223U;
+			uint action = seed >> 28U;
+			Vec2 step = Vec2((float)((seed >> 8U) & 0xFFU) / 255.f - 0.5f, (float)(seed & 0xFFU) / 255.f - 0.5f);
+			if (action < 8U)
+			{
+				step *= 0.1f;
+			}
+			else if (action < 14U)
+			{
+				step *= 6.f;
+			}
+			else
+			{
+				tree.DestroyProxy(proxyIds[slot]);
+				proxyIds[slot] = INVALID_BROADPHASE_PROXY;
+			}
+
+			bounds[slot] = AABB2(bounds[slot].m_minBounds + step, bounds[slot].m_maxBounds + step);
+			if (proxyIds[slot] == INVALID_BROADPHASE_PROXY)
+			{
+				proxyIds[slot] = tree.CreateProxy((Collider2D*)(uintptr_t)(slot + 1U), bounds[slot], false);
+			}
+			else
+			{
+				tree.MoveProxy(proxyIds[slot], bounds[slot]);
+			}
+		}
+
+		tree.GetCandidatePairs(pairs);
+		maxTreeHeight = (tree.GetTreeHeight() > maxTreeHeight) ? tree.GetTreeHeight() : maxTreeHeight;
+
+		//No pair twice, and every overlapping pair with a dynamic side is there. Fat bounds may add a few more
+		foundKeys.clear();
+		for (const BroadphasePair_T& pair : pairs)
+		{
+			foundKeys.push_back(GetTestPairKey(pair));
+		}
+		std::sort(foundKeys.begin(), foundKeys.end());
+		arePairsExact = arePairsExact && std::adjacent_find(foundKeys.begin(), foundKeys.end()) == foundKeys.end();
+
+		for (uint slotA = 0; slotA < NUM_PROXIES; ++slotA)
+		{
+			for (uint slotB = slotA + 1U; slotB < NUM_PROXIES; ++slotB)
+			{
+				if ((isStatic[slotA] && isStatic[slotB]) || !DoBoundsOverlap(bounds[slotA].m_minBounds, bounds[slotA].m_maxBounds, bounds[slotB].m_minBounds, bounds[slotB].m_maxBounds))
+				{
+					continue;
+				}
+
+				uint64_t key = ((uint64_t)slotA << 32U) | slotB;
+				arePairsExact = arePairsExact && std::binary_search(foundKeys.begin(), foundKeys.end(), key);
+			}
+		}
+
+		//Queries find every proxy whose bounds they touch, once
+		seed = seed * 1664525U + 1013904223U;
+		Vec2 queryMin((float)(seed >> 8U) / 16777216.f * WORLD_SIZE, (float)(seed & 0xFFFFU) / 65536.f * WORLD_SIZE);
+		AABB2 queryBounds(queryMin, queryMin + Vec2(5.f, 3.f));
+		Vec2 rayEnd = queryMin + Vec2(-8.f, 11.f);
+
+		queryResults.clear();
+		tree.QueryAABB(queryBounds, queryResults);
+		std::sort(queryResults.begin(), queryResults.end());
+		areQueriesComplete = areQueriesComplete && std::adjacent_find(queryResults.begin(), queryResults.end()) == queryResults.end();
+		for (uint slot = 0; slot < NUM_PROXIES; ++slot)
+		{
+			if (DoBoundsOverlap(bounds[slot].m_minBounds, bounds[slot].m_maxBounds, queryBounds.m_minBounds, queryBounds.m_maxBounds))
+			{
+				areQueriesComplete = areQueriesComplete && std::binary_search(queryResults.begin(), queryResults.end(), (Collider2D*)(uintptr_t)(slot + 1U));
+			}
+		}
+
+		Vec2 rayDelta = rayEnd - queryMin;
+		Vec2 inverseDelta(1.f / rayDelta.x, 1.f / rayDelta.y);
+		queryResults.clear();
+		tree.QueryRay(queryMin, rayEnd, queryResults);
+		std::sort(queryResults.begin(), queryResults.end());
+		for (uint slot = 0; slot < NUM_PROXIES; ++slot)
+		{
+			if (DoesSegmentHitBounds(queryMin, rayDelta, inverseDelta, bounds[slot].m_minBounds, bounds[slot].m_maxBounds))
+			{
+				areRaysComplete = areRaysComplete && std::binary_search(queryResults.begin(), queryResults.end(), (Collider2D*)(uintptr_t)(slot + 1U));
+			}
+		}
+	}
+
+	CONFIRM(arePairsExact);
+	CONFIRM(areQueriesComplete);
+	CONFIRM(areRaysComplete);
+
+	//Balanced, a list would be hundreds deep
+	CONFIRM(maxTreeHeight <= 20);
+	return true;
+}
@@ -0,0 +1,70 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+#include "Engine/Math/Broadphase2D.hpp"
+#include "Engine/Math/Vec2.hpp"
+
+//------------------------------------------------------------------------------------------------------------------------------
+constexpr float AABB_TREE_FAT_MARGIN = BROADPHASE_QUERY_MARGIN;	//Leaves are this much bigger than their collider on every side
+constexpr float AABB_TREE_DISPLACEMENT_MULTIPLIER = 2.f;	//and stretch ahead in the direction they last moved
+constexpr uint AABB_TREE_QUERY_STACK_SIZE = 256U;			//Queries walk on the stack so they can run in parallel, taller trees walk on the heap
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct AABBTreeNode_T
+{
+	Vec2			m_min;
+	Vec2			m_max;
+
+	uint			m_parent = INVALID_BROADPHASE_PROXY;	//Next free node while the node is on the free list
+	uint			m_child1 = INVALID_BROADPHASE_PROXY;
+	uint			m_child2 = INVALID_BROADPHASE_PROXY;
+	int				m_height = -1;							//0 for leaves, -1 for free nodes
+
+	//Leaves only
+	Collider2D*		m_collider = nullptr;
+	Vec2			m_tightMin;
+	Vec2			m_tightMax;
+	bool			m_isStatic = false;
+	bool			m_hasMoved = false;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Dynamic bounding volume tree. Leaves hold fattened collider bounds so a collider that moves a little doesn't touch the
+// tree at all, one that leaves its fat bounds is pulled out and reinserted and the path above it is refit and rebalanced.
+// Proxy ids are leaf node indices and stay valid until the proxy is destroyed
+//------------------------------------------------------------------------------------------------------------------------------
+class AABBTreeBroadphase : public Broadphase2D
+{
+public:
+	AABBTreeBroadphase();
+	~AABBTreeBroadphase();
+
+	virtual uint				CreateProxy(Collider2D* collider, const AABB2& bounds, bool isStatic) final;
+	virtual void				DestroyProxy(uint proxyId) final;
+	virtual void				MoveProxy(uint proxyId, const AABB2& bounds) final;
+
+	virtual void				GetCandidatePairs(BroadphasePairList& outPairs) final;
+
+	virtual void				QueryAABB(const AABB2& bounds, std::vector<Collider2D*>& outColliders) const final;
+	// Only walks down nodes whose fat bounds the segment passes through
+	virtual void				QueryRay(const Vec2& start, const Vec2& end, std::vector<Collider2D*>& outColliders) const final;
+
+	int							GetTreeHeight() const;
+
+private:
+	uint						AllocateNode();
+	void						FreeNode(uint nodeIndex);
+
+	void						InsertLeaf(uint leafIndex);
+	void						RemoveLeaf(uint leafIndex);
+	uint						Balance(uint nodeIndex);
+	void						RefitAncestors(uint nodeIndex);
+
+	void						QueryPairs(uint leafIndex, BroadphasePairList& outPairs);
+
+private:
+	std::vector<AABBTreeNode_T>	m_nodes;
+	uint						m_rootIndex = INVALID_BROADPHASE_PROXY;
+	uint						m_freeList = INVALID_BROADPHASE_PROXY;
+
+	std::vector<uint>			m_queryStack;
+};
@@ -0,0 +1,54 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+#include "Engine/Math/AABB2.hpp"
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------------
+class Collider2D;
+
+typedef unsigned int uint;
+constexpr uint INVALID_BROADPHASE_PROXY = 0xFFFFFFFFU;
+constexpr float BROADPHASE_QUERY_MARGIN = 0.1f;			//How far past the proxy bounds QueryAABB reaches
+
+//------------------------------------------------------------------------------------------------------------------------------
+// A pair of colliders whose bounds overlap. When one side is dynamic and the other static the dynamic one is m_colliderA
+struct BroadphasePair_T
+{
+	Collider2D*	m_colliderA;
+	Collider2D*	m_colliderB;
+};
+
+typedef std::vector<BroadphasePair_T> BroadphasePairList;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Finds the collider pairs worth handing to the narrowphase (GetCollisionInfo) without testing every pair.
+// PhysicsSystem keeps one proxy per collider and updates its bounds once a step before asking for pairs
+//------------------------------------------------------------------------------------------------------------------------------
+class Broadphase2D
+{
+public:
+	virtual ~Broadphase2D() {}
+
+	virtual uint				CreateProxy(Collider2D* collider, const AABB2& bounds, bool isStatic) = 0;
+	virtual void				DestroyProxy(uint proxyId) = 0;
+
+	// Called every step with the collider's current world bounds
+	virtual void				MoveProxy(uint proxyId, const AABB2& bounds) = 0;
+
+	// Every overlapping pair exactly once. Static vs static pairs are skipped unless one of the two moved since the last call
+	virtual void				GetCandidatePairs(BroadphasePairList& outPairs) = 0;
+
+	// Appends each collider whose proxy bounds grown by BROADPHASE_QUERY_MARGIN touch the box, once. The bounds are from
+	// the last MoveProxy, before the step pushed colliders out of their contacts, the margin still finds them where they
+	// ended up and the caller's exact test throws out the extras. Uses the structure built by the last GetCandidatePairs.
+	// Doesn't change anything so several threads can query at once
+	virtual void				QueryAABB(const AABB2& bounds, std::vector<Collider2D*>& outColliders) const = 0;
+
+	// Appends at least every collider whose proxy bounds the segment crosses. By default that's the segment's bounding box
+	virtual void				QueryRay(const Vec2& start, const Vec2& end, std::vector<Collider2D*>& outColliders) const
+	{
+		Vec2 minBounds(start.x < end.x ? start.x : end.x, start.y < end.y ? start.y : end.y);
+		Vec2 maxBounds(start.x > end.x ? start.x : end.x, start.y > end.y ? start.y : end.y);
+		QueryAABB(AABB2(minBounds, maxBounds), outColliders);
+	}
+};
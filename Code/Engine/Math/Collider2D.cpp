@@ -8,6 +8,12 @@
 #include "Engine/Math/Rigidbody2D.hpp"
 #include "Engine/Math/Trigger2D.hpp"
 
+//------------------------------------------------------------------------------------------------------------------------------
+Collider2D::~Collider2D()
+{
+
+}
+
 //------------------------------------------------------------------------------------------------------------------------------
 bool Collider2D::IsTouching(Collision2D* collision, Collider2D* otherCollider )
 {
@@ -88,10 +94,23 @@ AABB2 AABB2Collider::GetLocalShape() const
 AABB2 AABB2Collider::GetWorldShape() const
 {
 	AABB2 box = GetLocalShape();
-	box.TranslateByVector(m_rigidbody->GetPosition());
+	if (m_rigidbody != nullptr)
+	{
+		box.TranslateByVector(m_rigidbody->GetPosition());
+	}
+	else if (m_trigger != nullptr)
+	{
+		box.TranslateByVector(m_trigger->GetPosition());
+	}
 	return box;
 }
 
+//------------------------------------------------------------------------------------------------------------------------------
+AABB2 AABB2Collider::GetWorldBounds() const
+{
+	return GetWorldShape();
+}
+
 //------------------------------------------------------------------------------------------------------------------------------
 Vec2 AABB2Collider::GetBoxCenter() const
 {
@@ -133,10 +152,26 @@ Disc2D Disc2DCollider::GetLocalShape() const
 Disc2D Disc2DCollider::GetWorldShape() const
 {
 	Disc2D disc = GetLocalShape();
-	disc.TranslateByVector(m_rigidbody->GetPosition());
+	if (m_rigidbody != nullptr)
+	{
+		disc.TranslateByVector(m_rigidbody->GetPosition());
+	}
+	else if (m_trigger != nullptr)
+	{
+		disc.TranslateByVector(m_trigger->GetPosition());
+	}
 	return disc;
 }
 
+//------------------------------------------------------------------------------------------------------------------------------
+AABB2 Disc2DCollider::GetWorldBounds() const
+{
+	Disc2D disc = GetWorldShape();
+	float radius = disc.GetRadius();
+	Vec2 centre = disc.GetCentre();
+	return AABB2(Vec2(centre.x - radius, centre.y - radius), Vec2(centre.x + radius, centre.y + radius));
+}
+
 //------------------------------------------------------------------------------------------------------------------------------
 BoxCollider2D::BoxCollider2D( Vec2 center, Vec2 size /*= Vec2::ZERO*/, float rotationDegrees /*= 0.0f */ )
 {
@@ -156,7 +191,7 @@ void BoxCollider2D::SetMomentForObject()
 	float height = (m_localShape.m_halfExtents.y * 2.f); 
 
 	//0.08333333333 = 1/12 which is what we will need for the Moment of inertia of a box. I avoid the / operation like this 
-	m_rigidbody->m_momentOfInertia = m_rigidbody->m_mass * (1.f/12.f * (width * width + height * height));
+	m_rigidbody->SetMomentOfInertia(m_rigidbody->GetMass() * (1.f/12.f * (width * width + height * height)));
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
@@ -187,6 +222,31 @@ OBB2 BoxCollider2D::GetWorldShape() const
 	return box;
 }
 
+//------------------------------------------------------------------------------------------------------------------------------
+static AABB2 GetOBB2Bounds(const OBB2& box, float padding)
+{
+	Vec2 corners[4];
+	box.GetCorners(corners);
+
+	Vec2 minBounds = corners[0];
+	Vec2 maxBounds = corners[0];
+	for (int cornerIndex = 1; cornerIndex < 4; cornerIndex++)
+	{
+		minBounds.x = (corners[cornerIndex].x < minBounds.x) ? corners[cornerIndex].x : minBounds.x;
+		minBounds.y = (corners[cornerIndex].y < minBounds.y) ? corners[cornerIndex].y : minBounds.y;
+		maxBounds.x = (corners[cornerIndex].x > maxBounds.x) ? corners[cornerIndex].x : maxBounds.x;
+		maxBounds.y = (corners[cornerIndex].y > maxBounds.y) ? corners[cornerIndex].y : maxBounds.y;
+	}
+
+	return AABB2(Vec2(minBounds.x - padding, minBounds.y - padding), Vec2(maxBounds.x + padding, maxBounds.y + padding));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+AABB2 BoxCollider2D::GetWorldBounds() const
+{
+	return GetOBB2Bounds(GetWorldShape(), 0.f);
+}
+
 //------------------------------------------------------------------------------------------------------------------------------
 CapsuleCollider2D::CapsuleCollider2D( Vec2 start, Vec2 end, float radius )
 {
@@ -225,14 +285,16 @@ void CapsuleCollider2D::SetMomentForObject()
 	float height = (m_localShape.m_halfExtents.y * 2.f); 
 
 	//0.08333333333 = 1/12 which is what we will need for the Moment of inertia of a box. I avoid the / operation like this 
-	m_rigidbody->m_momentOfInertia = (0.08333333333f * (width * width + height * height)) * ratioBox * m_rigidbody->m_mass;
+	float mass = m_rigidbody->GetMass();
+	float momentOfInertia = (0.08333333333f * (width * width + height * height)) * ratioBox * mass;
 
 	float offset = GetDistance2D(m_rigidbody->GetPosition(), m_localShape.GetBottomLeft());
 
 	//Disc component
-	m_rigidbody->m_momentOfInertia += 0.5f * m_rigidbody->m_mass * ratioDisc * m_radius * m_radius;
+	momentOfInertia += 0.5f * mass * ratioDisc * m_radius * m_radius;
 	//Point component
-	m_rigidbody->m_momentOfInertia += offset * offset * m_rigidbody->m_mass * ratioDisc;
+	momentOfInertia += offset * offset * mass * ratioDisc;
+	m_rigidbody->SetMomentOfInertia(momentOfInertia);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
@@ -263,6 +325,13 @@ OBB2 CapsuleCollider2D::GetWorldShape() const
 	return box;
 }
 
+//------------------------------------------------------------------------------------------------------------------------------
+AABB2 CapsuleCollider2D::GetWorldBounds() const
+{
+	//The capsule is its core box swept by the radius
+	return GetOBB2Bounds(GetWorldShape(), m_radius);
+}
+
 //------------------------------------------------------------------------------------------------------------------------------
 const Capsule2D& CapsuleCollider2D::GetReferenceShape() const
 {
@@ -2,6 +2,7 @@
 //------------------------------------------------------------------------------------------------------------------------------
 //Engine Systems
 #include "Engine/Math/AABB2.hpp"
+#include "Engine/Math/Broadphase2D.hpp"
 #include "Engine/Math/Capsule2D.hpp"
 #include "Engine/Math/Disc2D.hpp"
 #include "Engine/Math/OBB2.hpp"
@@ -28,9 +29,11 @@ enum eColliderType2D
 class Collider2D
 {
 public:
+	virtual ~Collider2D();
 
 	virtual void				SetMomentForObject() = 0;
 	virtual bool				Contains(Vec2 worldPoint) = 0;
+	virtual AABB2				GetWorldBounds() const = 0;		//Axis aligned box around the world shape, for the broadphase
 
 	void						SetCollision(bool inCollision);
 	void						SetCollisionEvent(const std::string& eventString);
@@ -49,8 +52,11 @@ public:
 
 	bool						m_inCollision = false;
 	bool						m_isAlive = true;
+	bool						m_isPooled = false;			//Made by a PhysicsSystem Create function, goes back to its pool
+	uint						m_layerBits = 1U;			//Scene queries only see the collider if their layer mask shares a bit
 
 	std::string					m_onCollisionEvent = "";
+	uint						m_broadphaseProxy = INVALID_BROADPHASE_PROXY;
 };
 
 //------------------------------------------------------------------------------------------------------------------------------
@@ -62,6 +68,7 @@ public:
 
 	virtual void				SetMomentForObject();
 	virtual bool				Contains(Vec2 worldPoint);
+	virtual AABB2				GetWorldBounds() const;
 
 	AABB2						GetLocalShape() const;		//Shape relative to rigidbody
 	AABB2						GetWorldShape() const;		//Shape in world
@@ -80,6 +87,7 @@ public:
 
 	virtual void				SetMomentForObject();
 	virtual bool				Contains(Vec2 worldPoint);
+	virtual AABB2				GetWorldBounds() const;
 
 	Disc2D						GetLocalShape() const;
 	Disc2D						GetWorldShape() const;
@@ -97,6 +105,7 @@ public:
 
 	virtual void				SetMomentForObject();
 	virtual bool				Contains(Vec2 worldPoint);
+	virtual AABB2				GetWorldBounds() const;
 
 	OBB2						GetLocalShape() const;
 	OBB2						GetWorldShape() const;
@@ -114,6 +123,7 @@ public:
 
 	virtual void				SetMomentForObject();
 	virtual bool				Contains(Vec2 worldPoint);
+	virtual AABB2				GetWorldBounds() const;
 
 	OBB2						GetLocalShape() const;
 	OBB2						GetWorldShape() const;
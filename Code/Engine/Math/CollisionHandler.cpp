@@ -1,21 +1,52 @@
 //------------------------------------------------------------------------------------------------------------------------------
 #include "Engine/Math/CollisionHandler.hpp"
+#include "Engine/Commons/UnitTest.hpp"
+#include "Engine/Core/Time.hpp"
 #include "Engine/Math/Collider2D.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Math/Manifold.hpp"
+#include "Engine/Math/PhysicsSystem.hpp"
+#include "Engine/Math/PhysicsTestHelpers2D.hpp"
 #include "Engine/Math/Plane2D.hpp"
+#include "Engine/Math/Rigidbody2D.hpp"
 #include "Engine/Math/Segment2D.hpp"
 #include "Engine/Renderer/DebugRender.hpp"
 
 //------------------------------------------------------------------------------------------------------------------------------
-CollisionCheck2DCallback COLLISION_LOOKUP_TABLE[COLLIDER2D_COUNT][COLLIDER2D_COUNT] = {
+// One instance per collider pair. The types are known at compile time so the casts are free and the GetManifold overload
+// is picked statically, the table below only stores plain function pointers to these
+//------------------------------------------------------------------------------------------------------------------------------
+template <typename ColliderA, typename ColliderB>
+bool CheckColliderPair( Collision2D* out, Collider2D* a, Collider2D* b )
+{
+	Manifold2D manifold;
+	bool result = GetManifold(&manifold, *static_cast<ColliderA*>(a), *static_cast<ColliderB*>(b));
+
+	if(result)
+	{
+		out->m_Obj = a;
+		out->m_otherObj = b;
+		out->m_manifold = manifold;
+	}
+	else
+	{
+		out->m_Obj = nullptr;
+		out->m_otherObj = nullptr;
+	}
+
+	return result;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Rows and columns follow eColliderType2D, line and point have no collider yet
+const CollisionCheck2DCallback COLLISION_LOOKUP_TABLE[COLLIDER2D_COUNT][COLLIDER2D_COUNT] = {
 	/*******| aabb2 | disc  | capsl | obb2 | line  | point  */
-	/*aabb2*/ { CheckAABB2ByAABB2, CheckAABB2ByDisc, nullptr,				nullptr,			nullptr, nullptr },
-	/*disc */ { CheckDiscByAABB2,  CheckDiscByDisc,  nullptr,				nullptr,			nullptr, nullptr },
-	/*capsl*/ { nullptr,           nullptr,          CheckCapsuleByCapsule, CheckCapsuleByOBB2,	nullptr, nullptr },
-	/*obb2*/  { nullptr,           nullptr,          CheckOBB2ByCapsule,	CheckOBB2ByOBB2,	nullptr, nullptr },
-	/*line*/  { nullptr,           nullptr,          nullptr,				nullptr,			nullptr, nullptr },
-	/*point*/ { nullptr,           nullptr,          nullptr,				nullptr,			nullptr, nullptr },
+	/*aabb2*/ { CheckColliderPair<AABB2Collider, AABB2Collider>,		CheckColliderPair<AABB2Collider, Disc2DCollider>,		CheckColliderPair<AABB2Collider, CapsuleCollider2D>,		CheckColliderPair<AABB2Collider, BoxCollider2D>,		nullptr, nullptr },
+	/*disc */ { CheckColliderPair<Disc2DCollider, AABB2Collider>,		CheckColliderPair<Disc2DCollider, Disc2DCollider>,		CheckColliderPair<Disc2DCollider, CapsuleCollider2D>,		CheckColliderPair<Disc2DCollider, BoxCollider2D>,		nullptr, nullptr },
+	/*capsl*/ { CheckColliderPair<CapsuleCollider2D, AABB2Collider>,	CheckColliderPair<CapsuleCollider2D, Disc2DCollider>,	CheckColliderPair<CapsuleCollider2D, CapsuleCollider2D>,	CheckColliderPair<CapsuleCollider2D, BoxCollider2D>,	nullptr, nullptr },
+	/*obb2*/  { CheckColliderPair<BoxCollider2D, AABB2Collider>,		CheckColliderPair<BoxCollider2D, Disc2DCollider>,		CheckColliderPair<BoxCollider2D, CapsuleCollider2D>,		CheckColliderPair<BoxCollider2D, BoxCollider2D>,		nullptr, nullptr },
+	/*line*/  { nullptr,												nullptr,												nullptr,													nullptr,												nullptr, nullptr },
+	/*point*/ { nullptr,												nullptr,												nullptr,													nullptr,												nullptr, nullptr },
 }; 
 
 //------------------------------------------------------------------------------------------------------------------------------
@@ -27,7 +58,7 @@ bool GetCollisionInfo( Collision2D* out, Collider2D* a, Collider2D* b )
 	uint aType = a->GetType(); 
 	uint bType = b->GetType(); 
 
-	if(aType >= COLLIDER2D_COUNT && bType >= COLLIDER2D_COUNT)
+	if(aType >= COLLIDER2D_COUNT || bType >= COLLIDER2D_COUNT)
 	{
 		ERROR_AND_DIE("The Collider type was not part of the COLLISION_LOOKUP_TABLE");
 	}
@@ -88,57 +119,28 @@ bool GetManifold( Manifold2D *out, AABB2Collider const &boxA, AABB2Collider cons
 //------------------------------------------------------------------------------------------------------------------------------
 bool GetManifold( Manifold2D *out, AABB2Collider const &box, Disc2DCollider const &disc )
 {
-	Vec2 discCentre = disc.GetWorldShape().GetCentre();
-	AABB2 boxShape = box.GetWorldShape();
-	Vec2 closestPoint = GetClosestPointOnAABB2( discCentre, boxShape );
-	Vec2 boxCenter = boxShape.GetBoxCenter() + boxShape.m_minBounds;
-
-	float distanceSquared = GetDistanceSquared2D(discCentre, closestPoint);
-	float radius = disc.GetWorldShape().GetRadius();
-	//float distanceBwCenters = GetDistanceSquared2D(discCentre, boxCenter);
-
-	float distance = 0;
-
-	//Check is box inside disc
-	if(closestPoint == discCentre)
+	//Same test as disc vs box, the normal just has to point at the box instead
+	if (GetManifold(out, disc, box))
 	{
-		//box is inside disc
-		distance = GetDistance2D(discCentre, boxCenter);
-		Vec2 normal = boxCenter - discCentre;
-		normal.Normalize();
-
-		out->m_normal = normal;
-		out->m_penetration = distance;
+		out->m_normal *= -1.f;
 		return true;
 	}
 
-	if(distanceSquared < radius * radius)
-	{
-		//out here
-		distance = GetDistance2D(discCentre, closestPoint);
-		Vec2 normal = closestPoint - discCentre;
-		normal.Normalize();
-
-		out->m_normal = normal;
-		out->m_penetration = radius - distance;
-		return true;
-	}
-	else
-	{
-		return false;
-	}
+	return false;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
 bool GetManifold( Manifold2D *out, Disc2DCollider const &disc, AABB2Collider const &box)
 {
-	Vec2 discCentre = disc.GetWorldShape().GetCentre();
-	AABB2 boxShape = box.GetWorldShape();
+	return GetManifold(out, disc.GetWorldShape().GetCentre(), disc.GetWorldShape().GetRadius(), box.GetWorldShape());
+}
 
+//------------------------------------------------------------------------------------------------------------------------------
+bool GetManifold( Manifold2D *out, Vec2 const &discCentre, float radius, AABB2 const &boxShape )
+{
 	Vec2 closestPoint = GetClosestPointOnAABB2( discCentre, boxShape );
 
 	float distanceSquared = GetDistanceSquared2D(discCentre, closestPoint);
-	float radius = disc.GetWorldShape().GetRadius();
 
 	if(closestPoint == discCentre)
 	{
@@ -761,11 +763,12 @@ bool IsDiscInBox(Manifold2D* out, const Vec2 &discCentre, const AABB2& boxShape,
 //------------------------------------------------------------------------------------------------------------------------------
 bool GetManifold( Manifold2D *out, Disc2DCollider const &discA, Disc2DCollider const &discB )
 {
-	float discARad = discA.GetWorldShape().GetRadius();
-	float discBRad = discB.GetWorldShape().GetRadius();
+	return GetManifold(out, discA.GetWorldShape().GetCentre(), discA.GetWorldShape().GetRadius(), discB.GetWorldShape().GetCentre(), discB.GetWorldShape().GetRadius());
+}
 
-	Vec2 discACenter = discA.GetWorldShape().GetCentre();
-	Vec2 discBCenter = discB.GetWorldShape().GetCentre();
+//------------------------------------------------------------------------------------------------------------------------------
+bool GetManifold( Manifold2D *out, Vec2 const &discACenter, float discARad, Vec2 const &discBCenter, float discBRad )
+{
 	float distanceSquared = GetDistanceSquared2D(discACenter, discBCenter);
 	float radSumSquared = (discARad + discBRad) * (discARad + discBRad);
 
@@ -786,244 +789,278 @@ bool GetManifold( Manifold2D *out, Disc2DCollider const &discA, Disc2DCollider c
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-void GenerateManifoldBoxToBox(Manifold2D* manifold, Vec2 const &min, Vec2 const &max)
+bool GetManifold( Manifold2D *out, AABB2Collider const &a, BoxCollider2D const &b )
 {
-	//Remember since we collided, the max is actually manifold min and min is actually manifold max
-	float boxWidth = min.x - max.x;
-	float boxHeight = min.y - max.y;
-	float minValue = GetLowerValue(boxWidth, boxHeight);
-
-	Vec2 normal;
+	return GetManifold(out, OBB2(a.GetWorldShape()), 0.f, b.GetWorldShape(), 0.f);
+}
 
-	//Where is boxB wrt to boxA
-	if(minValue == boxWidth)
-	{
-		//normal is along X
-		normal = Vec2(1.f, 0.f);
-	}
-	else
-	{
-		//Normal is along Y
-		normal = Vec2(0.f, 1.f);
-	}
+//------------------------------------------------------------------------------------------------------------------------------
+bool GetManifold( Manifold2D *out, BoxCollider2D const &a, AABB2Collider const &b )
+{
+	return GetManifold(out, a.GetWorldShape(), 0.f, OBB2(b.GetWorldShape()), 0.f);
+}
 
-	manifold->m_normal = normal;
-	manifold->m_penetration = minValue;
+//------------------------------------------------------------------------------------------------------------------------------
+bool GetManifold( Manifold2D *out, AABB2Collider const &a, CapsuleCollider2D const &b )
+{
+	return GetManifold(out, OBB2(a.GetWorldShape()), 0.f, b.GetWorldShape(), b.GetCapsuleRadius());
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-bool CheckAABB2ByAABB2(Collision2D* out, Collider2D* a, Collider2D* b)
+bool GetManifold( Manifold2D *out, CapsuleCollider2D const &a, AABB2Collider const &b )
 {
-	//Check collision between 2 boxes
-	AABB2Collider* boxA = reinterpret_cast<AABB2Collider*>(a);
-	AABB2Collider* boxB = reinterpret_cast<AABB2Collider*>(b);
+	return GetManifold(out, a.GetWorldShape(), a.GetCapsuleRadius(), OBB2(b.GetWorldShape()), 0.f);
+}
 
-	Manifold2D manifold;
-	bool result = GetManifold(&manifold, *boxA, *boxB);
+//------------------------------------------------------------------------------------------------------------------------------
+bool GetManifold( Manifold2D *out, Disc2DCollider const &disc, BoxCollider2D const &box )
+{
+	Disc2D discShape = disc.GetWorldShape();
+	return GetManifold(out, discShape.GetCentre(), discShape.GetRadius(), box.GetWorldShape());
+}
 
-	if(result)
-	{
-		//Manifold is valid
-		out->m_Obj = a;
-		out->m_otherObj = b;
-		out->m_manifold = manifold;
-	}
-	else
+//------------------------------------------------------------------------------------------------------------------------------
+bool GetManifold( Manifold2D *out, BoxCollider2D const &box, Disc2DCollider const &disc )
+{
+	if (GetManifold(out, disc, box))
 	{
-		//Invalid manifold as no collision
-		out->m_Obj = nullptr;
-		out->m_otherObj = nullptr;
+		out->m_normal *= -1.f;
+		return true;
 	}
 
-	return result;
+	return false;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-bool CheckAABB2ByDisc(Collision2D* out, Collider2D* a, Collider2D* b)
+bool GetManifold( Manifold2D *out, Disc2DCollider const &disc, CapsuleCollider2D const &capsule )
 {
-	//box vs disc
-	AABB2Collider* boxA = reinterpret_cast<AABB2Collider*>(a);
-	Disc2DCollider* discB = reinterpret_cast<Disc2DCollider*>(b);
+	Disc2D discShape = disc.GetWorldShape();
+	Vec2 discCentre = discShape.GetCentre();
+	float radiusSum = discShape.GetRadius() + capsule.GetCapsuleRadius();
 
-	Manifold2D manifold;
-	bool result = GetManifold(&manifold, *boxA, *discB);
+	//The capsule's box has no width, its bottom left and top right corners are the ends of the bone
+	OBB2 bone = capsule.GetWorldShape();
+	Vec2 boneStart = bone.GetBottomLeft();
+	Vec2 boneEnd = bone.GetTopRight();
 
-	if(result)
+	Vec2 closestPoint = boneStart;
+	if ((boneEnd - boneStart).GetLengthSquared() > 0.f)
 	{
-		out->m_manifold = manifold;
-		out->m_Obj = a;
-		out->m_otherObj = b;
+		closestPoint = GetClosestPointOnLineSegment2D(discCentre, boneStart, boneEnd);
+	}
+
+	float distanceSquared = GetDistanceSquared2D(discCentre, closestPoint);
+	if (distanceSquared >= radiusSum * radiusSum)
+	{
+		return false;
+	}
+
+	float distance = sqrtf(distanceSquared);
+	if (distance > 0.f)
+	{
+		out->m_normal = (discCentre - closestPoint) / distance;
 	}
 	else
 	{
-		out->m_Obj = nullptr;
-		out->m_otherObj = nullptr;
+		//Centre is on the bone, push out sideways
+		out->m_normal = bone.GetRight();
 	}
 
-	return result;
+	out->m_penetration = radiusSum - distance;
+	out->m_contact = closestPoint + out->m_normal * capsule.GetCapsuleRadius();
+	return true;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-bool CheckDiscByDisc(Collision2D* out, Collider2D* a, Collider2D* b)
+bool GetManifold( Manifold2D *out, CapsuleCollider2D const &capsule, Disc2DCollider const &disc )
 {
-	//disc vs disc
-	Disc2DCollider* discA = reinterpret_cast<Disc2DCollider*>(a);
-	Disc2DCollider* discB = reinterpret_cast<Disc2DCollider*>(b);
-
-	Manifold2D manifold;
-	bool result = GetManifold(&manifold, *discA, *discB);
-
-	if(result)
+	if (GetManifold(out, disc, capsule))
 	{
-		// out here
-		out->m_Obj = a;
-		out->m_otherObj = b;
-		out->m_manifold = manifold;
+		out->m_normal *= -1.f;
 		return true;
 	}
-	else
-	{
-		out->m_otherObj = nullptr;
-		out->m_Obj = nullptr;
-		return false;
-	}
+
+	return false;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-bool CheckDiscByAABB2(Collision2D* out, Collider2D* a, Collider2D* b)
+bool GetManifold( Manifold2D *out, Vec2 const &discCentre, float discRadius, OBB2 const &box )
 {
-	//disc vs box
-	Disc2DCollider* discA = reinterpret_cast<Disc2DCollider*>(a);
-	AABB2Collider* boxB = reinterpret_cast<AABB2Collider*>(b);
+	//Solve as disc vs AABB2 in the box's space then rotate the normal back out
+	Vec2 localCentre = box.ToLocalPoint(discCentre);
+	Vec2 halfExtents = box.GetHalfExtents();
+	AABB2 localBox = AABB2(halfExtents * -1.f, halfExtents);
 
-	Manifold2D manifold;
-	bool result = GetManifold(&manifold, *discA, *boxB);
+	Vec2 closestPoint = GetClosestPointOnAABB2(localCentre, localBox);
+	Manifold2D localManifold;
 
-	if(result)
+	if (closestPoint == localCentre)
 	{
-		//out here
-		out->m_Obj = a;
-		out->m_otherObj = b;
-		out->m_manifold = manifold;
-		return true;
+		if (!IsDiscInBox(&localManifold, localCentre, localBox, discRadius))
+		{
+			return false;
+		}
 	}
 	else
 	{
-		out->m_Obj = nullptr;
-		out->m_otherObj = nullptr;
-		return false;
+		float distanceSquared = GetDistanceSquared2D(localCentre, closestPoint);
+		if (distanceSquared >= discRadius * discRadius)
+		{
+			return false;
+		}
+
+		float distance = sqrtf(distanceSquared);
+		localManifold.m_normal = (localCentre - closestPoint) / distance;
+		localManifold.m_penetration = discRadius - distance;
 	}
+
+	out->m_normal = localManifold.m_normal.x * box.GetRight() + localManifold.m_normal.y * box.GetUp();
+	out->m_penetration = localManifold.m_penetration;
+	out->m_contact = box.ToWorldPoint(closestPoint);
+	return true;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-bool CheckOBB2ByOBB2( Collision2D* out, Collider2D* a, Collider2D* b )
+void GenerateManifoldBoxToBox(Manifold2D* manifold, Vec2 const &min, Vec2 const &max)
 {
-	//OBB vs OBB
-	BoxCollider2D* boxA = reinterpret_cast<BoxCollider2D*>(a);
-	BoxCollider2D* boxB = reinterpret_cast<BoxCollider2D*>(b);
+	//Remember since we collided, the max is actually manifold min and min is actually manifold max
+	float boxWidth = min.x - max.x;
+	float boxHeight = min.y - max.y;
+	float minValue = GetLowerValue(boxWidth, boxHeight);
 
-	Manifold2D manifold;
-	bool result = GetManifold(&manifold, *boxA, *boxB);
+	Vec2 normal;
 
-	if(result)
+	//Where is boxB wrt to boxA
+	if(minValue == boxWidth)
 	{
-		//out here
-		out->m_Obj = a;
-		out->m_otherObj = b;
-		out->m_manifold = manifold;
-		return true;
+		//normal is along X
+		normal = Vec2(1.f, 0.f);
 	}
 	else
 	{
-		out->m_Obj = nullptr;
-		out->m_otherObj = nullptr;
-		return false;
+		//Normal is along Y
+		normal = Vec2(0.f, 1.f);
 	}
+
+	manifold->m_normal = normal;
+	manifold->m_penetration = minValue;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-bool CheckCapsuleByCapsule( Collision2D * out, Collider2D * a, Collider2D * b )
+void Collision2D::InvertCollision()
 {
-	//Capsule vs Capsule
-	CapsuleCollider2D* capA = reinterpret_cast<CapsuleCollider2D*>(a);
-	CapsuleCollider2D* capB = reinterpret_cast<CapsuleCollider2D*>(b);
-
-	Manifold2D manifold;
-	bool result = GetManifold(&manifold, *capA, *capB);
+	Collider2D* col = m_Obj;
+	m_Obj = m_otherObj;
+	m_otherObj = col;
+	m_manifold.m_normal *= -1.f;
+}
 
-	if(result)
-	{
-		//out here
-		out->m_Obj = a;
-		out->m_otherObj = b;
-		out->m_manifold = manifold;
-		return true;
-	}
-	else
+//------------------------------------------------------------------------------------------------------------------------------
+static void MakeDispatchTestColliders(PhysicsSystem& system, Collider2D** outCollidersA, Collider2D** outCollidersB, const Vec2& positionA, const Vec2& positionB)
+{
+	for (int typeIndex = 0; typeIndex < NUM_COLLIDER_TYPES; ++typeIndex)
 	{
-		out->m_Obj = nullptr;
-		out->m_otherObj = nullptr;
-		return false;
+		outCollidersA[typeIndex] = MakeTestCollider(system, (eColliderType2D)typeIndex, positionA, Vec2(1.f, 1.f), 30.f);
+		outCollidersB[typeIndex] = MakeTestCollider(system, (eColliderType2D)typeIndex, positionB, Vec2(1.f, 1.f), 30.f);
 	}
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-bool CheckCapsuleByOBB2( Collision2D* out, Collider2D* a, Collider2D* b )
+UNITTEST("CollisionDispatch", "Physics", 100)
 {
-	//Capsule vs OBB2
-	CapsuleCollider2D* capA = reinterpret_cast<CapsuleCollider2D*>(a);
-	BoxCollider2D* boxB = reinterpret_cast<BoxCollider2D*>(b);
+	PhysicsSystem system(BROADPHASE_BRUTE_FORCE);
 
-	Manifold2D manifold;
-	bool result = GetManifold(&manifold, *capA, *boxB);
+	Vec2 positionA = Vec2::ZERO;
+	Vec2 positionB = Vec2(0.3f, 0.2f);
 
-	if(result)
+	Collider2D* collidersA[NUM_COLLIDER_TYPES];
+	Collider2D* collidersB[NUM_COLLIDER_TYPES];
+	MakeDispatchTestColliders(system, collidersA, collidersB, positionA, positionB);
+
+	//Every pair overlaps and pushes A away from B
+	bool allPairsHit = true;
+	for (int typeA = 0; typeA < NUM_COLLIDER_TYPES; ++typeA)
 	{
-		//out here
-		out->m_Obj = a;
-		out->m_otherObj = b;
-		out->m_manifold = manifold;
-		return true;
+		for (int typeB = 0; typeB < NUM_COLLIDER_TYPES; ++typeB)
+		{
+			Collision2D collision;
+			bool isTouching = COLLISION_LOOKUP_TABLE[typeA][typeB] != nullptr && GetCollisionInfo(&collision, collidersA[typeA], collidersB[typeB]);
+			if (!isTouching || collision.m_manifold.m_penetration <= 0.f || GetDotProduct(collision.m_manifold.m_normal, positionA - positionB) <= 0.f)
+			{
+				allPairsHit = false;
+			}
+		}
 	}
-	else
+
+	for (int typeIndex = 0; typeIndex < NUM_COLLIDER_TYPES; ++typeIndex)
 	{
-		out->m_Obj = nullptr;
-		out->m_otherObj = nullptr;
-		return false;
+		system.DestroyRigidbody(collidersA[typeIndex]->m_rigidbody);
+		system.DestroyRigidbody(collidersB[typeIndex]->m_rigidbody);
 	}
+
+	CONFIRM(allPairsHit);
+	return true;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-bool CheckOBB2ByCapsule( Collision2D* out, Collider2D* a, Collider2D* b )
+UNITTEST("CollisionDispatch", "PhysicsBenchmark", 100)
 {
-	//OBB2 vs Capsule
-	BoxCollider2D* boxA = reinterpret_cast<BoxCollider2D*>(a);
-	CapsuleCollider2D* capB = reinterpret_cast<CapsuleCollider2D*>(b);
+	PhysicsSystem system(BROADPHASE_BRUTE_FORCE);
 
-	Manifold2D manifold;
-	bool result = GetManifold(&manifold, *boxA, *capB);
+	Collider2D* collidersA[NUM_COLLIDER_TYPES];
+	Collider2D* collidersB[NUM_COLLIDER_TYPES];
+	MakeDispatchTestColliders(system, collidersA, collidersB, Vec2::ZERO, Vec2(0.3f, 0.2f));
 
-	if(result)
+	//Same pairs through the table and through type erased wrappers of the same functions, the difference is the dispatch
+	constexpr int NUM_ITERATIONS = 10000;
+	std::function<bool(Collision2D*, Collider2D*, Collider2D*)> typeErasedTable[NUM_COLLIDER_TYPES][NUM_COLLIDER_TYPES];
+	for (int typeA = 0; typeA < NUM_COLLIDER_TYPES; ++typeA)
 	{
-		//out here
-		out->m_Obj = a;
-		out->m_otherObj = b;
-		out->m_manifold = manifold;
-		return true;
+		for (int typeB = 0; typeB < NUM_COLLIDER_TYPES; ++typeB)
+		{
+			typeErasedTable[typeA][typeB] = COLLISION_LOOKUP_TABLE[typeA][typeB];
+		}
 	}
-	else
+
+	uint pointerHits = 0U;
+	double startTime = GetCurrentTimeSeconds();
+	for (int iteration = 0; iteration < NUM_ITERATIONS; ++iteration)
 	{
-		out->m_Obj = nullptr;
-		out->m_otherObj = nullptr;
-		return false;
+		for (int typeA = 0; typeA < NUM_COLLIDER_TYPES; ++typeA)
+		{
+			for (int typeB = 0; typeB < NUM_COLLIDER_TYPES; ++typeB)
+			{
+				Collision2D collision;
+				pointerHits += GetCollisionInfo(&collision, collidersA[typeA], collidersB[typeB]) ? 1U : 0U;
+			}
+		}
 	}
-}
+	double pointerSeconds = GetCurrentTimeSeconds() - startTime;
 
-//------------------------------------------------------------------------------------------------------------------------------
-void Collision2D::InvertCollision()
-{
-	Collider2D* col = m_Obj;
-	m_Obj = m_otherObj;
-	m_otherObj = col;
-	m_manifold.m_normal *= -1.f;
+	uint typeErasedHits = 0U;
+	startTime = GetCurrentTimeSeconds();
+	for (int iteration = 0; iteration < NUM_ITERATIONS; ++iteration)
+	{
+		for (int typeA = 0; typeA < NUM_COLLIDER_TYPES; ++typeA)
+		{
+			for (int typeB = 0; typeB < NUM_COLLIDER_TYPES; ++typeB)
+			{
+				Collision2D collision;
+				typeErasedHits += typeErasedTable[collidersA[typeA]->GetType()][collidersB[typeB]->GetType()](&collision, collidersA[typeA], collidersB[typeB]) ? 1U : 0U;
+			}
+		}
+	}
+	double typeErasedSeconds = GetCurrentTimeSeconds() - startTime;
+
+	DebuggerPrintf("\n Collision dispatch %d pair tests: function pointer table %.3f ms, std::function table %.3f ms", 
+		NUM_ITERATIONS * NUM_COLLIDER_TYPES * NUM_COLLIDER_TYPES, pointerSeconds * 1000.0, typeErasedSeconds * 1000.0);
+
+	for (int typeIndex = 0; typeIndex < NUM_COLLIDER_TYPES; ++typeIndex)
+	{
+		system.DestroyRigidbody(collidersA[typeIndex]->m_rigidbody);
+		system.DestroyRigidbody(collidersB[typeIndex]->m_rigidbody);
+	}
+
+	CONFIRM(pointerHits == typeErasedHits);
+	return true;
 }
@@ -6,9 +6,11 @@
 #include "Engine/Math/Manifold.hpp"
 
 #include <functional>
+#include <vector>
 
 typedef unsigned int uint;
 class Collider2D;
+class Rigidbody2D;
 class AABB2Collider;
 class Disc2DCollider;
 class BoxCollider2D;
@@ -27,19 +29,23 @@ struct Collision2D
 	void InvertCollision();
 };
 
-typedef std::function<bool(Collision2D* out, Collider2D* a, Collider2D* b)> CollisionCheck2DCallback ;
-// 2D arrays are [Y][X] remember
-extern CollisionCheck2DCallback COLLISION_LOOKUP_TABLE[][COLLIDER2D_COUNT];
+//------------------------------------------------------------------------------------------------------------------------------
+// A touching pair found by the batched narrowphase, waiting to be resolved
+//------------------------------------------------------------------------------------------------------------------------------
+struct NarrowphaseContact_T
+{
+	Rigidbody2D*	m_bodyA = nullptr;
+	Rigidbody2D*	m_bodyB = nullptr;
+	Collision2D		m_collision;
+};
+
+typedef std::vector<NarrowphaseContact_T> NarrowphaseContactList;
+
+typedef bool (*CollisionCheck2DCallback)(Collision2D* out, Collider2D* a, Collider2D* b);
+// 2D arrays are [Y][X] remember. Every pair of collider types has an entry
+extern const CollisionCheck2DCallback COLLISION_LOOKUP_TABLE[][COLLIDER2D_COUNT];
 
 //------------------------------------------------------------------------------------------------------------------------------
-bool				CheckAABB2ByAABB2(Collision2D* out, Collider2D* a, Collider2D* b );
-bool				CheckAABB2ByDisc(Collision2D* out, Collider2D* a, Collider2D* b );
-bool				CheckDiscByDisc(Collision2D* out, Collider2D* a, Collider2D* b );
-bool				CheckDiscByAABB2(Collision2D* out, Collider2D* a, Collider2D* b );
-bool				CheckOBB2ByOBB2(Collision2D* out, Collider2D* a, Collider2D* b);
-bool				CheckCapsuleByCapsule(Collision2D* out, Collider2D* a, Collider2D* b);
-bool				CheckCapsuleByOBB2(Collision2D* out, Collider2D* a, Collider2D* b);
-bool				CheckOBB2ByCapsule(Collision2D* out, Collider2D* a, Collider2D* b);
 bool				GetCollisionInfo( Collision2D *out, Collider2D * a, Collider2D *b );
 
 //------------------------------------------------------------------------------------------------------------------------------
@@ -49,6 +55,8 @@ bool				GetManifold( Manifold2D *out, AABB2Collider const &obj0, AABB2Collider c
 bool				GetManifold( Manifold2D *out, AABB2Collider const &obj0, Disc2DCollider const &obj1 ); 
 bool				GetManifold( Manifold2D *out, Disc2DCollider const &obj0, Disc2DCollider const &obj1 );
 bool				GetManifold( Manifold2D *out, Disc2DCollider const &disc, AABB2Collider const &box );
+bool				GetManifold( Manifold2D *out, Vec2 const &discACentre, float discARadius, Vec2 const &discBCentre, float discBRadius );
+bool				GetManifold( Manifold2D *out, Vec2 const &discCentre, float discRadius, AABB2 const &box );
 
 //------------------------------------------------------------------------------------------------------------------------------
 //OBB to OBB and Pillbox to Pillbox collisions
@@ -65,6 +73,19 @@ bool				GetManifold( Manifold2D *out, CapsuleCollider2D const &a, CapsuleCollide
 bool				GetManifold( Manifold2D *out, BoxCollider2D const &a, CapsuleCollider2D const &b );
 bool				GetManifold( Manifold2D *out, CapsuleCollider2D const &a, BoxCollider2D const &b );
 
+//------------------------------------------------------------------------------------------------------------------------------
+//Mixed pairs, AABB2s are treated as unrotated OBBs and discs are solved in the other shape's space
+//------------------------------------------------------------------------------------------------------------------------------
+bool				GetManifold( Manifold2D *out, AABB2Collider const &a, BoxCollider2D const &b );
+bool				GetManifold( Manifold2D *out, BoxCollider2D const &a, AABB2Collider const &b );
+bool				GetManifold( Manifold2D *out, AABB2Collider const &a, CapsuleCollider2D const &b );
+bool				GetManifold( Manifold2D *out, CapsuleCollider2D const &a, AABB2Collider const &b );
+bool				GetManifold( Manifold2D *out, Disc2DCollider const &disc, BoxCollider2D const &box );
+bool				GetManifold( Manifold2D *out, BoxCollider2D const &box, Disc2DCollider const &disc );
+bool				GetManifold( Manifold2D *out, Disc2DCollider const &disc, CapsuleCollider2D const &capsule );
+bool				GetManifold( Manifold2D *out, CapsuleCollider2D const &capsule, Disc2DCollider const &disc );
+bool				GetManifold( Manifold2D *out, Vec2 const &discCentre, float discRadius, OBB2 const &box );
+
 bool				IsDiscInBox( Manifold2D* out, const Vec2 &discCentre, const AABB2& boxShape, float radius );
 
 //------------------------------------------------------------------------------------------------------------------------------
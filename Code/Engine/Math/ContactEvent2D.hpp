@@ -0,0 +1,40 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+#include "Engine/Math/Vec2.hpp"
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------------
+class Collider2D;
+
+typedef unsigned int uint;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// One contact found during a physics step. Plain data so a step's worth can be appended to one buffer and handed to the
+// listeners in a single call once the step is done. The normal points from B to A
+//------------------------------------------------------------------------------------------------------------------------------
+struct ContactEvent2D_T
+{
+	Collider2D*		m_colliderA = nullptr;
+	Collider2D*		m_colliderB = nullptr;
+	uint			m_bodyIdA = 0U;						//Rigidbody2D::m_bodyId
+	uint			m_bodyIdB = 0U;
+
+	Vec2			m_normal = Vec2::ZERO;
+	Vec2			m_point = Vec2::ZERO;
+	float			m_penetration = 0.f;
+	float			m_normalImpulse = 0.f;				//0 when the pass that found the contact didn't resolve it
+};
+
+typedef std::vector<ContactEvent2D_T> ContactEventList;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Called once per step with every contact from that step. Mark bodies dead from here rather than deleting them, later
+// events in the buffer can still point at them
+typedef void (*ContactEventCallbackFn)(const ContactEvent2D_T* contactEvents, uint numEvents, void* userData);
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct ContactListener_T
+{
+	ContactEventCallbackFn	m_callback = nullptr;
+	void*					m_userData = nullptr;
+};
@@ -0,0 +1,506 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Math/ContactSolver2D.hpp"
+#include "Engine/Math/Collider2D.hpp"
+#include "Engine/Math/CollisionHandler.hpp"
+#include "Engine/Commons/UnitTest.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/PhysicsSystem.hpp"
+#include "Engine/Math/PhysicsTestHelpers2D.hpp"
+#include "Engine/Math/Rigidbody2D.hpp"
+#include <algorithm>
+#include <float.h>
+#include <math.h>
+
+//------------------------------------------------------------------------------------------------------------------------------
+static inline uint64_t GetManifoldKey(uint bodyIdA, uint bodyIdB)
+{
+	//Lower id first so the pair finds last step's contact whichever way round the narrowphase handed it over
+	if (bodyIdA > bodyIdB)
+	{
+		return ((uint64_t)bodyIdB << 32) | (uint64_t)bodyIdA;
+	}
+	return ((uint64_t)bodyIdA << 32) | (uint64_t)bodyIdB;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static inline uint64_t GetManifoldKey(const Rigidbody2D* bodyA, const Rigidbody2D* bodyB)
+{
+	return GetManifoldKey(bodyA->m_bodyId, bodyB->m_bodyId);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static inline float GetCross(const Vec2& a, const Vec2& b)
+{
+	return a.x * b.y - a.y * b.x;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static inline float GetEffectiveMass(const SolverBody2D_T& bodyA, const SolverBody2D_T& bodyB, const Vec2& toPointA, const Vec2& toPointB, const Vec2& direction)
+{
+	float crossA = GetCross(toPointA, direction);
+	float crossB = GetCross(toPointB, direction);
+
+	float inverseMass = direction.x * direction.x * (bodyA.m_inverseMass.x + bodyB.m_inverseMass.x)
+		+ direction.y * direction.y * (bodyA.m_inverseMass.y + bodyB.m_inverseMass.y)
+		+ bodyA.m_inverseInertia * crossA * crossA
+		+ bodyB.m_inverseInertia * crossB * crossB;
+
+	return (inverseMass > 0.f) ? 1.f / inverseMass : 0.f;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static inline Vec2 GetRelativeVelocity(const SolverBody2D_T& bodyA, const SolverBody2D_T& bodyB, const Vec2& toPointA, const Vec2& toPointB)
+{
+	Vec2 velocityA = bodyA.m_velocity + bodyA.m_angularVelocity * toPointA.GetRotated90Degrees();
+	Vec2 velocityB = bodyB.m_velocity + bodyB.m_angularVelocity * toPointB.GetRotated90Degrees();
+	return velocityA - velocityB;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static inline void ApplyImpulse(SolverBody2D_T& bodyA, SolverBody2D_T& bodyB, const Vec2& toPointA, const Vec2& toPointB, const Vec2& impulse)
+{
+	//A is pushed along the impulse, B the opposite way
+	bodyA.m_velocity += impulse * bodyA.m_inverseMass;
+	bodyA.m_angularVelocity += bodyA.m_inverseInertia * GetCross(toPointA, impulse);
+
+	bodyB.m_velocity -= impulse * bodyB.m_inverseMass;
+	bodyB.m_angularVelocity -= bodyB.m_inverseInertia * GetCross(toPointB, impulse);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+ContactSolver2D::ContactSolver2D(const ContactSolverSettings_T& settings /*= ContactSolverSettings_T()*/)
+{
+	m_settings = settings;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+ContactSolver2D::~ContactSolver2D()
+{
+
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint ContactSolver2D::GetFeatureId(const Vec2& normal)
+{
+	float turns = (atan2f(normal.y, normal.x) + PI) / (2.f * PI);
+	return (uint)(turns * (float)CONTACT_FEATURE_SECTORS) % CONTACT_FEATURE_SECTORS;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool ContactSolver2D::AddContact(Rigidbody2D* bodyA, Rigidbody2D* bodyB, const Collision2D& collision)
+{
+	if (collision.m_manifold.m_normal == Vec2::ZERO)
+	{
+		return false;
+	}
+
+	ContactManifold2D_T manifold;
+	manifold.m_bodyA = bodyA;
+	manifold.m_bodyB = bodyB;
+	manifold.m_solverBodyA = GetSolverBody(bodyA);
+	manifold.m_solverBodyB = GetSolverBody(bodyB);
+
+	manifold.m_normal = collision.m_manifold.m_normal;
+	manifold.m_point = collision.m_manifold.m_contact;
+	manifold.m_penetration = collision.m_manifold.m_penetration;
+	//The feature is kept for the normal pointing at the lower id body, so flipping the pair order flips the normal back.
+	//The impulses need no flip, swapping A and B and negating the normal apply the same push to each body
+	bool isPairFlipped = bodyA->m_bodyId > bodyB->m_bodyId;
+	manifold.m_featureId = GetFeatureId(isPairFlipped ? manifold.m_normal * -1.f : manifold.m_normal);
+	manifold.m_friction = sqrtf(fabsf(bodyA->m_friction * bodyB->m_friction));
+	manifold.m_restitution = bodyA->m_material.restitution * bodyB->m_material.restitution;
+
+	if (m_settings.m_warmStarting)
+	{
+		const WarmStartContact2D_T* previous = FindWarmStartContact(bodyA, bodyB);
+		if (previous != nullptr && previous->m_featureId == manifold.m_featureId)
+		{
+			manifold.m_normalImpulse = previous->m_normalImpulse;
+			manifold.m_tangentImpulse = previous->m_tangentImpulse;
+		}
+	}
+
+	m_manifolds.push_back(manifold);
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void ContactSolver2D::Solve(float deltaTime, ContactEventList* outEvents /*= nullptr*/)
+{
+	PrepareContacts();
+
+	if (m_settings.m_warmStarting)
+	{
+		WarmStart();
+	}
+
+	for (uint iteration = 0; iteration < m_settings.m_velocityIterations; ++iteration)
+	{
+		SolveVelocities();
+	}
+
+	StoreVelocities(deltaTime);
+
+	for (uint iteration = 0; iteration < m_settings.m_positionIterations; ++iteration)
+	{
+		SolvePositions();
+	}
+
+	if (outEvents != nullptr)
+	{
+		for (const ContactManifold2D_T& manifold : m_manifolds)
+		{
+			ContactEvent2D_T contactEvent;
+			contactEvent.m_colliderA = manifold.m_bodyA->m_collider;
+			contactEvent.m_colliderB = manifold.m_bodyB->m_collider;
+			contactEvent.m_bodyIdA = manifold.m_bodyA->m_bodyId;
+			contactEvent.m_bodyIdB = manifold.m_bodyB->m_bodyId;
+			contactEvent.m_normal = manifold.m_normal;
+			contactEvent.m_point = manifold.m_point;
+			contactEvent.m_penetration = manifold.m_penetration;
+			contactEvent.m_normalImpulse = manifold.m_normalImpulse;
+			outEvents->push_back(contactEvent);
+		}
+	}
+
+	//Whatever wasn't touched this step is dropped, the rest seeds the next step's warm start
+	m_warmStartContacts.clear();
+	for (const ContactManifold2D_T& manifold : m_manifolds)
+	{
+		uint bodyIdA = manifold.m_bodyA->m_bodyId;
+		uint bodyIdB = manifold.m_bodyB->m_bodyId;
+		m_warmStartContacts.push_back(WarmStartContact2D_T{ (bodyIdA < bodyIdB) ? bodyIdA : bodyIdB, (bodyIdA < bodyIdB) ? bodyIdB : bodyIdA, manifold.m_featureId, manifold.m_normalImpulse, manifold.m_tangentImpulse });
+	}
+
+	std::sort(m_warmStartContacts.begin(), m_warmStartContacts.end(), [](const WarmStartContact2D_T& lhs, const WarmStartContact2D_T& rhs)
+	{
+		return GetManifoldKey(lhs.m_bodyIdA, lhs.m_bodyIdB) < GetManifoldKey(rhs.m_bodyIdA, rhs.m_bodyIdB);
+	});
+
+	m_manifolds.clear();
+	m_solverBodies.clear();
+	m_solverBodyLookup.clear();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void ContactSolver2D::SetWarmStartContacts(const WarmStartContact2D_T* contacts, uint numContacts)
+{
+	m_warmStartContacts.assign(contacts, contacts + numContacts);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+const WarmStartContact2D_T* ContactSolver2D::FindWarmStartContact(const Rigidbody2D* bodyA, const Rigidbody2D* bodyB) const
+{
+	uint64_t key = GetManifoldKey(bodyA, bodyB);
+	std::vector<WarmStartContact2D_T>::const_iterator previous = std::lower_bound(m_warmStartContacts.begin(), m_warmStartContacts.end(), key, [](const WarmStartContact2D_T& contact, uint64_t searchKey)
+	{
+		return GetManifoldKey(contact.m_bodyIdA, contact.m_bodyIdB) < searchKey;
+	});
+
+	if (previous == m_warmStartContacts.end() || GetManifoldKey(previous->m_bodyIdA, previous->m_bodyIdB) != key)
+	{
+		return nullptr;
+	}
+
+	return &(*previous);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint ContactSolver2D::GetSolverBody(Rigidbody2D* body)
+{
+	std::unordered_map<Rigidbody2D*, uint>::const_iterator existing = m_solverBodyLookup.find(body);
+	if (existing != m_solverBodyLookup.end())
+	{
+		return existing->second;
+	}
+
+	SolverBody2D_T solverBody;
+	solverBody.m_body = body;
+	solverBody.m_isDynamic = (body->GetSimulationType() == DYNAMIC_SIMULATION);
+
+	if (solverBody.m_isDynamic)
+	{
+		//Rigidbody2D keeps angular velocity in degrees, the solver works in radians
+		solverBody.m_velocity = body->GetVelocity();
+		solverBody.m_angularVelocity = DegreesToRadians(body->GetAngularVelocity());
+		solverBody.m_startVelocity = solverBody.m_velocity;
+		solverBody.m_startAngularVelocity = solverBody.m_angularVelocity;
+
+		//Locked axes get no inverse mass so no impulse can move them
+		if (body->GetMass() > 0.f)
+		{
+			solverBody.m_inverseMass = Vec2(body->GetConstraints().x, body->GetConstraints().y) / body->GetMass();
+		}
+
+		if (body->GetMomentOfInertia() > 0.f && body->GetConstraints().z != 0.f)
+		{
+			solverBody.m_inverseInertia = body->GetConstraints().z / body->GetMomentOfInertia();
+		}
+	}
+
+	uint solverIndex = (uint)m_solverBodies.size();
+	m_solverBodies.push_back(solverBody);
+	m_solverBodyLookup[body] = solverIndex;
+	return solverIndex;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void ContactSolver2D::PrepareContacts()
+{
+	for (ContactManifold2D_T& manifold : m_manifolds)
+	{
+		const SolverBody2D_T& bodyA = m_solverBodies[manifold.m_solverBodyA];
+		const SolverBody2D_T& bodyB = m_solverBodies[manifold.m_solverBodyB];
+
+		manifold.m_startPositionA = manifold.m_bodyA->GetPosition();
+		manifold.m_startPositionB = manifold.m_bodyB->GetPosition();
+		manifold.m_toPointA = manifold.m_point - manifold.m_startPositionA;
+		manifold.m_toPointB = manifold.m_point - manifold.m_startPositionB;
+
+		Vec2 tangent = manifold.m_normal.GetRotated90Degrees();
+		manifold.m_normalMass = GetEffectiveMass(bodyA, bodyB, manifold.m_toPointA, manifold.m_toPointB, manifold.m_normal);
+		manifold.m_tangentMass = GetEffectiveMass(bodyA, bodyB, manifold.m_toPointA, manifold.m_toPointB, tangent);
+
+		//Bounce off the closing speed we arrived with, slow contacts are treated as resting
+		float closingSpeed = GetDotProduct(GetRelativeVelocity(bodyA, bodyB, manifold.m_toPointA, manifold.m_toPointB), manifold.m_normal);
+		manifold.m_velocityBias = (closingSpeed < -m_settings.m_restitutionThreshold) ? -manifold.m_restitution * closingSpeed : 0.f;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void ContactSolver2D::WarmStart()
+{
+	for (const ContactManifold2D_T& manifold : m_manifolds)
+	{
+		Vec2 tangent = manifold.m_normal.GetRotated90Degrees();
+		Vec2 impulse = manifold.m_normal * manifold.m_normalImpulse + tangent * manifold.m_tangentImpulse;
+
+		ApplyImpulse(m_solverBodies[manifold.m_solverBodyA], m_solverBodies[manifold.m_solverBodyB], manifold.m_toPointA, manifold.m_toPointB, impulse);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void ContactSolver2D::SolveVelocities()
+{
+	for (ContactManifold2D_T& manifold : m_manifolds)
+	{
+		SolverBody2D_T& bodyA = m_solverBodies[manifold.m_solverBodyA];
+		SolverBody2D_T& bodyB = m_solverBodies[manifold.m_solverBodyB];
+		Vec2 tangent = manifold.m_normal.GetRotated90Degrees();
+
+		//Friction first, it is bounded by the normal impulse from the last iteration
+		float tangentSpeed = GetDotProduct(GetRelativeVelocity(bodyA, bodyB, manifold.m_toPointA, manifold.m_toPointB), tangent);
+		float maxFriction = manifold.m_friction * manifold.m_normalImpulse;
+		float oldTangentImpulse = manifold.m_tangentImpulse;
+		manifold.m_tangentImpulse = Clamp(oldTangentImpulse - manifold.m_tangentMass * tangentSpeed, -maxFriction, maxFriction);
+		ApplyImpulse(bodyA, bodyB, manifold.m_toPointA, manifold.m_toPointB, tangent * (manifold.m_tangentImpulse - oldTangentImpulse));
+
+		//Clamp the accumulated impulse rather than each delta so earlier iterations can be partly undone
+		float normalSpeed = GetDotProduct(GetRelativeVelocity(bodyA, bodyB, manifold.m_toPointA, manifold.m_toPointB), manifold.m_normal);
+		float oldNormalImpulse = manifold.m_normalImpulse;
+		manifold.m_normalImpulse = GetHigherValue(oldNormalImpulse + manifold.m_normalMass * (manifold.m_velocityBias - normalSpeed), 0.f);
+		ApplyImpulse(bodyA, bodyB, manifold.m_toPointA, manifold.m_toPointB, manifold.m_normal * (manifold.m_normalImpulse - oldNormalImpulse));
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void ContactSolver2D::StoreVelocities(float deltaTime)
+{
+	for (const SolverBody2D_T& solverBody : m_solverBodies)
+	{
+		if (!solverBody.m_isDynamic)
+		{
+			continue;
+		}
+
+		Rigidbody2D* body = solverBody.m_body;
+		body->SetVelocity(solverBody.m_velocity);
+		body->SetAngularVelocity(RadiansToDegrees(solverBody.m_angularVelocity));
+
+		//Bodies were already moved with their old velocities this step. Redo that part with the solved ones, otherwise
+		//a resting body sinks by gravity * dt^2 every step and only the position iterations pull it back out
+		Vec2 velocityChange = solverBody.m_velocity - solverBody.m_startVelocity;
+		float angularVelocityChange = solverBody.m_angularVelocity - solverBody.m_startAngularVelocity;
+
+		body->SetPosition(body->GetPosition() + velocityChange * deltaTime);
+		if (angularVelocityChange != 0.f)
+		{
+			body->SetRotation(body->GetRotation() + RadiansToDegrees(angularVelocityChange) * deltaTime);
+			body->ApplyRotation();
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void ContactSolver2D::SolvePositions()
+{
+	//Positions move straight to the bodies, the narrowphase isn't rerun so penetration is tracked from how far they moved
+	for (const ContactManifold2D_T& manifold : m_manifolds)
+	{
+		const SolverBody2D_T& bodyA = m_solverBodies[manifold.m_solverBodyA];
+		const SolverBody2D_T& bodyB = m_solverBodies[manifold.m_solverBodyB];
+		Vec2 positionA = manifold.m_bodyA->GetPosition();
+		Vec2 positionB = manifold.m_bodyB->GetPosition();
+
+		Vec2 relativeMovement = (positionA - manifold.m_startPositionA) - (positionB - manifold.m_startPositionB);
+		float penetration = manifold.m_penetration - GetDotProduct(relativeMovement, manifold.m_normal);
+		float correction = Clamp(m_settings.m_baumgarte * (penetration - m_settings.m_linearSlop), 0.f, m_settings.m_maxCorrection);
+
+		const Vec2& normal = manifold.m_normal;
+		float inverseMass = normal.x * normal.x * (bodyA.m_inverseMass.x + bodyB.m_inverseMass.x) + normal.y * normal.y * (bodyA.m_inverseMass.y + bodyB.m_inverseMass.y);
+		if (correction <= 0.f || inverseMass <= 0.f)
+		{
+			continue;
+		}
+
+		Vec2 push = normal * (correction / inverseMass);
+		manifold.m_bodyA->SetPosition(positionA + push * bodyA.m_inverseMass);
+		manifold.m_bodyB->SetPosition(positionB - push * bodyB.m_inverseMass);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// UNIT TEST
+//------------------------------------------------------------------------------------------------------------------------------
+UNITTEST("ContactSolverStack", "Physics", 100)
+{
+	constexpr uint NUM_BOXES = 10U;
+	constexpr uint SETTLE_STEPS = 240U;
+	constexpr uint WATCH_STEPS = 120U;
+	constexpr float STEP = 1.f / 60.f;
+
+	//Default settings, so warm starting and the accumulated impulse clamps are on
+	PhysicsSystem system(BROADPHASE_AABB_TREE);
+	system.EnableContactSolver();
+	std::vector<Transform2> transforms(NUM_BOXES + 1U);
+
+	transforms[NUM_BOXES].m_position = Vec2(0.f, -0.5f);
+	Rigidbody2D* ground = AddTestBody(system, STATIC_SIMULATION, COLLIDER_AABB2, &transforms[NUM_BOXES], Vec2(20.f, 1.f));
+
+	//Dropped from a small gap each so the stack has to land and settle rather than start at rest
+	std::vector<Rigidbody2D*> boxes;
+	for (uint boxIndex = 0; boxIndex < NUM_BOXES; ++boxIndex)
+	{
+		transforms[boxIndex].m_position = Vec2(0.f, 0.5f + (float)boxIndex * 1.02f);
+		boxes.push_back(AddTestBody(system, DYNAMIC_SIMULATION, COLLIDER_AABB2, &transforms[boxIndex]));
+	}
+
+	for (uint stepIndex = 0; stepIndex < SETTLE_STEPS; ++stepIndex)
+	{
+		system.Update(STEP);
+	}
+
+	//Once settled nothing drifts or buzzes, impulses never pull and the ground carries the whole stack's weight
+	float maxStepMove = 0.f;
+	float maxSpeed = 0.f;
+	float maxSideDrift = 0.f;
+	float minGroundImpulse = FLT_MAX;
+	float maxGroundImpulse = 0.f;
+	bool areImpulsesPushing = true;
+	for (uint stepIndex = 0; stepIndex < WATCH_STEPS; ++stepIndex)
+	{
+		std::vector<Vec2> lastPositions;
+		for (Rigidbody2D* box : boxes)
+		{
+			lastPositions.push_back(box->GetPosition());
+		}
+
+		system.Update(STEP);
+
+		for (uint boxIndex = 0; boxIndex < NUM_BOXES; ++boxIndex)
+		{
+			const Rigidbody2D* box = boxes[boxIndex];
+			maxStepMove = std::max(maxStepMove, (box->GetPosition() - lastPositions[boxIndex]).GetLength());
+			maxSpeed = std::max(maxSpeed, box->GetVelocity().GetLength());
+			maxSideDrift = std::max(maxSideDrift, fabsf(box->GetPosition().x));
+		}
+
+		float groundImpulse = 0.f;
+		for (const ContactEvent2D_T& contactEvent : system.GetContactEvents())
+		{
+			areImpulsesPushing = areImpulsesPushing && contactEvent.m_normalImpulse >= 0.f;
+			if (contactEvent.m_colliderA == ground->m_collider || contactEvent.m_colliderB == ground->m_collider)
+			{
+				groundImpulse += contactEvent.m_normalImpulse;
+			}
+		}
+		minGroundImpulse = std::min(minGroundImpulse, groundImpulse);
+		maxGroundImpulse = std::max(maxGroundImpulse, groundImpulse);
+	}
+
+	//Resting contacts sit inside the slop, so the top box can sink by at most that much per contact
+	ContactSolverSettings_T settings;
+	float topHeight = boxes[NUM_BOXES - 1U]->GetPosition().y;
+	float restingTopHeight = (float)NUM_BOXES - 0.5f;
+	float weightImpulse = (float)NUM_BOXES * boxes[0]->GetMass() * -system.GetGravity().y * STEP;
+
+	CONFIRM(maxStepMove < 0.001f);
+	CONFIRM(maxSpeed < 0.05f);
+	CONFIRM(maxSideDrift < 0.01f);
+	CONFIRM(fabsf(topHeight - restingTopHeight) < (float)(NUM_BOXES + 1U) * settings.m_linearSlop * 2.f);
+	CONFIRM(areImpulsesPushing);
+	CONFIRM(minGroundImpulse > weightImpulse * 0.95f && maxGroundImpulse < weightImpulse * 1.05f);
+	return true;
+}
+//------------------------------------------------------------------------------------------------------------------------------
+UNITTEST("ContactSolverWarmStartPairOrder", "Physics", 100)
+{
+	constexpr float STEP = 1.f / 60.f;
+	const Vec2 startPosition(0.f, 0.95f);
+	const Vec2 startVelocity(0.5f, -2.f);
+
+	PhysicsSystem system(BROADPHASE_AABB_TREE);
+	std::vector<Transform2> transforms(2U);
+	transforms[0].m_position = startPosition;
+	Rigidbody2D* box = AddTestBody(system, DYNAMIC_SIMULATION, COLLIDER_AABB2, &transforms[0]);
+	Rigidbody2D* ground = AddTestBody(system, STATIC_SIMULATION, COLLIDER_AABB2, &transforms[1]);
+
+	//Normal points from B to A, so from the ground up into the box
+	Collision2D collision;
+	collision.m_manifold.m_normal = Vec2(0.f, 1.f);
+	collision.m_manifold.m_contact = Vec2(0.f, 0.5f);
+	collision.m_manifold.m_penetration = 0.05f;
+
+	Collision2D flippedCollision = collision;
+	flippedCollision.m_manifold.m_normal = Vec2(0.f, -1.f);
+
+	//The second step runs no iterations, so whatever moves the box is the impulse carried over from the first
+	ContactSolverSettings_T settings;
+	ContactSolverSettings_T warmStartOnly;
+	warmStartOnly.m_velocityIterations = 0U;
+	warmStartOnly.m_positionIterations = 0U;
+
+	Vec2 solvedVelocities[2];
+	for (uint flipIndex = 0; flipIndex < 2U; ++flipIndex)
+	{
+		ContactSolver2D solver(settings);
+		box->SetPosition(startPosition);
+		box->SetVelocity(startVelocity);
+		box->SetRotation(0.f);
+		box->SetAngularVelocity(0.f);
+		solver.AddContact(box, ground, collision);
+		solver.Solve(STEP);
+
+		box->SetPosition(startPosition);
+		box->SetVelocity(startVelocity);
+		box->SetRotation(0.f);
+		box->SetAngularVelocity(0.f);
+		solver.SetSettings(warmStartOnly);
+		if (flipIndex == 0U)
+		{
+			solver.AddContact(box, ground, collision);
+		}
+		else
+		{
+			solver.AddContact(ground, box, flippedCollision);
+		}
+		solver.Solve(STEP);
+
+		solvedVelocities[flipIndex] = box->GetVelocity();
+	}
+
+	//Handing the pair over the other way round still finds last step's impulses, and they push the box the same way
+	CONFIRM(solvedVelocities[0].y > startVelocity.y + 0.1f);
+	CONFIRM((solvedVelocities[1] - solvedVelocities[0]).GetLength() < 0.0001f);
+	return true;
+}
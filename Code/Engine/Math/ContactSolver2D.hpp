@@ -0,0 +1,134 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+#include "Engine/Commons/EngineCommon.hpp"
+#include "Engine/Math/ContactEvent2D.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------------
+class Rigidbody2D;
+struct Collision2D;
+
+//------------------------------------------------------------------------------------------------------------------------------
+constexpr uint CONTACT_FEATURE_SECTORS = 32U;		//Normal directions are bucketed into this many feature ids
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct ContactSolverSettings_T
+{
+	uint	m_velocityIterations = 8U;
+	uint	m_positionIterations = 3U;
+	float	m_baumgarte = 0.2f;						//Fraction of the remaining penetration removed per position iteration
+	float	m_linearSlop = 0.005f;					//Penetration we allow so resting contacts stay touching
+	float	m_maxCorrection = 0.2f;					//Largest push a single position iteration can make
+	float	m_restitutionThreshold = 1.f;			//Closing speeds below this don't bounce, keeps stacks from buzzing
+	bool	m_warmStarting = true;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// One touching pair. The narrowphase gives a single point per pair so the manifold holds one point, the feature id says
+// which way the normal pointed so a contact that slid onto another face doesn't inherit the old face's impulses
+//------------------------------------------------------------------------------------------------------------------------------
+struct ContactManifold2D_T
+{
+	Rigidbody2D*	m_bodyA = nullptr;
+	Rigidbody2D*	m_bodyB = nullptr;
+	uint			m_solverBodyA = 0U;
+	uint			m_solverBodyB = 0U;
+
+	Vec2			m_normal = Vec2::ZERO;				//Points from B to A
+	Vec2			m_point = Vec2::ZERO;
+	float			m_penetration = 0.f;
+	uint			m_featureId = 0U;					//Of the normal pointing at the lower id body, see AddContact
+	float			m_friction = 0.f;
+	float			m_restitution = 0.f;
+
+	//Accumulated over the step and carried into the next one for warm starting
+	float			m_normalImpulse = 0.f;
+	float			m_tangentImpulse = 0.f;
+
+	//Filled by PrepareContacts
+	Vec2			m_toPointA = Vec2::ZERO;
+	Vec2			m_toPointB = Vec2::ZERO;
+	Vec2			m_startPositionA = Vec2::ZERO;
+	Vec2			m_startPositionB = Vec2::ZERO;
+	float			m_normalMass = 0.f;
+	float			m_tangentMass = 0.f;
+	float			m_velocityBias = 0.f;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// What a manifold hands to the next step's warm start. Plain words so the list copies straight into and out of snapshots
+//------------------------------------------------------------------------------------------------------------------------------
+struct WarmStartContact2D_T
+{
+	uint			m_bodyIdA;							//Always the lower id of the pair
+	uint			m_bodyIdB;
+	uint			m_featureId;
+	float			m_normalImpulse;
+	float			m_tangentImpulse;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Velocities are copied out of the bodies for the solve, angular velocity in radians. Static bodies have 0 inverse mass
+//------------------------------------------------------------------------------------------------------------------------------
+struct SolverBody2D_T
+{
+	Rigidbody2D*	m_body = nullptr;
+	Vec2			m_velocity = Vec2::ZERO;
+	float			m_angularVelocity = 0.f;
+	Vec2			m_startVelocity = Vec2::ZERO;
+	float			m_startAngularVelocity = 0.f;
+	Vec2			m_inverseMass = Vec2::ZERO;			//Per axis so the movement constraints fall out of the maths
+	float			m_inverseInertia = 0.f;
+	bool			m_isDynamic = false;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Sequential impulse solver. Manifolds persist between steps keyed on the body pair, so the impulses found last step are
+// applied up front (warm starting) and the iterations only have to fix what changed. Velocity iterations handle
+// restitution and Coulomb friction with accumulated impulse clamping, position iterations then push the remaining
+// penetration out with Baumgarte scaled corrections that never feed back into the velocities
+//------------------------------------------------------------------------------------------------------------------------------
+class ContactSolver2D
+{
+public:
+	explicit ContactSolver2D(const ContactSolverSettings_T& settings = ContactSolverSettings_T());
+	~ContactSolver2D();
+
+	void								SetSettings(const ContactSolverSettings_T& settings)	{ m_settings = settings; }
+	const ContactSolverSettings_T&		GetSettings() const										{ return m_settings; }
+
+	// Bodies must have a collider, A is the dynamic body in mixed pairs. Returns false if the contact had no normal to solve
+	bool								AddContact(Rigidbody2D* bodyA, Rigidbody2D* bodyB, const Collision2D& collision);
+	// Solves every contact added since the last call, then keeps them around for the next step's warm start.
+	// deltaTime is the step the bodies were just moved by, see StoreVelocities. Each solved contact is appended to
+	// outEvents with its final normal impulse
+	void								Solve(float deltaTime, ContactEventList* outEvents = nullptr);
+
+	static uint							GetFeatureId(const Vec2& normal);
+
+	// What the next step warm starts from, sorted by body ids, for snapshots
+	uint								GetWarmStartContactCount() const						{ return (uint)m_warmStartContacts.size(); }
+	const WarmStartContact2D_T*			GetWarmStartContacts() const							{ return m_warmStartContacts.data(); }
+	void								SetWarmStartContacts(const WarmStartContact2D_T* contacts, uint numContacts);
+
+private:
+	uint								GetSolverBody(Rigidbody2D* body);
+	const WarmStartContact2D_T*			FindWarmStartContact(const Rigidbody2D* bodyA, const Rigidbody2D* bodyB) const;
+	void								PrepareContacts();
+	void								WarmStart();
+	void								SolveVelocities();
+	void								SolvePositions();
+	void								StoreVelocities(float deltaTime);
+
+private:
+	ContactSolverSettings_T				m_settings;
+
+	std::vector<ContactManifold2D_T>	m_manifolds;					//This step, in the order they were added
+	std::vector<WarmStartContact2D_T>	m_warmStartContacts;			//Last step's, sorted on the body pair for a binary search
+
+	std::vector<SolverBody2D_T>			m_solverBodies;
+	std::unordered_map<Rigidbody2D*, uint>	m_solverBodyLookup;
+};
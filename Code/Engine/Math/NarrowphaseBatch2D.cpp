@@ -0,0 +1,487 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Math/NarrowphaseBatch2D.hpp"
+#include "Engine/Commons/UnitTest.hpp"
+#include "Engine/Core/Async/WorkerPool.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Math/AABB2.hpp"
+#include "Engine/Math/Collider2D.hpp"
+#include "Engine/Math/PhysicsSystem.hpp"
+#include "Engine/Math/PhysicsTestHelpers2D.hpp"
+#include "Engine/Math/Rigidbody2D.hpp"
+#include <immintrin.h>
+#include <string.h>
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Every lane does the same float ops in the same order as the scalar GetManifold, no reciprocal estimates and no fused
+// multiply adds, so the results match bit for bit. Masked off lanes may divide by 0, their results are never read
+//------------------------------------------------------------------------------------------------------------------------------
+static void WriteHitLanes(Manifold2D* outManifolds, uint8_t* outIsHit, uint startIndex, uint laneCount, int hitMask, const float* normalX, const float* normalY, const float* penetration)
+{
+	for (uint laneIndex = 0; laneIndex < laneCount; ++laneIndex)
+	{
+		if ((hitMask & (1 << laneIndex)) == 0)
+		{
+			outIsHit[startIndex + laneIndex] = 0U;
+			continue;
+		}
+
+		Manifold2D& manifold = outManifolds[startIndex + laneIndex];
+		manifold = Manifold2D();
+		manifold.m_normal = Vec2(normalX[laneIndex], normalY[laneIndex]);
+		manifold.m_penetration = penetration[laneIndex];
+		outIsHit[startIndex + laneIndex] = 1U;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static inline __m128 Select4(const __m128& mask, const __m128& ifTrue, const __m128& ifFalse)
+{
+	return _mm_or_ps(_mm_and_ps(mask, ifTrue), _mm_andnot_ps(mask, ifFalse));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void GetDiscVsDiscManifolds( Manifold2D* outManifolds, uint8_t* outIsHit, const DiscDiscPairs2D_T& pairs, uint startIndex, uint endIndex )
+{
+	const float* centreAX = pairs.m_centreAX.data();
+	const float* centreAY = pairs.m_centreAY.data();
+	const float* radiusA = pairs.m_radiusA.data();
+	const float* centreBX = pairs.m_centreBX.data();
+	const float* centreBY = pairs.m_centreBY.data();
+	const float* radiusB = pairs.m_radiusB.data();
+
+	uint pairIndex = startIndex;
+
+	const __m128 zero4 = _mm_setzero_ps();
+
+	for (; pairIndex + 4U <= endIndex; pairIndex += 4U)
+	{
+		__m128 dispX = _mm_sub_ps(_mm_loadu_ps(&centreAX[pairIndex]), _mm_loadu_ps(&centreBX[pairIndex]));
+		__m128 dispY = _mm_sub_ps(_mm_loadu_ps(&centreAY[pairIndex]), _mm_loadu_ps(&centreBY[pairIndex]));
+		__m128 distanceSquared = _mm_add_ps(_mm_mul_ps(dispX, dispX), _mm_mul_ps(dispY, dispY));
+		__m128 radSum = _mm_add_ps(_mm_loadu_ps(&radiusA[pairIndex]), _mm_loadu_ps(&radiusB[pairIndex]));
+		int hitMask = _mm_movemask_ps(_mm_cmplt_ps(distanceSquared, _mm_mul_ps(radSum, radSum)));
+		if (hitMask == 0)
+		{
+			memset(&outIsHit[pairIndex], 0, 4U);
+			continue;
+		}
+
+		__m128 distance = _mm_sqrt_ps(distanceSquared);
+		__m128 isZero = _mm_and_ps(_mm_cmpeq_ps(dispX, zero4), _mm_cmpeq_ps(dispY, zero4));
+
+		alignas(16) float normalX[4];
+		alignas(16) float normalY[4];
+		alignas(16) float penetration[4];
+		_mm_store_ps(normalX, Select4(isZero, dispX, _mm_div_ps(dispX, distance)));
+		_mm_store_ps(normalY, Select4(isZero, dispY, _mm_div_ps(dispY, distance)));
+		_mm_store_ps(penetration, _mm_sub_ps(radSum, distance));
+
+		WriteHitLanes(outManifolds, outIsHit, pairIndex, 4U, hitMask, normalX, normalY, penetration);
+	}
+
+	for (; pairIndex < endIndex; ++pairIndex)
+	{
+		Manifold2D manifold;
+		bool isHit = GetManifold(&manifold, Vec2(centreAX[pairIndex], centreAY[pairIndex]), radiusA[pairIndex], Vec2(centreBX[pairIndex], centreBY[pairIndex]), radiusB[pairIndex]);
+		if (isHit)
+		{
+			outManifolds[pairIndex] = manifold;
+		}
+		outIsHit[pairIndex] = isHit ? 1U : 0U;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Both branches of the scalar routine are worked out for every lane and the closest point test picks one. The clamp is a
+// select rather than min/max so a centre of -0 on a box edge of 0 keeps its sign like Clamp does
+//------------------------------------------------------------------------------------------------------------------------------
+void GetDiscVsAABB2Manifolds( Manifold2D* outManifolds, uint8_t* outIsHit, const DiscAABB2Pairs2D_T& pairs, uint startIndex, uint endIndex )
+{
+	const float* centreX = pairs.m_centreX.data();
+	const float* centreY = pairs.m_centreY.data();
+	const float* radii = pairs.m_radius.data();
+	const float* minX = pairs.m_minX.data();
+	const float* minY = pairs.m_minY.data();
+	const float* maxX = pairs.m_maxX.data();
+	const float* maxY = pairs.m_maxY.data();
+
+	uint pairIndex = startIndex;
+
+	const __m128 zero4 = _mm_setzero_ps();
+	const __m128 one4 = _mm_set1_ps(1.f);
+	const __m128 minusOne4 = _mm_set1_ps(-1.f);
+
+	for (; pairIndex + 4U <= endIndex; pairIndex += 4U)
+	{
+		__m128 discX = _mm_loadu_ps(&centreX[pairIndex]);
+		__m128 discY = _mm_loadu_ps(&centreY[pairIndex]);
+		__m128 radius = _mm_loadu_ps(&radii[pairIndex]);
+		__m128 boxMinX = _mm_loadu_ps(&minX[pairIndex]);
+		__m128 boxMinY = _mm_loadu_ps(&minY[pairIndex]);
+		__m128 boxMaxX = _mm_loadu_ps(&maxX[pairIndex]);
+		__m128 boxMaxY = _mm_loadu_ps(&maxY[pairIndex]);
+
+		__m128 closestX = Select4(_mm_cmplt_ps(discX, boxMinX), boxMinX, Select4(_mm_cmpgt_ps(discX, boxMaxX), boxMaxX, discX));
+		__m128 closestY = Select4(_mm_cmplt_ps(discY, boxMinY), boxMinY, Select4(_mm_cmpgt_ps(discY, boxMaxY), boxMaxY, discY));
+		__m128 isCentreInside = _mm_and_ps(_mm_cmpeq_ps(closestX, discX), _mm_cmpeq_ps(closestY, discY));
+
+		__m128 dispX = _mm_sub_ps(discX, closestX);
+		__m128 dispY = _mm_sub_ps(discY, closestY);
+		__m128 distanceSquared = _mm_add_ps(_mm_mul_ps(dispX, dispX), _mm_mul_ps(dispY, dispY));
+		__m128 isOutsideHit = _mm_andnot_ps(isCentreInside, _mm_cmplt_ps(distanceSquared, _mm_mul_ps(radius, radius)));
+
+		__m128 isStrictlyInside = _mm_and_ps(_mm_and_ps(_mm_cmplt_ps(discX, boxMaxX), _mm_cmplt_ps(discY, boxMaxY)), _mm_and_ps(_mm_cmpgt_ps(discX, boxMinX), _mm_cmpgt_ps(discY, boxMinY)));
+		__m128 isInsideHit = _mm_and_ps(isCentreInside, isStrictlyInside);
+
+		int hitMask = _mm_movemask_ps(_mm_or_ps(isOutsideHit, isInsideHit));
+		if (hitMask == 0)
+		{
+			memset(&outIsHit[pairIndex], 0, 4U);
+			continue;
+		}
+
+		__m128 distance = _mm_sqrt_ps(distanceSquared);
+		__m128 isZero = _mm_and_ps(_mm_cmpeq_ps(dispX, zero4), _mm_cmpeq_ps(dispY, zero4));
+		__m128 outsideNormalX = Select4(isZero, dispX, _mm_div_ps(dispX, distance));
+		__m128 outsideNormalY = Select4(isZero, dispY, _mm_div_ps(dispY, distance));
+		__m128 outsidePenetration = _mm_sub_ps(radius, distance);
+
+		__m128 rightToDisc = _mm_sub_ps(boxMaxX, discX);
+		__m128 leftToDisc = _mm_sub_ps(discX, boxMinX);
+		__m128 isLeftCloser = _mm_cmpgt_ps(rightToDisc, leftToDisc);
+		__m128 horizontalDist = Select4(isLeftCloser, leftToDisc, rightToDisc);
+		__m128 horizontalNormalX = Select4(isLeftCloser, minusOne4, one4);
+
+		__m128 topToDisc = _mm_sub_ps(boxMaxY, discY);
+		__m128 botToDisc = _mm_sub_ps(discY, boxMinY);
+		__m128 isBotCloser = _mm_cmpgt_ps(topToDisc, botToDisc);
+		__m128 vertDistance = Select4(isBotCloser, botToDisc, topToDisc);
+		__m128 vertNormalY = Select4(isBotCloser, minusOne4, one4);
+
+		__m128 isVertical = _mm_cmpgt_ps(horizontalDist, vertDistance);
+		__m128 insideNormalX = Select4(isVertical, zero4, horizontalNormalX);
+		__m128 insideNormalY = Select4(isVertical, vertNormalY, zero4);
+		__m128 insidePenetration = _mm_add_ps(Select4(isVertical, vertDistance, horizontalDist), radius);
+
+		alignas(16) float normalX[4];
+		alignas(16) float normalY[4];
+		alignas(16) float penetration[4];
+		_mm_store_ps(normalX, Select4(isCentreInside, insideNormalX, outsideNormalX));
+		_mm_store_ps(normalY, Select4(isCentreInside, insideNormalY, outsideNormalY));
+		_mm_store_ps(penetration, Select4(isCentreInside, insidePenetration, outsidePenetration));
+
+		WriteHitLanes(outManifolds, outIsHit, pairIndex, 4U, hitMask, normalX, normalY, penetration);
+	}
+
+	for (; pairIndex < endIndex; ++pairIndex)
+	{
+		AABB2 boxShape(Vec2(minX[pairIndex], minY[pairIndex]), Vec2(maxX[pairIndex], maxY[pairIndex]));
+		Manifold2D manifold;
+		bool isHit = GetManifold(&manifold, Vec2(centreX[pairIndex], centreY[pairIndex]), radii[pairIndex], boxShape);
+		if (isHit)
+		{
+			outManifolds[pairIndex] = manifold;
+		}
+		outIsHit[pairIndex] = isHit ? 1U : 0U;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+NarrowphaseBatch2D::NarrowphaseBatch2D()
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+NarrowphaseBatch2D::~NarrowphaseBatch2D()
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void NarrowphaseBatch2D::Clear()
+{
+	m_discDiscPairs.m_centreAX.clear();
+	m_discDiscPairs.m_centreAY.clear();
+	m_discDiscPairs.m_radiusA.clear();
+	m_discDiscPairs.m_centreBX.clear();
+	m_discDiscPairs.m_centreBY.clear();
+	m_discDiscPairs.m_radiusB.clear();
+	m_discDiscColliders.clear();
+
+	m_discBoxPairs.m_centreX.clear();
+	m_discBoxPairs.m_centreY.clear();
+	m_discBoxPairs.m_radius.clear();
+	m_discBoxPairs.m_minX.clear();
+	m_discBoxPairs.m_minY.clear();
+	m_discBoxPairs.m_maxX.clear();
+	m_discBoxPairs.m_maxY.clear();
+	m_discBoxColliders.clear();
+	m_isBoxFirst.clear();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool NarrowphaseBatch2D::AddPair(Collider2D* colliderA, Collider2D* colliderB)
+{
+	eColliderType2D typeA = colliderA->GetType();
+	eColliderType2D typeB = colliderB->GetType();
+
+	if (typeA == COLLIDER_DISC && typeB == COLLIDER_DISC)
+	{
+		Disc2D discA = static_cast<Disc2DCollider*>(colliderA)->GetWorldShape();
+		Disc2D discB = static_cast<Disc2DCollider*>(colliderB)->GetWorldShape();
+
+		m_discDiscPairs.m_centreAX.push_back(discA.GetCentre().x);
+		m_discDiscPairs.m_centreAY.push_back(discA.GetCentre().y);
+		m_discDiscPairs.m_radiusA.push_back(discA.GetRadius());
+		m_discDiscPairs.m_centreBX.push_back(discB.GetCentre().x);
+		m_discDiscPairs.m_centreBY.push_back(discB.GetCentre().y);
+		m_discDiscPairs.m_radiusB.push_back(discB.GetRadius());
+
+		m_discDiscColliders.push_back(colliderA);
+		m_discDiscColliders.push_back(colliderB);
+		return true;
+	}
+
+	bool isBoxFirst = (typeA == COLLIDER_AABB2 && typeB == COLLIDER_DISC);
+	if (!isBoxFirst && !(typeA == COLLIDER_DISC && typeB == COLLIDER_AABB2))
+	{
+		return false;
+	}
+
+	Collider2D* discCollider = isBoxFirst ? colliderB : colliderA;
+	Collider2D* boxCollider = isBoxFirst ? colliderA : colliderB;
+	Disc2D disc = static_cast<Disc2DCollider*>(discCollider)->GetWorldShape();
+	AABB2 box = static_cast<AABB2Collider*>(boxCollider)->GetWorldShape();
+
+	m_discBoxPairs.m_centreX.push_back(disc.GetCentre().x);
+	m_discBoxPairs.m_centreY.push_back(disc.GetCentre().y);
+	m_discBoxPairs.m_radius.push_back(disc.GetRadius());
+	m_discBoxPairs.m_minX.push_back(box.m_minBounds.x);
+	m_discBoxPairs.m_minY.push_back(box.m_minBounds.y);
+	m_discBoxPairs.m_maxX.push_back(box.m_maxBounds.x);
+	m_discBoxPairs.m_maxY.push_back(box.m_maxBounds.y);
+
+	m_discBoxColliders.push_back(colliderA);
+	m_discBoxColliders.push_back(colliderB);
+	m_isBoxFirst.push_back(isBoxFirst ? 1U : 0U);
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void NarrowphaseBatch2D::Run(WorkerPool* pool /*= nullptr*/)
+{
+	uint discDiscCount = (uint)m_discDiscPairs.m_centreAX.size();
+	uint discBoxCount = (uint)m_discBoxPairs.m_centreX.size();
+	uint pairCount = discDiscCount + discBoxCount;
+
+	m_manifolds.resize(pairCount);
+	m_isHit.resize(pairCount);
+
+	Manifold2D* discBoxManifolds = m_manifolds.data() + discDiscCount;
+	uint8_t* discBoxIsHit = m_isHit.data() + discDiscCount;
+
+	if (pool == nullptr)
+	{
+		GetDiscVsDiscManifolds(m_manifolds.data(), m_isHit.data(), m_discDiscPairs, 0U, discDiscCount);
+		GetDiscVsAABB2Manifolds(discBoxManifolds, discBoxIsHit, m_discBoxPairs, 0U, discBoxCount);
+		return;
+	}
+
+	//Each worker writes only its own slots so the results don't need merging
+	pool->ParallelFor(pairCount, [&](uint, uint startIndex, uint endIndex)
+	{
+		if (startIndex < discDiscCount)
+		{
+			GetDiscVsDiscManifolds(m_manifolds.data(), m_isHit.data(), m_discDiscPairs, startIndex, (endIndex < discDiscCount) ? endIndex : discDiscCount);
+		}
+
+		if (endIndex > discDiscCount)
+		{
+			uint discBoxStart = (startIndex > discDiscCount) ? startIndex - discDiscCount : 0U;
+			GetDiscVsAABB2Manifolds(discBoxManifolds, discBoxIsHit, m_discBoxPairs, discBoxStart, endIndex - discDiscCount);
+		}
+	});
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void NarrowphaseBatch2D::AppendContacts(NarrowphaseContactList& outContacts) const
+{
+	uint discDiscCount = (uint)m_discDiscPairs.m_centreAX.size();
+	uint pairCount = (uint)m_isHit.size();
+
+	for (uint pairIndex = 0; pairIndex < pairCount; ++pairIndex)
+	{
+		if (m_isHit[pairIndex] == 0U)
+		{
+			continue;
+		}
+
+		bool isDiscDisc = (pairIndex < discDiscCount);
+		const std::vector<Collider2D*>& colliders = isDiscDisc ? m_discDiscColliders : m_discBoxColliders;
+		uint colliderIndex = (isDiscDisc ? pairIndex : pairIndex - discDiscCount) * 2U;
+
+		NarrowphaseContact_T contact;
+		contact.m_collision.m_Obj = colliders[colliderIndex];
+		contact.m_collision.m_otherObj = colliders[colliderIndex + 1U];
+		contact.m_collision.m_manifold = m_manifolds[pairIndex];
+		if (!isDiscDisc && m_isBoxFirst[pairIndex - discDiscCount] != 0U)
+		{
+			contact.m_collision.m_manifold.m_normal *= -1.f;
+		}
+
+		contact.m_bodyA = contact.m_collision.m_Obj->m_rigidbody;
+		contact.m_bodyB = contact.m_collision.m_otherObj->m_rigidbody;
+		outContacts.push_back(contact);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Collision2D has padding, so compare the fields rather than the whole struct
+static bool AreCollisionsBitExact(const Collision2D& lhs, const Collision2D& rhs)
+{
+	const Manifold2D& lhsManifold = lhs.m_manifold;
+	const Manifold2D& rhsManifold = rhs.m_manifold;
+	return lhs.m_Obj == rhs.m_Obj && lhs.m_otherObj == rhs.m_otherObj
+		&& memcmp(&lhsManifold.m_normal, &rhsManifold.m_normal, sizeof(Vec2)) == 0
+		&& memcmp(&lhsManifold.m_penetration, &rhsManifold.m_penetration, sizeof(float)) == 0
+		&& memcmp(&lhsManifold.m_contact, &rhsManifold.m_contact, sizeof(Vec2)) == 0;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static void MakeBatchTestColliders(PhysicsSystem& system, std::vector<Collider2D*>& outColliders)
+{
+	//Edge cases the wide paths have to agree with the scalar code on: same centre, centre inside or on the edge of a box
+	//and exactly touching
+	outColliders.push_back(MakeTestCollider(system, COLLIDER_DISC, Vec2(1.f, 1.f), Vec2(1.f, 1.f)));
+	outColliders.push_back(MakeTestCollider(system, COLLIDER_DISC, Vec2(1.f, 1.f), Vec2(0.5f, 0.5f)));
+	outColliders.push_back(MakeTestCollider(system, COLLIDER_DISC, Vec2(2.f, 1.f), Vec2(1.f, 1.f)));
+	outColliders.push_back(MakeTestCollider(system, COLLIDER_AABB2, Vec2(1.f, 1.f), Vec2(2.f, 1.f)));
+	outColliders.push_back(MakeTestCollider(system, COLLIDER_DISC, Vec2(2.f, 1.f), Vec2(0.5f, 0.5f)));
+	outColliders.push_back(MakeTestCollider(system, COLLIDER_DISC, Vec2(0.f, 0.5f), Vec2(0.5f, 0.5f)));
+	outColliders.push_back(MakeTestCollider(system, COLLIDER_AABB2, Vec2(-1.f, 0.5f), Vec2(2.f, 2.f)));
+	outColliders.push_back(MakeTestCollider(system, COLLIDER_AABB2, Vec2(1.f, 1.5f), Vec2(1.f, 1.f)));
+
+	//Enough random ones that the pair counts aren't a multiple of the lane width
+	uint seed = 17U;
+	for (int colliderIndex = 0; colliderIndex < 53; ++colliderIndex)
+	{
+		seed = seed * 1664525U + 1013904223U;
+		Vec2 position((float)(seed >> 8U) / 16777216.f * 8.f, (float)(seed & 0xFFFFU) / 65536.f * 8.f);
+		seed = seed * 1664525U + 1013904223U;
+		Vec2 size(0.2f + (float)(seed >> 8U) / 16777216.f * 4.f, 0.1f + (float)(seed & 0xFFFFU) / 65536.f * 2.f);
+		outColliders.push_back(MakeTestCollider(system, (colliderIndex % 3 == 0) ? COLLIDER_AABB2 : COLLIDER_DISC, position, size));
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+UNITTEST("NarrowphaseBatch", "Physics", 100)
+{
+	PhysicsSystem system(BROADPHASE_BRUTE_FORCE);
+	std::vector<Collider2D*> colliders;
+	MakeBatchTestColliders(system, colliders);
+
+	NarrowphaseBatch2D batch;
+	std::vector<Collision2D> expectedCollisions;
+	uint numColliders = (uint)colliders.size();
+	for (uint indexA = 0; indexA < numColliders; ++indexA)
+	{
+		for (uint indexB = 0; indexB < numColliders; ++indexB)
+		{
+			if (indexA == indexB || !batch.AddPair(colliders[indexA], colliders[indexB]))
+			{
+				continue;
+			}
+
+			Collision2D collision;
+			if (GetCollisionInfo(&collision, colliders[indexA], colliders[indexB]))
+			{
+				expectedCollisions.push_back(collision);
+			}
+		}
+	}
+
+	batch.Run();
+	NarrowphaseContactList contacts;
+	batch.AppendContacts(contacts);
+
+	//Same touching pairs, though the batch gives the disc vs disc ones first
+	bool isBitExact = (contacts.size() == expectedCollisions.size());
+	for (const Collision2D& expected : expectedCollisions)
+	{
+		bool isFound = false;
+		for (const NarrowphaseContact_T& contact : contacts)
+		{
+			if (contact.m_collision.m_Obj == expected.m_Obj && contact.m_collision.m_otherObj == expected.m_otherObj)
+			{
+				isFound = AreCollisionsBitExact(contact.m_collision, expected);
+				break;
+			}
+		}
+
+		isBitExact = isBitExact && isFound;
+	}
+
+	for (Collider2D* collider : colliders)
+	{
+		system.DestroyRigidbody(collider->m_rigidbody);
+	}
+
+	CONFIRM(batch.GetPairCount() > 0U);
+	CONFIRM(!expectedCollisions.empty());
+	CONFIRM(isBitExact);
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+UNITTEST("NarrowphaseBatch", "PhysicsBenchmark", 100)
+{
+	PhysicsSystem system(BROADPHASE_BRUTE_FORCE);
+	std::vector<Collider2D*> colliders;
+	MakeBatchTestColliders(system, colliders);
+
+	NarrowphaseBatch2D batch;
+	uint numColliders = (uint)colliders.size();
+	for (uint indexA = 0; indexA < numColliders; ++indexA)
+	{
+		for (uint indexB = 0; indexB < numColliders; ++indexB)
+		{
+			if (indexA != indexB)
+			{
+				batch.AddPair(colliders[indexA], colliders[indexB]);
+			}
+		}
+	}
+
+	constexpr int NUM_ITERATIONS = 100;
+	double startTime = GetCurrentTimeSeconds();
+	for (int iteration = 0; iteration < NUM_ITERATIONS; ++iteration)
+	{
+		batch.Run();
+	}
+	double batchSeconds = GetCurrentTimeSeconds() - startTime;
+
+	uint scalarHits = 0U;
+	startTime = GetCurrentTimeSeconds();
+	for (int iteration = 0; iteration < NUM_ITERATIONS; ++iteration)
+	{
+		for (uint indexA = 0; indexA < numColliders; ++indexA)
+		{
+			for (uint indexB = 0; indexB < numColliders; ++indexB)
+			{
+				Collision2D collision;
+				bool isSupported = (colliders[indexA]->GetType() == COLLIDER_DISC) || (colliders[indexB]->GetType() == COLLIDER_DISC);
+				scalarHits += (indexA != indexB && isSupported && GetCollisionInfo(&collision, colliders[indexA], colliders[indexB])) ? 1U : 0U;
+			}
+		}
+	}
+	double scalarSeconds = GetCurrentTimeSeconds() - startTime;
+
+	DebuggerPrintf("\n Narrowphase %d x %u pairs: batched %.3f ms, GetCollisionInfo %.3f ms (%u hits)",
+		NUM_ITERATIONS, batch.GetPairCount(), batchSeconds * 1000.0, scalarSeconds * 1000.0, scalarHits);
+
+	for (Collider2D* collider : colliders)
+	{
+		system.DestroyRigidbody(collider->m_rigidbody);
+	}
+
+	return true;
+}
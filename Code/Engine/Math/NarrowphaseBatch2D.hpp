@@ -0,0 +1,75 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+#include "Engine/Commons/EngineCommon.hpp"
+#include "Engine/Math/CollisionHandler.hpp"
+#include <stdint.h>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------------
+class Collider2D;
+class WorkerPool;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// World shapes of disc vs disc pairs, one float array per field
+struct DiscDiscPairs2D_T
+{
+	std::vector<float>		m_centreAX;
+	std::vector<float>		m_centreAY;
+	std::vector<float>		m_radiusA;
+	std::vector<float>		m_centreBX;
+	std::vector<float>		m_centreBY;
+	std::vector<float>		m_radiusB;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// World shapes of disc vs AABB2 pairs, the normal comes out pointing from the box to the disc
+struct DiscAABB2Pairs2D_T
+{
+	std::vector<float>		m_centreX;
+	std::vector<float>		m_centreY;
+	std::vector<float>		m_radius;
+	std::vector<float>		m_minX;
+	std::vector<float>		m_minY;
+	std::vector<float>		m_maxX;
+	std::vector<float>		m_maxY;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Same maths in the same order as the GetManifold overloads for the collider pairs, so every lane matches them bit for bit.
+// outIsHit[i] is 1 where pair i touches and only then is outManifolds[i] written, like GetManifold leaving out alone.
+// Runs pairs [startIndex, endIndex) 4 at a time with SSE and the rest through the scalar fallback
+void		GetDiscVsDiscManifolds( Manifold2D* outManifolds, uint8_t* outIsHit, const DiscDiscPairs2D_T& pairs, uint startIndex, uint endIndex );
+void		GetDiscVsAABB2Manifolds( Manifold2D* outManifolds, uint8_t* outIsHit, const DiscAABB2Pairs2D_T& pairs, uint startIndex, uint endIndex );
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Collects the disc vs disc and disc vs AABB2 pairs of a narrowphase pass into the arrays above, runs the kernels and hands
+// the touching ones back as contacts. Any other pair is turned away and still goes through GetCollisionInfo
+//------------------------------------------------------------------------------------------------------------------------------
+class NarrowphaseBatch2D
+{
+public:
+	NarrowphaseBatch2D();
+	~NarrowphaseBatch2D();
+
+	void					Clear();
+	bool					AddPair(Collider2D* colliderA, Collider2D* colliderB);
+
+	uint					GetPairCount() const		{ return (uint)(m_discDiscColliders.size() + m_discBoxColliders.size()) / 2U; }
+
+	// Splits the pairs across the pool when there is one, the kernels only read the arrays filled by AddPair
+	void					Run(WorkerPool* pool = nullptr);
+	// Contacts come out with the colliders in the order they were added, same as IsTouching would give
+	void					AppendContacts(NarrowphaseContactList& outContacts) const;
+
+private:
+	DiscDiscPairs2D_T		m_discDiscPairs;
+	std::vector<Collider2D*>	m_discDiscColliders;			//A and B of each pair, interleaved
+
+	DiscAABB2Pairs2D_T		m_discBoxPairs;
+	std::vector<Collider2D*>	m_discBoxColliders;				//As added so the box can be first, interleaved
+	std::vector<uint8_t>	m_isBoxFirst;					//Flips the normal back, like GetManifold(box, disc)
+
+	//Disc vs disc results first, then disc vs box
+	std::vector<Manifold2D>	m_manifolds;
+	std::vector<uint8_t>	m_isHit;
+};
@@ -0,0 +1,355 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Math/PhysicsQuery2D.hpp"
+#include "Engine/Commons/UnitTest.hpp"
+#include "Engine/Math/AABB2.hpp"
+#include "Engine/Math/Collider2D.hpp"
+#include "Engine/Math/CollisionHandler.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/OBB2.hpp"
+#include "Engine/Math/PhysicsSystem.hpp"
+#include "Engine/Math/PhysicsTestHelpers2D.hpp"
+#include "Engine/Math/Rigidbody2D.hpp"
+#include <float.h>
+#include <math.h>
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Slab test in the box's frame
+static bool RaycastBox(float* outDistance, Vec2* outNormal, const Vec2& start, const Vec2& direction, float maxDistance, const Vec2& center, const Vec2& right, const Vec2& up, const Vec2& halfExtents)
+{
+	Vec2 displacement = start - center;
+	const float localStart[2] = { GetDotProduct(displacement, right), GetDotProduct(displacement, up) };
+	const float localDirection[2] = { GetDotProduct(direction, right), GetDotProduct(direction, up) };
+	const float extents[2] = { halfExtents.x, halfExtents.y };
+	const Vec2 axes[2] = { right, up };
+
+	float entry = -FLT_MAX;
+	float exit = FLT_MAX;
+	Vec2 entryNormal = Vec2::ZERO;
+
+	for (int axis = 0; axis < 2; ++axis)
+	{
+		if (fabsf(localDirection[axis]) < 1e-8f)
+		{
+			if (fabsf(localStart[axis]) > extents[axis])
+			{
+				return false;
+			}
+			continue;
+		}
+
+		//Moving up the axis we come in through the negative face
+		float inverseDirection = 1.f / localDirection[axis];
+		float slabEntry = (-extents[axis] - localStart[axis]) * inverseDirection;
+		float slabExit = (extents[axis] - localStart[axis]) * inverseDirection;
+		float faceSign = -1.f;
+		if (slabEntry > slabExit)
+		{
+			float swap = slabEntry;
+			slabEntry = slabExit;
+			slabExit = swap;
+			faceSign = 1.f;
+		}
+
+		if (slabEntry > entry)
+		{
+			entry = slabEntry;
+			entryNormal = axes[axis] * faceSign;
+		}
+		exit = (slabExit < exit) ? slabExit : exit;
+
+		if (entry > exit)
+		{
+			return false;
+		}
+	}
+
+	if (exit < 0.f || entry > maxDistance)
+	{
+		return false;
+	}
+
+	if (entry < 0.f)
+	{
+		*outDistance = 0.f;
+		*outNormal = direction * -1.f;
+		return true;
+	}
+
+	*outDistance = entry;
+	*outNormal = entryNormal;
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static bool RaycastDisc(float* outDistance, Vec2* outNormal, const Vec2& start, const Vec2& direction, float maxDistance, const Vec2& centre, float radius)
+{
+	if (radius <= 0.f)
+	{
+		return false;
+	}
+
+	Vec2 end = start + direction * maxDistance;
+	Vec2 closestPoint = GetClosestPointOnLineSegment2D(centre, start, end);
+	if (GetDistanceSquared2D(closestPoint, centre) >= radius * radius)
+	{
+		return false;
+	}
+
+	if (GetDistanceSquared2D(start, centre) <= radius * radius)
+	{
+		*outDistance = 0.f;
+		*outNormal = direction * -1.f;
+		return true;
+	}
+
+	float distance = GetRayImpactFractionVsDisc2D(start, direction, maxDistance, centre, radius);
+	*outDistance = distance;
+	*outNormal = (start + direction * distance - centre).GetNormalized();
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// A box grown by radius with rounded corners, the two stretched boxes cover the flat sides and a disc per corner the rest.
+// Capsules are a box with no width rounded by their radius
+static bool RaycastRoundedBox(float* outDistance, Vec2* outNormal, const Vec2& start, const Vec2& direction, float maxDistance, const OBB2& box, float radius)
+{
+	float bestDistance = FLT_MAX;
+	Vec2 bestNormal = Vec2::ZERO;
+
+	float distance;
+	Vec2 normal;
+	const Vec2& halfExtents = box.GetHalfExtents();
+
+	if (RaycastBox(&distance, &normal, start, direction, maxDistance, box.GetCenter(), box.GetRight(), box.GetUp(), Vec2(halfExtents.x + radius, halfExtents.y)) && distance < bestDistance)
+	{
+		bestDistance = distance;
+		bestNormal = normal;
+	}
+
+	if (radius > 0.f)
+	{
+		if (RaycastBox(&distance, &normal, start, direction, maxDistance, box.GetCenter(), box.GetRight(), box.GetUp(), Vec2(halfExtents.x, halfExtents.y + radius)) && distance < bestDistance)
+		{
+			bestDistance = distance;
+			bestNormal = normal;
+		}
+
+		Vec2 corners[4];
+		box.GetCorners(corners);
+		for (int cornerIndex = 0; cornerIndex < 4; ++cornerIndex)
+		{
+			if (RaycastDisc(&distance, &normal, start, direction, maxDistance, corners[cornerIndex], radius) && distance < bestDistance)
+			{
+				bestDistance = distance;
+				bestNormal = normal;
+			}
+		}
+	}
+
+	if (bestDistance == FLT_MAX)
+	{
+		return false;
+	}
+
+	*outDistance = bestDistance;
+	*outNormal = bestNormal;
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool RaycastCollider2D( RaycastHit2D_T* out, const Collider2D& collider, const Vec2& start, const Vec2& direction, float maxDistance, float castRadius /*= 0.f*/ )
+{
+	float distance = 0.f;
+	Vec2 normal = Vec2::ZERO;
+	bool isHit = false;
+
+	switch (collider.m_colliderType)
+	{
+	case COLLIDER_AABB2:
+	{
+		AABB2 box = static_cast<const AABB2Collider&>(collider).GetWorldShape();
+		isHit = RaycastRoundedBox(&distance, &normal, start, direction, maxDistance, OBB2(box), castRadius);
+	}
+	break;
+	case COLLIDER_DISC:
+	{
+		Disc2D disc = static_cast<const Disc2DCollider&>(collider).GetWorldShape();
+		isHit = RaycastDisc(&distance, &normal, start, direction, maxDistance, disc.GetCentre(), disc.GetRadius() + castRadius);
+	}
+	break;
+	case COLLIDER_BOX:
+	{
+		OBB2 box = static_cast<const BoxCollider2D&>(collider).GetWorldShape();
+		isHit = RaycastRoundedBox(&distance, &normal, start, direction, maxDistance, box, castRadius);
+	}
+	break;
+	case COLLIDER_CAPSULE:
+	{
+		const CapsuleCollider2D& capsule = static_cast<const CapsuleCollider2D&>(collider);
+		isHit = RaycastRoundedBox(&distance, &normal, start, direction, maxDistance, capsule.GetWorldShape(), capsule.GetCapsuleRadius() + castRadius);
+	}
+	break;
+	default:
+		break;
+	}
+
+	if (!isHit)
+	{
+		return false;
+	}
+
+	out->m_collider = const_cast<Collider2D*>(&collider);
+	out->m_distance = distance;
+	out->m_normal = normal;
+	out->m_point = (distance > 0.f) ? start + direction * distance - normal * castRadius : start;
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool DoesColliderOverlapAABB2( const Collider2D& collider, const AABB2& box )
+{
+	Manifold2D manifold;
+
+	switch (collider.m_colliderType)
+	{
+	case COLLIDER_AABB2:
+	{
+		AABB2 shape = static_cast<const AABB2Collider&>(collider).GetWorldShape();
+		return shape.m_minBounds.x <= box.m_maxBounds.x && box.m_minBounds.x <= shape.m_maxBounds.x && shape.m_minBounds.y <= box.m_maxBounds.y && box.m_minBounds.y <= shape.m_maxBounds.y;
+	}
+	case COLLIDER_DISC:
+	{
+		Disc2D disc = static_cast<const Disc2DCollider&>(collider).GetWorldShape();
+		return GetManifold(&manifold, disc.GetCentre(), disc.GetRadius(), OBB2(box));
+	}
+	case COLLIDER_BOX:
+		return GetManifold(&manifold, OBB2(box), static_cast<const BoxCollider2D&>(collider).GetWorldShape());
+	case COLLIDER_CAPSULE:
+	{
+		const CapsuleCollider2D& capsule = static_cast<const CapsuleCollider2D&>(collider);
+		return GetManifold(&manifold, OBB2(box), 0.f, capsule.GetWorldShape(), capsule.GetCapsuleRadius());
+	}
+	default:
+		return false;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool DoesColliderOverlapDisc2D( const Collider2D& collider, const Vec2& centre, float radius )
+{
+	Manifold2D manifold;
+
+	switch (collider.m_colliderType)
+	{
+	case COLLIDER_AABB2:
+		return GetManifold(&manifold, centre, radius, OBB2(static_cast<const AABB2Collider&>(collider).GetWorldShape()));
+	case COLLIDER_DISC:
+	{
+		Disc2D disc = static_cast<const Disc2DCollider&>(collider).GetWorldShape();
+		return DoDiscsOverlap(centre, radius, disc.GetCentre(), disc.GetRadius());
+	}
+	case COLLIDER_BOX:
+		return GetManifold(&manifold, centre, radius, static_cast<const BoxCollider2D&>(collider).GetWorldShape());
+	case COLLIDER_CAPSULE:
+	{
+		const CapsuleCollider2D& capsule = static_cast<const CapsuleCollider2D&>(collider);
+		OBB2 bone = capsule.GetWorldShape();
+		Vec2 closestPoint = GetClosestPointOnLineSegment2D(centre, bone.GetBottomLeft(), bone.GetTopRight());
+		float touchDistance = radius + capsule.GetCapsuleRadius();
+		return GetDistanceSquared2D(centre, closestPoint) < touchDistance * touchDistance;
+	}
+	default:
+		return false;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// UNIT TEST
+//------------------------------------------------------------------------------------------------------------------------------
+constexpr float QUERY_TEST_SPACING = 10.f;
+constexpr float QUERY_TEST_STEP = 1.f / 60.f;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Distance from the centre to the side and to the top of a unit sized test collider
+static Vec2 GetQueryTestExtents(eColliderType2D type)
+{
+	return (type == COLLIDER_CAPSULE) ? Vec2(0.25f, 0.75f) : Vec2(0.5f, 0.5f);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+UNITTEST("PhysicsQueries", "Physics", 100)
+{
+	for (int broadphaseType = 0; broadphaseType < NUM_BROADPHASE_TYPES; ++broadphaseType)
+	{
+		//One static collider of each type in a row, far enough apart that a query only ever reaches one
+		PhysicsSystem system((eBroadphaseType)broadphaseType);
+		std::vector<Transform2> transforms(NUM_COLLIDER_TYPES);
+		std::vector<Rigidbody2D*> bodies;
+		for (int colliderType = 0; colliderType < NUM_COLLIDER_TYPES; ++colliderType)
+		{
+			transforms[colliderType].m_position = Vec2((float)colliderType * QUERY_TEST_SPACING, 0.f);
+			bodies.push_back(AddTestBody(system, STATIC_SIMULATION, (eColliderType2D)colliderType, &transforms[colliderType]));
+		}
+		system.Update(QUERY_TEST_STEP);
+
+		std::vector<Collider2D*> overlaps;
+		for (int colliderType = 0; colliderType < NUM_COLLIDER_TYPES; ++colliderType)
+		{
+			Collider2D* collider = bodies[colliderType]->m_collider;
+			Vec2 centre = transforms[colliderType].m_position;
+			Vec2 extents = GetQueryTestExtents((eColliderType2D)colliderType);
+
+			//Straight down onto the top, and just past the side
+			RaycastHit2D_T hit;
+			CONFIRM(system.Raycast(&hit, centre + Vec2(0.f, 5.f), Vec2(0.f, -1.f), 10.f));
+			CONFIRM(hit.m_collider == collider);
+			CONFIRM(fabsf(hit.m_distance - (5.f - extents.y)) < 0.001f);
+			CONFIRM(hit.m_normal.y > 0.999f);
+			CONFIRM(!system.Raycast(&hit, centre + Vec2(extents.x + 0.05f, 5.f), Vec2(0.f, -1.f), 10.f));
+			CONFIRM(!system.Raycast(&hit, centre + Vec2(0.f, 5.f), Vec2(0.f, -1.f), 4.f - extents.y));
+
+			//A small box or disc just inside the side touches, one just outside doesn't
+			CONFIRM(system.OverlapAABB(overlaps, AABB2(centre + Vec2(extents.x - 0.05f, -0.05f), centre + Vec2(extents.x + 0.2f, 0.05f))) == 1U);
+			CONFIRM(overlaps[0] == collider);
+			CONFIRM(system.OverlapAABB(overlaps, AABB2(centre + Vec2(extents.x + 0.05f, -0.05f), centre + Vec2(extents.x + 0.2f, 0.05f))) == 0U);
+			CONFIRM(system.OverlapDisc(overlaps, centre + Vec2(extents.x + 0.1f, 0.f), 0.15f) == 1U);
+			CONFIRM(overlaps[0] == collider);
+			CONFIRM(system.OverlapDisc(overlaps, centre + Vec2(extents.x + 0.1f, 0.f), 0.05f) == 0U);
+		}
+
+		//Along the row every collider is hit, nearest first
+		RaycastHitList hits;
+		CONFIRM(system.RaycastAll(hits, Vec2(-5.f, 0.f), Vec2(1.f, 0.f), QUERY_TEST_SPACING * (float)NUM_COLLIDER_TYPES) == (uint)NUM_COLLIDER_TYPES);
+		for (int colliderType = 0; colliderType < NUM_COLLIDER_TYPES; ++colliderType)
+		{
+			CONFIRM(hits[colliderType].m_collider == bodies[colliderType]->m_collider);
+		}
+	}
+
+	//A box that lands inside the ground is pushed out after the broadphase saw it, the query margin still covers where it
+	//ends up
+	for (int broadphaseType = 0; broadphaseType < NUM_BROADPHASE_TYPES; ++broadphaseType)
+	{
+		PhysicsSystem system((eBroadphaseType)broadphaseType);
+		std::vector<Transform2> transforms(2U);
+		transforms[0].m_position = Vec2(0.f, -0.5f);
+		AddTestBody(system, STATIC_SIMULATION, COLLIDER_AABB2, &transforms[0], Vec2(20.f, 1.f));
+		transforms[1].m_position = Vec2(0.f, 0.4f);
+		Rigidbody2D* box = AddTestBody(system, DYNAMIC_SIMULATION, COLLIDER_AABB2, &transforms[1]);
+
+		system.Update(QUERY_TEST_STEP);
+
+		float top = box->m_collider->GetWorldBounds().m_maxBounds.y;
+		CONFIRM(top > 0.95f);
+
+		RaycastHit2D_T hit;
+		CONFIRM(system.Raycast(&hit, Vec2(-5.f, top - 0.01f), Vec2(1.f, 0.f), 10.f));
+		CONFIRM(hit.m_collider == box->m_collider);
+
+		std::vector<Collider2D*> overlaps;
+		CONFIRM(system.OverlapAABB(overlaps, AABB2(Vec2(-0.1f, top - 0.01f), Vec2(0.1f, top + 0.5f))) == 1U);
+		CONFIRM(overlaps[0] == box->m_collider);
+	}
+
+	return true;
+}
@@ -0,0 +1,42 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+#include "Engine/Math/Vec2.hpp"
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------------
+class Collider2D;
+struct AABB2;
+
+typedef unsigned int uint;
+
+//------------------------------------------------------------------------------------------------------------------------------
+constexpr uint ALL_PHYSICS_LAYERS = 0xFFFFFFFFU;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// m_collider is nullptr when nothing was hit. m_point is on the surface of the collider that was hit
+struct RaycastHit2D_T
+{
+	Collider2D*		m_collider = nullptr;
+	Vec2			m_point = Vec2::ZERO;
+	Vec2			m_normal = Vec2::ZERO;			//Out of the collider, back towards the caster
+	float			m_distance = 0.f;				//Along the direction from the start
+};
+
+typedef std::vector<RaycastHit2D_T> RaycastHitList;
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct RaycastQuery2D_T
+{
+	Vec2			m_start = Vec2::ZERO;
+	Vec2			m_direction = Vec2(1.f, 0.f);	//Normalized
+	float			m_maxDistance = 0.f;
+	uint			m_layerMask = ALL_PHYSICS_LAYERS;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Narrowphase for the scene queries, against the collider's world shape. A cast that starts inside the shape hits at
+// distance 0 with the normal facing back along the direction. castRadius above 0 sweeps a disc instead of a point,
+// the hit point is then where the disc first touches the collider
+bool		RaycastCollider2D( RaycastHit2D_T* out, const Collider2D& collider, const Vec2& start, const Vec2& direction, float maxDistance, float castRadius = 0.f );
+bool		DoesColliderOverlapAABB2( const Collider2D& collider, const AABB2& box );
+bool		DoesColliderOverlapDisc2D( const Collider2D& collider, const Vec2& centre, float radius );
@@ -0,0 +1,372 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Math/PhysicsSnapshot2D.hpp"
+#include "Engine/Commons/UnitTest.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Math/Collider2D.hpp"
+#include "Engine/Math/PhysicsSystem.hpp"
+#include "Engine/Math/PhysicsTestHelpers2D.hpp"
+#include "Engine/Math/Rigidbody2D.hpp"
+#include <string.h>
+
+//------------------------------------------------------------------------------------------------------------------------------
+constexpr uint SNAPSHOT_HEADER_WORDS = sizeof(PhysicsSnapshotHeader_T) / sizeof(uint);
+constexpr uint SNAPSHOT_BODY_WORDS = sizeof(BodySnapshot2D_T) / sizeof(uint);
+constexpr uint SNAPSHOT_CONTACT_WORDS = sizeof(WarmStartContact2D_T) / sizeof(uint);
+constexpr uint MAX_DELTA_RUN = 0xFFFFU;
+
+//------------------------------------------------------------------------------------------------------------------------------
+PhysicsSnapshot2D::PhysicsSnapshot2D()
+{
+	Reset(0U, 0U);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+PhysicsSnapshot2D::~PhysicsSnapshot2D()
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void PhysicsSnapshot2D::Reset(uint numBodies, uint numContacts)
+{
+	m_words.resize(SNAPSHOT_HEADER_WORDS + numBodies * SNAPSHOT_BODY_WORDS + numContacts * SNAPSHOT_CONTACT_WORDS);
+
+	PhysicsSnapshotHeader_T& header = GetHeader();
+	header = PhysicsSnapshotHeader_T();
+	header.m_numBodies = numBodies;
+	header.m_numContacts = numContacts;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+const BodySnapshot2D_T* PhysicsSnapshot2D::GetBodies() const
+{
+	return reinterpret_cast<const BodySnapshot2D_T*>(m_words.data() + SNAPSHOT_HEADER_WORDS);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+BodySnapshot2D_T* PhysicsSnapshot2D::GetBodies()
+{
+	return reinterpret_cast<BodySnapshot2D_T*>(m_words.data() + SNAPSHOT_HEADER_WORDS);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+const WarmStartContact2D_T* PhysicsSnapshot2D::GetContacts() const
+{
+	return reinterpret_cast<const WarmStartContact2D_T*>(m_words.data() + SNAPSHOT_HEADER_WORDS + GetHeader().m_numBodies * SNAPSHOT_BODY_WORDS);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+WarmStartContact2D_T* PhysicsSnapshot2D::GetContacts()
+{
+	return reinterpret_cast<WarmStartContact2D_T*>(m_words.data() + SNAPSHOT_HEADER_WORDS + GetHeader().m_numBodies * SNAPSHOT_BODY_WORDS);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void PhysicsSnapshot2D::SetWords(const uint* words, uint wordCount)
+{
+	m_words.resize(wordCount);
+	memcpy(m_words.data(), words, wordCount * sizeof(uint));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void PhysicsSnapshot2D::ResizeWords(uint wordCount)
+{
+	m_words.resize(wordCount);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Bitwise, so -0 and 0 differ and a NaN equals itself. That is what a deterministic replay has to reproduce
+bool PhysicsSnapshot2D::operator==(const PhysicsSnapshot2D& compare) const
+{
+	return m_words.size() == compare.m_words.size() && memcmp(m_words.data(), compare.m_words.data(), m_words.size() * sizeof(uint)) == 0;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Words past the end of the base read as zero, so blocks of different sizes still line up word for word
+static inline uint GetBaseWord( const uint* baseWords, uint baseWordCount, uint wordIndex )
+{
+	return (wordIndex < baseWordCount) ? baseWords[wordIndex] : 0U;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void EncodeXorDelta( std::vector<uint>& outEncoded, const uint* words, uint wordCount, const uint* baseWords, uint baseWordCount )
+{
+	outEncoded.clear();
+
+	uint wordIndex = 0U;
+	while (wordIndex < wordCount)
+	{
+		uint unchangedCount = 0U;
+		while (wordIndex < wordCount && words[wordIndex] == GetBaseWord(baseWords, baseWordCount, wordIndex) && unchangedCount < MAX_DELTA_RUN)
+		{
+			++unchangedCount;
+			++wordIndex;
+		}
+
+		//Reserve the token, the changed count is only known once the run ends
+		uint tokenIndex = (uint)outEncoded.size();
+		outEncoded.push_back(0U);
+
+		uint changedCount = 0U;
+		while (wordIndex < wordCount && words[wordIndex] != GetBaseWord(baseWords, baseWordCount, wordIndex) && changedCount < MAX_DELTA_RUN)
+		{
+			outEncoded.push_back(words[wordIndex] ^ GetBaseWord(baseWords, baseWordCount, wordIndex));
+			++changedCount;
+			++wordIndex;
+		}
+
+		outEncoded[tokenIndex] = (unchangedCount << 16U) | changedCount;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void ApplyXorDelta( uint* inOutWords, uint wordCount, const uint* encoded, uint encodedCount )
+{
+	uint wordIndex = 0U;
+	uint encodedIndex = 0U;
+	while (encodedIndex < encodedCount)
+	{
+		uint token = encoded[encodedIndex++];
+		wordIndex += token >> 16U;
+
+		uint changedCount = token & MAX_DELTA_RUN;
+		ASSERT_OR_DIE(wordIndex + changedCount <= wordCount, "XOR delta runs past the end of the snapshot");
+		for (uint changedIndex = 0U; changedIndex < changedCount; ++changedIndex)
+		{
+			inOutWords[wordIndex++] ^= encoded[encodedIndex++];
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+PhysicsSnapshotRing2D::PhysicsSnapshotRing2D(uint capacity)
+{
+	m_frames.resize((capacity > 1U) ? capacity - 1U : 0U);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+PhysicsSnapshotRing2D::~PhysicsSnapshotRing2D()
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void PhysicsSnapshotRing2D::Clear()
+{
+	m_count = 0U;
+	m_newestIndex = 0U;
+	m_newestFrame = 0U;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void PhysicsSnapshotRing2D::Push(const PhysicsSnapshot2D& snapshot)
+{
+	uint numOlderFrames = (uint)m_frames.size();
+	if (m_count > 0U && numOlderFrames > 0U)
+	{
+		//The current newest becomes the way back from the one being pushed, overwriting the oldest when full
+		m_newestIndex = (m_newestIndex + 1U) % numOlderFrames;
+		RingFrame_T& frame = m_frames[m_newestIndex];
+		frame.m_frameCount = m_newestFrame;
+		frame.m_wordCount = m_newest.GetWordCount();
+
+		EncodeXorDelta(m_deltaWords, m_newest.GetWords(), frame.m_wordCount, snapshot.GetWords(), snapshot.GetWordCount());
+		frame.m_deltaWordCount = (uint)m_deltaWords.size();
+
+		//Sized to the bound so CompressBlock can't fail, shrinking after keeps the capacity for the next time round
+		size_t deltaSize = m_deltaWords.size() * sizeof(uint);
+		frame.m_compressedDelta.resize(GetCompressedBlockBound(deltaSize));
+		size_t compressedSize = CompressBlock(reinterpret_cast<const byte*>(m_deltaWords.data()), deltaSize, frame.m_compressedDelta.data(), frame.m_compressedDelta.size());
+		frame.m_compressedDelta.resize(compressedSize);
+	}
+
+	m_newest.SetWords(snapshot.GetWords(), snapshot.GetWordCount());
+	m_newestFrame = snapshot.GetHeader().m_frameCount;
+	m_count = (m_count < numOlderFrames + 1U) ? m_count + 1U : m_count;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool PhysicsSnapshotRing2D::GetSnapshot(PhysicsSnapshot2D* outSnapshot, uint frameCount) const
+{
+	if (m_count == 0U)
+	{
+		return false;
+	}
+
+	outSnapshot->SetWords(m_newest.GetWords(), m_newest.GetWordCount());
+	if (frameCount == m_newestFrame)
+	{
+		return true;
+	}
+
+	std::vector<uint> deltaWords;
+	uint numOlderFrames = (uint)m_frames.size();
+	for (uint framesBack = 0U; framesBack + 1U < m_count; ++framesBack)
+	{
+		const RingFrame_T& frame = m_frames[(m_newestIndex + numOlderFrames - framesBack) % numOlderFrames];
+		size_t deltaSize = frame.m_deltaWordCount * sizeof(uint);
+		deltaWords.resize(frame.m_deltaWordCount);
+
+		size_t decompressedSize = DecompressBlock(frame.m_compressedDelta.data(), frame.m_compressedDelta.size(), reinterpret_cast<byte*>(deltaWords.data()), deltaSize);
+		ASSERT_OR_DIE(decompressedSize == deltaSize, "Snapshot ring delta failed to decompress");
+
+		//The delta was taken against the newer frame read as zero past its end, so size to the older frame first
+		outSnapshot->ResizeWords(frame.m_wordCount);
+		ApplyXorDelta(outSnapshot->GetWords(), frame.m_wordCount, deltaWords.data(), frame.m_deltaWordCount);
+
+		if (frame.m_frameCount == frameCount)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint PhysicsSnapshotRing2D::GetStoredByteCount() const
+{
+	if (m_count == 0U)
+	{
+		return 0U;
+	}
+
+	uint byteCount = m_newest.GetWordCount() * sizeof(uint);
+	uint numOlderFrames = (uint)m_frames.size();
+	for (uint framesBack = 0U; framesBack + 1U < m_count; ++framesBack)
+	{
+		byteCount += (uint)m_frames[(m_newestIndex + numOlderFrames - framesBack) % numOlderFrames].m_compressedDelta.size();
+	}
+	return byteCount;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// UNIT TEST
+//------------------------------------------------------------------------------------------------------------------------------
+constexpr uint SNAPSHOT_TEST_GRID_SIZE = 32U;
+constexpr uint SNAPSHOT_TEST_BODIES = SNAPSHOT_TEST_GRID_SIZE * SNAPSHOT_TEST_GRID_SIZE;
+constexpr float SNAPSHOT_TEST_STEP = 1.f / 60.f;
+constexpr double SNAPSHOT_TARGET_MICROSECONDS_PER_1K_BODIES = 100.0;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// A pile of discs and boxes dropping onto the ground. The transforms are the game objects, they must not move once the
+// bodies point at them
+static void MakeSnapshotTestScene(PhysicsSystem& system, std::vector<Transform2>& outTransforms)
+{
+	system.EnableContactSolver();
+	system.SetSleepingEnabled(true);
+
+	outTransforms.resize(SNAPSHOT_TEST_BODIES + 1U);
+	outTransforms[SNAPSHOT_TEST_BODIES].m_position = Vec2(0.f, -0.5f);
+	AddTestBody(system, STATIC_SIMULATION, COLLIDER_AABB2, &outTransforms[SNAPSHOT_TEST_BODIES], Vec2(80.f, 1.f));
+
+	for (uint bodyIndex = 0; bodyIndex < SNAPSHOT_TEST_BODIES; ++bodyIndex)
+	{
+		uint column = bodyIndex % SNAPSHOT_TEST_GRID_SIZE;
+		uint row = bodyIndex / SNAPSHOT_TEST_GRID_SIZE;
+		outTransforms[bodyIndex].m_position = Vec2((float)column - SNAPSHOT_TEST_GRID_SIZE * 0.5f + 0.1f * (float)(row % 3U), 0.5f + (float)row * 0.85f);
+		AddTestBody(system, DYNAMIC_SIMULATION, (bodyIndex % 2U == 0U) ? COLLIDER_DISC : COLLIDER_AABB2, &outTransforms[bodyIndex], Vec2(0.8f, 0.8f));
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+UNITTEST("PhysicsSnapshot", "Physics", 100)
+{
+	constexpr uint NUM_FRAMES = 60U;
+	constexpr uint ROLLBACK_FRAMES = 8U;
+
+	PhysicsSystem system(BROADPHASE_AABB_TREE);
+	std::vector<Transform2> transforms;
+	MakeSnapshotTestScene(system, transforms);
+
+	PhysicsSnapshotRing2D ring(16U);
+	PhysicsSnapshot2D snapshot;
+	std::vector<PhysicsSnapshot2D> savedSnapshots(NUM_FRAMES);
+	for (uint frameIndex = 0U; frameIndex < NUM_FRAMES; ++frameIndex)
+	{
+		system.Update(SNAPSHOT_TEST_STEP);
+		system.SaveSnapshot(snapshot);
+		ring.Push(snapshot);
+		savedSnapshots[frameIndex] = snapshot;
+	}
+	PhysicsSnapshot2D finalSnapshot = snapshot;
+
+	//Every frame still in the ring decodes to what was pushed, across the frames where the contact count changed size
+	bool isEveryFrameDecoded = true;
+	PhysicsSnapshot2D decodedSnapshot;
+	for (uint framesBack = 0U; framesBack < ring.GetCount(); ++framesBack)
+	{
+		const PhysicsSnapshot2D& savedSnapshot = savedSnapshots[NUM_FRAMES - 1U - framesBack];
+		bool isDecoded = ring.GetSnapshot(&decodedSnapshot, savedSnapshot.GetHeader().m_frameCount) && decodedSnapshot == savedSnapshot;
+		isEveryFrameDecoded = isEveryFrameDecoded && isDecoded;
+	}
+
+	//Roll back and simulate the same frames again, the state has to come out bit for bit the same
+	PhysicsSnapshot2D rollbackSnapshot;
+	uint rollbackFrame = ring.GetNewestFrame() - ROLLBACK_FRAMES;
+	bool isFound = ring.GetSnapshot(&rollbackSnapshot, rollbackFrame);
+	bool isRestored = isFound && system.RestoreSnapshot(rollbackSnapshot);
+
+	for (uint frameIndex = 0U; frameIndex < ROLLBACK_FRAMES; ++frameIndex)
+	{
+		system.Update(SNAPSHOT_TEST_STEP);
+	}
+	system.SaveSnapshot(snapshot);
+
+	//The pile is still settling and the contact count changes every frame, the ring should hold well under a third anyway
+	uint wholeBytes = ring.GetCount() * finalSnapshot.GetWordCount() * (uint)sizeof(uint);
+
+	CONFIRM(isEveryFrameDecoded);
+	CONFIRM(isFound);
+	CONFIRM(isRestored);
+	CONFIRM(snapshot == finalSnapshot);
+	CONFIRM(ring.GetStoredByteCount() * 3U < wholeBytes);
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+UNITTEST("PhysicsSnapshot", "PhysicsBenchmark", 100)
+{
+	constexpr uint NUM_FRAMES = 60U;
+
+	PhysicsSystem system(BROADPHASE_AABB_TREE);
+	std::vector<Transform2> transforms;
+	MakeSnapshotTestScene(system, transforms);
+
+	PhysicsSnapshotRing2D ring(16U);
+	PhysicsSnapshot2D snapshot;
+	double saveSeconds = 0.0;
+	for (uint frameIndex = 0U; frameIndex < NUM_FRAMES; ++frameIndex)
+	{
+		system.Update(SNAPSHOT_TEST_STEP);
+
+		double startTime = GetCurrentTimeSeconds();
+		system.SaveSnapshot(snapshot);
+		saveSeconds += GetCurrentTimeSeconds() - startTime;
+		ring.Push(snapshot);
+	}
+
+	//Restoring the same frame again is the same work, so keep the fastest and a restore the scheduler cut into doesn't count
+	constexpr uint NUM_RESTORES = 16U;
+	PhysicsSnapshot2D rollbackSnapshot;
+	ring.GetSnapshot(&rollbackSnapshot, ring.GetNewestFrame() - 8U);
+
+	bool isRestored = true;
+	double restoreSeconds = 1.0;
+	for (uint restoreIndex = 0U; restoreIndex < NUM_RESTORES; ++restoreIndex)
+	{
+		double startTime = GetCurrentTimeSeconds();
+		isRestored = system.RestoreSnapshot(rollbackSnapshot) && isRestored;
+		restoreSeconds = std::min(restoreSeconds, GetCurrentTimeSeconds() - startTime);
+	}
+
+	double saveMicroseconds = saveSeconds * 1000000.0 / NUM_FRAMES;
+	double restoreMicroseconds = restoreSeconds * 1000000.0;
+	double targetMicroseconds = SNAPSHOT_TARGET_MICROSECONDS_PER_1K_BODIES * SNAPSHOT_TEST_BODIES / 1000.0;
+
+	DebuggerPrintf("\n Physics snapshot of %u bodies and %u contacts: save %.1f us, restore %.1f us, ring of %u frames holds %u of %u bytes",
+		SNAPSHOT_TEST_BODIES, snapshot.GetHeader().m_numContacts, saveMicroseconds, restoreMicroseconds, ring.GetCount(), ring.GetStoredByteCount(), ring.GetCount() * snapshot.GetWordCount() * (uint)sizeof(uint));
+
+	CONFIRM(isRestored);
+	CONFIRM(saveMicroseconds < targetMicroseconds);
+	CONFIRM(restoreMicroseconds < targetMicroseconds);
+	return true;
+}
@@ -0,0 +1,130 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+#include "Engine/Commons/EngineCommon.hpp"
+#include "Engine/Core/BlockCompressor.hpp"
+#include "Engine/Math/ContactSolver2D.hpp"
+#include <stdint.h>
+#include <type_traits>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Everything in a snapshot is 4 byte words with no pointers, so a snapshot is one flat block that copies with a memcpy and
+// two snapshots of the same bodies can be XORed word by word. Vec2 has a user copy constructor, hence the loose floats
+//------------------------------------------------------------------------------------------------------------------------------
+struct PhysicsSnapshotHeader_T
+{
+	uint		m_frameCount = 0U;
+	float		m_timeAccumulator = 0.f;
+	float		m_interpolationAlpha = 1.f;
+	uint		m_numBodies = 0U;
+	uint		m_numContacts = 0U;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct BodySnapshot2D_T
+{
+	uint		m_bodyId;
+	float		m_positionX;
+	float		m_positionY;
+	float		m_rotation;
+	float		m_velocityX;
+	float		m_velocityY;
+	float		m_angularVelocity;
+	float		m_frameForcesX;
+	float		m_frameForcesY;
+	float		m_frameTorque;
+	float		m_previousPositionX;
+	float		m_previousPositionY;
+	float		m_previousRotation;
+	float		m_sleepTime;
+	float		m_sleepPositionX;
+	float		m_sleepPositionY;
+	uint		m_isAwake;
+};
+
+static_assert(std::is_trivially_copyable<BodySnapshot2D_T>::value && sizeof(BodySnapshot2D_T) % sizeof(uint) == 0, "Snapshots are copied as raw words");
+static_assert(std::is_trivially_copyable<WarmStartContact2D_T>::value && sizeof(WarmStartContact2D_T) % sizeof(uint) == 0, "Snapshots are copied as raw words");
+
+//------------------------------------------------------------------------------------------------------------------------------
+// The state PhysicsSystem::SaveSnapshot captures: the header, then every body in bucket order, then the warm start contacts
+// sorted by body ids. Only valid for the system and bodies it was taken from, restoring needs the same bodies alive
+//------------------------------------------------------------------------------------------------------------------------------
+class PhysicsSnapshot2D
+{
+public:
+	PhysicsSnapshot2D();
+	~PhysicsSnapshot2D();
+
+	// Sizes the block, keeps its memory so saving every frame into the same snapshot doesn't allocate
+	void							Reset(uint numBodies, uint numContacts);
+
+	const PhysicsSnapshotHeader_T&	GetHeader() const			{ return *reinterpret_cast<const PhysicsSnapshotHeader_T*>(m_words.data()); }
+	PhysicsSnapshotHeader_T&		GetHeader()					{ return *reinterpret_cast<PhysicsSnapshotHeader_T*>(m_words.data()); }
+	const BodySnapshot2D_T*			GetBodies() const;
+	BodySnapshot2D_T*				GetBodies();
+	const WarmStartContact2D_T*		GetContacts() const;
+	WarmStartContact2D_T*			GetContacts();
+
+	uint							GetWordCount() const		{ return (uint)m_words.size(); }
+	const uint*						GetWords() const			{ return m_words.data(); }
+	uint*							GetWords()					{ return m_words.data(); }
+	void							SetWords(const uint* words, uint wordCount);
+	// Words past the old size come back zero
+	void							ResizeWords(uint wordCount);
+
+	bool							operator==(const PhysicsSnapshot2D& compare) const;
+
+private:
+	std::vector<uint>				m_words;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// The last capacity frames. Only the newest is kept whole, every older one is stored as the XOR delta going back to it from
+// the frame after, block compressed. Any change to a float makes its whole word non-zero, so the delta itself only drops
+// the words of sleeping bodies and settled contacts; the compressor then takes out the zero bytes left in the changed words,
+// the sign, exponent and top mantissa bits of a float that barely moved. Frames of different sizes (the contact count
+// changes most frames) still delta, the shorter one reads as zeros past its end. Getting a frame undoes the deltas from the
+// newest back, so recent frames are the cheap ones, which is what rollback wants
+//------------------------------------------------------------------------------------------------------------------------------
+class PhysicsSnapshotRing2D
+{
+public:
+	explicit PhysicsSnapshotRing2D(uint capacity);
+	~PhysicsSnapshotRing2D();
+
+	void							Clear();
+	// Frames are found by their header's frame count so push them in step order
+	void							Push(const PhysicsSnapshot2D& snapshot);
+	bool							GetSnapshot(PhysicsSnapshot2D* outSnapshot, uint frameCount) const;
+
+	uint							GetCount() const			{ return m_count; }
+	uint							GetNewestFrame() const		{ return m_newestFrame; }
+	// Bytes held for every frame together, to compare against GetCount() whole snapshots
+	uint							GetStoredByteCount() const;
+
+private:
+	struct RingFrame_T
+	{
+		uint						m_frameCount = 0U;
+		uint						m_wordCount = 0U;				//Size of the frame once decoded
+		uint						m_deltaWordCount = 0U;			//Size of the XOR delta once decompressed
+		std::vector<byte>			m_compressedDelta;
+	};
+
+private:
+	std::vector<RingFrame_T>		m_frames;						//Older frames, m_frames[m_newestIndex] is the one before the newest
+	uint							m_newestIndex = 0U;
+	uint							m_count = 0U;					//Including the newest
+
+	PhysicsSnapshot2D				m_newest;
+	uint							m_newestFrame = 0U;
+
+	std::vector<uint>				m_deltaWords;					//Kept between pushes so encoding doesn't allocate once warm
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// XOR delta of a word block against a base, base words past its end read as zero. Each run is a token word, unchanged words
+// in the high 16 bits and changed words in the low 16, followed by the changed words XORed with the base. Applying the
+// delta to the base, zero extended or cut to wordCount, gives the block
+void		EncodeXorDelta( std::vector<uint>& outEncoded, const uint* words, uint wordCount, const uint* baseWords, uint baseWordCount );
+void		ApplyXorDelta( uint* inOutWords, uint wordCount, const uint* encoded, uint encodedCount );
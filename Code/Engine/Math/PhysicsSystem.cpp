@@ -1,62 +1,340 @@
 //------------------------------------------------------------------------------------------------------------------------------
 #include "Engine/Math/PhysicsSystem.hpp"
+#include "Engine/Allocators/UntrackedAllocator.hpp"
+#include "Engine/Commons/UnitTest.hpp"
+#include "Engine/Core/Async/WorkerPool.hpp"
 #include "Engine/Core/EventSystems.hpp"
 #include "Engine/Core/NamedProperties.hpp"
+#include "Engine/Math/AABBTreeBroadphase.hpp"
 #include "Engine/Math/Collider2D.hpp"
 #include "Engine/Math/CollisionHandler.hpp"
+#include "Engine/Math/ContactSolver2D.hpp"
 #include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/PhysicsSnapshot2D.hpp"
+#include "Engine/Math/PhysicsTestHelpers2D.hpp"
 #include "Engine/Math/RigidBodyBucket.hpp"
 #include "Engine/Math/Rigidbody2D.hpp"
+#include "Engine/Math/SweepAndPruneBroadphase.hpp"
 #include "Engine/Math/Trigger2D.hpp"
 #include "Engine/Math/TriggerBucket.hpp"
 #include "Engine/Renderer/Rgba.hpp"
+#include <algorithm>
+#include <float.h>
+#include <math.h>
+#include <string.h>
 
 PhysicsSystem* g_physicsSystem = nullptr;
 
 //------------------------------------------------------------------------------------------------------------------------------
-PhysicsSystem::PhysicsSystem()
+PhysicsSystem::PhysicsSystem(eBroadphaseType broadphaseType /*= BROADPHASE_AABB_TREE*/, float cellSize /*= DEFAULT_SPATIAL_HASH_CELL_SIZE*/)
 {
 	m_rbBucket = new RigidBodyBucket;
 	m_triggerBucket = new TriggerBucket;
+
+	UntrackedAllocator* poolBase = UntrackedAllocator::GetInstance();
+	m_rigidbodyPool.Initialize(poolBase, PHYSICS_POOL_BLOCKS_PER_CHUNK);
+	m_triggerPool.Initialize(poolBase, PHYSICS_POOL_BLOCKS_PER_CHUNK);
+	m_aabb2ColliderPool.Initialize(poolBase, PHYSICS_POOL_BLOCKS_PER_CHUNK);
+	m_discColliderPool.Initialize(poolBase, PHYSICS_POOL_BLOCKS_PER_CHUNK);
+	m_boxColliderPool.Initialize(poolBase, PHYSICS_POOL_BLOCKS_PER_CHUNK);
+	m_capsuleColliderPool.Initialize(poolBase, PHYSICS_POOL_BLOCKS_PER_CHUNK);
+
+	m_broadphaseType = broadphaseType;
+	switch (m_broadphaseType)
+	{
+	case BROADPHASE_AABB_TREE:
+		m_broadphase = new AABBTreeBroadphase();
+		break;
+	case BROADPHASE_SPATIAL_HASH:
+		m_broadphase = new SpatialHashBroadphase(cellSize);
+		break;
+	case BROADPHASE_SWEEP_AND_PRUNE:
+		m_broadphase = new SweepAndPruneBroadphase();
+		break;
+	case BROADPHASE_BRUTE_FORCE:
+	default:
+		m_broadphase = nullptr;
+		break;
+	}
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
 PhysicsSystem::~PhysicsSystem()
 {
+	//Everything still in the buckets, or created and never added, goes through the queue so the destructors run and
+	//free the colliders before the pools are released
+	for (int rbTypes = 0; rbTypes < NUM_SIMULATION_TYPES; rbTypes++)
+	{
+		for (Rigidbody2D* rigidbody : m_rbBucket->m_RbBucket[rbTypes])
+		{
+			DestroyRigidbody(rigidbody);
+		}
+	}
+
+	for (Rigidbody2D* rigidbody : m_unaddedRigidbodies)
+	{
+		DestroyRigidbody(rigidbody);
+	}
+
+	for (int triggerTypes = 0; triggerTypes < NUM_SIMULATION_TYPES; triggerTypes++)
+	{
+		for (Trigger2D* trigger : m_triggerBucket->m_triggerBucket[triggerTypes])
+		{
+			DestroyTrigger(trigger);
+		}
+	}
+
+	for (Trigger2D* trigger : m_unaddedTriggers)
+	{
+		DestroyTrigger(trigger);
+	}
+
+	ProcessDestroyQueue();
+
+	m_rigidbodyPool.Deinitialize();
+	m_triggerPool.Deinitialize();
+	m_aabb2ColliderPool.Deinitialize();
+	m_discColliderPool.Deinitialize();
+	m_boxColliderPool.Deinitialize();
+	m_capsuleColliderPool.Deinitialize();
+
+	delete m_rbBucket;
+	m_rbBucket = nullptr;
+
+	delete m_triggerBucket;
+	m_triggerBucket = nullptr;
+
+	delete m_broadphase;
+	m_broadphase = nullptr;
+
+	delete m_narrowphasePool;
+	m_narrowphasePool = nullptr;
+
+	delete m_contactSolver;
+	m_contactSolver = nullptr;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void PhysicsSystem::SetNarrowphaseThreadCount(uint threadCount)
+{
+	delete m_narrowphasePool;
+	m_narrowphasePool = nullptr;
+	m_workerContacts.clear();
 
+	if (threadCount > 0U)
+	{
+		m_narrowphasePool = new WorkerPool(threadCount);
+		m_workerContacts.resize(threadCount);
+	}
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
 Rigidbody2D* PhysicsSystem::CreateRigidbody( eSimulationType simulationType )
 {
-	Rigidbody2D *rigidbody = new Rigidbody2D(this, simulationType);
+	Rigidbody2D *rigidbody = m_rigidbodyPool.Create(this, simulationType);
+	m_unaddedRigidbodies.push_back(rigidbody);
 	return rigidbody;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
 Trigger2D* PhysicsSystem::CreateTrigger(eSimulationType simulationType)
 {
-	Trigger2D *trigger = new Trigger2D(this, simulationType);
+	Trigger2D *trigger = m_triggerPool.Create(this, simulationType);
+	m_unaddedTriggers.push_back(trigger);
 	return trigger;
 }
 
+//------------------------------------------------------------------------------------------------------------------------------
+AABB2Collider* PhysicsSystem::CreateAABB2Collider(const Vec2& minBounds, const Vec2& maxBounds)
+{
+	AABB2Collider* collider = m_aabb2ColliderPool.Create(minBounds, maxBounds);
+	collider->SetColliderType(COLLIDER_AABB2);
+	collider->m_isPooled = true;
+	return collider;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+Disc2DCollider* PhysicsSystem::CreateDiscCollider(const Vec2& centre, float radius)
+{
+	Disc2DCollider* collider = m_discColliderPool.Create(centre, radius);
+	collider->SetColliderType(COLLIDER_DISC);
+	collider->m_isPooled = true;
+	return collider;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+BoxCollider2D* PhysicsSystem::CreateBoxCollider(const Vec2& center, const Vec2& size /*= Vec2::ZERO*/, float rotationDegrees /*= 0.f*/)
+{
+	BoxCollider2D* collider = m_boxColliderPool.Create(center, size, rotationDegrees);
+	collider->SetColliderType(COLLIDER_BOX);
+	collider->m_isPooled = true;
+	return collider;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+CapsuleCollider2D* PhysicsSystem::CreateCapsuleCollider(const Vec2& start, const Vec2& end, float radius)
+{
+	CapsuleCollider2D* collider = m_capsuleColliderPool.Create(start, end, radius);
+	collider->SetColliderType(COLLIDER_CAPSULE);
+	collider->m_isPooled = true;
+	return collider;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Searched from the back, things are usually added right after they are made
+template <typename OBJ>
+static void RemoveUnadded(std::vector<OBJ*>& unadded, const OBJ* object)
+{
+	for (size_t index = unadded.size(); index > 0; index--)
+	{
+		if (unadded[index - 1] == object)
+		{
+			unadded[index - 1] = unadded.back();
+			unadded.pop_back();
+			return;
+		}
+	}
+}
+
 //------------------------------------------------------------------------------------------------------------------------------
 void PhysicsSystem::AddRigidbodyToVector(Rigidbody2D* rigidbody)
 {
+	RemoveUnadded(m_unaddedRigidbodies, rigidbody);
 	m_rbBucket->m_RbBucket[rigidbody->GetSimulationType()].push_back(rigidbody);
+
+	if (rigidbody->GetSimulationType() == DYNAMIC_SIMULATION)
+	{
+		m_bodyStore.SetBodyIntegrated(rigidbody, rigidbody->IsAwake());
+	}
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
 void PhysicsSystem::AddTriggerToVector(Trigger2D* trigger)
 {
+	RemoveUnadded(m_unaddedTriggers, trigger);
 	m_triggerBucket->m_triggerBucket[trigger->GetSimulationType()].push_back(trigger);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
 void PhysicsSystem::DestroyRigidbody( Rigidbody2D* rigidbody )
 {
-	delete rigidbody;
-	rigidbody = nullptr;
+	if (rigidbody == nullptr || rigidbody->m_isQueuedForDestroy)
+	{
+		return;
+	}
+
+	rigidbody->m_isAlive = false;
+	rigidbody->m_isQueuedForDestroy = true;
+	m_rigidbodyDestroyQueue.push_back(rigidbody);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void PhysicsSystem::DestroyTrigger(Trigger2D* trigger)
+{
+	if (trigger == nullptr || trigger->m_isQueuedForDestroy)
+	{
+		return;
+	}
+
+	trigger->m_isQueuedForDestroy = true;
+	m_triggerDestroyQueue.push_back(trigger);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void PhysicsSystem::DestroyCollider(Collider2D* collider)
+{
+	if (collider == nullptr)
+	{
+		return;
+	}
+
+	if (!collider->m_isPooled)
+	{
+		delete collider;
+		return;
+	}
+
+	switch (collider->GetType())
+	{
+	case COLLIDER_AABB2:
+		m_aabb2ColliderPool.Destroy(static_cast<AABB2Collider*>(collider));
+		break;
+	case COLLIDER_DISC:
+		m_discColliderPool.Destroy(static_cast<Disc2DCollider*>(collider));
+		break;
+	case COLLIDER_BOX:
+		m_boxColliderPool.Destroy(static_cast<BoxCollider2D*>(collider));
+		break;
+	case COLLIDER_CAPSULE:
+		m_capsuleColliderPool.Destroy(static_cast<CapsuleCollider2D*>(collider));
+		break;
+	default:
+		ERROR_AND_DIE("Pooled collider has no type to return it to its pool");
+		break;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+template <typename OBJ>
+static void RemoveQueuedEntries(std::vector<OBJ*>& objects)
+{
+	size_t objectIndex = 0;
+	while (objectIndex < objects.size())
+	{
+		if (objects[objectIndex] == nullptr || objects[objectIndex]->m_isQueuedForDestroy)
+		{
+			objects[objectIndex] = objects.back();
+			objects.pop_back();
+		}
+		else
+		{
+			objectIndex++;
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void PhysicsSystem::ProcessDestroyQueue()
+{
+	//One swap and pop pass per bucket takes out every queued entry, instead of each destructor scanning for itself.
+	//Same for the trigger touches, and before anything is freed so no touch is left holding a dead pointer
+	if (!m_rigidbodyDestroyQueue.empty() || !m_triggerDestroyQueue.empty())
+	{
+		m_triggerTouches.RemoveTouchesIf([](const TriggerTouch2D& touch)
+		{
+			return touch.GetTrigger()->m_isQueuedForDestroy || touch.GetCollider()->m_rigidbody->m_isQueuedForDestroy;
+		});
+	}
+
+	if (!m_rigidbodyDestroyQueue.empty())
+	{
+		for (int rbTypes = 0; rbTypes < NUM_SIMULATION_TYPES; rbTypes++)
+		{
+			RemoveQueuedEntries(m_rbBucket->m_RbBucket[rbTypes]);
+		}
+		RemoveQueuedEntries(m_unaddedRigidbodies);
+
+		for (Rigidbody2D* rigidbody : m_rigidbodyDestroyQueue)
+		{
+			m_rigidbodyPool.Destroy(rigidbody);
+		}
+		m_rigidbodyDestroyQueue.clear();
+	}
+
+	if (!m_triggerDestroyQueue.empty())
+	{
+		for (int triggerTypes = 0; triggerTypes < NUM_SIMULATION_TYPES; triggerTypes++)
+		{
+			RemoveQueuedEntries(m_triggerBucket->m_triggerBucket[triggerTypes]);
+		}
+		RemoveQueuedEntries(m_unaddedTriggers);
+
+		for (Trigger2D* trigger : m_triggerDestroyQueue)
+		{
+			m_triggerPool.Destroy(trigger);
+		}
+		m_triggerDestroyQueue.clear();
+	}
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
@@ -65,6 +343,89 @@ void PhysicsSystem::SetGravity( const Vec2& gravity )
 	m_gravity = gravity;
 }
 
+//------------------------------------------------------------------------------------------------------------------------------
+void PhysicsSystem::EnableContactSolver(const ContactSolverSettings_T& settings /*= ContactSolverSettings_T()*/)
+{
+	if (m_contactSolver == nullptr)
+	{
+		m_contactSolver = new ContactSolver2D(settings);
+	}
+	else
+	{
+		m_contactSolver->SetSettings(settings);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void PhysicsSystem::DisableContactSolver()
+{
+	delete m_contactSolver;
+	m_contactSolver = nullptr;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void PhysicsSystem::AddContactListener(ContactEventCallbackFn callback, void* userData /*= nullptr*/)
+{
+	ContactListener_T listener;
+	listener.m_callback = callback;
+	listener.m_userData = userData;
+	m_contactListeners.push_back(listener);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void PhysicsSystem::RemoveContactListener(ContactEventCallbackFn callback, void* userData /*= nullptr*/)
+{
+	for (size_t listenerIndex = 0; listenerIndex < m_contactListeners.size(); ++listenerIndex)
+	{
+		if (m_contactListeners[listenerIndex].m_callback == callback && m_contactListeners[listenerIndex].m_userData == userData)
+		{
+			m_contactListeners.erase(m_contactListeners.begin() + listenerIndex);
+			return;
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void PhysicsSystem::SetSleepingEnabled(bool isEnabled)
+{
+	m_isSleepingEnabled = isEnabled;
+	if (isEnabled)
+	{
+		return;
+	}
+
+	for (Rigidbody2D* rigidbody : m_rbBucket->m_RbBucket[DYNAMIC_SIMULATION])
+	{
+		if (rigidbody != nullptr)
+		{
+			rigidbody->WakeUp();
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void PhysicsSystem::SetFixedTimeStep(float fixedTimeStep, uint maxSubsteps /*= DEFAULT_MAX_SUBSTEPS*/)
+{
+	m_fixedTimeStep = (fixedTimeStep > 0.f) ? fixedTimeStep : 0.f;
+	m_maxSubsteps = (maxSubsteps == 0U) ? 1U : maxSubsteps;
+	m_timeAccumulator = 0.f;
+	m_interpolationAlpha = 1.f;
+
+	//Start blending from where the bodies are now
+	StorePreviousTransforms();
+	for (int rigidTypes = 0; rigidTypes < NUM_SIMULATION_TYPES; rigidTypes++)
+	{
+		for (Rigidbody2D* rigidbody : m_rbBucket->m_RbBucket[rigidTypes])
+		{
+			if (rigidbody != nullptr)
+			{
+				rigidbody->m_renderPosition = rigidbody->GetPosition();
+				rigidbody->m_renderRotation = rigidbody->GetRotation();
+			}
+		}
+	}
+}
+
 //------------------------------------------------------------------------------------------------------------------------------
 void PhysicsSystem::CopyTransformsFromObjects()
 {
@@ -76,9 +437,39 @@ void PhysicsSystem::CopyTransformsFromObjects()
 
 		for(int rigidbodyIndex = 0; rigidbodyIndex < numRigidbodies; rigidbodyIndex++)
 		{
-			if(m_rbBucket->m_RbBucket[rigidTypes][rigidbodyIndex] != nullptr)
+			Rigidbody2D* rigidbody = m_rbBucket->m_RbBucket[rigidTypes][rigidbodyIndex];
+			if(rigidbody == nullptr)
+			{
+				continue;
+			}
+
+			if (m_fixedTimeStep > 0.f)
+			{
+				//The object holds a blended position, only take it if the game moved the object since we wrote it.
+				//That is a teleport so there is nothing to blend from
+				if (rigidbody->m_object_transform->m_position != rigidbody->m_renderPosition)
+				{
+					rigidbody->SetPosition(rigidbody->m_object_transform->m_position);
+					rigidbody->m_previousPosition = rigidbody->m_object_transform->m_position;
+					rigidbody->m_renderPosition = rigidbody->m_object_transform->m_position;
+				}
+			}
+			else
+			{
+				rigidbody->SetPosition(rigidbody->m_object_transform->m_position);
+			}
+
+			//The body keeps its own rotation, only the position and scale come from the object
+			rigidbody->m_scale = rigidbody->m_object_transform->m_scale;
+
+			//Sleeping bodies have no velocity and stay where they fell asleep, anything else was done from outside the step.
+			//Checked here rather than in the broadphase so it works with every broadphase type
+			if (!rigidbody->IsAwake())
 			{
-				m_rbBucket->m_RbBucket[rigidTypes][rigidbodyIndex]->m_transform = *m_rbBucket->m_RbBucket[rigidTypes][rigidbodyIndex]->m_object_transform;
+				if (rigidbody->GetPosition() != rigidbody->m_sleepPosition || rigidbody->GetVelocity() != Vec2::ZERO || rigidbody->GetAngularVelocity() != 0.f)
+				{
+					rigidbody->WakeUp();
+				}
 			}
 		}
 	}
@@ -94,10 +485,26 @@ void PhysicsSystem::CopyTransformsToObjects()
 
 		for(int rigidbodyIndex = 0; rigidbodyIndex < numRigidbodies; rigidbodyIndex++)
 		{
-			if(m_rbBucket->m_RbBucket[rigidTypes][rigidbodyIndex] != nullptr)
+			Rigidbody2D* rigidbody = m_rbBucket->m_RbBucket[rigidTypes][rigidbodyIndex];
+			if(rigidbody == nullptr)
+			{
+				continue;
+			}
+
+			*rigidbody->m_object_transform = rigidbody->GetTransform();
+
+			if (m_fixedTimeStep > 0.f)
+			{
+				float alpha = m_interpolationAlpha;
+				rigidbody->m_renderPosition = rigidbody->m_previousPosition + (rigidbody->GetPosition() - rigidbody->m_previousPosition) * alpha;
+				rigidbody->m_renderRotation = rigidbody->m_previousRotation + (rigidbody->GetRotation() - rigidbody->m_previousRotation) * alpha;
+				rigidbody->m_object_transform->m_position = rigidbody->m_renderPosition;
+				rigidbody->m_object_transform->m_rotation = rigidbody->m_renderRotation;
+			}
+			else
 			{
-				*m_rbBucket->m_RbBucket[rigidTypes][rigidbodyIndex]->m_object_transform = m_rbBucket->m_RbBucket[rigidTypes][rigidbodyIndex]->m_transform;				
-				m_rbBucket->m_RbBucket[rigidTypes][rigidbodyIndex]->m_transform.m_rotation = m_rbBucket->m_RbBucket[rigidTypes][rigidbodyIndex]->m_rotation;
+				rigidbody->m_renderPosition = rigidbody->GetPosition();
+				rigidbody->m_renderRotation = rigidbody->GetRotation();
 			}
 		}
 	}
@@ -106,13 +513,59 @@ void PhysicsSystem::CopyTransformsToObjects()
 //------------------------------------------------------------------------------------------------------------------------------
 void PhysicsSystem::Update( float deltaTime )
 {
-	CopyTransformsFromObjects(); 
+	if (m_fixedTimeStep <= 0.f)
+	{
+		CopyTransformsFromObjects(); 
+
+		SetAllCollisionsToFalse();
+
+		RunStep( deltaTime );
+
+		CopyTransformsToObjects();  
+		return;
+	}
+
+	CopyTransformsFromObjects();
+
+	m_timeAccumulator += deltaTime;
+
+	uint numSubsteps = 0U;
+	while (m_timeAccumulator >= m_fixedTimeStep && numSubsteps < m_maxSubsteps)
+	{
+		StorePreviousTransforms();
+		SetAllCollisionsToFalse();
+
+		RunStep(m_fixedTimeStep);
+
+		m_timeAccumulator -= m_fixedTimeStep;
+		numSubsteps++;
+	}
 
-	SetAllCollisionsToFalse();
+	//Out of substeps, drop the whole steps we couldn't run instead of carrying them into the next frame
+	if (m_timeAccumulator >= m_fixedTimeStep)
+	{
+		m_timeAccumulator = fmodf(m_timeAccumulator, m_fixedTimeStep);
+	}
 
-	RunStep( deltaTime );
+	m_interpolationAlpha = m_timeAccumulator / m_fixedTimeStep;
+
+	CopyTransformsToObjects();
+}
 
-	CopyTransformsToObjects();  
+//------------------------------------------------------------------------------------------------------------------------------
+void PhysicsSystem::StorePreviousTransforms()
+{
+	for (int rigidTypes = 0; rigidTypes < NUM_SIMULATION_TYPES; rigidTypes++)
+	{
+		for (Rigidbody2D* rigidbody : m_rbBucket->m_RbBucket[rigidTypes])
+		{
+			if (rigidbody != nullptr)
+			{
+				rigidbody->m_previousPosition = rigidbody->GetPosition();
+				rigidbody->m_previousRotation = rigidbody->GetRotation();
+			}
+		}
+	}
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
@@ -135,6 +588,12 @@ void PhysicsSystem::SetAllCollisionsToFalse()
 //------------------------------------------------------------------------------------------------------------------------------
 void PhysicsSystem::UpdateAllCollisions()
 {	
+	if (m_broadphase != nullptr)
+	{
+		UpdateCandidatePairCollisions();
+		return;
+	}
+
 	//Check Static vs Static to mark as collided
 	CheckStaticVsStaticCollisions();
 
@@ -151,13 +610,64 @@ void PhysicsSystem::UpdateAllCollisions()
 //------------------------------------------------------------------------------------------------------------------------------
 void PhysicsSystem::UpdateTriggers()
 {
+	//With a broadphase the trigger pairs were split out of this step's candidate pairs
+	if (m_broadphase == nullptr)
+	{
+		GetAllTriggerPairs(m_triggerPairs);
+	}
+
 	//Check if any dynamic object has entered/exited trigger
-	int numTriggers = (int)m_triggerBucket->m_triggerBucket->size();
-	for (int triggerIndex = 0; triggerIndex < numTriggers; triggerIndex++)
+	for (const BroadphasePair_T& pair : m_triggerPairs)
 	{
-		m_triggerBucket->m_triggerBucket[STATIC_SIMULATION][triggerIndex]->Update(m_frameCount);
+		Trigger2D* trigger = pair.m_colliderA->m_trigger;
+
+		Collision2D collision;
+		if (!pair.m_colliderB->IsTouching(&collision, pair.m_colliderA))
+		{
+			continue;
+		}
+
+		if (m_triggerTouches.Touch(trigger, pair.m_colliderB, m_frameCount))
+		{
+			EventArgs args;
+			g_eventSystem->FireEvent(trigger->m_onEnterEvent, args);
+		}
+	}
+
+	//Whatever wasn't touched this step has left its trigger
+	m_triggerTouches.CollectExits(m_frameCount, m_triggerExits);
+	for (const TriggerTouch2D& touch : m_triggerExits)
+	{
+		touch.GetCollider()->m_rigidbody->m_isAlive = false;
+
+		EventArgs args;
+		g_eventSystem->FireEvent(touch.GetTrigger()->m_onExitEvent, args);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void PhysicsSystem::GetAllTriggerPairs(BroadphasePairList& outPairs)
+{
+	outPairs.clear();
+
+	for (int triggerTypes = 0; triggerTypes < NUM_SIMULATION_TYPES; triggerTypes++)
+	{
+		for (Trigger2D* trigger : m_triggerBucket->m_triggerBucket[triggerTypes])
+		{
+			if (trigger == nullptr || trigger->m_collider == nullptr)
+			{
+				continue;
+			}
+
+			for (Rigidbody2D* rigidbody : m_rbBucket->m_RbBucket[DYNAMIC_SIMULATION])
+			{
+				if (rigidbody != nullptr && rigidbody->m_collider != nullptr)
+				{
+					outPairs.push_back(BroadphasePair_T{ trigger->m_collider, rigidbody->m_collider });
+				}
+			}
+		}
 	}
-	
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
@@ -165,34 +675,361 @@ void PhysicsSystem::PurgeDeletedObjects()
 {
 	for (int rbTypes = 0; rbTypes < NUM_SIMULATION_TYPES; rbTypes++)
 	{
-		for (int rbIndex = 0; rbIndex < m_rbBucket->m_RbBucket[rbTypes].size(); rbIndex++)
+		for (Rigidbody2D* rigidbody : m_rbBucket->m_RbBucket[rbTypes])
 		{
-			if (!m_rbBucket->m_RbBucket[rbTypes][rbIndex]->m_isAlive)
+			if (rigidbody != nullptr && !rigidbody->m_isAlive)
 			{
-				delete m_rbBucket->m_RbBucket[rbTypes][rbIndex];
-				m_rbBucket->m_RbBucket[rbTypes][rbIndex] = nullptr;
-
-				m_rbBucket->m_RbBucket[rbTypes].erase(m_rbBucket->m_RbBucket[rbTypes].begin() + rbIndex);
-				rbIndex--;
+				DestroyRigidbody(rigidbody);
 			}
 		}
 	}
+
+	ProcessDestroyQueue();
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-void PhysicsSystem::DebugRender( RenderContext* renderContext ) const
+bool PhysicsSystem::Raycast(RaycastHit2D_T* outHit, const Vec2& start, const Vec2& direction, float maxDistance, uint layerMask /*= ALL_PHYSICS_LAYERS*/) const
 {
-	DebugRenderRigidBodies(renderContext);
-	DebugRenderTriggers(renderContext);
+	std::vector<Collider2D*> candidates;
+	GetRayCandidates(candidates, start, start + direction * maxDistance);
+	return CastAgainstCandidates(outHit, candidates, start, direction, maxDistance, 0.f, layerMask);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-void PhysicsSystem::DebugRenderRigidBodies(RenderContext* renderContext) const
+uint PhysicsSystem::RaycastAll(RaycastHitList& outHits, const Vec2& start, const Vec2& direction, float maxDistance, uint layerMask /*= ALL_PHYSICS_LAYERS*/) const
 {
-	for (int rbTypes = 0; rbTypes < NUM_SIMULATION_TYPES; rbTypes++)
+	outHits.clear();
+
+	std::vector<Collider2D*> candidates;
+	GetRayCandidates(candidates, start, start + direction * maxDistance);
+
+	for (Collider2D* collider : candidates)
 	{
-		int numRigidbodies = static_cast<int>(m_rbBucket->m_RbBucket[rbTypes].size());
-		for (int rbIndex = 0; rbIndex < numRigidbodies; rbIndex++)
+		RaycastHit2D_T hit;
+		if (IsQueryCandidate(collider, layerMask) && RaycastCollider2D(&hit, *collider, start, direction, maxDistance))
+		{
+			outHits.push_back(hit);
+		}
+	}
+
+	std::sort(outHits.begin(), outHits.end(), [](const RaycastHit2D_T& a, const RaycastHit2D_T& b) { return a.m_distance < b.m_distance; });
+	return (uint)outHits.size();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint PhysicsSystem::OverlapAABB(std::vector<Collider2D*>& outColliders, const AABB2& box, uint layerMask /*= ALL_PHYSICS_LAYERS*/) const
+{
+	outColliders.clear();
+
+	std::vector<Collider2D*> candidates;
+	GetQueryCandidates(candidates, box);
+
+	for (Collider2D* collider : candidates)
+	{
+		if (IsQueryCandidate(collider, layerMask) && DoesColliderOverlapAABB2(*collider, box))
+		{
+			outColliders.push_back(collider);
+		}
+	}
+
+	return (uint)outColliders.size();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint PhysicsSystem::OverlapDisc(std::vector<Collider2D*>& outColliders, const Vec2& centre, float radius, uint layerMask /*= ALL_PHYSICS_LAYERS*/) const
+{
+	outColliders.clear();
+
+	std::vector<Collider2D*> candidates;
+	GetQueryCandidates(candidates, AABB2(centre - Vec2(radius, radius), centre + Vec2(radius, radius)));
+
+	for (Collider2D* collider : candidates)
+	{
+		if (IsQueryCandidate(collider, layerMask) && DoesColliderOverlapDisc2D(*collider, centre, radius))
+		{
+			outColliders.push_back(collider);
+		}
+	}
+
+	return (uint)outColliders.size();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool PhysicsSystem::ShapeCast(RaycastHit2D_T* outHit, const Vec2& start, float castRadius, const Vec2& direction, float maxDistance, uint layerMask /*= ALL_PHYSICS_LAYERS*/) const
+{
+	//Everything the disc can touch on the way is inside the bounds of the sweep
+	Vec2 end = start + direction * maxDistance;
+	Vec2 minBounds(std::min(start.x, end.x) - castRadius, std::min(start.y, end.y) - castRadius);
+	Vec2 maxBounds(std::max(start.x, end.x) + castRadius, std::max(start.y, end.y) + castRadius);
+
+	std::vector<Collider2D*> candidates;
+	GetQueryCandidates(candidates, AABB2(minBounds, maxBounds));
+	return CastAgainstCandidates(outHit, candidates, start, direction, maxDistance, castRadius, layerMask);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void PhysicsSystem::RaycastBatch(const std::vector<RaycastQuery2D_T>& queries, RaycastHitList& outHits)
+{
+	outHits.assign(queries.size(), RaycastHit2D_T());
+
+	//Queries only read the broadphase and the colliders, each slice just needs its own candidate list
+	WorkerRangeCallback answerQueries = [&](uint workerIndex, uint startIndex, uint endIndex)
+	{
+		UNUSED(workerIndex);
+
+		std::vector<Collider2D*> candidates;
+		for (uint queryIndex = startIndex; queryIndex < endIndex; ++queryIndex)
+		{
+			const RaycastQuery2D_T& query = queries[queryIndex];
+
+			candidates.clear();
+			GetRayCandidates(candidates, query.m_start, query.m_start + query.m_direction * query.m_maxDistance);
+			CastAgainstCandidates(&outHits[queryIndex], candidates, query.m_start, query.m_direction, query.m_maxDistance, 0.f, query.m_layerMask);
+		}
+	};
+
+	if (m_narrowphasePool != nullptr)
+	{
+		m_narrowphasePool->ParallelFor((uint)queries.size(), answerQueries);
+	}
+	else
+	{
+		answerQueries(0U, 0U, (uint)queries.size());
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void PhysicsSystem::SaveSnapshot(PhysicsSnapshot2D& outSnapshot) const
+{
+	uint numBodies = 0U;
+	for (int rbType = 0; rbType < NUM_SIMULATION_TYPES; rbType++)
+	{
+		for (const Rigidbody2D* rigidbody : m_rbBucket->m_RbBucket[rbType])
+		{
+			numBodies += (rigidbody != nullptr && rigidbody->m_isAlive) ? 1U : 0U;
+		}
+	}
+
+	uint numContacts = (m_contactSolver != nullptr) ? m_contactSolver->GetWarmStartContactCount() : 0U;
+	outSnapshot.Reset(numBodies, numContacts);
+
+	PhysicsSnapshotHeader_T& header = outSnapshot.GetHeader();
+	header.m_frameCount = m_frameCount;
+	header.m_timeAccumulator = m_timeAccumulator;
+	header.m_interpolationAlpha = m_interpolationAlpha;
+
+	BodySnapshot2D_T* bodySnapshot = outSnapshot.GetBodies();
+	for (int rbType = 0; rbType < NUM_SIMULATION_TYPES; rbType++)
+	{
+		for (const Rigidbody2D* rigidbody : m_rbBucket->m_RbBucket[rbType])
+		{
+			if (rigidbody == nullptr || !rigidbody->m_isAlive)
+			{
+				continue;
+			}
+
+			bodySnapshot->m_bodyId = rigidbody->m_bodyId;
+			bodySnapshot->m_positionX = rigidbody->GetPosition().x;
+			bodySnapshot->m_positionY = rigidbody->GetPosition().y;
+			bodySnapshot->m_rotation = rigidbody->GetRotation();
+			bodySnapshot->m_velocityX = rigidbody->GetVelocity().x;
+			bodySnapshot->m_velocityY = rigidbody->GetVelocity().y;
+			bodySnapshot->m_angularVelocity = rigidbody->GetAngularVelocity();
+			bodySnapshot->m_frameForcesX = rigidbody->GetFrameForces().x;
+			bodySnapshot->m_frameForcesY = rigidbody->GetFrameForces().y;
+			bodySnapshot->m_frameTorque = rigidbody->GetFrameTorque();
+			bodySnapshot->m_previousPositionX = rigidbody->m_previousPosition.x;
+			bodySnapshot->m_previousPositionY = rigidbody->m_previousPosition.y;
+			bodySnapshot->m_previousRotation = rigidbody->m_previousRotation;
+			bodySnapshot->m_sleepTime = rigidbody->m_sleepTime;
+			bodySnapshot->m_sleepPositionX = rigidbody->m_sleepPosition.x;
+			bodySnapshot->m_sleepPositionY = rigidbody->m_sleepPosition.y;
+			bodySnapshot->m_isAwake = rigidbody->m_isAwake ? 1U : 0U;
+			++bodySnapshot;
+		}
+	}
+
+	if (numContacts > 0U)
+	{
+		memcpy(outSnapshot.GetContacts(), m_contactSolver->GetWarmStartContacts(), numContacts * sizeof(WarmStartContact2D_T));
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool PhysicsSystem::RestoreSnapshot(const PhysicsSnapshot2D& snapshot)
+{
+	const PhysicsSnapshotHeader_T& header = snapshot.GetHeader();
+	const BodySnapshot2D_T* bodySnapshots = snapshot.GetBodies();
+
+	//Check every body first so a snapshot of other bodies changes nothing
+	uint bodyIndex = 0U;
+	for (int rbType = 0; rbType < NUM_SIMULATION_TYPES; rbType++)
+	{
+		for (const Rigidbody2D* rigidbody : m_rbBucket->m_RbBucket[rbType])
+		{
+			if (rigidbody == nullptr || !rigidbody->m_isAlive)
+			{
+				continue;
+			}
+
+			if (bodyIndex >= header.m_numBodies || bodySnapshots[bodyIndex].m_bodyId != rigidbody->m_bodyId)
+			{
+				return false;
+			}
+			++bodyIndex;
+		}
+	}
+
+	if (bodyIndex != header.m_numBodies)
+	{
+		return false;
+	}
+
+	const BodySnapshot2D_T* bodySnapshot = bodySnapshots;
+	for (int rbType = 0; rbType < NUM_SIMULATION_TYPES; rbType++)
+	{
+		for (Rigidbody2D* rigidbody : m_rbBucket->m_RbBucket[rbType])
+		{
+			if (rigidbody == nullptr || !rigidbody->m_isAlive)
+			{
+				continue;
+			}
+
+			//These move the body in or out of the store, the values they reset are overwritten below
+			if (bodySnapshot->m_isAwake != 0U)
+			{
+				rigidbody->WakeUp();
+			}
+			else
+			{
+				rigidbody->PutToSleep();
+			}
+
+			rigidbody->SetPosition(Vec2(bodySnapshot->m_positionX, bodySnapshot->m_positionY));
+			rigidbody->SetRotation(bodySnapshot->m_rotation);
+			rigidbody->SetVelocity(Vec2(bodySnapshot->m_velocityX, bodySnapshot->m_velocityY));
+			rigidbody->SetAngularVelocity(bodySnapshot->m_angularVelocity);
+			rigidbody->SetFrameForces(Vec2(bodySnapshot->m_frameForcesX, bodySnapshot->m_frameForcesY));
+			rigidbody->SetFrameTorque(bodySnapshot->m_frameTorque);
+			rigidbody->m_previousPosition = Vec2(bodySnapshot->m_previousPositionX, bodySnapshot->m_previousPositionY);
+			rigidbody->m_previousRotation = bodySnapshot->m_previousRotation;
+			rigidbody->m_sleepTime = bodySnapshot->m_sleepTime;
+			rigidbody->m_sleepPosition = Vec2(bodySnapshot->m_sleepPositionX, bodySnapshot->m_sleepPositionY);
+			++bodySnapshot;
+
+			Collider2D* collider = rigidbody->m_collider;
+			if (collider == nullptr)
+			{
+				continue;
+			}
+
+			rigidbody->ApplyRotation();
+
+			//The step moves the proxies of awake bodies, sleeping ones are skipped until they wake so move those now
+			if (!rigidbody->m_isAwake && m_broadphase != nullptr && collider->m_broadphaseProxy != INVALID_BROADPHASE_PROXY)
+			{
+				m_broadphase->MoveProxy(collider->m_broadphaseProxy, collider->GetWorldBounds());
+			}
+		}
+	}
+
+	m_frameCount = header.m_frameCount;
+	m_timeAccumulator = header.m_timeAccumulator;
+	m_interpolationAlpha = header.m_interpolationAlpha;
+
+	if (m_contactSolver != nullptr)
+	{
+		m_contactSolver->SetWarmStartContacts(snapshot.GetContacts(), header.m_numContacts);
+	}
+
+	//The objects are where the next Update reads the transforms from
+	CopyTransformsToObjects();
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool PhysicsSystem::IsQueryCandidate(const Collider2D* collider, uint layerMask) const
+{
+	if (collider == nullptr || !collider->m_isAlive || (collider->m_layerBits & layerMask) == 0U)
+	{
+		return false;
+	}
+
+	//Triggers and dead bodies waiting to be released aren't in the scene as far as queries go
+	return collider->m_rigidbody != nullptr && collider->m_rigidbody->m_isAlive;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void PhysicsSystem::GetQueryCandidates(std::vector<Collider2D*>& outColliders, const AABB2& bounds) const
+{
+	if (m_broadphase != nullptr)
+	{
+		m_broadphase->QueryAABB(bounds, outColliders);
+		return;
+	}
+
+	for (int rbTypes = 0; rbTypes < NUM_SIMULATION_TYPES; rbTypes++)
+	{
+		for (Rigidbody2D* rigidbody : m_rbBucket->m_RbBucket[rbTypes])
+		{
+			if (rigidbody != nullptr && rigidbody->m_collider != nullptr)
+			{
+				outColliders.push_back(rigidbody->m_collider);
+			}
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void PhysicsSystem::GetRayCandidates(std::vector<Collider2D*>& outColliders, const Vec2& start, const Vec2& end) const
+{
+	if (m_broadphase != nullptr)
+	{
+		m_broadphase->QueryRay(start, end, outColliders);
+		return;
+	}
+
+	Vec2 minBounds(std::min(start.x, end.x), std::min(start.y, end.y));
+	Vec2 maxBounds(std::max(start.x, end.x), std::max(start.y, end.y));
+	GetQueryCandidates(outColliders, AABB2(minBounds, maxBounds));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool PhysicsSystem::CastAgainstCandidates(RaycastHit2D_T* outHit, const std::vector<Collider2D*>& candidates, const Vec2& start, const Vec2& direction, float maxDistance, float castRadius, uint layerMask) const
+{
+	*outHit = RaycastHit2D_T();
+
+	for (Collider2D* collider : candidates)
+	{
+		RaycastHit2D_T hit;
+		if (!IsQueryCandidate(collider, layerMask) || !RaycastCollider2D(&hit, *collider, start, direction, maxDistance, castRadius))
+		{
+			continue;
+		}
+
+		if (outHit->m_collider == nullptr || hit.m_distance < outHit->m_distance)
+		{
+			*outHit = hit;
+		}
+	}
+
+	return outHit->m_collider != nullptr;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void PhysicsSystem::DebugRender( RenderContext* renderContext ) const
+{
+	DebugRenderRigidBodies(renderContext);
+	DebugRenderTriggers(renderContext);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void PhysicsSystem::DebugRenderRigidBodies(RenderContext* renderContext) const
+{
+	for (int rbTypes = 0; rbTypes < NUM_SIMULATION_TYPES; rbTypes++)
+	{
+		int numRigidbodies = static_cast<int>(m_rbBucket->m_RbBucket[rbTypes].size());
+		for (int rbIndex = 0; rbIndex < numRigidbodies; rbIndex++)
 		{
 			//Nullptr check first
 			if (m_rbBucket->m_RbBucket[rbTypes][rbIndex] == nullptr)
@@ -225,7 +1062,11 @@ void PhysicsSystem::DebugRenderRigidBodies(RenderContext* renderContext) const
 			break;
 			case DYNAMIC_SIMULATION:
 			{
-				if (m_rbBucket->m_RbBucket[rbTypes][rbIndex]->m_collider->m_inCollision)
+				if (!m_rbBucket->m_RbBucket[rbTypes][rbIndex]->IsAwake())
+				{
+					m_rbBucket->m_RbBucket[rbTypes][rbIndex]->DebugRender(renderContext, Rgba::DARK_GREY);
+				}
+				else if (m_rbBucket->m_RbBucket[rbTypes][rbIndex]->m_collider->m_inCollision)
 				{
 					m_rbBucket->m_RbBucket[rbTypes][rbIndex]->DebugRender(renderContext, Rgba::RED);
 				}
@@ -307,28 +1148,45 @@ const Vec2& PhysicsSystem::GetGravity() const
 void PhysicsSystem::RunStep( float deltaTime )
 {
 	m_frameCount++;
+	m_touchingDynamicPairs.clear();
+	m_sleepingDynamicPairs.clear();
+	m_contactEvents.clear();
+
+	if (m_isSleepingEnabled)
+	{
+		WakeQueuedBodyNeighbours();
+	}
+
+	//Last step's events can point at queued bodies, so they only go once the events are cleared
+	ProcessDestroyQueue();
 
 	//First move all rigidbodies based on forces on them
 	MoveAllDynamicObjects(deltaTime);
 
-	UpdateAllCollisions();
+	if (m_contactSolver != nullptr)
+	{
+		UpdateSolverContacts(deltaTime);
+	}
+	else
+	{
+		UpdateAllCollisions();
+	}
+
+	if (m_isSleepingEnabled)
+	{
+		UpdateIslands(deltaTime);
+	}
 
 	UpdateTriggers();
+
+	DispatchContactEvents();
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
 void PhysicsSystem::MoveAllDynamicObjects(float deltaTime)
 {
-	int numObjects = static_cast<int>(m_rbBucket->m_RbBucket[DYNAMIC_SIMULATION].size());
-
-	for (int objectIndex = 0; objectIndex < numObjects; objectIndex++)
-	{
-		if(m_rbBucket->m_RbBucket[DYNAMIC_SIMULATION][objectIndex] != nullptr)
-		{
-			m_rbBucket->m_RbBucket[DYNAMIC_SIMULATION][objectIndex]->Move(deltaTime);
-		}
-
-	}
+	//Only the awake dynamic bodies are in the integrated range
+	m_bodyStore.Integrate(deltaTime, GetGravity());
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
@@ -349,7 +1207,7 @@ void PhysicsSystem::CheckStaticVsStaticCollisions()
 			continue;
 		}
 
-		for(int otherColliderIndex = 0; otherColliderIndex < numStaticObjects; otherColliderIndex++)
+		for(int otherColliderIndex = colliderIndex + 1; otherColliderIndex < numStaticObjects; otherColliderIndex++)
 		{
 			//check condition where the other collider is nullptr
 			if(m_rbBucket->m_RbBucket[STATIC_SIMULATION][otherColliderIndex] == nullptr)
@@ -362,23 +1220,7 @@ void PhysicsSystem::CheckStaticVsStaticCollisions()
 				continue;
 			}
 
-			//Make sure we aren't the same rigidbody
-			if(m_rbBucket->m_RbBucket[STATIC_SIMULATION][colliderIndex] == m_rbBucket->m_RbBucket[STATIC_SIMULATION][otherColliderIndex])
-			{
-				continue;
-			}
-
-			Collision2D collision;
-			if(m_rbBucket->m_RbBucket[STATIC_SIMULATION][colliderIndex]->m_collider->IsTouching(&collision, m_rbBucket->m_RbBucket[STATIC_SIMULATION][otherColliderIndex]->m_collider))
-			{
-				//Set collision to true
-				m_rbBucket->m_RbBucket[STATIC_SIMULATION][colliderIndex]->m_collider->SetCollision(true);
-				m_rbBucket->m_RbBucket[STATIC_SIMULATION][otherColliderIndex]->m_collider->SetCollision(true);
-
-				//Call required collision events
-				NamedProperties args;
-				m_rbBucket->m_RbBucket[STATIC_SIMULATION][colliderIndex]->m_collider->FireCollisionEvent(args);
-			}
+			CheckStaticVsStaticPair(m_rbBucket->m_RbBucket[STATIC_SIMULATION][colliderIndex], m_rbBucket->m_RbBucket[STATIC_SIMULATION][otherColliderIndex]);
 		}
 	}
 }
@@ -397,7 +1239,7 @@ void PhysicsSystem::ResolveDynamicVsStaticCollisions(bool canResolve)
 			continue;
 		}
 
-		if (!m_rbBucket->m_RbBucket[DYNAMIC_SIMULATION][colliderIndex]->m_isAlive)
+		if (!m_rbBucket->m_RbBucket[DYNAMIC_SIMULATION][colliderIndex]->m_isAlive || !m_rbBucket->m_RbBucket[DYNAMIC_SIMULATION][colliderIndex]->IsAwake())
 		{
 			continue;
 		}
@@ -415,89 +1257,7 @@ void PhysicsSystem::ResolveDynamicVsStaticCollisions(bool canResolve)
 				continue;
 			}
 
-			Collision2D collision;
-			if(m_rbBucket->m_RbBucket[DYNAMIC_SIMULATION][colliderIndex]->m_collider->IsTouching(&collision, m_rbBucket->m_RbBucket[STATIC_SIMULATION][otherColliderIndex]->m_collider))
-			{
-				//Set collision to true
-				m_rbBucket->m_RbBucket[DYNAMIC_SIMULATION][colliderIndex]->m_collider->SetCollision(true);
-				m_rbBucket->m_RbBucket[STATIC_SIMULATION][otherColliderIndex]->m_collider->SetCollision(true);
-
-				//Call the collision event
-				NamedProperties args;
-				m_rbBucket->m_RbBucket[DYNAMIC_SIMULATION][colliderIndex]->m_collider->FireCollisionEvent(args);
-				m_rbBucket->m_RbBucket[STATIC_SIMULATION][otherColliderIndex]->m_collider->FireCollisionEvent(args);
-
-				//Push the object out based on the collision manifold
-				if(collision.m_manifold.m_normal != Vec2::ZERO)
-				{
-					m_rbBucket->m_RbBucket[DYNAMIC_SIMULATION][colliderIndex]->m_transform.m_position += collision.m_manifold.m_normal * collision.m_manifold.m_penetration;
-				}
-
-
-				if(canResolve)
-				{
-
-					Rigidbody2D* rb0 = m_rbBucket->m_RbBucket[DYNAMIC_SIMULATION][colliderIndex];
-					Rigidbody2D* rb1 = m_rbBucket->m_RbBucket[STATIC_SIMULATION][otherColliderIndex];
-
-					Vec2 velocity0 = rb0->m_velocity;
-					Vec2 velocity1 = rb1->m_velocity;
-
-					float mass0 = rb0->m_mass; 
-				
-					Manifold2D manifold = collision.m_manifold;
-					Vec2 contactPoint = manifold.m_contact + manifold.m_normal * (manifold.m_penetration);
-
-					//Get the vector from the object centre to the point of contact for both objects
-					Vec2 rb0toContact = contactPoint - rb0->m_object_transform->m_position;
-					Vec2 rb1toContact = contactPoint - rb1->m_object_transform->m_position;
-
-					//Get the perpendicular of the vector from center to point
-					Vec2 toPointPerpendicular0 = rb0toContact.GetRotated90Degrees();
-					Vec2 toPointPerpendicular1 = rb1toContact.GetRotated90Degrees();
-
-					//Get the velocity at the impact point for both objects
-					Vec2 velocityAtPoint0 = velocity0 + DegreesToRadians(rb0->m_angularVelocity) * toPointPerpendicular0;
-					Vec2 velocityAtPoint1 = velocity1 + DegreesToRadians(rb1->m_angularVelocity) * toPointPerpendicular1;
-
-					//Coefficient of restitution
-					float CoefficientOfRestitution = (collision.m_Obj->m_rigidbody->m_material.restitution) * (collision.m_otherObj->m_rigidbody->m_material.restitution);
-					
-					//Generate Impulse along the normal
-					float j = -(1 + CoefficientOfRestitution) * GetDotProduct((velocityAtPoint0 - velocityAtPoint1), manifold.m_normal);
-					float constant0 = ( GetDotProduct(toPointPerpendicular0, manifold.m_normal) * GetDotProduct(toPointPerpendicular0, manifold.m_normal) / rb0->m_momentOfInertia ) ;
-					float d = (1 / mass0) + (constant0);
-
-					float impulseAlongNormal = j / d;
-
-					rb0->ApplyImpulseAt( impulseAlongNormal * collision.m_manifold.m_normal, contactPoint );					
-
-					//Get updated velocity
-					velocity0 = rb0->m_velocity;
-					velocity1 = rb1->m_velocity;
-
-					//Get the velocity at the impact point for both objects
-					velocityAtPoint0 = velocity0 + DegreesToRadians(rb0->m_angularVelocity) * toPointPerpendicular0;
-					velocityAtPoint1 = velocity1 + DegreesToRadians(rb1->m_angularVelocity) * toPointPerpendicular1;
-
-					//Generate the impuse along the tangent
-					Vec2 tangent = manifold.m_normal.GetRotated90Degrees();
-					float jT = -(1 + CoefficientOfRestitution) * GetDotProduct((velocityAtPoint0 - velocityAtPoint1), tangent);
-					float constant0T = (GetDotProduct(toPointPerpendicular0, tangent) * GetDotProduct(toPointPerpendicular0, tangent) / rb0->m_momentOfInertia);
-					float dT = (1 / mass0) + (constant0T);
-
-					float impulseAlongTangent = jT / dT;
-
-					//Coulumb's law
-					float frictionCoefficient = sqrt(abs(rb0->m_friction * rb1->m_friction));
-
-					impulseAlongTangent = Clamp(impulseAlongTangent, -impulseAlongNormal, impulseAlongNormal);
-					impulseAlongTangent *= frictionCoefficient;
-
-					rb0->ApplyImpulseAt(impulseAlongTangent * tangent, contactPoint);
-				}
-
-			}
+			ResolveDynamicVsStaticPair(m_rbBucket->m_RbBucket[DYNAMIC_SIMULATION][colliderIndex], m_rbBucket->m_RbBucket[STATIC_SIMULATION][otherColliderIndex], canResolve);
 		}
 	}
 }
@@ -533,125 +1293,763 @@ void PhysicsSystem::ResolveDynamicVsDynamicCollisions(bool canResolve)
 				continue;
 			}
 
-			Collision2D collision;
-			if(m_rbBucket->m_RbBucket[DYNAMIC_SIMULATION][colliderIndex]->m_collider->IsTouching(&collision, m_rbBucket->m_RbBucket[DYNAMIC_SIMULATION][otherColliderIndex]->m_collider))
+			//Two sleeping bodies can't have started touching, but the ones still resting on each other keep their island linked
+			if (!m_rbBucket->m_RbBucket[DYNAMIC_SIMULATION][colliderIndex]->IsAwake() && !m_rbBucket->m_RbBucket[DYNAMIC_SIMULATION][otherColliderIndex]->IsAwake())
 			{
-				//Set collision to true
-				m_rbBucket->m_RbBucket[DYNAMIC_SIMULATION][colliderIndex]->m_collider->SetCollision(true);
-				m_rbBucket->m_RbBucket[DYNAMIC_SIMULATION][otherColliderIndex]->m_collider->SetCollision(true);
-
-				//Push the object out based on the collision manifold
-				if(collision.m_manifold.m_normal != Vec2::ZERO)
-				{
-					float mass0 = m_rbBucket->m_RbBucket[DYNAMIC_SIMULATION][colliderIndex]->m_mass; 
-					float mass1 = m_rbBucket->m_RbBucket[DYNAMIC_SIMULATION][otherColliderIndex]->m_mass; 
-					float totalMass = mass0 + mass1;
-
-					//Correction on system mass
-					float correct0 = mass1 / totalMass;   // move myself along the correction normal
-					float correct1 = 1 - correct0;  // move opposite along the normal
-
-					Vec2 move0 = collision.m_manifold.m_normal * collision.m_manifold.m_penetration * correct0;
-					Vec2 move1 = (collision.m_manifold.m_normal * -1) * collision.m_manifold.m_penetration * correct1;
-
-					//m_rbBucket->m_RbBucket[DYNAMIC_SIMULATION][colliderIndex]->m_transform.m_position += collision.m_manifold.m_normal * collision.m_manifold.m_penetration * correct0;
-					//m_rbBucket->m_RbBucket[DYNAMIC_SIMULATION][otherColliderIndex]->m_transform.m_position += (collision.m_manifold.m_normal * -1) * collision.m_manifold.m_penetration * correct1;
-					
-					m_rbBucket->m_RbBucket[DYNAMIC_SIMULATION][colliderIndex]->MoveBy(move0);
-					m_rbBucket->m_RbBucket[DYNAMIC_SIMULATION][otherColliderIndex]->MoveBy(move1);
-				}
-
-
-				if(canResolve)
+				Collider2D* colliderA = m_rbBucket->m_RbBucket[DYNAMIC_SIMULATION][colliderIndex]->m_collider;
+				Collider2D* colliderB = m_rbBucket->m_RbBucket[DYNAMIC_SIMULATION][otherColliderIndex]->m_collider;
+				if (m_isSleepingEnabled && AreIslandNeighbours(colliderA, colliderB))
 				{
-					//resolve
-					Rigidbody2D* rb0 = m_rbBucket->m_RbBucket[DYNAMIC_SIMULATION][colliderIndex];
-					Rigidbody2D* rb1 = m_rbBucket->m_RbBucket[DYNAMIC_SIMULATION][otherColliderIndex];
-
-					//Vec2 *contactPoint = new Vec2();
-					//float impulseAlongNormal = GetImpulseAlongNormal(contactPoint, collision, *rb0, *rb1);
-
-					Vec2 velocity0 = rb0->m_velocity;
-					Vec2 velocity1 = rb1->m_velocity;
-
-					float mass0 = rb0->m_mass;
-					float mass1 = rb1->m_mass;
-					float totalMass = mass0 + mass1;
-
-					//Correction on system mass
-					float correct0 = mass1 / totalMass;   // move myself along the correction normal
-					//float correct1 = 1 - correct0;  // move opposite along the normal
-
-					Manifold2D manifold = collision.m_manifold;
-					Vec2 contactPoint = manifold.m_contact + manifold.m_normal * (manifold.m_penetration * correct0);
-
-					//Get the vector from the object centre to the point of contact for both objects
-					Vec2 rb0toContact = contactPoint - rb0->m_object_transform->m_position;
-					Vec2 rb1toContact = contactPoint - rb1->m_object_transform->m_position;
-
-					//Get the perpendicular of the vector from center to point
-					Vec2 toPointPerpendicular0 = rb0toContact.GetRotated90Degrees();
-					Vec2 toPointPerpendicular1 = rb1toContact.GetRotated90Degrees();
-
-					//Get the velocity at the impact point for both objects
-					Vec2 velocityAtPoint0 = velocity0 + DegreesToRadians(rb0->m_angularVelocity) * toPointPerpendicular0;
-					Vec2 velocityAtPoint1 = velocity1 + DegreesToRadians(rb1->m_angularVelocity) * toPointPerpendicular1;
-
-					//Coefficient of restitution
-					float CoefficientOfRestitution = (collision.m_Obj->m_rigidbody->m_material.restitution) * (collision.m_otherObj->m_rigidbody->m_material.restitution);
-
-					//Impulse along the normal
-					float j = -(1 + CoefficientOfRestitution) * GetDotProduct((velocityAtPoint0 - velocityAtPoint1), manifold.m_normal);
-					float constant0 = (GetDotProduct(toPointPerpendicular0, manifold.m_normal) * GetDotProduct(toPointPerpendicular0, manifold.m_normal) / rb0->m_momentOfInertia);
-					float constant1 = (GetDotProduct(toPointPerpendicular1, manifold.m_normal) * GetDotProduct(toPointPerpendicular1, manifold.m_normal) / rb1->m_momentOfInertia);
-					float d = ((mass0 + mass1) / (mass0 * mass1)) + constant0 + constant1;
-
-					float impulseAlongNormal = j / d;
-
-					rb0->ApplyImpulseAt(impulseAlongNormal * collision.m_manifold.m_normal, contactPoint);
-					rb1->ApplyImpulseAt(-1.f * (impulseAlongNormal * collision.m_manifold.m_normal), contactPoint);
-
-					// Get updated velocities
-					velocity0 = rb0->m_velocity;
-					velocity1 = rb1->m_velocity;
-
-					//Get the velocity at the impact point for both objects
-					velocityAtPoint0 = velocity0 + DegreesToRadians(rb0->m_angularVelocity) * toPointPerpendicular0;
-					velocityAtPoint1 = velocity1 + DegreesToRadians(rb1->m_angularVelocity) * toPointPerpendicular1;
-
-					//Impulse along the tangent
-					Vec2 tangent = manifold.m_normal.GetRotated90Degrees();
-					float jT = -(1 + CoefficientOfRestitution) * GetDotProduct((velocityAtPoint0 - velocityAtPoint1), tangent);
-					float constant0T = (GetDotProduct(toPointPerpendicular0, tangent) * GetDotProduct(toPointPerpendicular0, tangent) / rb0->m_momentOfInertia);
-					float constant1T = (GetDotProduct(toPointPerpendicular1, tangent) * GetDotProduct(toPointPerpendicular1, tangent) / rb1->m_momentOfInertia);
-					float dT = ((mass0 + mass1) / (mass0 * mass1)) + constant0T + constant1T;
-
-					float impulseAlongTangent = jT / dT;
-
-					//Coulumb's law
-					float frictionCoefficient = sqrt(abs(rb0->m_friction * rb1->m_friction));
-
-					impulseAlongTangent = Clamp(impulseAlongTangent, -impulseAlongNormal, impulseAlongNormal);
-					impulseAlongTangent *= frictionCoefficient;
-
-					rb0->ApplyImpulseAt( impulseAlongTangent * tangent, contactPoint );
-					rb1->ApplyImpulseAt( -1.f * (impulseAlongTangent * tangent), contactPoint );
+					m_sleepingDynamicPairs.push_back(BroadphasePair_T{ colliderA, colliderB });
 				}
-
+				continue;
 			}
+
+			ResolveDynamicVsDynamicPair(m_rbBucket->m_RbBucket[DYNAMIC_SIMULATION][colliderIndex], m_rbBucket->m_RbBucket[DYNAMIC_SIMULATION][otherColliderIndex], canResolve);
 		}
 	}
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-float PhysicsSystem::GetImpulseAlongNormal(Vec2 *out, const Collision2D& collision, const Rigidbody2D& rb0, const Rigidbody2D& rb1)
+void PhysicsSystem::UpdateBroadphase()
 {
-	Vec2 velocity0 = rb0.m_velocity;
-	Vec2 velocity1 = rb1.m_velocity;
-
-	float mass0 = rb0.m_mass; 
-	float mass1 = rb1.m_mass; 
-	float totalMass = mass0 + mass1;
+	for (int rbTypes = 0; rbTypes < NUM_SIMULATION_TYPES; rbTypes++)
+	{
+		int numRigidbodies = static_cast<int>(m_rbBucket->m_RbBucket[rbTypes].size());
+		for (int rbIndex = 0; rbIndex < numRigidbodies; rbIndex++)
+		{
+			Rigidbody2D* rigidbody = m_rbBucket->m_RbBucket[rbTypes][rbIndex];
+			if (rigidbody == nullptr || !rigidbody->m_isAlive || rigidbody->m_collider == nullptr)
+			{
+				continue;
+			}
+
+			//Proxies are made lazily so it doesn't matter whether the collider was set before the body was added
+			Collider2D* collider = rigidbody->m_collider;
+
+			//Sleeping bodies haven't moved, CopyTransformsFromObjects wakes the ones moved from outside
+			if (!rigidbody->IsAwake() && collider->m_broadphaseProxy != INVALID_BROADPHASE_PROXY)
+			{
+				continue;
+			}
+
+			if (collider->m_broadphaseProxy == INVALID_BROADPHASE_PROXY)
+			{
+				collider->m_broadphaseProxy = m_broadphase->CreateProxy(collider, collider->GetWorldBounds(), rbTypes == STATIC_SIMULATION);
+			}
+			else
+			{
+				m_broadphase->MoveProxy(collider->m_broadphaseProxy, collider->GetWorldBounds());
+			}
+		}
+	}
+
+	//Triggers share the broadphase so their overlaps come out with the other candidate pairs
+	for (int triggerTypes = 0; triggerTypes < NUM_SIMULATION_TYPES; triggerTypes++)
+	{
+		for (Trigger2D* trigger : m_triggerBucket->m_triggerBucket[triggerTypes])
+		{
+			if (trigger == nullptr || trigger->m_collider == nullptr)
+			{
+				continue;
+			}
+
+			Collider2D* collider = trigger->m_collider;
+			if (collider->m_broadphaseProxy == INVALID_BROADPHASE_PROXY)
+			{
+				collider->m_broadphaseProxy = m_broadphase->CreateProxy(collider, collider->GetWorldBounds(), triggerTypes == STATIC_SIMULATION);
+			}
+			else
+			{
+				m_broadphase->MoveProxy(collider->m_broadphaseProxy, collider->GetWorldBounds());
+			}
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void PhysicsSystem::UpdateCandidatePairCollisions()
+{
+	UpdateBroadphase();
+	m_broadphase->GetCandidatePairs(m_candidatePairs);
+	SplitCandidatePairs();
+
+	//Same passes as the brute force path, but every pair in a pass is tested against the positions from the start of that
+	//pass. Without a pool the batch runs inline, so the thread count never changes the result
+	GenerateContacts(m_staticPairs);
+	for (const NarrowphaseContact_T& contact : m_contacts)
+	{
+		ApplyStaticVsStaticContact(contact.m_bodyA, contact.m_bodyB, contact.m_collision);
+	}
+
+	for (int passIndex = 0; passIndex < 3; passIndex++)
+	{
+		bool canResolve = (passIndex != 2);
+		GenerateContacts((passIndex == 1) ? m_dynamicPairs : m_dynamicStaticPairs);
+
+		for (const NarrowphaseContact_T& contact : m_contacts)
+		{
+			if (passIndex == 1)
+			{
+				ResolveDynamicVsDynamicContact(contact.m_bodyA, contact.m_bodyB, contact.m_collision, canResolve);
+			}
+			else
+			{
+				ResolveDynamicVsStaticContact(contact.m_bodyA, contact.m_bodyB, contact.m_collision, canResolve);
+			}
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void PhysicsSystem::UpdateSolverContacts(float deltaTime)
+{
+	if (m_broadphase != nullptr)
+	{
+		UpdateBroadphase();
+		m_broadphase->GetCandidatePairs(m_candidatePairs);
+	}
+	else
+	{
+		GetAllPairs(m_candidatePairs);
+	}
+	SplitCandidatePairs();
+
+	GenerateContacts(m_staticPairs);
+	for (const NarrowphaseContact_T& contact : m_contacts)
+	{
+		ApplyStaticVsStaticContact(contact.m_bodyA, contact.m_bodyB, contact.m_collision);
+	}
+
+	//Every contact goes to the solver at once, nothing is pushed or resolved until they are all known
+	GenerateContacts(m_dynamicStaticPairs);
+	for (const NarrowphaseContact_T& contact : m_contacts)
+	{
+		contact.m_bodyA->m_collider->SetCollision(true);
+		contact.m_bodyB->m_collider->SetCollision(true);
+
+		//Solved contacts get their event from the solver, with the impulse it settled on
+		if (!m_contactSolver->AddContact(contact.m_bodyA, contact.m_bodyB, contact.m_collision))
+		{
+			RecordContactEvent(contact.m_bodyA, contact.m_bodyB, contact.m_collision, 0.f);
+		}
+	}
+
+	GenerateContacts(m_dynamicPairs);
+	for (const NarrowphaseContact_T& contact : m_contacts)
+	{
+		contact.m_bodyA->m_collider->SetCollision(true);
+		contact.m_bodyB->m_collider->SetCollision(true);
+		m_touchingDynamicPairs.push_back(BroadphasePair_T{ contact.m_bodyA->m_collider, contact.m_bodyB->m_collider });
+
+		if (!m_contactSolver->AddContact(contact.m_bodyA, contact.m_bodyB, contact.m_collision))
+		{
+			RecordContactEvent(contact.m_bodyA, contact.m_bodyB, contact.m_collision, 0.f);
+		}
+	}
+
+	m_contactSolver->Solve(deltaTime, &m_contactEvents);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void PhysicsSystem::GetAllPairs(BroadphasePairList& outPairs)
+{
+	outPairs.clear();
+
+	std::vector<Rigidbody2D*>& staticBodies = m_rbBucket->m_RbBucket[STATIC_SIMULATION];
+
+	for (int rbType = 0; rbType < NUM_SIMULATION_TYPES; rbType++)
+	{
+		std::vector<Rigidbody2D*>& bodies = m_rbBucket->m_RbBucket[rbType];
+		int numBodies = static_cast<int>(bodies.size());
+
+		for (int rbIndex = 0; rbIndex < numBodies; rbIndex++)
+		{
+			if (bodies[rbIndex] == nullptr || bodies[rbIndex]->m_collider == nullptr)
+			{
+				continue;
+			}
+
+			//Each body pairs with the ones after it in its own bucket, dynamic bodies also pair with every static one
+			for (int otherIndex = rbIndex + 1; otherIndex < numBodies; otherIndex++)
+			{
+				if (bodies[otherIndex] != nullptr && bodies[otherIndex]->m_collider != nullptr)
+				{
+					outPairs.push_back(BroadphasePair_T{ bodies[rbIndex]->m_collider, bodies[otherIndex]->m_collider });
+				}
+			}
+
+			if (rbType != DYNAMIC_SIMULATION)
+			{
+				continue;
+			}
+
+			for (Rigidbody2D* staticBody : staticBodies)
+			{
+				if (staticBody != nullptr && staticBody->m_collider != nullptr)
+				{
+					outPairs.push_back(BroadphasePair_T{ bodies[rbIndex]->m_collider, staticBody->m_collider });
+				}
+			}
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void PhysicsSystem::SplitCandidatePairs()
+{
+	//Split the pairs up by the pass that handles them, dropping pairs with dead bodies. Mixed pairs put the dynamic body first
+	m_staticPairs.clear();
+	m_dynamicStaticPairs.clear();
+	m_dynamicPairs.clear();
+	m_triggerPairs.clear();
+
+	for (const BroadphasePair_T& pair : m_candidatePairs)
+	{
+		//Triggers only care about dynamic bodies, sleeping or not
+		if (pair.m_colliderA->m_trigger != nullptr || pair.m_colliderB->m_trigger != nullptr)
+		{
+			bool isTriggerA = pair.m_colliderA->m_trigger != nullptr;
+			Collider2D* otherCollider = isTriggerA ? pair.m_colliderB : pair.m_colliderA;
+
+			if (otherCollider->m_rigidbody != nullptr && otherCollider->m_rigidbody->GetSimulationType() == DYNAMIC_SIMULATION)
+			{
+				m_triggerPairs.push_back(isTriggerA ? pair : BroadphasePair_T{ pair.m_colliderB, pair.m_colliderA });
+			}
+			continue;
+		}
+
+		Rigidbody2D* rb0 = pair.m_colliderA->m_rigidbody;
+		Rigidbody2D* rb1 = pair.m_colliderB->m_rigidbody;
+		if (!rb0->m_isAlive || !rb1->m_isAlive)
+		{
+			continue;
+		}
+
+		bool isDynamic0 = rb0->GetSimulationType() == DYNAMIC_SIMULATION;
+		bool isDynamic1 = rb1->GetSimulationType() == DYNAMIC_SIMULATION;
+
+		//Pairs where the only dynamic bodies are asleep can't have changed since they fell asleep, but two sleeping bodies
+		//still resting on each other keep their island linked. GetAllPairs hands over every pair, so the bounds are checked here
+		if ((isDynamic0 || isDynamic1) && !(isDynamic0 && rb0->IsAwake()) && !(isDynamic1 && rb1->IsAwake()))
+		{
+			if (isDynamic0 && isDynamic1 && m_isSleepingEnabled && AreIslandNeighbours(pair.m_colliderA, pair.m_colliderB))
+			{
+				m_sleepingDynamicPairs.push_back(pair);
+			}
+			continue;
+		}
+
+		if (isDynamic0 && isDynamic1)
+		{
+			m_dynamicPairs.push_back(pair);
+		}
+		else if (isDynamic0 != isDynamic1)
+		{
+			m_dynamicStaticPairs.push_back(isDynamic0 ? pair : BroadphasePair_T{ pair.m_colliderB, pair.m_colliderA });
+		}
+		else if (rb0->GetSimulationType() == STATIC_SIMULATION && rb1->GetSimulationType() == STATIC_SIMULATION)
+		{
+			m_staticPairs.push_back(pair);
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void PhysicsSystem::GenerateContacts(const BroadphasePairList& pairs)
+{
+	m_contacts.clear();
+
+	m_narrowphaseBatch.Clear();
+	m_unbatchedPairs.clear();
+	for (const BroadphasePair_T& pair : pairs)
+	{
+		if (!m_narrowphaseBatch.AddPair(pair.m_colliderA, pair.m_colliderB))
+		{
+			m_unbatchedPairs.push_back(pair);
+		}
+	}
+
+	m_narrowphaseBatch.Run(m_narrowphasePool);
+	m_narrowphaseBatch.AppendContacts(m_contacts);
+
+	//Inline without a pool, which produces the same contacts in the same order as the merged worker buffers
+	if (m_narrowphasePool == nullptr)
+	{
+		for (const BroadphasePair_T& pair : m_unbatchedPairs)
+		{
+			NarrowphaseContact_T contact;
+			if (pair.m_colliderA->IsTouching(&contact.m_collision, pair.m_colliderB))
+			{
+				contact.m_bodyA = pair.m_colliderA->m_rigidbody;
+				contact.m_bodyB = pair.m_colliderB->m_rigidbody;
+				m_contacts.push_back(contact);
+			}
+		}
+	}
+	else
+	{
+		for (NarrowphaseContactList& workerContacts : m_workerContacts)
+		{
+			workerContacts.clear();
+		}
+
+		//The collision checks only read the colliders so the pairs can be split across threads any way we like
+		m_narrowphasePool->ParallelFor((uint)m_unbatchedPairs.size(), [&](uint workerIndex, uint startIndex, uint endIndex)
+		{
+			NarrowphaseContactList& workerContacts = m_workerContacts[workerIndex];
+			for (uint pairIndex = startIndex; pairIndex < endIndex; ++pairIndex)
+			{
+				NarrowphaseContact_T contact;
+				if (m_unbatchedPairs[pairIndex].m_colliderA->IsTouching(&contact.m_collision, m_unbatchedPairs[pairIndex].m_colliderB))
+				{
+					contact.m_bodyA = m_unbatchedPairs[pairIndex].m_colliderA->m_rigidbody;
+					contact.m_bodyB = m_unbatchedPairs[pairIndex].m_colliderB->m_rigidbody;
+					workerContacts.push_back(contact);
+				}
+			}
+		});
+
+		for (const NarrowphaseContactList& workerContacts : m_workerContacts)
+		{
+			m_contacts.insert(m_contacts.end(), workerContacts.begin(), workerContacts.end());
+		}
+	}
+
+	//Resolve order only depends on the bodies, never on the thread count or the order the broadphase gave us
+	std::stable_sort(m_contacts.begin(), m_contacts.end(), [](const NarrowphaseContact_T& lhs, const NarrowphaseContact_T& rhs)
+	{
+		if (lhs.m_bodyA->m_bodyId != rhs.m_bodyA->m_bodyId)
+		{
+			return lhs.m_bodyA->m_bodyId < rhs.m_bodyA->m_bodyId;
+		}
+		return lhs.m_bodyB->m_bodyId < rhs.m_bodyB->m_bodyId;
+	});
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void PhysicsSystem::CheckStaticVsStaticPair(Rigidbody2D* rb0, Rigidbody2D* rb1)
+{
+	Collision2D collision;
+	if(rb0->m_collider->IsTouching(&collision, rb1->m_collider))
+	{
+		ApplyStaticVsStaticContact(rb0, rb1, collision);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void PhysicsSystem::ApplyStaticVsStaticContact(Rigidbody2D* rb0, Rigidbody2D* rb1, const Collision2D& collision)
+{
+	//Set collision to true
+	rb0->m_collider->SetCollision(true);
+	rb1->m_collider->SetCollision(true);
+
+	//Collision events go out after the step
+	RecordContactEvent(rb0, rb1, collision, 0.f);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void PhysicsSystem::RecordContactEvent(Rigidbody2D* rb0, Rigidbody2D* rb1, const Collision2D& collision, float normalImpulse)
+{
+	ContactEvent2D_T contactEvent;
+	contactEvent.m_colliderA = rb0->m_collider;
+	contactEvent.m_colliderB = rb1->m_collider;
+	contactEvent.m_bodyIdA = rb0->m_bodyId;
+	contactEvent.m_bodyIdB = rb1->m_bodyId;
+	contactEvent.m_normal = collision.m_manifold.m_normal;
+	contactEvent.m_point = collision.m_manifold.m_contact;
+	contactEvent.m_penetration = collision.m_manifold.m_penetration;
+	contactEvent.m_normalImpulse = normalImpulse;
+	m_contactEvents.push_back(contactEvent);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void PhysicsSystem::DispatchContactEvents()
+{
+	//The colliders' own events first. Dynamic vs dynamic contacts never fired these so they still don't
+	for (const ContactEvent2D_T& contactEvent : m_contactEvents)
+	{
+		bool isDynamicA = contactEvent.m_colliderA->m_rigidbody->GetSimulationType() == DYNAMIC_SIMULATION;
+		bool isDynamicB = contactEvent.m_colliderB->m_rigidbody->GetSimulationType() == DYNAMIC_SIMULATION;
+		if (isDynamicA && isDynamicB)
+		{
+			continue;
+		}
+
+		if (!contactEvent.m_colliderA->m_onCollisionEvent.empty())
+		{
+			EventArgs args;
+			contactEvent.m_colliderA->FireCollisionEvent(args);
+		}
+
+		if (!contactEvent.m_colliderB->m_onCollisionEvent.empty())
+		{
+			EventArgs args;
+			contactEvent.m_colliderB->FireCollisionEvent(args);
+		}
+	}
+
+	if (m_contactEvents.empty())
+	{
+		return;
+	}
+
+	for (const ContactListener_T& listener : m_contactListeners)
+	{
+		listener.m_callback(m_contactEvents.data(), (uint)m_contactEvents.size(), listener.m_userData);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void PhysicsSystem::ResolveDynamicVsStaticPair(Rigidbody2D* dynamicBody, Rigidbody2D* staticBody, bool canResolve)
+{
+	Collision2D collision;
+	if(dynamicBody->m_collider->IsTouching(&collision, staticBody->m_collider))
+	{
+		ResolveDynamicVsStaticContact(dynamicBody, staticBody, collision, canResolve);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void PhysicsSystem::ResolveDynamicVsStaticContact(Rigidbody2D* dynamicBody, Rigidbody2D* staticBody, const Collision2D& collision, bool canResolve)
+{
+	//Set collision to true
+	dynamicBody->m_collider->SetCollision(true);
+	staticBody->m_collider->SetCollision(true);
+
+	//Push the object out based on the collision manifold
+	if(collision.m_manifold.m_normal != Vec2::ZERO)
+	{
+		dynamicBody->SetPosition(dynamicBody->GetPosition() + collision.m_manifold.m_normal * collision.m_manifold.m_penetration);
+	}
+
+
+	if(canResolve)
+	{
+
+		Rigidbody2D* rb0 = dynamicBody;
+		Rigidbody2D* rb1 = staticBody;
+
+		Vec2 velocity0 = rb0->GetVelocity();
+		Vec2 velocity1 = rb1->GetVelocity();
+
+		float mass0 = rb0->GetMass(); 
+	
+		Manifold2D manifold = collision.m_manifold;
+		Vec2 contactPoint = manifold.m_contact + manifold.m_normal * (manifold.m_penetration);
+
+		//Get the vector from the object centre to the point of contact for both objects
+		Vec2 rb0toContact = contactPoint - rb0->GetPosition();
+		Vec2 rb1toContact = contactPoint - rb1->GetPosition();
+
+		//Get the perpendicular of the vector from center to point
+		Vec2 toPointPerpendicular0 = rb0toContact.GetRotated90Degrees();
+		Vec2 toPointPerpendicular1 = rb1toContact.GetRotated90Degrees();
+
+		//Get the velocity at the impact point for both objects
+		Vec2 velocityAtPoint0 = velocity0 + DegreesToRadians(rb0->GetAngularVelocity()) * toPointPerpendicular0;
+		Vec2 velocityAtPoint1 = velocity1 + DegreesToRadians(rb1->GetAngularVelocity()) * toPointPerpendicular1;
+
+		//Coefficient of restitution
+		float CoefficientOfRestitution = (collision.m_Obj->m_rigidbody->m_material.restitution) * (collision.m_otherObj->m_rigidbody->m_material.restitution);
+		
+		//Generate Impulse along the normal
+		float j = -(1 + CoefficientOfRestitution) * GetDotProduct((velocityAtPoint0 - velocityAtPoint1), manifold.m_normal);
+		float constant0 = ( GetDotProduct(toPointPerpendicular0, manifold.m_normal) * GetDotProduct(toPointPerpendicular0, manifold.m_normal) / rb0->GetMomentOfInertia() ) ;
+		float d = (1 / mass0) + (constant0);
+
+		float impulseAlongNormal = j / d;
+
+		//Collision events go out after the step. Only the resolving pass records one, the pass after the dynamic pairs
+		//just pushes back out what they pushed in and would report the same contact again with no impulse
+		RecordContactEvent(dynamicBody, staticBody, collision, impulseAlongNormal);
+
+		rb0->ApplyImpulseAt( impulseAlongNormal * collision.m_manifold.m_normal, contactPoint );					
+
+		//Get updated velocity
+		velocity0 = rb0->GetVelocity();
+		velocity1 = rb1->GetVelocity();
+
+		//Get the velocity at the impact point for both objects
+		velocityAtPoint0 = velocity0 + DegreesToRadians(rb0->GetAngularVelocity()) * toPointPerpendicular0;
+		velocityAtPoint1 = velocity1 + DegreesToRadians(rb1->GetAngularVelocity()) * toPointPerpendicular1;
+
+		//Generate the impuse along the tangent
+		Vec2 tangent = manifold.m_normal.GetRotated90Degrees();
+		float jT = -(1 + CoefficientOfRestitution) * GetDotProduct((velocityAtPoint0 - velocityAtPoint1), tangent);
+		float constant0T = (GetDotProduct(toPointPerpendicular0, tangent) * GetDotProduct(toPointPerpendicular0, tangent) / rb0->GetMomentOfInertia());
+		float dT = (1 / mass0) + (constant0T);
+
+		float impulseAlongTangent = jT / dT;
+
+		//Coulumb's law
+		float frictionCoefficient = sqrt(abs(rb0->m_friction * rb1->m_friction));
+
+		impulseAlongTangent = Clamp(impulseAlongTangent, -impulseAlongNormal, impulseAlongNormal);
+		impulseAlongTangent *= frictionCoefficient;
+
+		rb0->ApplyImpulseAt(impulseAlongTangent * tangent, contactPoint);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void PhysicsSystem::ResolveDynamicVsDynamicPair(Rigidbody2D* rb0, Rigidbody2D* rb1, bool canResolve)
+{
+	Collision2D collision;
+	if(rb0->m_collider->IsTouching(&collision, rb1->m_collider))
+	{
+		ResolveDynamicVsDynamicContact(rb0, rb1, collision, canResolve);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void PhysicsSystem::ResolveDynamicVsDynamicContact(Rigidbody2D* rb0, Rigidbody2D* rb1, const Collision2D& collision, bool canResolve)
+{
+	m_touchingDynamicPairs.push_back(BroadphasePair_T{ rb0->m_collider, rb1->m_collider });
+
+	//Set collision to true
+	rb0->m_collider->SetCollision(true);
+	rb1->m_collider->SetCollision(true);
+	RecordContactEvent(rb0, rb1, collision, 0.f);
+
+	//Push the object out based on the collision manifold
+	if(collision.m_manifold.m_normal != Vec2::ZERO)
+	{
+		float mass0 = rb0->GetMass(); 
+		float mass1 = rb1->GetMass(); 
+		float totalMass = mass0 + mass1;
+
+		//Correction on system mass
+		float correct0 = mass1 / totalMass;   // move myself along the correction normal
+		float correct1 = 1 - correct0;  // move opposite along the normal
+
+		Vec2 move0 = collision.m_manifold.m_normal * collision.m_manifold.m_penetration * correct0;
+		Vec2 move1 = (collision.m_manifold.m_normal * -1) * collision.m_manifold.m_penetration * correct1;
+
+		//rb0->SetPosition(rb0->GetPosition() + collision.m_manifold.m_normal * collision.m_manifold.m_penetration * correct0);
+		//rb1->SetPosition(rb1->GetPosition() + (collision.m_manifold.m_normal * -1) * collision.m_manifold.m_penetration * correct1);
+		
+		rb0->MoveBy(move0);
+		rb1->MoveBy(move1);
+	}
+
+
+	if(canResolve)
+	{
+		//resolve
+		//Vec2 *contactPoint = new Vec2();
+		//float impulseAlongNormal = GetImpulseAlongNormal(contactPoint, collision, *rb0, *rb1);
+
+		Vec2 velocity0 = rb0->GetVelocity();
+		Vec2 velocity1 = rb1->GetVelocity();
+
+		float mass0 = rb0->GetMass();
+		float mass1 = rb1->GetMass();
+		float totalMass = mass0 + mass1;
+
+		//Correction on system mass
+		float correct0 = mass1 / totalMass;   // move myself along the correction normal
+		//float correct1 = 1 - correct0;  // move opposite along the normal
+
+		Manifold2D manifold = collision.m_manifold;
+		Vec2 contactPoint = manifold.m_contact + manifold.m_normal * (manifold.m_penetration * correct0);
+
+		//Get the vector from the object centre to the point of contact for both objects
+		Vec2 rb0toContact = contactPoint - rb0->GetPosition();
+		Vec2 rb1toContact = contactPoint - rb1->GetPosition();
+
+		//Get the perpendicular of the vector from center to point
+		Vec2 toPointPerpendicular0 = rb0toContact.GetRotated90Degrees();
+		Vec2 toPointPerpendicular1 = rb1toContact.GetRotated90Degrees();
+
+		//Get the velocity at the impact point for both objects
+		Vec2 velocityAtPoint0 = velocity0 + DegreesToRadians(rb0->GetAngularVelocity()) * toPointPerpendicular0;
+		Vec2 velocityAtPoint1 = velocity1 + DegreesToRadians(rb1->GetAngularVelocity()) * toPointPerpendicular1;
+
+		//Coefficient of restitution
+		float CoefficientOfRestitution = (collision.m_Obj->m_rigidbody->m_material.restitution) * (collision.m_otherObj->m_rigidbody->m_material.restitution);
+
+		//Impulse along the normal
+		float j = -(1 + CoefficientOfRestitution) * GetDotProduct((velocityAtPoint0 - velocityAtPoint1), manifold.m_normal);
+		float constant0 = (GetDotProduct(toPointPerpendicular0, manifold.m_normal) * GetDotProduct(toPointPerpendicular0, manifold.m_normal) / rb0->GetMomentOfInertia());
+		float constant1 = (GetDotProduct(toPointPerpendicular1, manifold.m_normal) * GetDotProduct(toPointPerpendicular1, manifold.m_normal) / rb1->GetMomentOfInertia());
+		float d = ((mass0 + mass1) / (mass0 * mass1)) + constant0 + constant1;
+
+		float impulseAlongNormal = j / d;
+		m_contactEvents.back().m_normalImpulse = impulseAlongNormal;
+
+		rb0->ApplyImpulseAt(impulseAlongNormal * collision.m_manifold.m_normal, contactPoint);
+		rb1->ApplyImpulseAt(-1.f * (impulseAlongNormal * collision.m_manifold.m_normal), contactPoint);
+
+		// Get updated velocities
+		velocity0 = rb0->GetVelocity();
+		velocity1 = rb1->GetVelocity();
+
+		//Get the velocity at the impact point for both objects
+		velocityAtPoint0 = velocity0 + DegreesToRadians(rb0->GetAngularVelocity()) * toPointPerpendicular0;
+		velocityAtPoint1 = velocity1 + DegreesToRadians(rb1->GetAngularVelocity()) * toPointPerpendicular1;
+
+		//Impulse along the tangent
+		Vec2 tangent = manifold.m_normal.GetRotated90Degrees();
+		float jT = -(1 + CoefficientOfRestitution) * GetDotProduct((velocityAtPoint0 - velocityAtPoint1), tangent);
+		float constant0T = (GetDotProduct(toPointPerpendicular0, tangent) * GetDotProduct(toPointPerpendicular0, tangent) / rb0->GetMomentOfInertia());
+		float constant1T = (GetDotProduct(toPointPerpendicular1, tangent) * GetDotProduct(toPointPerpendicular1, tangent) / rb1->GetMomentOfInertia());
+		float dT = ((mass0 + mass1) / (mass0 * mass1)) + constant0T + constant1T;
+
+		float impulseAlongTangent = jT / dT;
+
+		//Coulumb's law
+		float frictionCoefficient = sqrt(abs(rb0->m_friction * rb1->m_friction));
+
+		impulseAlongTangent = Clamp(impulseAlongTangent, -impulseAlongNormal, impulseAlongNormal);
+		impulseAlongTangent *= frictionCoefficient;
+
+		rb0->ApplyImpulseAt( impulseAlongTangent * tangent, contactPoint );
+		rb1->ApplyImpulseAt( -1.f * (impulseAlongTangent * tangent), contactPoint );
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static uint FindIslandRoot(std::vector<uint>& parents, uint index)
+{
+	//Path halving, every other node on the way up is pointed at its grandparent
+	while (parents[index] != index)
+	{
+		parents[index] = parents[parents[index]];
+		index = parents[index];
+	}
+
+	return index;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void PhysicsSystem::UpdateIslands(float deltaTime)
+{
+	std::vector<Rigidbody2D*>& dynamicBodies = m_rbBucket->m_RbBucket[DYNAMIC_SIMULATION];
+	uint numBodies = static_cast<uint>(dynamicBodies.size());
+
+	//Every body starts out as its own island
+	m_islandParents.resize(numBodies);
+	for (uint bodyIndex = 0; bodyIndex < numBodies; bodyIndex++)
+	{
+		m_islandParents[bodyIndex] = bodyIndex;
+		if (dynamicBodies[bodyIndex] != nullptr)
+		{
+			dynamicBodies[bodyIndex]->m_islandIndex = bodyIndex;
+		}
+	}
+
+	//Statics never join an island, otherwise the floor would tie the whole scene into one.
+	//The sleeping pairs keep a sleeping island whole, so whatever wakes one of its bodies wakes all of them
+	const BroadphasePairList* islandPairLists[] = { &m_touchingDynamicPairs, &m_sleepingDynamicPairs };
+	for (const BroadphasePairList* pairList : islandPairLists)
+	{
+		for (const BroadphasePair_T& pair : *pairList)
+		{
+			uint rootA = FindIslandRoot(m_islandParents, pair.m_colliderA->m_rigidbody->m_islandIndex);
+			uint rootB = FindIslandRoot(m_islandParents, pair.m_colliderB->m_rigidbody->m_islandIndex);
+			if (rootA != rootB)
+			{
+				m_islandParents[std::max(rootA, rootB)] = std::min(rootA, rootB);
+			}
+		}
+	}
+
+	//An island can sleep once the body that came to rest last has been resting long enough, bodies already asleep don't hold it back
+	float linearToleranceSquared = m_linearSleepTolerance * m_linearSleepTolerance;
+	m_islandSleepTimes.assign(numBodies, FLT_MAX);
+	for (uint bodyIndex = 0; bodyIndex < numBodies; bodyIndex++)
+	{
+		Rigidbody2D* rigidbody = dynamicBodies[bodyIndex];
+		if (rigidbody == nullptr || !rigidbody->m_isAlive || !rigidbody->IsAwake())
+		{
+			continue;
+		}
+
+		bool isResting = rigidbody->GetVelocity().GetLengthSquared() <= linearToleranceSquared && fabsf(rigidbody->GetAngularVelocity()) <= m_angularSleepTolerance;
+		rigidbody->m_sleepTime = isResting ? rigidbody->m_sleepTime + deltaTime : 0.f;
+
+		uint root = FindIslandRoot(m_islandParents, bodyIndex);
+		m_islandSleepTimes[root] = std::min(m_islandSleepTimes[root], rigidbody->m_sleepTime);
+	}
+
+	//Islands sleep and wake whole, a sleeping body touched by an awake one is woken with the rest of its new island
+	for (uint bodyIndex = 0; bodyIndex < numBodies; bodyIndex++)
+	{
+		Rigidbody2D* rigidbody = dynamicBodies[bodyIndex];
+		if (rigidbody == nullptr || !rigidbody->m_isAlive)
+		{
+			continue;
+		}
+
+		if (m_islandSleepTimes[FindIslandRoot(m_islandParents, bodyIndex)] >= m_timeToSleep)
+		{
+			rigidbody->PutToSleep();
+		}
+		else
+		{
+			rigidbody->WakeUp();
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool PhysicsSystem::AreIslandNeighbours(const Collider2D* colliderA, const Collider2D* colliderB) const
+{
+	if (colliderA == nullptr || colliderB == nullptr)
+	{
+		return false;
+	}
+
+	//Resting contacts sit at or just inside the surface, so a small margin is enough to keep them linked
+	AABB2 boundsA = colliderA->GetWorldBounds();
+	AABB2 boundsB = colliderB->GetWorldBounds();
+	return boundsA.m_minBounds.x <= boundsB.m_maxBounds.x + ISLAND_LINK_MARGIN && boundsB.m_minBounds.x <= boundsA.m_maxBounds.x + ISLAND_LINK_MARGIN
+		&& boundsA.m_minBounds.y <= boundsB.m_maxBounds.y + ISLAND_LINK_MARGIN && boundsB.m_minBounds.y <= boundsA.m_maxBounds.y + ISLAND_LINK_MARGIN;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void PhysicsSystem::WakeQueuedBodyNeighbours()
+{
+	//Whatever was resting on a destroyed body has lost its support, its island follows once it moves
+	for (const Rigidbody2D* rigidbody : m_rigidbodyDestroyQueue)
+	{
+		if (rigidbody->m_collider == nullptr)
+		{
+			continue;
+		}
+
+		AABB2 bounds = rigidbody->m_collider->GetWorldBounds();
+		bounds.m_minBounds -= Vec2(ISLAND_LINK_MARGIN, ISLAND_LINK_MARGIN);
+		bounds.m_maxBounds += Vec2(ISLAND_LINK_MARGIN, ISLAND_LINK_MARGIN);
+
+		m_wakeCandidates.clear();
+		GetQueryCandidates(m_wakeCandidates, bounds);
+		for (Collider2D* collider : m_wakeCandidates)
+		{
+			Rigidbody2D* neighbour = collider->m_rigidbody;
+			if (neighbour == nullptr || !neighbour->m_isAlive || neighbour->IsAwake() || neighbour->GetSimulationType() != DYNAMIC_SIMULATION)
+			{
+				continue;
+			}
+
+			if (AreIslandNeighbours(rigidbody->m_collider, collider))
+			{
+				neighbour->WakeUp();
+			}
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+float PhysicsSystem::GetImpulseAlongNormal(Vec2 *out, const Collision2D& collision, const Rigidbody2D& rb0, const Rigidbody2D& rb1)
+{
+	Vec2 velocity0 = rb0.GetVelocity();
+	Vec2 velocity1 = rb1.GetVelocity();
+
+	float mass0 = rb0.GetMass(); 
+	float mass1 = rb1.GetMass(); 
+	float totalMass = mass0 + mass1;
 
 	//Correction on system mass
 	float correct0 = mass1 / totalMass;   // move myself along the correction normal
@@ -664,8 +2062,8 @@ float PhysicsSystem::GetImpulseAlongNormal(Vec2 *out, const Collision2D& collisi
 	*out = contactPoint;
 
 	//Get the vector from the object centre to the point of contact for both objects
-	Vec2 rb0toContact = contactPoint - rb0.m_object_transform->m_position;
-	Vec2 rb1toContact = contactPoint - rb1.m_object_transform->m_position;
+	Vec2 rb0toContact = contactPoint - rb0.GetPosition();
+	Vec2 rb1toContact = contactPoint - rb1.GetPosition();
 
 	//Get the perpendicular of the vector from center to point
 	Vec2 toPointPerpendicular0 = rb0toContact.GetRotated90Degrees();
@@ -674,19 +2072,306 @@ float PhysicsSystem::GetImpulseAlongNormal(Vec2 *out, const Collision2D& collisi
 	//Generate the impulse along normal
 
 	//Get the velocity at the impact point for both objects
-	Vec2 velocityAtPoint0 = velocity0 + DegreesToRadians(rb0.m_angularVelocity) * toPointPerpendicular0;
-	Vec2 velocityAtPoint1 = velocity1 + DegreesToRadians(rb1.m_angularVelocity) * toPointPerpendicular1;
+	Vec2 velocityAtPoint0 = velocity0 + DegreesToRadians(rb0.GetAngularVelocity()) * toPointPerpendicular0;
+	Vec2 velocityAtPoint1 = velocity1 + DegreesToRadians(rb1.GetAngularVelocity()) * toPointPerpendicular1;
 
 	//Coefficient of restitution
 	float CoefficientOfRestitution = (collision.m_Obj->m_rigidbody->m_material.restitution) * (collision.m_otherObj->m_rigidbody->m_material.restitution);
 
 	float j = -(1 + CoefficientOfRestitution) * GetDotProduct((velocityAtPoint0 - velocityAtPoint1), manifold.m_normal);
 
-	float constant0 = ( GetDotProduct(toPointPerpendicular0, manifold.m_normal) * GetDotProduct(toPointPerpendicular0, manifold.m_normal) / rb0.m_momentOfInertia ) ;
-	float constant1 = ( GetDotProduct(toPointPerpendicular1, manifold.m_normal) * GetDotProduct(toPointPerpendicular1, manifold.m_normal) / rb1.m_momentOfInertia );
+	float constant0 = ( GetDotProduct(toPointPerpendicular0, manifold.m_normal) * GetDotProduct(toPointPerpendicular0, manifold.m_normal) / rb0.GetMomentOfInertia() ) ;
+	float constant1 = ( GetDotProduct(toPointPerpendicular1, manifold.m_normal) * GetDotProduct(toPointPerpendicular1, manifold.m_normal) / rb1.GetMomentOfInertia() );
 	
 	float d = ((mass0 + mass1) / (mass0 * mass1)) + constant0 + constant1;
 
 	float impulseAlongNormal = j / d;
 	return impulseAlongNormal;
-}
\ No newline at end of file
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// UNIT TEST
+//------------------------------------------------------------------------------------------------------------------------------
+constexpr uint ISLAND_TEST_BOXES = 5U;
+constexpr float SYSTEM_TEST_STEP = 1.f / 60.f;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// A stack of boxes left to settle until the whole island is asleep
+static bool MakeSleepingStack(PhysicsSystem& system, std::vector<Transform2>& outTransforms, std::vector<Rigidbody2D*>& outBoxes)
+{
+	system.EnableContactSolver();
+	system.SetSleepingEnabled(true);
+
+	outTransforms.resize(ISLAND_TEST_BOXES + 1U);
+	outTransforms[ISLAND_TEST_BOXES].m_position = Vec2(0.f, -0.5f);
+	AddTestBody(system, STATIC_SIMULATION, COLLIDER_AABB2, &outTransforms[ISLAND_TEST_BOXES], Vec2(20.f, 1.f));
+
+	for (uint boxIndex = 0; boxIndex < ISLAND_TEST_BOXES; ++boxIndex)
+	{
+		outTransforms[boxIndex].m_position = Vec2(0.f, 0.5f + (float)boxIndex);
+		outBoxes.push_back(AddTestBody(system, DYNAMIC_SIMULATION, COLLIDER_AABB2, &outTransforms[boxIndex]));
+	}
+
+	for (uint stepIndex = 0; stepIndex < 240U; ++stepIndex)
+	{
+		system.Update(SYSTEM_TEST_STEP);
+	}
+
+	bool isAsleep = true;
+	for (const Rigidbody2D* box : outBoxes)
+	{
+		isAsleep = isAsleep && !box->IsAwake();
+	}
+	return isAsleep;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+UNITTEST("SleepingIslands", "Physics", 100)
+{
+	for (int broadphaseType = 0; broadphaseType < NUM_BROADPHASE_TYPES; ++broadphaseType)
+	{
+		//A push on the top box wakes the whole stack in the same step, not one layer per step
+		{
+			PhysicsSystem system((eBroadphaseType)broadphaseType);
+			std::vector<Transform2> transforms;
+			std::vector<Rigidbody2D*> boxes;
+			CONFIRM(MakeSleepingStack(system, transforms, boxes));
+
+			boxes[ISLAND_TEST_BOXES - 1U]->ApplyImpulses(Vec2(0.1f, 0.f), 0.f);
+			system.Update(SYSTEM_TEST_STEP);
+
+			for (const Rigidbody2D* box : boxes)
+			{
+				CONFIRM(box->IsAwake());
+			}
+		}
+
+		//Moving a sleeping body's object or writing its velocity wakes it, with or without a broadphase
+		{
+			PhysicsSystem system((eBroadphaseType)broadphaseType);
+			std::vector<Transform2> transforms;
+			std::vector<Rigidbody2D*> boxes;
+			CONFIRM(MakeSleepingStack(system, transforms, boxes));
+
+			Vec2 teleportPosition(10.f, 20.f);
+			transforms[ISLAND_TEST_BOXES - 1U].m_position = teleportPosition;
+			boxes[ISLAND_TEST_BOXES - 2U]->SetVelocity(Vec2(-1.f, 0.f));
+			system.Update(SYSTEM_TEST_STEP);
+
+			CONFIRM(boxes[ISLAND_TEST_BOXES - 1U]->IsAwake());
+			CONFIRM(boxes[ISLAND_TEST_BOXES - 1U]->GetPosition().y < teleportPosition.y);
+			CONFIRM(boxes[ISLAND_TEST_BOXES - 2U]->IsAwake());
+			CONFIRM(transforms[ISLAND_TEST_BOXES - 2U].m_position.x < 0.f);
+		}
+
+		//Taking the bottom box away drops everything above it, nothing is left asleep in mid air
+		{
+			PhysicsSystem system((eBroadphaseType)broadphaseType);
+			std::vector<Transform2> transforms;
+			std::vector<Rigidbody2D*> boxes;
+			CONFIRM(MakeSleepingStack(system, transforms, boxes));
+
+			std::vector<float> restingHeights;
+			for (const Rigidbody2D* box : boxes)
+			{
+				restingHeights.push_back(box->GetPosition().y);
+			}
+
+			system.DestroyRigidbody(boxes[0]);
+			for (uint stepIndex = 0; stepIndex < 60U; ++stepIndex)
+			{
+				system.Update(SYSTEM_TEST_STEP);
+			}
+
+			for (uint boxIndex = 1U; boxIndex < ISLAND_TEST_BOXES; ++boxIndex)
+			{
+				CONFIRM(boxes[boxIndex]->GetPosition().y < restingHeights[boxIndex] - 0.9f);
+			}
+		}
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+UNITTEST("FixedStepInterpolation", "Physics", 100)
+{
+	//Steps and frames are powers of two so the accumulator lands exactly on half a step
+	constexpr float FIXED_STEP = 0.25f;
+	constexpr float FRAME_TIME = 0.125f;
+
+	PhysicsSystem system(BROADPHASE_AABB_TREE);
+	Transform2 transform;
+	Rigidbody2D* body = AddTestBody(system, DYNAMIC_SIMULATION, COLLIDER_AABB2, &transform);
+	body->SetAngularVelocity(40.f);
+	body->SetVelocity(Vec2(2.f, 0.f));
+	system.SetFixedTimeStep(FIXED_STEP);
+
+	//Two frames run one step, the third lands halfway to the next one
+	for (uint frameIndex = 0; frameIndex < 3U; ++frameIndex)
+	{
+		system.Update(FRAME_TIME);
+	}
+
+	//The object is drawn halfway between the last two steps, rotation as well as position
+	float expectedRotation = body->m_previousRotation + (body->GetRotation() - body->m_previousRotation) * 0.5f;
+	Vec2 expectedPosition = body->m_previousPosition + (body->GetPosition() - body->m_previousPosition) * 0.5f;
+	CONFIRM(body->GetRotation() > body->m_previousRotation);
+	CONFIRM(fabsf(transform.m_rotation - expectedRotation) < 0.0001f);
+	CONFIRM((transform.m_position - expectedPosition).GetLength() < 0.0001f);
+
+	//The blended object doesn't leak back into the simulation on the next frame
+	float stepRotation = body->GetRotation();
+	Vec2 stepPosition = body->GetPosition();
+	system.Update(FRAME_TIME * 0.5f);
+	CONFIRM(body->GetRotation() == stepRotation);
+	CONFIRM(body->GetPosition() == stepPosition);
+	CONFIRM(body->GetTransform().m_rotation == stepRotation);
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+UNITTEST("ContactEventsOncePerPair", "Physics", 100)
+{
+	constexpr uint NUM_BOXES = 6U;
+
+	//The per pair resolve passes see the dynamic vs static contacts twice a step, listeners should only hear about them once
+	for (int broadphaseType = 0; broadphaseType < NUM_BROADPHASE_TYPES; ++broadphaseType)
+	{
+		PhysicsSystem system((eBroadphaseType)broadphaseType);
+		std::vector<Transform2> transforms(NUM_BOXES + 1U);
+		transforms[NUM_BOXES].m_position = Vec2(0.f, -0.5f);
+		AddTestBody(system, STATIC_SIMULATION, COLLIDER_AABB2, &transforms[NUM_BOXES], Vec2(20.f, 1.f));
+
+		//Short stacks sunk into each other, so the dynamic pass pushes the bottom boxes back into the ground
+		for (uint boxIndex = 0; boxIndex < NUM_BOXES; ++boxIndex)
+		{
+			transforms[boxIndex].m_position = Vec2((float)(boxIndex / 2U) * 2.f, 0.45f + (float)(boxIndex % 2U) * 0.9f);
+			AddTestBody(system, DYNAMIC_SIMULATION, COLLIDER_AABB2, &transforms[boxIndex]);
+		}
+
+		uint numEvents = 0U;
+		for (uint stepIndex = 0; stepIndex < 60U; ++stepIndex)
+		{
+			system.Update(SYSTEM_TEST_STEP);
+
+			const ContactEventList& contactEvents = system.GetContactEvents();
+			numEvents += (uint)contactEvents.size();
+			for (size_t eventIndex = 0; eventIndex < contactEvents.size(); ++eventIndex)
+			{
+				for (size_t otherIndex = eventIndex + 1U; otherIndex < contactEvents.size(); ++otherIndex)
+				{
+					bool isSamePair = (contactEvents[eventIndex].m_colliderA == contactEvents[otherIndex].m_colliderA && contactEvents[eventIndex].m_colliderB == contactEvents[otherIndex].m_colliderB)
+						|| (contactEvents[eventIndex].m_colliderA == contactEvents[otherIndex].m_colliderB && contactEvents[eventIndex].m_colliderB == contactEvents[otherIndex].m_colliderA);
+					CONFIRM(!isSamePair);
+				}
+			}
+		}
+
+		CONFIRM(numEvents > 0U);
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static void RunNarrowphaseThreadScene(eBroadphaseType broadphaseType, uint threadCount, std::vector<Transform2>& outTransforms)
+{
+	constexpr uint NUM_BODIES = 40U;
+	const eColliderType2D colliderTypes[3] = { COLLIDER_AABB2, COLLIDER_DISC, COLLIDER_BOX };
+
+	PhysicsSystem system(broadphaseType);
+	system.SetNarrowphaseThreadCount(threadCount);
+
+	outTransforms.clear();
+	outTransforms.resize(NUM_BODIES + 1U);
+	outTransforms[NUM_BODIES].m_position = Vec2(0.f, -0.5f);
+	AddTestBody(system, STATIC_SIMULATION, COLLIDER_AABB2, &outTransforms[NUM_BODIES], Vec2(40.f, 1.f));
+
+	//A jumbled pile of mixed shapes sunk into each other, so every pass has overlapping pairs that push the same bodies
+	uint seed = 7U;
+	for (uint bodyIndex = 0; bodyIndex < NUM_BODIES; ++bodyIndex)
+	{
+		seed = seed * 1664525U + 1013904223U;
+		float offset = (float)(seed >> 24U) / 255.f;
+		outTransforms[bodyIndex].m_position = Vec2((float)(bodyIndex % 8U) * 0.8f + offset * 0.3f, 0.4f + (float)(bodyIndex / 8U) * 0.7f);
+		AddTestBody(system, DYNAMIC_SIMULATION, colliderTypes[bodyIndex % 3U], &outTransforms[bodyIndex]);
+	}
+
+	for (uint stepIndex = 0; stepIndex < 30U; ++stepIndex)
+	{
+		system.Update(SYSTEM_TEST_STEP);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+UNITTEST("NarrowphaseThreadCount", "Physics", 100)
+{
+	//The narrowphase thread count only changes who runs the checks, never where the bodies end up
+	for (int broadphaseType = 0; broadphaseType < NUM_BROADPHASE_TYPES; ++broadphaseType)
+	{
+		std::vector<Transform2> inlineTransforms;
+		RunNarrowphaseThreadScene((eBroadphaseType)broadphaseType, 0U, inlineTransforms);
+
+		const uint threadCounts[2] = { 1U, 4U };
+		for (uint threadCount : threadCounts)
+		{
+			std::vector<Transform2> threadedTransforms;
+			RunNarrowphaseThreadScene((eBroadphaseType)broadphaseType, threadCount, threadedTransforms);
+
+			for (size_t bodyIndex = 0; bodyIndex < inlineTransforms.size(); ++bodyIndex)
+			{
+				CONFIRM(threadedTransforms[bodyIndex].m_position == inlineTransforms[bodyIndex].m_position);
+				CONFIRM(threadedTransforms[bodyIndex].m_rotation == inlineTransforms[bodyIndex].m_rotation);
+			}
+		}
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Counts its own destructor, which only runs if deleting through Collider2D reaches it
+class CountedTestCollider : public AABB2Collider
+{
+public:
+	CountedTestCollider() : AABB2Collider(Vec2(-0.5f, -0.5f), Vec2(0.5f, 0.5f)) { s_numAlive++; }
+	~CountedTestCollider() { s_numAlive--; }
+
+	static int s_numAlive;
+};
+
+int CountedTestCollider::s_numAlive = 0;
+
+//------------------------------------------------------------------------------------------------------------------------------
+UNITTEST("SystemOwnsColliders", "Physics", 100)
+{
+	//Colliders made with new rather than the Create functions, on bodies that were added, destroyed, or never added at all
+	{
+		PhysicsSystem system(BROADPHASE_AABB_TREE);
+		std::vector<Transform2> transforms(6U);
+		for (uint bodyIndex = 0; bodyIndex < 6U; ++bodyIndex)
+		{
+			transforms[bodyIndex].m_position = Vec2((float)bodyIndex * 2.f, 0.f);
+
+			Rigidbody2D* rigidbody = system.CreateRigidbody((bodyIndex % 2U == 0U) ? DYNAMIC_SIMULATION : STATIC_SIMULATION);
+			rigidbody->SetCollider(new CountedTestCollider())->m_rigidbody = rigidbody;
+			rigidbody->SetObject(nullptr, &transforms[bodyIndex]);
+
+			if (bodyIndex < 2U)
+			{
+				system.AddRigidbodyToVector(rigidbody);
+			}
+			else if (bodyIndex < 4U)
+			{
+				system.DestroyRigidbody(rigidbody);
+			}
+		}
+
+		system.Update(SYSTEM_TEST_STEP);
+		CONFIRM(CountedTestCollider::s_numAlive == 4);
+	}
+
+	CONFIRM(CountedTestCollider::s_numAlive == 0);
+	return true;
+}
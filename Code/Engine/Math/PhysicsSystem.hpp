@@ -1,15 +1,38 @@
 //------------------------------------------------------------------------------------------------------------------------------
 #pragma once
+#include "Engine/Allocators/ObjectAllocator.hpp"
 #include "Engine/Commons/EngineCommon.hpp"
+#include "Engine/Math/Broadphase2D.hpp"
+#include "Engine/Math/PhysicsQuery2D.hpp"
+#include "Engine/Math/CollisionHandler.hpp"
+#include "Engine/Math/ContactEvent2D.hpp"
+#include "Engine/Math/ContactSolver2D.hpp"
+#include "Engine/Math/NarrowphaseBatch2D.hpp"
 #include "Engine/Math/Rigidbody2D.hpp"
+#include "Engine/Math/RigidbodyStore2D.hpp"
+#include "Engine/Math/SpatialHashBroadphase.hpp"
+#include "Engine/Math/TriggerTouchSet2D.hpp"
+
+//------------------------------------------------------------------------------------------------------------------------------
+constexpr float DEFAULT_LINEAR_SLEEP_TOLERANCE = 0.05f;		//Units per second
+constexpr float DEFAULT_ANGULAR_SLEEP_TOLERANCE = 2.f;		//Degrees per second
+constexpr float DEFAULT_TIME_TO_SLEEP = 0.5f;
+constexpr float ISLAND_LINK_MARGIN = 0.01f;					//Sleeping bodies this close still count as resting on each other
+constexpr uint	DEFAULT_MAX_SUBSTEPS = 8U;
+constexpr uint	PHYSICS_POOL_BLOCKS_PER_CHUNK = 128U;
 
 //------------------------------------------------------------------------------------------------------------------------------
 class RenderContext;
+class AABB2Collider;
+class BoxCollider2D;
+class CapsuleCollider2D;
 class Collider2D;
+class Disc2DCollider;
+class PhysicsSnapshot2D;
 class RigidBodyBucket;
 class Trigger2D;
 class TriggerBucket;
-struct Collision2D;
+class WorkerPool;
 
 //------------------------------------------------------------------------------------------------------------------------------
 class PhysicsSystem
@@ -17,16 +40,49 @@ class PhysicsSystem
 	friend class Rigidbody2D;
 
 public:
-	PhysicsSystem();
+	// cellSize is only used by BROADPHASE_SPATIAL_HASH
+	explicit PhysicsSystem(eBroadphaseType broadphaseType = BROADPHASE_AABB_TREE, float cellSize = DEFAULT_SPATIAL_HASH_CELL_SIZE);
 	~PhysicsSystem();
 
+	// Bodies, triggers and colliders are allocated from pools owned by the system, never delete them yourself.
+	// Destroying a body or trigger only queues it, it is released at the start of the next step so pointers to it stay
+	// valid for the rest of the frame. Anything still alive is released with the system
 	Rigidbody2D*			CreateRigidbody(eSimulationType simulationType);
 	Trigger2D*				CreateTrigger(eSimulationType simulationType);
+	AABB2Collider*			CreateAABB2Collider(const Vec2& minBounds, const Vec2& maxBounds);
+	Disc2DCollider*			CreateDiscCollider(const Vec2& centre, float radius);
+	BoxCollider2D*			CreateBoxCollider(const Vec2& center, const Vec2& size = Vec2::ZERO, float rotationDegrees = 0.f);
+	CapsuleCollider2D*		CreateCapsuleCollider(const Vec2& start, const Vec2& end, float radius);
 	void					AddRigidbodyToVector( Rigidbody2D* rigidbody );
 	void					AddTriggerToVector(Trigger2D* trigger);
 	void					DestroyRigidbody( Rigidbody2D* rigidbody );
+	void					DestroyTrigger(Trigger2D* trigger);
+	// Colliders go with the body or trigger holding them, this is for one that was never attached. Frees immediately
+	void					DestroyCollider(Collider2D* collider);
 	void					SetGravity(const Vec2& gravity);
 
+	// Spreads the batched narrowphase of each pass across that many threads. 0 runs it inline on the calling thread,
+	// results are the same for every count
+	void					SetNarrowphaseThreadCount(uint threadCount);
+
+	// Replaces the per pair push and impulse passes with the iterative solver, contacts then persist between steps
+	void					EnableContactSolver(const ContactSolverSettings_T& settings = ContactSolverSettings_T());
+	void					DisableContactSolver();
+
+	// Listeners get every contact of a step in one call once the step is done, after the colliders' collision events
+	void					AddContactListener(ContactEventCallbackFn callback, void* userData = nullptr);
+	void					RemoveContactListener(ContactEventCallbackFn callback, void* userData = nullptr);
+	const ContactEventList&	GetContactEvents() const			{ return m_contactEvents; }
+
+	// Islands of touching dynamic bodies that stay under the sleep tolerances for m_timeToSleep seconds go to sleep
+	void					SetSleepingEnabled(bool isEnabled);
+
+	// A step above 0 makes Update advance the simulation in fixed steps of that size and blend the objects between the
+	// last two steps. At most maxSubsteps run per Update, time past that is dropped so a slow frame can't snowball.
+	// 0 goes back to one step per Update with the frame's delta
+	void					SetFixedTimeStep(float fixedTimeStep, uint maxSubsteps = DEFAULT_MAX_SUBSTEPS);
+	float					GetInterpolationAlpha() const		{ return m_interpolationAlpha; }
+
 	void					CopyTransformsFromObjects();
 	void					CopyTransformsToObjects();
 	void					Update(float deltaTime);
@@ -34,8 +90,30 @@ public:
 	void					UpdateAllCollisions();
 	void					UpdateTriggers();
 
+	// Queues every body marked dead (Rigidbody2D::Destroy, leaving a trigger) and releases the queue right away
 	void					PurgeDeletedObjects();
 
+	// Scene queries, they go through the broadphase and test the colliders of live bodies where they are now. Triggers are
+	// never reported. The broadphase only learns about new or moved bodies during a step, so a body created since the last
+	// step isn't found yet. Directions must be normalized
+	bool					Raycast(RaycastHit2D_T* outHit, const Vec2& start, const Vec2& direction, float maxDistance, uint layerMask = ALL_PHYSICS_LAYERS) const;
+	// Every hit along the ray, nearest first. Returns how many were found
+	uint					RaycastAll(RaycastHitList& outHits, const Vec2& start, const Vec2& direction, float maxDistance, uint layerMask = ALL_PHYSICS_LAYERS) const;
+	uint					OverlapAABB(std::vector<Collider2D*>& outColliders, const AABB2& box, uint layerMask = ALL_PHYSICS_LAYERS) const;
+	uint					OverlapDisc(std::vector<Collider2D*>& outColliders, const Vec2& centre, float radius, uint layerMask = ALL_PHYSICS_LAYERS) const;
+	// Sweeps a disc of castRadius from start, the hit point is where the disc first touches
+	bool					ShapeCast(RaycastHit2D_T* outHit, const Vec2& start, float castRadius, const Vec2& direction, float maxDistance, uint layerMask = ALL_PHYSICS_LAYERS) const;
+	// outHits[i] answers queries[i], with a nullptr collider for a miss. The queries are split across the narrowphase
+	// pool when SetNarrowphaseThreadCount made one, so this can't be called while a step is running
+	void					RaycastBatch(const std::vector<RaycastQuery2D_T>& queries, RaycastHitList& outHits);
+
+	// Rollback and replays. A snapshot holds the simulation state of every live body (transform, velocities, forces, sleep
+	// state and the fixed step blend) and the contact solver's warm start, call these between Updates. Restoring needs the
+	// same bodies alive as when it was saved and returns false, changing nothing, if they aren't. Trigger touches and
+	// contact events are left as they are
+	void					SaveSnapshot(PhysicsSnapshot2D& outSnapshot) const;
+	bool					RestoreSnapshot(const PhysicsSnapshot2D& snapshot);
+
 	void					DebugRender( RenderContext* renderContext ) const;
 	void					DebugRenderRigidBodies( RenderContext* renderContext ) const;
 	void					DebugRenderTriggers( RenderContext* renderContext ) const;
@@ -45,12 +123,58 @@ public:
 private:
 
 	void					RunStep(float deltaTime);
+	void					StorePreviousTransforms();
+
+	//Takes the queued bodies and triggers out of the buckets and hands them back to their pools
+	void					ProcessDestroyQueue();
 
 	void					MoveAllDynamicObjects(float deltaTime);
 	void					CheckStaticVsStaticCollisions();
 	void					ResolveDynamicVsStaticCollisions( bool canResolve );
 	void					ResolveDynamicVsDynamicCollisions( bool canResolve );
 
+	//Broadphase path, only candidate pairs reach the narrowphase
+	void					UpdateBroadphase();
+	void					UpdateCandidatePairCollisions();
+
+	//Narrowphase and response for a single pair, shared by the brute force and broadphase paths
+	void					CheckStaticVsStaticPair( Rigidbody2D* rb0, Rigidbody2D* rb1 );
+	void					ResolveDynamicVsStaticPair( Rigidbody2D* dynamicBody, Rigidbody2D* staticBody, bool canResolve );
+	void					ResolveDynamicVsDynamicPair( Rigidbody2D* rb0, Rigidbody2D* rb1, bool canResolve );
+
+	//Response for a pair whose contact is already known
+	void					ApplyStaticVsStaticContact( Rigidbody2D* rb0, Rigidbody2D* rb1, const Collision2D& collision );
+	void					ResolveDynamicVsStaticContact( Rigidbody2D* dynamicBody, Rigidbody2D* staticBody, const Collision2D& collision, bool canResolve );
+	void					ResolveDynamicVsDynamicContact( Rigidbody2D* rb0, Rigidbody2D* rb1, const Collision2D& collision, bool canResolve );
+
+	//Contact solver path, every contact is gathered first and then solved together
+	void					UpdateSolverContacts( float deltaTime );
+	void					GetAllPairs( BroadphasePairList& outPairs );
+
+	//Splits m_candidatePairs into the static, dynamic vs static, dynamic vs dynamic and trigger lists
+	void					SplitCandidatePairs();
+	//Brute force trigger pairs for when there is no broadphase, every trigger against every dynamic body
+	void					GetAllTriggerPairs( BroadphasePairList& outPairs );
+	//Tests the pairs (on the narrowphase pool if there is one) and leaves the touching ones in m_contacts sorted by body ids.
+	//Pairs the batch supports go through its SIMD kernels, the rest one at a time
+	void					GenerateContacts( const BroadphasePairList& pairs );
+
+	//Contact events, recorded during the step and handed out after it
+	void					RecordContactEvent( Rigidbody2D* rb0, Rigidbody2D* rb1, const Collision2D& collision, float normalImpulse );
+	void					DispatchContactEvents();
+
+	//Scene queries. Candidates come from the broadphase, or every body when brute forcing
+	bool					IsQueryCandidate( const Collider2D* collider, uint layerMask ) const;
+	void					GetQueryCandidates( std::vector<Collider2D*>& outColliders, const AABB2& bounds ) const;
+	void					GetRayCandidates( std::vector<Collider2D*>& outColliders, const Vec2& start, const Vec2& end ) const;
+	bool					CastAgainstCandidates( RaycastHit2D_T* outHit, const std::vector<Collider2D*>& candidates, const Vec2& start, const Vec2& direction, float maxDistance, float castRadius, uint layerMask ) const;
+
+	//Union-find over this step's touching dynamic pairs and the sleeping pairs still resting on each other, then sleeps or wakes each island as a whole
+	void					UpdateIslands( float deltaTime );
+	bool					AreIslandNeighbours( const Collider2D* colliderA, const Collider2D* colliderB ) const;
+	//Wakes the sleeping bodies resting on anything in the destroy queue, before it is freed
+	void					WakeQueuedBodyNeighbours();
+
 	//Utilities
 	float					GetImpulseAlongNormal( Vec2* out, const Collision2D& collision, const Rigidbody2D& rb0, const Rigidbody2D& rb1 );
 
@@ -61,6 +185,63 @@ public:
 	TriggerBucket*					m_triggerBucket;
 	uint							m_frameCount = 0U;
 
+	eBroadphaseType					m_broadphaseType = BROADPHASE_AABB_TREE;
+	Broadphase2D*					m_broadphase = nullptr;			//nullptr when brute forcing
+	BroadphasePairList				m_candidatePairs;
+
+	RigidbodyStore2D				m_bodyStore;					//State of every body, the awake dynamic ones packed first for integration
+	uint							m_nextBodyId = 0U;
+
+	//Candidate pairs split by pass, mixed pairs have the dynamic collider first
+	BroadphasePairList				m_staticPairs;
+	BroadphasePairList				m_dynamicStaticPairs;
+	BroadphasePairList				m_dynamicPairs;
+	BroadphasePairList				m_triggerPairs;					//Trigger collider first, other side is always a dynamic body
+
+	TriggerTouchSet2D				m_triggerTouches;
+	std::vector<TriggerTouch2D>		m_triggerExits;
+
+	WorkerPool*						m_narrowphasePool = nullptr;	//nullptr runs the batched narrowphase inline
+	std::vector<NarrowphaseContactList>	m_workerContacts;			//One buffer per worker, merged into m_contacts
+	NarrowphaseContactList			m_contacts;
+	NarrowphaseBatch2D				m_narrowphaseBatch;				//Disc vs disc and disc vs AABB2 pairs, tested 4 at a time
+	BroadphasePairList				m_unbatchedPairs;				//Everything else, through GetCollisionInfo
+
+	ContactSolver2D*				m_contactSolver = nullptr;		//nullptr keeps the per pair resolve passes
+
+	ContactEventList				m_contactEvents;				//This step's contacts, kept until the next step starts
+	std::vector<ContactListener_T>	m_contactListeners;
+
+	//Sleeping
+	bool							m_isSleepingEnabled = false;
+	float							m_linearSleepTolerance = DEFAULT_LINEAR_SLEEP_TOLERANCE;
+	float							m_angularSleepTolerance = DEFAULT_ANGULAR_SLEEP_TOLERANCE;
+	float							m_timeToSleep = DEFAULT_TIME_TO_SLEEP;
+	BroadphasePairList				m_touchingDynamicPairs;			//Dynamic pairs that touched this step, they link islands
+	BroadphasePairList				m_sleepingDynamicPairs;			//Sleeping pairs skipped by the narrowphase, they keep sleeping islands linked
+	std::vector<Collider2D*>		m_wakeCandidates;
+	std::vector<uint>				m_islandParents;				//Indexed by Rigidbody2D::m_islandIndex
+	std::vector<float>				m_islandSleepTimes;
+
+	//Fixed step
+	float							m_fixedTimeStep = 0.f;			//0 steps once per Update with the frame delta
+	uint							m_maxSubsteps = DEFAULT_MAX_SUBSTEPS;
+	float							m_timeAccumulator = 0.f;		//Frame time not simulated yet, always under one step
+	float							m_interpolationAlpha = 1.f;		//How far the objects are between the last two steps
+
+
+	//Pools, everything the Create functions hand out lives in these
+	ObjectAllocator<Rigidbody2D>		m_rigidbodyPool;
+	ObjectAllocator<Trigger2D>			m_triggerPool;
+	ObjectAllocator<AABB2Collider>		m_aabb2ColliderPool;
+	ObjectAllocator<Disc2DCollider>		m_discColliderPool;
+	ObjectAllocator<BoxCollider2D>		m_boxColliderPool;
+	ObjectAllocator<CapsuleCollider2D>	m_capsuleColliderPool;
+
+	std::vector<Rigidbody2D*>		m_rigidbodyDestroyQueue;
+	std::vector<Trigger2D*>			m_triggerDestroyQueue;
+	std::vector<Rigidbody2D*>		m_unaddedRigidbodies;			//Created but not in a bucket, so the destructor still finds them
+	std::vector<Trigger2D*>			m_unaddedTriggers;
 
 	//system info like gravity
 	Vec2							m_gravity = Vec2(0.0f, -9.8f);
@@ -0,0 +1,54 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Math/PhysicsTestHelpers2D.hpp"
+#include "Engine/Math/PhysicsSystem.hpp"
+#include "Engine/Math/Rigidbody2D.hpp"
+
+//------------------------------------------------------------------------------------------------------------------------------
+static Collider2D* CreateTestShape(PhysicsSystem& system, eColliderType2D type, const Vec2& size, float rotationDegrees)
+{
+	switch (type)
+	{
+	case COLLIDER_DISC:
+		return system.CreateDiscCollider(Vec2::ZERO, size.x * 0.5f);
+	case COLLIDER_CAPSULE:
+		return system.CreateCapsuleCollider(Vec2(0.f, size.y * -0.5f), Vec2(0.f, size.y * 0.5f), size.x * 0.25f);
+	case COLLIDER_BOX:
+		return system.CreateBoxCollider(Vec2::ZERO, size, rotationDegrees);
+	case COLLIDER_AABB2:
+	default:
+		return system.CreateAABB2Collider(size * -0.5f, size * 0.5f);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+Collider2D* MakeTestCollider(PhysicsSystem& system, eColliderType2D type, const Vec2& position, const Vec2& size /*= Vec2(1.f, 1.f)*/, float rotationDegrees /*= 0.f*/)
+{
+	Collider2D* collider = CreateTestShape(system, type, size, rotationDegrees);
+
+	Rigidbody2D* rigidbody = system.CreateRigidbody(STATIC_SIMULATION);
+	rigidbody->SetPosition(position);
+	rigidbody->SetCollider(collider);
+	collider->m_rigidbody = rigidbody;
+	return collider;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+Rigidbody2D* AddTestBody(PhysicsSystem& system, eSimulationType simulationType, eColliderType2D type, Transform2* transform, const Vec2& size /*= Vec2(1.f, 1.f)*/)
+{
+	Collider2D* collider = CreateTestShape(system, type, size, 0.f);
+
+	Rigidbody2D* rigidbody = system.CreateRigidbody(simulationType);
+	rigidbody->SetCollider(collider);
+	collider->m_rigidbody = rigidbody;
+
+	if (simulationType == DYNAMIC_SIMULATION)
+	{
+		rigidbody->SetConstraints(true, true, true);
+		rigidbody->SetMomentOfInertia(0.1f);
+		rigidbody->m_material.restitution = 0.f;
+	}
+
+	rigidbody->SetObject(nullptr, transform);
+	system.AddRigidbodyToVector(rigidbody);
+	return rigidbody;
+}
@@ -0,0 +1,24 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+#include "Engine/Math/Collider2D.hpp"
+#include "Engine/Math/PhysicsTypes.hpp"
+#include "Engine/Math/Vec2.hpp"
+
+//------------------------------------------------------------------------------------------------------------------------------
+class PhysicsSystem;
+class Rigidbody2D;
+struct Transform2;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Fixtures shared by the physics unit tests and the "PhysicsBenchmark" category. Timing belongs in the benchmark category
+// so the "Physics" tests stay quiet and don't depend on the machine they run on
+//------------------------------------------------------------------------------------------------------------------------------
+
+// A static body at position holding a collider centred on it, for tests that call the narrowphase directly. size is the
+// box size, a disc's diameter in x, or a capsule's segment length in y with a radius of a quarter of x. rotationDegrees
+// only applies to boxes. The body is never added, the system frees it with everything else or on DestroyRigidbody
+Collider2D*		MakeTestCollider(PhysicsSystem& system, eColliderType2D type, const Vec2& position, const Vec2& size = Vec2(1.f, 1.f), float rotationDegrees = 0.f);
+
+// A body simulated by the system with the transform standing in for its game object, so it has to stay put in memory.
+// Dynamic bodies get no restitution and a fixed moment of inertia so stacks can come to rest
+Rigidbody2D*	AddTestBody(PhysicsSystem& system, eSimulationType simulationType, eColliderType2D type, Transform2* transform, const Vec2& size = Vec2(1.f, 1.f));
@@ -10,3 +10,14 @@ enum eSimulationType
 
 	NUM_SIMULATION_TYPES
 };
+
+//------------------------------------------------------------------------------------------------------------------------------
+enum eBroadphaseType
+{
+	BROADPHASE_BRUTE_FORCE,			//Every pair of bodies goes to the narrowphase
+	BROADPHASE_AABB_TREE,
+	BROADPHASE_SPATIAL_HASH,		//Best when bodies are all about the same size, see SpatialHashBroadphase
+	BROADPHASE_SWEEP_AND_PRUNE,		//Best when most bodies barely move between steps, pairs come out in a stable order
+
+	NUM_BROADPHASE_TYPES
+};
@@ -8,39 +8,31 @@
 #include "Engine/Math/Vertex_PCU.hpp"
 #include "Engine/Renderer/RenderContext.hpp"
 
-//------------------------------------------------------------------------------------------------------------------------------
-Rigidbody2D::Rigidbody2D(float mass)
-{
-	m_mass = mass;
-}
-
 //------------------------------------------------------------------------------------------------------------------------------
 Rigidbody2D::Rigidbody2D( PhysicsSystem* physicsSystem, eSimulationType simulationType, float mass /*= 1.0f*/ )
 {
 	m_system = physicsSystem;
 	m_simulationType = simulationType;
-	m_mass = mass;
+	m_bodyId = physicsSystem->m_nextBodyId++;
+
+	//Stored from the start but only integrated once the system adds it as dynamic
+	physicsSystem->m_bodyStore.AddBody(this, mass);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
 Rigidbody2D::~Rigidbody2D()
 {
-	for(int rbType = 0; rbType < NUM_SIMULATION_TYPES; rbType++)
-	{
-		int rbCount = static_cast<int>(m_system->m_rbBucket->m_RbBucket[rbType].size());
+	//The system's destroy queue has already taken us out of the buckets and the trigger touches
+	m_system->m_bodyStore.RemoveBody(this);
 
-		for(int rbIndex = 0; rbIndex < rbCount; rbIndex++)
+	if (m_collider != nullptr)
+	{
+		if (m_collider->m_broadphaseProxy != INVALID_BROADPHASE_PROXY && m_system->m_broadphase != nullptr)
 		{
-			if(m_system->m_rbBucket->m_RbBucket[rbType][rbIndex] == this)
-			{
-				m_system->m_rbBucket->m_RbBucket[rbType][rbIndex] = nullptr;
-			}
+			m_system->m_broadphase->DestroyProxy(m_collider->m_broadphaseProxy);
 		}
-	}
 
-	if (m_collider != nullptr)
-	{
-		delete m_collider;
+		m_system->DestroyCollider(m_collider);
 		m_collider = nullptr;
 	}
 
@@ -56,43 +48,11 @@ void Rigidbody2D::Move( float deltaTime )
 		return;
 	}
 
-	//Calc Acceleration due to gravity
-	Vec2 gravity = m_system->GetGravity();
-	Vec2 acc =  gravity * m_gravity_scale;
-
-	//Apply the acceleration due to gravity
-	m_velocity += acc * deltaTime;
-
-	//Calc linear forces added
-	acc = m_frameForces / m_mass;
-	m_velocity += acc * deltaTime;
-
-	m_velocity *= (1.0f - (GetLinearDrag() * deltaTime));
-
-	//Set new position based on new velocities
-	m_transform.m_position += m_velocity * deltaTime * Vec2(m_constraints.x, m_constraints.y);
-
-	//Angular velocity steps
-	float angularAcc = m_frameTorque / m_momentOfInertia;
-	m_angularVelocity += angularAcc * deltaTime;
-	m_angularVelocity *= (1.f - (GetAngularDrag() * deltaTime));
-	m_rotation += m_angularVelocity * deltaTime * m_constraints.z;
-
+	//Same math the store runs for every awake body, just for this slot
+	m_store->IntegrateRange(m_storeIndex, m_storeIndex + 1U, deltaTime, m_system->GetGravity());
 	ApplyRotation();
 }
 
-//------------------------------------------------------------------------------------------------------------------------------
-float Rigidbody2D::GetLinearDrag()
-{
-	return m_linearDrag;
-}
-
-//------------------------------------------------------------------------------------------------------------------------------
-float Rigidbody2D::GetAngularDrag()
-{
-	return m_angularDrag;
-}
-
 //------------------------------------------------------------------------------------------------------------------------------
 void Rigidbody2D::ApplyRotation()
 {
@@ -101,13 +61,13 @@ void Rigidbody2D::ApplyRotation()
 	case COLLIDER_BOX:
 	{
 		BoxCollider2D* collider = reinterpret_cast<BoxCollider2D*>(m_collider);
-		collider->m_localShape.SetRotation(m_rotation * m_constraints.z);
+		collider->m_localShape.SetRotation(GetRotation() * GetConstraints().z);
 	}
 	break;
 	case COLLIDER_CAPSULE:
 	{
 		CapsuleCollider2D* collider = reinterpret_cast<CapsuleCollider2D*>(m_collider);
-		collider->m_localShape.SetRotation(m_rotation * m_constraints.z);
+		collider->m_localShape.SetRotation(GetRotation() * GetConstraints().z);
 	}
 	break;
 	}
@@ -155,7 +115,7 @@ void Rigidbody2D::DebugRender( RenderContext* renderContext, const Rgba& color )
 		CapsuleCollider2D* collider = reinterpret_cast<CapsuleCollider2D*>(m_collider);
 
 		AddVertsForWireCapsule2D(verts, collider->GetWorldShape(), collider->GetCapsuleRadius(), color, 0.5f);
-		AddVertsForLine2D(verts, collider->GetWorldShape().m_center, collider->GetWorldShape().m_center + collider->GetCapsuleRadius() * Vec2(0.f, 1.f).GetRotatedDegrees(m_rotation), 0.2f, Rgba::WHITE);
+		AddVertsForLine2D(verts, collider->GetWorldShape().m_center, collider->GetWorldShape().m_center + collider->GetCapsuleRadius() * Vec2(0.f, 1.f).GetRotatedDegrees(GetRotation()), 0.2f, Rgba::WHITE);
 		break;
 	}
 	case NUM_COLLIDER_TYPES:
@@ -171,6 +131,12 @@ void Rigidbody2D::DebugRender( RenderContext* renderContext, const Rgba& color )
 void Rigidbody2D::SetSimulationMode( eSimulationType simulationType )
 {
 	m_simulationType = simulationType;
+
+	//Only dynamic bodies integrate
+	if (simulationType != DYNAMIC_SIMULATION)
+	{
+		m_store->SetBodyIntegrated(this, false);
+	}
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
@@ -185,20 +151,64 @@ void Rigidbody2D::SetObject( void* object, Transform2* objectTransform )
 {
 	m_object = object;
 	m_object_transform = objectTransform;
+
+	if (m_object_transform != nullptr)
+	{
+		m_previousPosition = m_object_transform->m_position;
+		m_renderPosition = m_object_transform->m_position;
+	}
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
 void Rigidbody2D::SetConstraints(const Vec3& constraints)
 {
-	m_constraints = constraints;
+	m_store->SetConstraints(m_storeIndex, constraints);
+	WakeUp();
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
 void Rigidbody2D::SetConstraints(bool x, bool y, bool rotation)
 {
-	(x) ? m_constraints.x = 1.f : m_constraints.x = 0.f;
-	(y) ? m_constraints.y = 1.f : m_constraints.y = 0.f;
-	(rotation) ? m_constraints.z = 1.f : m_constraints.z = 0.f;
+	Vec3 constraints;
+	(x) ? constraints.x = 1.f : constraints.x = 0.f;
+	(y) ? constraints.y = 1.f : constraints.y = 0.f;
+	(rotation) ? constraints.z = 1.f : constraints.z = 0.f;
+	SetConstraints(constraints);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void Rigidbody2D::WakeUp()
+{
+	if (m_isAwake)
+	{
+		return;
+	}
+
+	m_isAwake = true;
+	m_sleepTime = 0.f;
+	if (m_system != nullptr && m_simulationType == DYNAMIC_SIMULATION)
+	{
+		m_system->m_bodyStore.SetBodyIntegrated(this, true);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void Rigidbody2D::PutToSleep()
+{
+	if (!m_isAwake)
+	{
+		return;
+	}
+
+	m_isAwake = false;
+	SetVelocity(Vec2::ZERO);
+	SetAngularVelocity(0.f);
+	m_sleepPosition = GetPosition();
+
+	if (m_system != nullptr)
+	{
+		m_system->m_bodyStore.SetBodyIntegrated(this, false);
+	}
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
@@ -209,9 +219,9 @@ void Rigidbody2D::Destroy()
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
-Vec2 Rigidbody2D::GetPosition() const
+Transform2 Rigidbody2D::GetTransform() const
 {
-	return m_transform.m_position;
+	return Transform2(GetPosition(), GetRotation(), m_scale);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
@@ -223,10 +233,13 @@ eSimulationType Rigidbody2D::GetSimulationType()
 //------------------------------------------------------------------------------------------------------------------------------
 void Rigidbody2D::ApplyImpulses( Vec2 linearImpulse, float angularImpulse )
 {
-	m_velocity += linearImpulse / m_mass;
-	m_velocity = m_velocity * Vec2(m_constraints.x, m_constraints.y);
-	m_angularVelocity += RadiansToDegrees(angularImpulse / m_momentOfInertia); 
-	m_angularVelocity *= m_constraints.z;
+	WakeUp();
+
+	Vec3 constraints = GetConstraints();
+	Vec2 velocity = GetVelocity() + linearImpulse / GetMass();
+	SetVelocity(velocity * Vec2(constraints.x, constraints.y));
+	float angularVelocity = GetAngularVelocity() + RadiansToDegrees(angularImpulse / GetMomentOfInertia()); 
+	SetAngularVelocity(angularVelocity * constraints.z);
 }
 
 //------------------------------------------------------------------------------------------------------------------------------
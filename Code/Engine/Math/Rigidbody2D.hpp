@@ -3,6 +3,7 @@
 //Engine Systems
 #include "Engine/Commons/EngineCommon.hpp"
 #include "Engine/Math/PhysicsTypes.hpp"
+#include "Engine/Math/RigidbodyStore2D.hpp"
 #include "Engine/Math/Transform2.hpp"
 #include "Engine/Math/Vec3.hpp"
 
@@ -16,11 +17,13 @@ struct PhysicsMaterialT
 	float restitution = 1.f;
 };
 
+//------------------------------------------------------------------------------------------------------------------------------
+// Handle to a body in its PhysicsSystem's RigidbodyStore2D. Position, velocity, mass and the rest of the integration
+// state live in the store, the accessors below read and write the body's slot
 //------------------------------------------------------------------------------------------------------------------------------
 class Rigidbody2D
 {
 public:
-	Rigidbody2D( float mass = 1.0f);
 	explicit Rigidbody2D(PhysicsSystem* physicsSystem, eSimulationType simulationType, float mass = 1.0f);
 	~Rigidbody2D();
 
@@ -28,15 +31,22 @@ public:
 	void									Move(float deltaTime);
 	void									ApplyRotation();
 	//Apply specific movement
-	inline void								MoveBy(Vec2 movement) { m_transform.m_position += movement * Vec2(m_constraints.x, m_constraints.y);}
+	inline void								MoveBy(Vec2 movement) { Vec3 constraints = GetConstraints(); SetPosition(GetPosition() + movement * Vec2(constraints.x, constraints.y)); WakeUp(); }
 	
 	//Impulses
 	void									ApplyImpulses(Vec2 linearImpulse, float angularImpulse);
 	void									ApplyImpulseAt(Vec2 linearImpulse, Vec2 pointOfContact);
 	
 	//Forces and Torques
-	inline void								AddForce(Vec2 force) { m_frameForces += force; }
-	inline void								AddTorque(float torque) { m_frameTorque += torque; }
+	inline void								AddForce(Vec2 force) { SetFrameForces(GetFrameForces() + force); m_sleepTime = 0.f; WakeUp(); }
+	inline void								AddTorque(float torque) { SetFrameTorque(GetFrameTorque() + torque); m_sleepTime = 0.f; WakeUp(); }
+
+	//Sleeping, asleep bodies are skipped by integration, the broadphase and the narrowphase until something wakes them.
+	//The Set accessors don't wake a body, use the functions above or call WakeUp.
+	//Forces also restart the sleep timer, impulses only wake so contact impulses don't keep resting bodies up
+	void									WakeUp();
+	void									PutToSleep();
+	inline bool								IsAwake() const { return m_isAwake; }
 
 	//Render
 	void									DebugRender(RenderContext* renderContext, const Rgba& color) const;
@@ -49,11 +59,33 @@ public:
 	void									SetConstraints(bool x, bool y, bool rotation);
 	void									Destroy();
 
-	//Accessors
-	Vec2									GetPosition() const;
+	//Accessors, all of these go to the body's slot in the store
+	inline Vec2								GetPosition() const							{ return m_store->GetPosition(m_storeIndex); }
+	inline void								SetPosition(const Vec2& position)			{ m_store->SetPosition(m_storeIndex, position); }
+	inline float							GetRotation() const							{ return m_store->GetRotation(m_storeIndex); }
+	inline void								SetRotation(float rotation)					{ m_store->SetRotation(m_storeIndex, rotation); }
+	inline Vec2								GetVelocity() const							{ return m_store->GetVelocity(m_storeIndex); }
+	inline void								SetVelocity(const Vec2& velocity)			{ m_store->SetVelocity(m_storeIndex, velocity); }
+	inline float							GetAngularVelocity() const					{ return m_store->GetAngularVelocity(m_storeIndex); }
+	inline void								SetAngularVelocity(float angularVelocity)	{ m_store->SetAngularVelocity(m_storeIndex, angularVelocity); }
+	inline Vec2								GetFrameForces() const						{ return m_store->GetForce(m_storeIndex); }
+	inline void								SetFrameForces(const Vec2& forces)			{ m_store->SetForce(m_storeIndex, forces); }
+	inline float							GetFrameTorque() const						{ return m_store->GetTorque(m_storeIndex); }
+	inline void								SetFrameTorque(float torque)				{ m_store->SetTorque(m_storeIndex, torque); }
+	inline float							GetMass() const								{ return m_store->GetMass(m_storeIndex); }
+	inline void								SetMass(float mass)							{ m_store->SetMass(m_storeIndex, mass); }
+	inline float							GetMomentOfInertia() const					{ return m_store->GetMomentOfInertia(m_storeIndex); }
+	inline void								SetMomentOfInertia(float momentOfInertia)	{ m_store->SetMomentOfInertia(m_storeIndex, momentOfInertia); }
+	inline Vec2								GetGravityScale() const						{ return m_store->GetGravityScale(m_storeIndex); }
+	inline void								SetGravityScale(const Vec2& scale)			{ m_store->SetGravityScale(m_storeIndex, scale); }
+	inline Vec3								GetConstraints() const						{ return m_store->GetConstraints(m_storeIndex); }
+	inline float							GetLinearDrag() const						{ return m_store->GetLinearDrag(m_storeIndex); }
+	inline void								SetLinearDrag(float drag)					{ m_store->SetLinearDrag(m_storeIndex, drag); }
+	inline float							GetAngularDrag() const						{ return m_store->GetAngularDrag(m_storeIndex); }
+	inline void								SetAngularDrag(float drag)					{ m_store->SetAngularDrag(m_storeIndex, drag); }
+
+	Transform2								GetTransform() const;
 	eSimulationType							GetSimulationType();
-	float									GetLinearDrag();
-	float									GetAngularDrag();
 
 
 public:
@@ -61,29 +93,31 @@ public:
 	void*									m_object = nullptr; 			// user (game) pointer for external use
 	Transform2*								m_object_transform = nullptr;	// what does this rigidbody affect
 
-	Transform2								m_transform;					// rigidbody transform (mimics the object at start of frame, and used to tell the change to object at end of frame)
-	Vec2									m_gravity_scale = Vec2::ONE;	// how much are we affected by gravity
-	Vec2									m_velocity = Vec2::ZERO; 
-	float 									m_angularVelocity = 0.f;
-	float									m_mass;  						// how heavy am I
+	Vec2									m_scale = Vec2::ONE;			// the object's scale, handed back with the position and rotation from the store
 
 	Collider2D*								m_collider = nullptr;			// my shape; (could eventually be made a set)
 	bool									m_isTrigger = false;
 	PhysicsMaterialT						m_material;
 
-	float									m_momentOfInertia = 0.f;
-	float									m_rotation = 0.f;
-
-	Vec2									m_frameForces = Vec2::ZERO;
-	float									m_frameTorque = 0.f;
-
 	float									m_friction = 1.f;				// Friction along the surface
 
-	float									m_linearDrag = 0.1f;
-	float									m_angularDrag = 0.1f;
-
-	Vec3									m_constraints = Vec3(0.f, 1.f, 0.f);		//x,z = movement constraint on x,z axis, z = rotation constraint
 	bool									m_isAlive = true;
+	bool									m_isQueuedForDestroy = false;	// waiting in the system's destroy queue
+
+	RigidbodyStore2D*						m_store = nullptr;				// the system's store, owns the state behind the accessors
+	uint									m_storeIndex = INVALID_BODY_STORE_INDEX;	// slot in m_store, moves when other bodies come and go
+	uint									m_bodyId = 0U;					// unique per system, orders contacts in the batched narrowphase
+
+	bool									m_isAwake = true;
+	float									m_sleepTime = 0.f;				// how long we have been slow enough to sleep
+	Vec2									m_sleepPosition = Vec2::ZERO;	// where we fell asleep, moving the body from outside wakes it
+	uint									m_islandIndex = 0U;				// scratch index for the island pass
+
+	//Fixed step mode, the object is drawn between the last two steps
+	Vec2									m_previousPosition = Vec2::ZERO;	// state before the last fixed step
+	float									m_previousRotation = 0.f;
+	Vec2									m_renderPosition = Vec2::ZERO;		// last position written to the object
+	float									m_renderRotation = 0.f;				// rotation blended the same way, for drawing
 
 private:
 	eSimulationType							m_simulationType = TYPE_UNKOWN;
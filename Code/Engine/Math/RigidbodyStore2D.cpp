@@ -0,0 +1,387 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Math/RigidbodyStore2D.hpp"
+#include "Engine/Commons/UnitTest.hpp"
+#include "Engine/Math/PhysicsSystem.hpp"
+#include "Engine/Math/PhysicsTestHelpers2D.hpp"
+#include "Engine/Math/Rigidbody2D.hpp"
+#include <xmmintrin.h>
+
+//------------------------------------------------------------------------------------------------------------------------------
+RigidbodyStore2D::RigidbodyStore2D()
+{
+
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+RigidbodyStore2D::~RigidbodyStore2D()
+{
+	//Bodies can outlive the store, don't leave them pointing at a slot
+	for (Rigidbody2D* body : m_bodies)
+	{
+		body->m_store = nullptr;
+		body->m_storeIndex = INVALID_BODY_STORE_INDEX;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RigidbodyStore2D::AddBody(Rigidbody2D* body, float mass)
+{
+	if (body->m_storeIndex != INVALID_BODY_STORE_INDEX)
+	{
+		return;
+	}
+
+	body->m_store = this;
+	body->m_storeIndex = (uint)m_bodies.size();
+	m_bodies.push_back(body);
+
+	//Same defaults Rigidbody2D had when it owned these
+	m_positionX.push_back(0.f);
+	m_positionY.push_back(0.f);
+	m_velocityX.push_back(0.f);
+	m_velocityY.push_back(0.f);
+	m_forceX.push_back(0.f);
+	m_forceY.push_back(0.f);
+	m_mass.push_back(mass);
+	m_linearDrag.push_back(0.1f);
+	m_gravityScaleX.push_back(1.f);
+	m_gravityScaleY.push_back(1.f);
+	m_constraintX.push_back(0.f);
+	m_constraintY.push_back(1.f);
+
+	m_rotation.push_back(0.f);
+	m_angularVelocity.push_back(0.f);
+	m_torque.push_back(0.f);
+	m_momentOfInertia.push_back(0.f);
+	m_angularDrag.push_back(0.1f);
+	m_constraintRotation.push_back(0.f);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RigidbodyStore2D::RemoveBody(Rigidbody2D* body)
+{
+	if (body->m_storeIndex == INVALID_BODY_STORE_INDEX)
+	{
+		return;
+	}
+
+	//Out of the integrated range first so the last slot can fill the hole without breaking the packing
+	SetBodyIntegrated(body, false);
+
+	uint slotIndex = body->m_storeIndex;
+	uint lastIndex = (uint)m_bodies.size() - 1U;
+	if (slotIndex != lastIndex)
+	{
+		MoveSlot(lastIndex, slotIndex);
+	}
+
+	m_bodies.pop_back();
+	m_positionX.pop_back();
+	m_positionY.pop_back();
+	m_velocityX.pop_back();
+	m_velocityY.pop_back();
+	m_forceX.pop_back();
+	m_forceY.pop_back();
+	m_mass.pop_back();
+	m_linearDrag.pop_back();
+	m_gravityScaleX.pop_back();
+	m_gravityScaleY.pop_back();
+	m_constraintX.pop_back();
+	m_constraintY.pop_back();
+
+	m_rotation.pop_back();
+	m_angularVelocity.pop_back();
+	m_torque.pop_back();
+	m_momentOfInertia.pop_back();
+	m_angularDrag.pop_back();
+	m_constraintRotation.pop_back();
+
+	body->m_store = nullptr;
+	body->m_storeIndex = INVALID_BODY_STORE_INDEX;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RigidbodyStore2D::SetBodyIntegrated(Rigidbody2D* body, bool isIntegrated)
+{
+	uint slotIndex = body->m_storeIndex;
+	if (slotIndex == INVALID_BODY_STORE_INDEX || isIntegrated == (slotIndex < m_integratedCount))
+	{
+		return;
+	}
+
+	if (isIntegrated)
+	{
+		SwapSlots(slotIndex, m_integratedCount);
+		m_integratedCount++;
+	}
+	else
+	{
+		m_integratedCount--;
+		SwapSlots(slotIndex, m_integratedCount);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool RigidbodyStore2D::IsBodyIntegrated(const Rigidbody2D* body) const
+{
+	return body->m_storeIndex < m_integratedCount;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RigidbodyStore2D::SwapSlots(uint slotA, uint slotB)
+{
+	if (slotA == slotB)
+	{
+		return;
+	}
+
+	std::swap(m_bodies[slotA], m_bodies[slotB]);
+	m_bodies[slotA]->m_storeIndex = slotA;
+	m_bodies[slotB]->m_storeIndex = slotB;
+
+	std::vector<float>* fieldArrays[] =
+	{
+		&m_positionX, &m_positionY, &m_velocityX, &m_velocityY, &m_forceX, &m_forceY, &m_mass, &m_linearDrag,
+		&m_gravityScaleX, &m_gravityScaleY, &m_constraintX, &m_constraintY,
+		&m_rotation, &m_angularVelocity, &m_torque, &m_momentOfInertia, &m_angularDrag, &m_constraintRotation
+	};
+
+	for (std::vector<float>* fieldArray : fieldArrays)
+	{
+		std::swap((*fieldArray)[slotA], (*fieldArray)[slotB]);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RigidbodyStore2D::MoveSlot(uint fromSlot, uint toSlot)
+{
+	m_bodies[toSlot] = m_bodies[fromSlot];
+	m_bodies[toSlot]->m_storeIndex = toSlot;
+
+	std::vector<float>* fieldArrays[] =
+	{
+		&m_positionX, &m_positionY, &m_velocityX, &m_velocityY, &m_forceX, &m_forceY, &m_mass, &m_linearDrag,
+		&m_gravityScaleX, &m_gravityScaleY, &m_constraintX, &m_constraintY,
+		&m_rotation, &m_angularVelocity, &m_torque, &m_momentOfInertia, &m_angularDrag, &m_constraintRotation
+	};
+
+	for (std::vector<float>* fieldArray : fieldArrays)
+	{
+		(*fieldArray)[toSlot] = (*fieldArray)[fromSlot];
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RigidbodyStore2D::Integrate(float deltaTime, const Vec2& gravity)
+{
+	//Same operations in the same order as IntegrateRange so every lane matches the scalar result bit for bit.
+	//Divides stay divides for the same reason, multiplying by a stored inverse would round differently
+	uint bodyCount = m_integratedCount;
+	uint bodyIndex = 0U;
+
+	float* positionX = m_positionX.data();
+	float* positionY = m_positionY.data();
+	float* velocityX = m_velocityX.data();
+	float* velocityY = m_velocityY.data();
+	float* rotation = m_rotation.data();
+	float* angularVelocity = m_angularVelocity.data();
+
+	const __m128 deltaTime4 = _mm_set1_ps(deltaTime);
+	const __m128 gravityX4 = _mm_set1_ps(gravity.x);
+	const __m128 gravityY4 = _mm_set1_ps(gravity.y);
+	const __m128 one4 = _mm_set1_ps(1.f);
+
+	for (; bodyIndex + 4U <= bodyCount; bodyIndex += 4U)
+	{
+		__m128 linearDamping = _mm_sub_ps(one4, _mm_mul_ps(_mm_loadu_ps(&m_linearDrag[bodyIndex]), deltaTime4));
+		__m128 mass = _mm_loadu_ps(&m_mass[bodyIndex]);
+
+		__m128 velX = _mm_loadu_ps(&velocityX[bodyIndex]);
+		velX = _mm_add_ps(velX, _mm_mul_ps(_mm_mul_ps(gravityX4, _mm_loadu_ps(&m_gravityScaleX[bodyIndex])), deltaTime4));
+		velX = _mm_add_ps(velX, _mm_mul_ps(_mm_div_ps(_mm_loadu_ps(&m_forceX[bodyIndex]), mass), deltaTime4));
+		velX = _mm_mul_ps(velX, linearDamping);
+		_mm_storeu_ps(&velocityX[bodyIndex], velX);
+		_mm_storeu_ps(&positionX[bodyIndex], _mm_add_ps(_mm_loadu_ps(&positionX[bodyIndex]), _mm_mul_ps(_mm_mul_ps(velX, deltaTime4), _mm_loadu_ps(&m_constraintX[bodyIndex]))));
+
+		__m128 velY = _mm_loadu_ps(&velocityY[bodyIndex]);
+		velY = _mm_add_ps(velY, _mm_mul_ps(_mm_mul_ps(gravityY4, _mm_loadu_ps(&m_gravityScaleY[bodyIndex])), deltaTime4));
+		velY = _mm_add_ps(velY, _mm_mul_ps(_mm_div_ps(_mm_loadu_ps(&m_forceY[bodyIndex]), mass), deltaTime4));
+		velY = _mm_mul_ps(velY, linearDamping);
+		_mm_storeu_ps(&velocityY[bodyIndex], velY);
+		_mm_storeu_ps(&positionY[bodyIndex], _mm_add_ps(_mm_loadu_ps(&positionY[bodyIndex]), _mm_mul_ps(_mm_mul_ps(velY, deltaTime4), _mm_loadu_ps(&m_constraintY[bodyIndex]))));
+
+		__m128 angVel = _mm_loadu_ps(&angularVelocity[bodyIndex]);
+		angVel = _mm_add_ps(angVel, _mm_mul_ps(_mm_div_ps(_mm_loadu_ps(&m_torque[bodyIndex]), _mm_loadu_ps(&m_momentOfInertia[bodyIndex])), deltaTime4));
+		angVel = _mm_mul_ps(angVel, _mm_sub_ps(one4, _mm_mul_ps(_mm_loadu_ps(&m_angularDrag[bodyIndex]), deltaTime4)));
+		_mm_storeu_ps(&angularVelocity[bodyIndex], angVel);
+		_mm_storeu_ps(&rotation[bodyIndex], _mm_add_ps(_mm_loadu_ps(&rotation[bodyIndex]), _mm_mul_ps(_mm_mul_ps(angVel, deltaTime4), _mm_loadu_ps(&m_constraintRotation[bodyIndex]))));
+	}
+
+	IntegrateRange(bodyIndex, bodyCount, deltaTime, gravity);
+
+	//Box and capsule shapes keep their own rotation
+	for (bodyIndex = 0U; bodyIndex < bodyCount; ++bodyIndex)
+	{
+		m_bodies[bodyIndex]->ApplyRotation();
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void RigidbodyStore2D::IntegrateRange(uint startIndex, uint endIndex, float deltaTime, const Vec2& gravity)
+{
+	//Scalar version of the kernel, also the tail for whatever doesn't fill a full vector
+	for (uint bodyIndex = startIndex; bodyIndex < endIndex; ++bodyIndex)
+	{
+		float linearDamping = 1.f - (m_linearDrag[bodyIndex] * deltaTime);
+
+		m_velocityX[bodyIndex] += (gravity.x * m_gravityScaleX[bodyIndex]) * deltaTime;
+		m_velocityY[bodyIndex] += (gravity.y * m_gravityScaleY[bodyIndex]) * deltaTime;
+		m_velocityX[bodyIndex] += (m_forceX[bodyIndex] / m_mass[bodyIndex]) * deltaTime;
+		m_velocityY[bodyIndex] += (m_forceY[bodyIndex] / m_mass[bodyIndex]) * deltaTime;
+		m_velocityX[bodyIndex] *= linearDamping;
+		m_velocityY[bodyIndex] *= linearDamping;
+		m_positionX[bodyIndex] += (m_velocityX[bodyIndex] * deltaTime) * m_constraintX[bodyIndex];
+		m_positionY[bodyIndex] += (m_velocityY[bodyIndex] * deltaTime) * m_constraintY[bodyIndex];
+
+		m_angularVelocity[bodyIndex] += (m_torque[bodyIndex] / m_momentOfInertia[bodyIndex]) * deltaTime;
+		m_angularVelocity[bodyIndex] *= (1.f - (m_angularDrag[bodyIndex] * deltaTime));
+		m_rotation[bodyIndex] += (m_angularVelocity[bodyIndex] * deltaTime) * m_constraintRotation[bodyIndex];
+	}
+}
+//------------------------------------------------------------------------------------------------------------------------------
+// UNIT TEST
+//------------------------------------------------------------------------------------------------------------------------------
+static float GetStoreTestValue(uint& seed, float minValue, float maxValue)
+{
+	seed = seed * 1664525U + 1013904223U;
+	return minValue + (float)(seed >> 8U) / 16777216.f * (maxValue - minValue);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct StoreTestBody_T
+{
+	Vec2	m_position;
+	Vec2	m_velocity;
+	float	m_rotation;
+	float	m_angularVelocity;
+	float	m_mass;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+UNITTEST("RigidbodyStore", "Physics", 100)
+{
+	constexpr uint NUM_BODIES = 24U;
+	constexpr float STEP = 1.f / 60.f;
+
+	PhysicsSystem system(BROADPHASE_AABB_TREE);
+	std::vector<Transform2> transforms(NUM_BODIES);
+	std::vector<Rigidbody2D*> bodies;
+	for (uint bodyIndex = 0; bodyIndex < NUM_BODIES; ++bodyIndex)
+	{
+		eSimulationType simulationType = (bodyIndex % 7U == 6U) ? STATIC_SIMULATION : DYNAMIC_SIMULATION;
+		bodies.push_back(AddTestBody(system, simulationType, (bodyIndex % 2U == 0U) ? COLLIDER_BOX : COLLIDER_DISC, &transforms[bodyIndex]));
+		bodies.back()->SetPosition(Vec2((float)bodyIndex, 0.f));
+		bodies.back()->SetMass(1.f + (float)bodyIndex);
+	}
+
+	//Shuffle the slots around, sleeping and destroyed bodies leave the integrated range and the last slot fills holes
+	bodies[3]->PutToSleep();
+	bodies[8]->PutToSleep();
+	bodies[12]->PutToSleep();
+	bodies[20]->PutToSleep();
+	bodies[3]->WakeUp();
+	system.DestroyRigidbody(bodies[5]);
+	system.DestroyRigidbody(bodies[16]);
+	system.PurgeDeletedObjects();
+	bodies[5] = nullptr;
+	bodies[16] = nullptr;
+
+	//Every body still finds its own state
+	bool isStateKept = true;
+	for (uint bodyIndex = 0; bodyIndex < NUM_BODIES; ++bodyIndex)
+	{
+		if (bodies[bodyIndex] != nullptr)
+		{
+			isStateKept = isStateKept && bodies[bodyIndex]->GetPosition().x == (float)bodyIndex && bodies[bodyIndex]->GetMass() == 1.f + (float)bodyIndex;
+		}
+	}
+	CONFIRM(isStateKept);
+
+	uint seed = 1234U;
+	std::vector<StoreTestBody_T> expected(NUM_BODIES);
+	uint numIntegrated = 0U;
+	for (uint bodyIndex = 0; bodyIndex < NUM_BODIES; ++bodyIndex)
+	{
+		Rigidbody2D* body = bodies[bodyIndex];
+		if (body == nullptr)
+		{
+			continue;
+		}
+
+		body->SetPosition(Vec2(GetStoreTestValue(seed, -50.f, 50.f), GetStoreTestValue(seed, -50.f, 50.f)));
+		body->SetVelocity(Vec2(GetStoreTestValue(seed, -10.f, 10.f), GetStoreTestValue(seed, -10.f, 10.f)));
+		body->SetRotation(GetStoreTestValue(seed, -180.f, 180.f));
+		body->SetAngularVelocity(GetStoreTestValue(seed, -90.f, 90.f));
+		body->SetFrameForces(Vec2(GetStoreTestValue(seed, -20.f, 20.f), GetStoreTestValue(seed, -20.f, 20.f)));
+		body->SetFrameTorque(GetStoreTestValue(seed, -5.f, 5.f));
+		body->SetMass(GetStoreTestValue(seed, 0.5f, 4.f));
+		body->SetMomentOfInertia(GetStoreTestValue(seed, 0.1f, 2.f));
+		body->SetLinearDrag(GetStoreTestValue(seed, 0.f, 0.5f));
+		body->SetAngularDrag(GetStoreTestValue(seed, 0.f, 0.5f));
+		body->SetGravityScale(Vec2(GetStoreTestValue(seed, 0.f, 2.f), GetStoreTestValue(seed, 0.f, 2.f)));
+		if (bodyIndex % 5U == 4U)
+		{
+			body->SetConstraints(Vec3(0.f, 1.f, 0.f));
+		}
+
+		//The same math Move did on the body's own members
+		StoreTestBody_T& state = expected[bodyIndex];
+		state.m_position = body->GetPosition();
+		state.m_velocity = body->GetVelocity();
+		state.m_rotation = body->GetRotation();
+		state.m_angularVelocity = body->GetAngularVelocity();
+		state.m_mass = body->GetMass();
+
+		bool isIntegrated = body->IsAwake() && body->GetSimulationType() == DYNAMIC_SIMULATION;
+		CONFIRM(system.m_bodyStore.IsBodyIntegrated(body) == isIntegrated);
+		if (!isIntegrated)
+		{
+			continue;
+		}
+
+		numIntegrated++;
+		Vec3 constraints = body->GetConstraints();
+		state.m_velocity += system.GetGravity() * body->GetGravityScale() * STEP;
+		state.m_velocity += body->GetFrameForces() / body->GetMass() * STEP;
+		state.m_velocity *= (1.f - (body->GetLinearDrag() * STEP));
+		state.m_position += state.m_velocity * STEP * Vec2(constraints.x, constraints.y);
+
+		state.m_angularVelocity += body->GetFrameTorque() / body->GetMomentOfInertia() * STEP;
+		state.m_angularVelocity *= (1.f - (body->GetAngularDrag() * STEP));
+		state.m_rotation += state.m_angularVelocity * STEP * constraints.z;
+	}
+
+	//Enough awake bodies for the 4 wide loop and a scalar tail
+	CONFIRM(system.m_bodyStore.GetIntegratedCount() == numIntegrated);
+	CONFIRM(numIntegrated % 4U != 0U && numIntegrated > 8U);
+
+	system.m_bodyStore.Integrate(STEP, system.GetGravity());
+
+	bool isBitExact = true;
+	for (uint bodyIndex = 0; bodyIndex < NUM_BODIES; ++bodyIndex)
+	{
+		const Rigidbody2D* body = bodies[bodyIndex];
+		if (body == nullptr)
+		{
+			continue;
+		}
+
+		const StoreTestBody_T& state = expected[bodyIndex];
+		isBitExact = isBitExact && body->GetPosition() == state.m_position && body->GetVelocity() == state.m_velocity;
+		isBitExact = isBitExact && body->GetRotation() == state.m_rotation && body->GetAngularVelocity() == state.m_angularVelocity;
+		isBitExact = isBitExact && body->GetMass() == state.m_mass;
+	}
+
+	CONFIRM(isBitExact);
+	return true;
+}
@@ -0,0 +1,94 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+#include "Engine/Commons/EngineCommon.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------------
+class Rigidbody2D;
+
+//------------------------------------------------------------------------------------------------------------------------------
+constexpr uint INVALID_BODY_STORE_INDEX = 0xFFFFFFFFU;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Owns the integration state of every body in a PhysicsSystem, one contiguous float array per field so the integrator
+// runs 4 bodies per SSE instruction. Rigidbody2D is a handle, its accessors read and write its slot here.
+// The awake dynamic bodies are packed at the front so the kernel runs over [0, integrated count) without skipping
+// anything. Removing a body moves the last one into its slot
+//------------------------------------------------------------------------------------------------------------------------------
+class RigidbodyStore2D
+{
+public:
+	RigidbodyStore2D();
+	~RigidbodyStore2D();
+
+	void					AddBody(Rigidbody2D* body, float mass);
+	void					RemoveBody(Rigidbody2D* body);
+	void					SetBodyIntegrated(Rigidbody2D* body, bool isIntegrated);
+	bool					IsBodyIntegrated(const Rigidbody2D* body) const;
+
+	uint					GetBodyCount() const		{ return (uint)m_bodies.size(); }
+	uint					GetIntegratedCount() const	{ return m_integratedCount; }
+
+	void					Integrate(float deltaTime, const Vec2& gravity);
+	void					IntegrateRange(uint startIndex, uint endIndex, float deltaTime, const Vec2& gravity);
+
+	//Per slot state
+	inline Vec2				GetPosition(uint slot) const				{ return Vec2(m_positionX[slot], m_positionY[slot]); }
+	inline void				SetPosition(uint slot, const Vec2& position)	{ m_positionX[slot] = position.x; m_positionY[slot] = position.y; }
+	inline Vec2				GetVelocity(uint slot) const				{ return Vec2(m_velocityX[slot], m_velocityY[slot]); }
+	inline void				SetVelocity(uint slot, const Vec2& velocity)	{ m_velocityX[slot] = velocity.x; m_velocityY[slot] = velocity.y; }
+	inline Vec2				GetForce(uint slot) const					{ return Vec2(m_forceX[slot], m_forceY[slot]); }
+	inline void				SetForce(uint slot, const Vec2& force)		{ m_forceX[slot] = force.x; m_forceY[slot] = force.y; }
+	inline float			GetMass(uint slot) const					{ return m_mass[slot]; }
+	inline void				SetMass(uint slot, float mass)				{ m_mass[slot] = mass; }
+	inline float			GetLinearDrag(uint slot) const				{ return m_linearDrag[slot]; }
+	inline void				SetLinearDrag(uint slot, float drag)		{ m_linearDrag[slot] = drag; }
+	inline Vec2				GetGravityScale(uint slot) const			{ return Vec2(m_gravityScaleX[slot], m_gravityScaleY[slot]); }
+	inline void				SetGravityScale(uint slot, const Vec2& scale)	{ m_gravityScaleX[slot] = scale.x; m_gravityScaleY[slot] = scale.y; }
+
+	inline float			GetRotation(uint slot) const				{ return m_rotation[slot]; }
+	inline void				SetRotation(uint slot, float rotation)		{ m_rotation[slot] = rotation; }
+	inline float			GetAngularVelocity(uint slot) const			{ return m_angularVelocity[slot]; }
+	inline void				SetAngularVelocity(uint slot, float angularVelocity)	{ m_angularVelocity[slot] = angularVelocity; }
+	inline float			GetTorque(uint slot) const					{ return m_torque[slot]; }
+	inline void				SetTorque(uint slot, float torque)			{ m_torque[slot] = torque; }
+	inline float			GetMomentOfInertia(uint slot) const			{ return m_momentOfInertia[slot]; }
+	inline void				SetMomentOfInertia(uint slot, float momentOfInertia)	{ m_momentOfInertia[slot] = momentOfInertia; }
+	inline float			GetAngularDrag(uint slot) const				{ return m_angularDrag[slot]; }
+	inline void				SetAngularDrag(uint slot, float drag)		{ m_angularDrag[slot] = drag; }
+
+	inline Vec3				GetConstraints(uint slot) const				{ return Vec3(m_constraintX[slot], m_constraintY[slot], m_constraintRotation[slot]); }
+	inline void				SetConstraints(uint slot, const Vec3& constraints)	{ m_constraintX[slot] = constraints.x; m_constraintY[slot] = constraints.y; m_constraintRotation[slot] = constraints.z; }
+
+private:
+	void					SwapSlots(uint slotA, uint slotB);
+	void					MoveSlot(uint fromSlot, uint toSlot);
+
+private:
+	std::vector<Rigidbody2D*>	m_bodies;
+	uint						m_integratedCount = 0U;
+
+	//Linear state
+	std::vector<float>		m_positionX;
+	std::vector<float>		m_positionY;
+	std::vector<float>		m_velocityX;
+	std::vector<float>		m_velocityY;
+	std::vector<float>		m_forceX;
+	std::vector<float>		m_forceY;
+	std::vector<float>		m_mass;
+	std::vector<float>		m_linearDrag;
+	std::vector<float>		m_gravityScaleX;
+	std::vector<float>		m_gravityScaleY;
+	std::vector<float>		m_constraintX;
+	std::vector<float>		m_constraintY;
+
+	//Angular state
+	std::vector<float>		m_rotation;
+	std::vector<float>		m_angularVelocity;
+	std::vector<float>		m_torque;
+	std::vector<float>		m_momentOfInertia;
+	std::vector<float>		m_angularDrag;
+	std::vector<float>		m_constraintRotation;
+};
@@ -0,0 +1,584 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Math/SpatialHashBroadphase.hpp"
+#include "Engine/Commons/EngineCommon.hpp"
+#include "Engine/Commons/UnitTest.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Math/PhysicsSystem.hpp"
+#include "Engine/Math/PhysicsTestHelpers2D.hpp"
+#include <algorithm>
+#include <limits>
+#include <math.h>
+
+//------------------------------------------------------------------------------------------------------------------------------
+SpatialHashBroadphase::SpatialHashBroadphase(float cellSize /*= DEFAULT_SPATIAL_HASH_CELL_SIZE*/)
+{
+	m_cellSize = cellSize;
+	m_inverseCellSize = 1.f / cellSize;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+SpatialHashBroadphase::~SpatialHashBroadphase()
+{
+
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint SpatialHashBroadphase::CreateProxy(Collider2D* collider, const AABB2& bounds, bool isStatic)
+{
+	uint proxyId;
+	if (m_freeProxies.empty())
+	{
+		proxyId = (uint)m_proxies.size();
+		m_proxies.emplace_back();
+	}
+	else
+	{
+		proxyId = m_freeProxies.back();
+		m_freeProxies.pop_back();
+	}
+
+	SpatialHashProxy_T& proxy = m_proxies[proxyId];
+	proxy.m_collider = collider;
+	proxy.m_isStatic = isStatic;
+	proxy.m_hasMoved = true;
+	SetProxyBounds(proxy, bounds.m_minBounds, bounds.m_maxBounds);
+
+	return proxyId;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void SpatialHashBroadphase::DestroyProxy(uint proxyId)
+{
+	m_proxies[proxyId] = SpatialHashProxy_T();
+	m_freeProxies.push_back(proxyId);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void SpatialHashBroadphase::MoveProxy(uint proxyId, const AABB2& bounds)
+{
+	SpatialHashProxy_T& proxy = m_proxies[proxyId];
+	if (proxy.m_min == bounds.m_minBounds && proxy.m_max == bounds.m_maxBounds)
+	{
+		return;
+	}
+
+	proxy.m_hasMoved = true;
+	SetProxyBounds(proxy, bounds.m_minBounds, bounds.m_maxBounds);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void SpatialHashBroadphase::SetProxyBounds(SpatialHashProxy_T& proxy, const Vec2& minBounds, const Vec2& maxBounds)
+{
+	proxy.m_min = minBounds;
+	proxy.m_max = maxBounds;
+
+	//Huge or NaN bounds would have the cell loops run for ever, those proxies stay off the grid
+	int cells[4] = { 0, 0, 0, 0 };
+	float cellCount;
+	proxy.m_isOffGrid = !GetCellSpan(minBounds, maxBounds, cells, cellCount) || cellCount > SPATIAL_HASH_MAX_PROXY_CELLS;
+
+	proxy.m_cellMinX = proxy.m_isOffGrid ? 0 : cells[0];
+	proxy.m_cellMinY = proxy.m_isOffGrid ? 0 : cells[1];
+	proxy.m_cellMaxX = proxy.m_isOffGrid ? 0 : cells[2];
+	proxy.m_cellMaxY = proxy.m_isOffGrid ? 0 : cells[3];
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Cells as min x, min y, max x, max y. False when a bound isn't finite or the cell doesn't fit in an int
+bool SpatialHashBroadphase::GetCellSpan(const Vec2& minBounds, const Vec2& maxBounds, int* outCells, float& outCellCount) const
+{
+	float cells[4] = 
+	{ 
+		floorf(minBounds.x * m_inverseCellSize), 
+		floorf(minBounds.y * m_inverseCellSize), 
+		floorf(maxBounds.x * m_inverseCellSize), 
+		floorf(maxBounds.y * m_inverseCellSize) 
+	};
+
+	for (int cornerIndex = 0; cornerIndex < 4; ++cornerIndex)
+	{
+		//Written so a NaN fails it too
+		if (!(fabsf(cells[cornerIndex]) <= SPATIAL_HASH_MAX_CELL_COORD))
+		{
+			return false;
+		}
+
+		outCells[cornerIndex] = (int)cells[cornerIndex];
+	}
+
+	outCellCount = (cells[2] - cells[0] + 1.f) * (cells[3] - cells[1] + 1.f);
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint SpatialHashBroadphase::GetBucketIndex(int cellX, int cellY) const
+{
+	return (((uint)cellX * 73856093U) ^ ((uint)cellY * 19349663U)) & m_bucketMask;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void SpatialHashBroadphase::RebuildBuckets()
+{
+	//Roughly twice as many buckets as proxies keeps most buckets to a single cell
+	uint bucketCount = SPATIAL_HASH_MIN_BUCKETS;
+	while (bucketCount < m_proxies.size() * 2U)
+	{
+		bucketCount <<= 1U;
+	}
+	m_bucketMask = bucketCount - 1U;
+
+	//Count entries per bucket, the extra slot at the end makes the prefix sum double as bucket ends
+	m_bucketStarts.assign(bucketCount + 1U, 0U);
+	m_offGridProxyIds.clear();
+
+	uint proxyCount = (uint)m_proxies.size();
+	for (uint proxyId = 0; proxyId < proxyCount; ++proxyId)
+	{
+		const SpatialHashProxy_T& proxy = m_proxies[proxyId];
+		if (proxy.m_collider == nullptr)
+		{
+			continue;
+		}
+
+		if (proxy.m_isOffGrid)
+		{
+			m_offGridProxyIds.push_back(proxyId);
+			continue;
+		}
+
+		for (int cellY = proxy.m_cellMinY; cellY <= proxy.m_cellMaxY; ++cellY)
+		{
+			for (int cellX = proxy.m_cellMinX; cellX <= proxy.m_cellMaxX; ++cellX)
+			{
+				m_bucketStarts[GetBucketIndex(cellX, cellY) + 1U]++;
+			}
+		}
+	}
+
+	for (uint bucketIndex = 0; bucketIndex < bucketCount; ++bucketIndex)
+	{
+		m_bucketStarts[bucketIndex + 1U] += m_bucketStarts[bucketIndex];
+	}
+
+	//Scatter, counting each bucket's write head up from its start. That leaves every start one bucket late, shifted back after
+	m_bucketEntries.resize(m_bucketStarts[bucketCount]);
+	for (uint proxyId = 0; proxyId < proxyCount; ++proxyId)
+	{
+		const SpatialHashProxy_T& proxy = m_proxies[proxyId];
+		if (proxy.m_collider == nullptr || proxy.m_isOffGrid)
+		{
+			continue;
+		}
+
+		for (int cellY = proxy.m_cellMinY; cellY <= proxy.m_cellMaxY; ++cellY)
+		{
+			for (int cellX = proxy.m_cellMinX; cellX <= proxy.m_cellMaxX; ++cellX)
+			{
+				m_bucketEntries[m_bucketStarts[GetBucketIndex(cellX, cellY)]++] = { proxyId, cellX, cellY };
+			}
+		}
+	}
+
+	for (uint bucketIndex = bucketCount; bucketIndex > 0U; --bucketIndex)
+	{
+		m_bucketStarts[bucketIndex] = m_bucketStarts[bucketIndex - 1U];
+	}
+	m_bucketStarts[0] = 0U;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void SpatialHashBroadphase::GetCandidatePairs(BroadphasePairList& outPairs)
+{
+	outPairs.clear();
+	RebuildBuckets();
+
+	uint proxyCount = (uint)m_proxies.size();
+	for (uint proxyId = 0; proxyId < proxyCount; ++proxyId)
+	{
+		const SpatialHashProxy_T& proxy = m_proxies[proxyId];
+
+		//Dynamic proxies find everything they touch. Statics only look (for other statics) when they moved
+		if (proxy.m_collider == nullptr || proxy.m_isOffGrid || (proxy.m_isStatic && !proxy.m_hasMoved))
+		{
+			continue;
+		}
+
+		for (int cellY = proxy.m_cellMinY; cellY <= proxy.m_cellMaxY; ++cellY)
+		{
+			for (int cellX = proxy.m_cellMinX; cellX <= proxy.m_cellMaxX; ++cellX)
+			{
+				uint bucketIndex = GetBucketIndex(cellX, cellY);
+				uint entryEnd = m_bucketStarts[bucketIndex + 1U];
+
+				for (uint entryIndex = m_bucketStarts[bucketIndex]; entryIndex < entryEnd; ++entryIndex)
+				{
+					const SpatialHashEntry_T& entry = m_bucketEntries[entryIndex];
+					uint otherId = entry.m_proxyId;
+					if (otherId == proxyId || entry.m_cellX != cellX || entry.m_cellY != cellY)
+					{
+						continue;
+					}
+
+					const SpatialHashProxy_T& other = m_proxies[otherId];
+
+					//Each pair is reported by exactly one of its proxies, same rules as the tree
+					bool isReported;
+					if (proxy.m_isStatic)
+					{
+						isReported = other.m_isStatic && (!other.m_hasMoved || proxyId < otherId);
+					}
+					else
+					{
+						isReported = other.m_isStatic || proxyId < otherId;
+					}
+
+					if (!isReported)
+					{
+						continue;
+					}
+
+					if (proxy.m_min.x > other.m_max.x || other.m_min.x > proxy.m_max.x || proxy.m_min.y > other.m_max.y || other.m_min.y > proxy.m_max.y)
+					{
+						continue;
+					}
+
+					//Pairs sharing several cells are only reported from the cell holding the bottom left corner of their overlap
+					int ownerCellX = (proxy.m_cellMinX > other.m_cellMinX) ? proxy.m_cellMinX : other.m_cellMinX;
+					int ownerCellY = (proxy.m_cellMinY > other.m_cellMinY) ? proxy.m_cellMinY : other.m_cellMinY;
+					if (ownerCellX != cellX || ownerCellY != cellY)
+					{
+						continue;
+					}
+
+					outPairs.push_back({ proxy.m_collider, other.m_collider });
+				}
+			}
+		}
+	}
+
+	GetOffGridPairs(outPairs);
+
+	for (uint proxyId = 0; proxyId < proxyCount; ++proxyId)
+	{
+		m_proxies[proxyId].m_hasMoved = false;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Off grid proxies aren't in any bucket, so each checks every other live proxy. Two off grid ones pair from the lower id
+void SpatialHashBroadphase::GetOffGridPairs(BroadphasePairList& outPairs) const
+{
+	uint proxyCount = (uint)m_proxies.size();
+	for (uint proxyId : m_offGridProxyIds)
+	{
+		const SpatialHashProxy_T& proxy = m_proxies[proxyId];
+		for (uint otherId = 0; otherId < proxyCount; ++otherId)
+		{
+			const SpatialHashProxy_T& other = m_proxies[otherId];
+			if (other.m_collider == nullptr || otherId == proxyId || (other.m_isOffGrid && otherId < proxyId))
+			{
+				continue;
+			}
+
+			if (proxy.m_isStatic && other.m_isStatic && !proxy.m_hasMoved && !other.m_hasMoved)
+			{
+				continue;
+			}
+
+			//Written so a NaN bound overlaps nothing
+			if (!(proxy.m_min.x <= other.m_max.x && proxy.m_min.y <= other.m_max.y && other.m_min.x <= proxy.m_max.x && other.m_min.y <= proxy.m_max.y))
+			{
+				continue;
+			}
+
+			//Dynamic side first
+			if (proxy.m_isStatic && !other.m_isStatic)
+			{
+				outPairs.push_back({ other.m_collider, proxy.m_collider });
+			}
+			else
+			{
+				outPairs.push_back({ proxy.m_collider, other.m_collider });
+			}
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void SpatialHashBroadphase::QueryAABB(const AABB2& queryBounds, std::vector<Collider2D*>& outColliders) const
+{
+	if (m_bucketStarts.empty())
+	{
+		return;
+	}
+
+	//Same reach as the AABB tree's fat leaves, proxies were placed before the step resolved its contacts
+	AABB2 bounds(queryBounds.m_minBounds - Vec2(BROADPHASE_QUERY_MARGIN, BROADPHASE_QUERY_MARGIN), queryBounds.m_maxBounds + Vec2(BROADPHASE_QUERY_MARGIN, BROADPHASE_QUERY_MARGIN));
+
+	int queryCells[4];
+	float queryCellCount;
+	bool isOnGrid = GetCellSpan(bounds.m_minBounds, bounds.m_maxBounds, queryCells, queryCellCount);
+
+	uint liveProxyCount = (uint)(m_proxies.size() - m_freeProxies.size());
+	if (!isOnGrid || queryCellCount > (float)liveProxyCount)
+	{
+		for (const SpatialHashProxy_T& proxy : m_proxies)
+		{
+			if (proxy.m_collider == nullptr)
+			{
+				continue;
+			}
+
+			if (proxy.m_min.x <= bounds.m_maxBounds.x && bounds.m_minBounds.x <= proxy.m_max.x && proxy.m_min.y <= bounds.m_maxBounds.y && bounds.m_minBounds.y <= proxy.m_max.y)
+			{
+				outColliders.push_back(proxy.m_collider);
+			}
+		}
+		return;
+	}
+
+	int queryMinX = queryCells[0];
+	int queryMinY = queryCells[1];
+	int queryMaxX = queryCells[2];
+	int queryMaxY = queryCells[3];
+
+	for (int cellY = queryMinY; cellY <= queryMaxY; ++cellY)
+	{
+		for (int cellX = queryMinX; cellX <= queryMaxX; ++cellX)
+		{
+			uint bucketIndex = GetBucketIndex(cellX, cellY);
+			uint entryEnd = m_bucketStarts[bucketIndex + 1U];
+
+			for (uint entryIndex = m_bucketStarts[bucketIndex]; entryIndex < entryEnd; ++entryIndex)
+			{
+				const SpatialHashEntry_T& entry = m_bucketEntries[entryIndex];
+				if (entry.m_cellX != cellX || entry.m_cellY != cellY)
+				{
+					continue;
+				}
+
+				const SpatialHashProxy_T& proxy = m_proxies[entry.m_proxyId];
+				if (proxy.m_collider == nullptr)
+				{
+					continue;
+				}
+
+				if (proxy.m_min.x > bounds.m_maxBounds.x || bounds.m_minBounds.x > proxy.m_max.x || proxy.m_min.y > bounds.m_maxBounds.y || bounds.m_minBounds.y > proxy.m_max.y)
+				{
+					continue;
+				}
+
+				//Same trick as the pairs, a proxy in several of the queried cells only comes out of the bottom left one
+				int ownerCellX = (proxy.m_cellMinX > queryMinX) ? proxy.m_cellMinX : queryMinX;
+				int ownerCellY = (proxy.m_cellMinY > queryMinY) ? proxy.m_cellMinY : queryMinY;
+				if (ownerCellX != cellX || ownerCellY != cellY)
+				{
+					continue;
+				}
+
+				outColliders.push_back(proxy.m_collider);
+			}
+		}
+	}
+
+	for (uint proxyId : m_offGridProxyIds)
+	{
+		const SpatialHashProxy_T& proxy = m_proxies[proxyId];
+		if (proxy.m_collider == nullptr || !proxy.m_isOffGrid)
+		{
+			continue;
+		}
+
+		if (proxy.m_min.x <= bounds.m_maxBounds.x && bounds.m_minBounds.x <= proxy.m_max.x && proxy.m_min.y <= bounds.m_maxBounds.y && bounds.m_minBounds.y <= proxy.m_max.y)
+		{
+			outColliders.push_back(proxy.m_collider);
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// UNIT TEST
+//------------------------------------------------------------------------------------------------------------------------------
+static inline bool DoTestBoundsOverlap(const AABB2& a, const AABB2& b)
+{
+	return a.m_minBounds.x <= b.m_maxBounds.x && b.m_minBounds.x <= a.m_maxBounds.x && a.m_minBounds.y <= b.m_maxBounds.y && b.m_minBounds.y <= a.m_maxBounds.y;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+static inline uint64_t GetTestPairKey(const BroadphasePair_T& pair)
+{
+	//Fake collider pointers are the bounds index plus one
+	uint64_t indexA = (uint64_t)(uintptr_t)pair.m_colliderA - 1U;
+	uint64_t indexB = (uint64_t)(uintptr_t)pair.m_colliderB - 1U;
+	return (indexA < indexB) ? (indexA << 32U) | indexB : (indexB << 32U) | indexA;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+UNITTEST("SpatialHashBroadphase", "Physics", 100)
+{
+	constexpr uint NUM_PROXIES = 1000U;
+	constexpr float WORLD_SIZE = 120.f;
+	const float NAN_BOUND = std::numeric_limits<float>::quiet_NaN();
+
+	//Mostly body sized boxes, a few spanning many cells and a few the grid can't hold at all
+	std::vector<AABB2> bounds;
+	std::vector<bool> isStatic;
+	uint seed = 12345U;
+	for (uint proxyIndex = 0; proxyIndex < NUM_PROXIES; ++proxyIndex)
+	{
+		seed = seed * 1664525U + 1013904223U;
+		Vec2 position((float)(seed >> 8U) / 16777216.f * WORLD_SIZE, (float)(seed & 0xFFFFU) / 65536.f * WORLD_SIZE);
+		float size = (proxyIndex % 50U == 0U) ? 30.f : 1.5f;
+		bounds.push_back(AABB2(position, position + Vec2(size, size)));
+		isStatic.push_back(proxyIndex % 7U == 0U);
+	}
+	bounds.push_back(AABB2(Vec2(-1.0e20f, 10.f), Vec2(1.0e20f, 11.f)));
+	bounds.push_back(AABB2(Vec2(NAN_BOUND, 5.f), Vec2(6.f, 6.f)));
+	bounds.push_back(AABB2(Vec2(-INFINITY, -INFINITY), Vec2(INFINITY, 0.5f)));
+	bounds.push_back(AABB2(Vec2(-1.0e20f, 40.f), Vec2(1.0e20f, 41.f)));
+	isStatic.insert(isStatic.end(), { true, false, false, true });
+
+	SpatialHashBroadphase spatialHash(2.f);
+	uint numBounds = (uint)bounds.size();
+	for (uint proxyIndex = 0; proxyIndex < numBounds; ++proxyIndex)
+	{
+		spatialHash.CreateProxy((Collider2D*)(uintptr_t)(proxyIndex + 1U), bounds[proxyIndex], isStatic[proxyIndex]);
+	}
+
+	bool arePairsExact = true;
+	bool isDynamicFirst = true;
+	bool areQueriesExact = true;
+
+	BroadphasePairList pairs;
+	std::vector<uint64_t> foundKeys;
+	std::vector<uint64_t> expectedKeys;
+	std::vector<Collider2D*> queryResults;
+	std::vector<Collider2D*> expectedResults;
+	for (uint round = 0; round < 2U; ++round)
+	{
+		//The first round has every proxy new, the second only moves the dynamic ones so static pairs drop out
+		if (round > 0U)
+		{
+			for (uint proxyIndex = 0; proxyIndex < numBounds; ++proxyIndex)
+			{
+				if (!isStatic[proxyIndex])
+				{
+					bounds[proxyIndex] = AABB2(bounds[proxyIndex].m_minBounds + Vec2(0.7f, -0.3f), bounds[proxyIndex].m_maxBounds + Vec2(0.7f, -0.3f));
+					spatialHash.MoveProxy(proxyIndex, bounds[proxyIndex]);
+				}
+			}
+		}
+
+		spatialHash.GetCandidatePairs(pairs);
+
+		foundKeys.clear();
+		for (const BroadphasePair_T& pair : pairs)
+		{
+			foundKeys.push_back(GetTestPairKey(pair));
+			isDynamicFirst = isDynamicFirst && !(isStatic[(uintptr_t)pair.m_colliderA - 1U] && !isStatic[(uintptr_t)pair.m_colliderB - 1U]);
+		}
+		std::sort(foundKeys.begin(), foundKeys.end());
+
+		expectedKeys.clear();
+		for (uint indexA = 0; indexA < numBounds; ++indexA)
+		{
+			for (uint indexB = indexA + 1U; indexB < numBounds; ++indexB)
+			{
+				bool isStaticPair = isStatic[indexA] && isStatic[indexB];
+				if ((round == 0U || !isStaticPair) && DoTestBoundsOverlap(bounds[indexA], bounds[indexB]))
+				{
+					expectedKeys.push_back(((uint64_t)indexA << 32U) | indexB);
+				}
+			}
+		}
+		arePairsExact = arePairsExact && foundKeys == expectedKeys;
+
+		//Small boxes walk the grid, big and NaN ones fall back to checking every proxy
+		AABB2 queries[] = 
+		{ 
+			AABB2(Vec2(10.f, 10.f), Vec2(14.f, 12.f)), 
+			AABB2(Vec2(-5.f, 30.f), Vec2(90.f, 45.f)), 
+			AABB2(Vec2(-1.0e30f, -1.0e30f), Vec2(1.0e30f, 1.0e30f)), 
+			AABB2(Vec2(NAN_BOUND, 0.f), Vec2(10.f, 10.f)) 
+		};
+
+		for (const AABB2& query : queries)
+		{
+			queryResults.clear();
+			spatialHash.QueryAABB(query, queryResults);
+			std::sort(queryResults.begin(), queryResults.end());
+
+			//Queries reach the margin past the proxies
+			AABB2 reach(query.m_minBounds - Vec2(BROADPHASE_QUERY_MARGIN, BROADPHASE_QUERY_MARGIN), query.m_maxBounds + Vec2(BROADPHASE_QUERY_MARGIN, BROADPHASE_QUERY_MARGIN));
+			expectedResults.clear();
+			for (uint proxyIndex = 0; proxyIndex < numBounds; ++proxyIndex)
+			{
+				if (DoTestBoundsOverlap(bounds[proxyIndex], reach))
+				{
+					expectedResults.push_back((Collider2D*)(uintptr_t)(proxyIndex + 1U));
+				}
+			}
+			areQueriesExact = areQueriesExact && queryResults == expectedResults;
+		}
+	}
+
+	CONFIRM(!expectedKeys.empty());
+	CONFIRM(arePairsExact);
+	CONFIRM(isDynamicFirst);
+	CONFIRM(areQueriesExact);
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Steps of the whole PhysicsSystem with each broadphase, so the baseline is the brute force path the engine really runs
+UNITTEST("SpatialHashBroadphase", "PhysicsBenchmark", 100)
+{
+	const uint bodyCounts[] = { 100U, 1000U, 10000U };
+	const eBroadphaseType broadphaseTypes[] = { BROADPHASE_BRUTE_FORCE, BROADPHASE_SPATIAL_HASH, BROADPHASE_AABB_TREE };
+	constexpr uint MAX_BRUTE_FORCE_BODIES = 1000U;
+
+	for (uint bodyCount : bodyCounts)
+	{
+		double stepSeconds[3] = { 0.0, 0.0, 0.0 };
+		for (int typeIndex = 0; typeIndex < 3; ++typeIndex)
+		{
+			if (broadphaseTypes[typeIndex] == BROADPHASE_BRUTE_FORCE && bodyCount > MAX_BRUTE_FORCE_BODIES)
+			{
+				continue;
+			}
+
+			//Same size bodies at a constant density, so pairs per body stay the same as the count grows
+			std::vector<Transform2> transforms(bodyCount);
+			PhysicsSystem system(broadphaseTypes[typeIndex]);
+
+			float worldSize = sqrtf((float)bodyCount) * 4.f;
+			uint seed = 12345U;
+			for (uint bodyIndex = 0; bodyIndex < bodyCount; ++bodyIndex)
+			{
+				seed = seed * 1664525U + 1013904223U;
+				transforms[bodyIndex].m_position = Vec2((float)(seed >> 8U) / 16777216.f * worldSize, (float)(seed & 0xFFFFU) / 65536.f * worldSize);
+				AddTestBody(system, DYNAMIC_SIMULATION, COLLIDER_DISC, &transforms[bodyIndex], Vec2(1.5f, 1.5f));
+			}
+
+			//The first step makes the proxies
+			system.Update(1.f / 60.f);
+
+			double startTime = GetCurrentTimeSeconds();
+			system.Update(1.f / 60.f);
+			stepSeconds[typeIndex] = GetCurrentTimeSeconds() - startTime;
+		}
+
+		if (bodyCount > MAX_BRUTE_FORCE_BODIES)
+		{
+			DebuggerPrintf("\n PhysicsSystem step with %u bodies: brute force skipped, spatial hash %.3f ms, aabb tree %.3f ms",
+				bodyCount, stepSeconds[1] * 1000.0, stepSeconds[2] * 1000.0);
+		}
+		else
+		{
+			DebuggerPrintf("\n PhysicsSystem step with %u bodies: brute force %.3f ms, spatial hash %.3f ms, aabb tree %.3f ms",
+				bodyCount, stepSeconds[0] * 1000.0, stepSeconds[1] * 1000.0, stepSeconds[2] * 1000.0);
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,76 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+#include "Engine/Math/Broadphase2D.hpp"
+#include "Engine/Math/Vec2.hpp"
+
+//------------------------------------------------------------------------------------------------------------------------------
+constexpr float DEFAULT_SPATIAL_HASH_CELL_SIZE = 2.f;		//Works best around the size of a typical body
+constexpr uint SPATIAL_HASH_MIN_BUCKETS = 64U;
+constexpr float SPATIAL_HASH_MAX_PROXY_CELLS = 1024.f;		//Proxies spanning more cells than this are kept off the grid
+constexpr float SPATIAL_HASH_MAX_CELL_COORD = 1.0e9f;		//Cell coordinates have to fit in an int
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct SpatialHashProxy_T
+{
+	Collider2D*		m_collider = nullptr;			//nullptr while the slot is free
+	Vec2			m_min;
+	Vec2			m_max;
+	int				m_cellMinX = 0;
+	int				m_cellMinY = 0;
+	int				m_cellMaxX = 0;
+	int				m_cellMaxY = 0;
+	bool			m_isStatic = false;
+	bool			m_hasMoved = false;
+	bool			m_isOffGrid = false;			//Huge or non finite bounds, paired by checking every other proxy
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct SpatialHashEntry_T
+{
+	uint			m_proxyId;
+	int				m_cellX;						//Buckets can hold more than one cell, entries remember theirs
+	int				m_cellY;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Uniform grid hashed into a flat bucket table, good when bodies are all about the same size.
+// The table is rebuilt every step with a counting sort so each bucket's proxy ids sit next to each other in one array.
+// A pair sharing several cells is only reported from the cell holding the bottom left corner of their overlap
+//------------------------------------------------------------------------------------------------------------------------------
+class SpatialHashBroadphase : public Broadphase2D
+{
+public:
+	explicit SpatialHashBroadphase(float cellSize = DEFAULT_SPATIAL_HASH_CELL_SIZE);
+	~SpatialHashBroadphase();
+
+	virtual uint					CreateProxy(Collider2D* collider, const AABB2& bounds, bool isStatic) final;
+	virtual void					DestroyProxy(uint proxyId) final;
+	virtual void					MoveProxy(uint proxyId, const AABB2& bounds) final;
+
+	virtual void					GetCandidatePairs(BroadphasePairList& outPairs) final;
+
+	// A box spanning more cells than there are proxies, or with bounds that aren't finite, just checks every proxy instead
+	virtual void					QueryAABB(const AABB2& queryBounds, std::vector<Collider2D*>& outColliders) const final;
+
+	float							GetCellSize() const		{ return m_cellSize; }
+
+private:
+	void							SetProxyBounds(SpatialHashProxy_T& proxy, const Vec2& minBounds, const Vec2& maxBounds);
+	bool							GetCellSpan(const Vec2& minBounds, const Vec2& maxBounds, int* outCells, float& outCellCount) const;
+	void							GetOffGridPairs(BroadphasePairList& outPairs) const;
+	uint							GetBucketIndex(int cellX, int cellY) const;
+	void							RebuildBuckets();
+
+private:
+	float							m_cellSize;
+	float							m_inverseCellSize;
+
+	std::vector<SpatialHashProxy_T>	m_proxies;
+	std::vector<uint>				m_freeProxies;
+
+	//Counting sort output, bucket b owns m_bucketEntries[m_bucketStarts[b] .. m_bucketStarts[b + 1])
+	uint							m_bucketMask = 0U;
+	std::vector<uint>				m_bucketStarts;
+	std::vector<SpatialHashEntry_T>	m_bucketEntries;
+	std::vector<uint>				m_offGridProxyIds;
+};
@@ -0,0 +1,662 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Math/SweepAndPruneBroadphase.hpp"
+#include "Engine/Commons/UnitTest.hpp"
+#include <algorithm>
+#include <float.h>
+#include <math.h>
+
+//------------------------------------------------------------------------------------------------------------------------------
+static inline bool IsEndpointBefore(const SweepAndPruneEndpoint_T& a, const SweepAndPruneEndpoint_T& b)
+{
+	//On a tie mins go first, so boxes that just touch count as overlapping like everywhere else in the broadphase
+	return (a.m_value < b.m_value) || (a.m_value == b.m_value && !a.m_isMax && b.m_isMax);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+SweepAndPruneBroadphase::SweepAndPruneBroadphase()
+{
+
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+SweepAndPruneBroadphase::~SweepAndPruneBroadphase()
+{
+
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint64_t SweepAndPruneBroadphase::GetPairKey(uint proxyIdA, uint proxyIdB)
+{
+	return (proxyIdA < proxyIdB) ? (((uint64_t)proxyIdA << 32) | proxyIdB) : (((uint64_t)proxyIdB << 32) | proxyIdA);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint SweepAndPruneBroadphase::CreateProxy(Collider2D* collider, const AABB2& bounds, bool isStatic)
+{
+	uint proxyId;
+	if (m_freeProxies.empty())
+	{
+		proxyId = (uint)m_proxies.size();
+		m_proxies.emplace_back();
+	}
+	else
+	{
+		proxyId = m_freeProxies.back();
+		m_freeProxies.pop_back();
+	}
+
+	SweepAndPruneProxy_T& proxy = m_proxies[proxyId];
+	proxy.m_collider = collider;
+	proxy.m_isStatic = isStatic;
+	proxy.m_isBeingRemoved = false;
+
+	//New endpoints start at the end as if the proxy sat right of everything, the next sort moves them in and adds the overlaps
+	proxy.m_minEndpoint = (uint)m_endpoints.size();
+	m_endpoints.push_back({ FLT_MAX, proxyId, false });
+	proxy.m_maxEndpoint = (uint)m_endpoints.size();
+	m_endpoints.push_back({ FLT_MAX, proxyId, true });
+
+	SetProxyBounds(proxyId, bounds);
+	m_newProxyCount++;
+	return proxyId;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void SweepAndPruneBroadphase::DestroyProxy(uint proxyId)
+{
+	//Pushing the endpoints out to infinity lets the next sort remove every overlap the proxy had, then they get popped
+	SweepAndPruneProxy_T& proxy = m_proxies[proxyId];
+	if (proxy.m_isOffAxis)
+	{
+		m_offAxisProxyIds.erase(std::find(m_offAxisProxyIds.begin(), m_offAxisProxyIds.end(), proxyId));
+		proxy.m_isOffAxis = false;
+	}
+
+	proxy.m_isBeingRemoved = true;
+	m_endpoints[proxy.m_minEndpoint].m_value = FLT_MAX;
+	m_endpoints[proxy.m_maxEndpoint].m_value = FLT_MAX;
+
+	m_destroyedProxies.push_back(proxyId);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void SweepAndPruneBroadphase::MoveProxy(uint proxyId, const AABB2& bounds)
+{
+	SweepAndPruneProxy_T& proxy = m_proxies[proxyId];
+	if (proxy.m_min == bounds.m_minBounds && proxy.m_max == bounds.m_maxBounds)
+	{
+		return;
+	}
+
+	SetProxyBounds(proxyId, bounds);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void SweepAndPruneBroadphase::SetProxyBounds(uint proxyId, const AABB2& bounds)
+{
+	SweepAndPruneProxy_T& proxy = m_proxies[proxyId];
+	proxy.m_min = bounds.m_minBounds;
+	proxy.m_max = bounds.m_maxBounds;
+	proxy.m_hasMoved = true;
+
+	//A NaN endpoint breaks the ordering both sorts need and an inverted one closes before it opens, park them at FLT_MAX.
+	//Their X overlaps are still tracked like any other so the set stays right when they come back, pairs just skip them
+	bool isOffAxis = !(isfinite(proxy.m_min.x) && isfinite(proxy.m_min.y) && isfinite(proxy.m_max.x) && isfinite(proxy.m_max.y)) || proxy.m_min.x > proxy.m_max.x;
+	if (isOffAxis && !proxy.m_isOffAxis)
+	{
+		m_offAxisProxyIds.push_back(proxyId);
+	}
+	else if (!isOffAxis && proxy.m_isOffAxis)
+	{
+		m_offAxisProxyIds.erase(std::find(m_offAxisProxyIds.begin(), m_offAxisProxyIds.end(), proxyId));
+	}
+	proxy.m_isOffAxis = isOffAxis;
+
+	m_endpoints[proxy.m_minEndpoint].m_value = isOffAxis ? FLT_MAX : proxy.m_min.x;
+	m_endpoints[proxy.m_maxEndpoint].m_value = isOffAxis ? FLT_MAX : proxy.m_max.x;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void SweepAndPruneBroadphase::GetCandidatePairs(BroadphasePairList& outPairs)
+{
+	outPairs.clear();
+
+	//A big batch of new proxies would cost O(n^2) swaps coming in from the end, sorting from scratch is cheaper then
+	uint liveProxyCount = (uint)(m_proxies.size() - m_freeProxies.size());
+	if (m_newProxyCount * 4U > liveProxyCount)
+	{
+		RebuildOverlaps();
+	}
+	else
+	{
+		SortEndpoints();
+	}
+	m_newProxyCount = 0U;
+
+	RemoveDestroyedProxies();
+
+	//X overlaps become pairs if they overlap on Y too
+	for (uint64_t pairKey : m_xOverlaps)
+	{
+		uint proxyIdA = (uint)(pairKey >> 32);
+		uint proxyIdB = (uint)(pairKey & 0xFFFFFFFFU);
+		const SweepAndPruneProxy_T& proxyA = m_proxies[proxyIdA];
+		const SweepAndPruneProxy_T& proxyB = m_proxies[proxyIdB];
+
+		if (proxyA.m_isStatic && proxyB.m_isStatic && !proxyA.m_hasMoved && !proxyB.m_hasMoved)
+		{
+			continue;
+		}
+
+		if (proxyA.m_isOffAxis || proxyB.m_isOffAxis || proxyA.m_min.y > proxyB.m_max.y || proxyB.m_min.y > proxyA.m_max.y)
+		{
+			continue;
+		}
+
+		if (proxyA.m_isStatic && !proxyB.m_isStatic)
+		{
+			outPairs.push_back({ proxyB.m_collider, proxyA.m_collider });
+		}
+		else
+		{
+			outPairs.push_back({ proxyA.m_collider, proxyB.m_collider });
+		}
+	}
+
+	GetOffAxisPairs(outPairs);
+
+	for (SweepAndPruneProxy_T& proxy : m_proxies)
+	{
+		proxy.m_hasMoved = false;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Off axis proxies check every other live proxy. Two off axis ones pair from the lower id
+void SweepAndPruneBroadphase::GetOffAxisPairs(BroadphasePairList& outPairs) const
+{
+	uint proxyCount = (uint)m_proxies.size();
+	for (uint proxyId : m_offAxisProxyIds)
+	{
+		const SweepAndPruneProxy_T& proxy = m_proxies[proxyId];
+		for (uint otherId = 0; otherId < proxyCount; ++otherId)
+		{
+			const SweepAndPruneProxy_T& other = m_proxies[otherId];
+			if (other.m_collider == nullptr || other.m_isBeingRemoved || otherId == proxyId || (other.m_isOffAxis && otherId < proxyId))
+			{
+				continue;
+			}
+
+			if (proxy.m_isStatic && other.m_isStatic && !proxy.m_hasMoved && !other.m_hasMoved)
+			{
+				continue;
+			}
+
+			//Written so a NaN bound overlaps nothing
+			if (!(proxy.m_min.x <= other.m_max.x && proxy.m_min.y <= other.m_max.y && other.m_min.x <= proxy.m_max.x && other.m_min.y <= proxy.m_max.y))
+			{
+				continue;
+			}
+
+			//Dynamic side first
+			if (proxy.m_isStatic && !other.m_isStatic)
+			{
+				outPairs.push_back({ other.m_collider, proxy.m_collider });
+			}
+			else
+			{
+				outPairs.push_back({ proxy.m_collider, other.m_collider });
+			}
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void SweepAndPruneBroadphase::QueryAABB(const AABB2& queryBounds, std::vector<Collider2D*>& outColliders) const
+{
+	//Same reach as the AABB tree's fat leaves, proxies were placed before the step resolved its contacts
+	AABB2 bounds(queryBounds.m_minBounds - Vec2(BROADPHASE_QUERY_MARGIN, BROADPHASE_QUERY_MARGIN), queryBounds.m_maxBounds + Vec2(BROADPHASE_QUERY_MARGIN, BROADPHASE_QUERY_MARGIN));
+
+	//Destroyed proxies sit at FLT_MAX wherever they were until the next step, everything else is still in order
+	for (const SweepAndPruneEndpoint_T& endpoint : m_endpoints)
+	{
+		const SweepAndPruneProxy_T& proxy = m_proxies[endpoint.m_proxyId];
+		if (proxy.m_isBeingRemoved || proxy.m_isOffAxis || proxy.m_collider == nullptr)
+		{
+			continue;
+		}
+
+		if (endpoint.m_value > bounds.m_maxBounds.x)
+		{
+			break;
+		}
+
+		//Each proxy is looked at once, from its min
+		if (endpoint.m_isMax)
+		{
+			continue;
+		}
+
+		if (proxy.m_max.x >= bounds.m_minBounds.x && proxy.m_min.y <= bounds.m_maxBounds.y && bounds.m_minBounds.y <= proxy.m_max.y)
+		{
+			outColliders.push_back(proxy.m_collider);
+		}
+	}
+
+	for (uint proxyId : m_offAxisProxyIds)
+	{
+		const SweepAndPruneProxy_T& proxy = m_proxies[proxyId];
+		if (proxy.m_min.x <= bounds.m_maxBounds.x && bounds.m_minBounds.x <= proxy.m_max.x && proxy.m_min.y <= bounds.m_maxBounds.y && bounds.m_minBounds.y <= proxy.m_max.y)
+		{
+			outColliders.push_back(proxy.m_collider);
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void SweepAndPruneBroadphase::SortEndpoints()
+{
+	uint endpointCount = (uint)m_endpoints.size();
+	for (uint endpointIndex = 1; endpointIndex < endpointCount; ++endpointIndex)
+	{
+		SweepAndPruneEndpoint_T moving = m_endpoints[endpointIndex];
+
+		uint insertIndex = endpointIndex;
+		while (insertIndex > 0U && IsEndpointBefore(moving, m_endpoints[insertIndex - 1U]))
+		{
+			const SweepAndPruneEndpoint_T& passed = m_endpoints[insertIndex - 1U];
+
+			//A min moving left past a max starts an overlap, a max moving left past a min ends one
+			if (!moving.m_isMax && passed.m_isMax)
+			{
+				m_xOverlaps.insert(GetPairKey(moving.m_proxyId, passed.m_proxyId));
+			}
+			else if (moving.m_isMax && !passed.m_isMax)
+			{
+				m_xOverlaps.erase(GetPairKey(moving.m_proxyId, passed.m_proxyId));
+			}
+
+			//Shift the passed endpoint right
+			m_endpoints[insertIndex] = passed;
+			SweepAndPruneProxy_T& passedProxy = m_proxies[passed.m_proxyId];
+			if (passed.m_isMax)
+			{
+				passedProxy.m_maxEndpoint = insertIndex;
+			}
+			else
+			{
+				passedProxy.m_minEndpoint = insertIndex;
+			}
+
+			insertIndex--;
+		}
+
+		if (insertIndex != endpointIndex)
+		{
+			m_endpoints[insertIndex] = moving;
+			SweepAndPruneProxy_T& movingProxy = m_proxies[moving.m_proxyId];
+			if (moving.m_isMax)
+			{
+				movingProxy.m_maxEndpoint = insertIndex;
+			}
+			else
+			{
+				movingProxy.m_minEndpoint = insertIndex;
+			}
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void SweepAndPruneBroadphase::RebuildOverlaps()
+{
+	std::sort(m_endpoints.begin(), m_endpoints.end(), IsEndpointBefore);
+	m_xOverlaps.clear();
+
+	//Sweep once keeping the proxies whose interval is open, every min pairs with everything open at that point
+	std::vector<uint> openProxies;
+	uint endpointCount = (uint)m_endpoints.size();
+	for (uint endpointIndex = 0; endpointIndex < endpointCount; ++endpointIndex)
+	{
+		const SweepAndPruneEndpoint_T& endpoint = m_endpoints[endpointIndex];
+		SweepAndPruneProxy_T& proxy = m_proxies[endpoint.m_proxyId];
+
+		if (endpoint.m_isMax)
+		{
+			proxy.m_maxEndpoint = endpointIndex;
+			std::vector<uint>::iterator openIter = std::find(openProxies.begin(), openProxies.end(), endpoint.m_proxyId);
+			*openIter = openProxies.back();
+			openProxies.pop_back();
+			continue;
+		}
+
+		proxy.m_minEndpoint = endpointIndex;
+		if (!proxy.m_isBeingRemoved)
+		{
+			for (uint openProxyId : openProxies)
+			{
+				if (!m_proxies[openProxyId].m_isBeingRemoved)
+				{
+					m_xOverlaps.insert(GetPairKey(endpoint.m_proxyId, openProxyId));
+				}
+			}
+		}
+		openProxies.push_back(endpoint.m_proxyId);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void SweepAndPruneBroadphase::RemoveDestroyedProxies()
+{
+	if (m_destroyedProxies.empty())
+	{
+		return;
+	}
+
+	//Compact by the flag, a live proxy whose max is FLT_MAX can sort after the destroyed endpoints
+	uint endpointCount = (uint)m_endpoints.size();
+	uint keptCount = 0U;
+	for (uint endpointIndex = 0; endpointIndex < endpointCount; ++endpointIndex)
+	{
+		SweepAndPruneEndpoint_T endpoint = m_endpoints[endpointIndex];
+		SweepAndPruneProxy_T& proxy = m_proxies[endpoint.m_proxyId];
+		if (proxy.m_isBeingRemoved)
+		{
+			continue;
+		}
+
+		if (endpoint.m_isMax)
+		{
+			proxy.m_maxEndpoint = keptCount;
+		}
+		else
+		{
+			proxy.m_minEndpoint = keptCount;
+		}
+		m_endpoints[keptCount++] = endpoint;
+	}
+	m_endpoints.resize(keptCount);
+
+	//Sweeping out doesn't clear overlaps that tie at FLT_MAX, with each other or with a live proxy there, so drop them here
+	std::set<uint64_t>::iterator overlapIter = m_xOverlaps.begin();
+	while (overlapIter != m_xOverlaps.end())
+	{
+		uint proxyIdA = (uint)(*overlapIter >> 32);
+		uint proxyIdB = (uint)(*overlapIter & 0xFFFFFFFFU);
+		if (m_proxies[proxyIdA].m_isBeingRemoved || m_proxies[proxyIdB].m_isBeingRemoved)
+		{
+			overlapIter = m_xOverlaps.erase(overlapIter);
+		}
+		else
+		{
+			++overlapIter;
+		}
+	}
+
+	for (uint proxyId : m_destroyedProxies)
+	{
+		m_proxies[proxyId] = SweepAndPruneProxy_T();
+		m_freeProxies.push_back(proxyId);
+	}
+	m_destroyedProxies.clear();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// UNIT TEST
+//------------------------------------------------------------------------------------------------------------------------------
+UNITTEST("SweepAndPruneBroadphase", "Physics", 100)
+{
+	constexpr uint NUM_PROXIES = 200U;
+	constexpr uint NUM_ROUNDS = 12U;
+	constexpr float WORLD_SIZE = 30.f;
+
+	SweepAndPruneBroadphase sweepAndPrune;
+	std::vector<AABB2> bounds(NUM_PROXIES);
+	std::vector<uint> proxyIds(NUM_PROXIES, INVALID_BROADPHASE_PROXY);
+	std::vector<bool> isStatic(NUM_PROXIES);
+
+	uint seed = 777U;
+	for (uint slot = 0; slot < NUM_PROXIES; ++slot)
+	{
+		seed = seed * 1664525U + 1013904223U;
+		Vec2 position((float)(seed >> 8U) / 16777216.f * WORLD_SIZE, (float)(seed & 0xFFFFU) / 65536.f * WORLD_SIZE);
+		bounds[slot] = AABB2(position, position + Vec2(1.2f, 1.2f));
+		isStatic[slot] = (slot % 8U == 0U);
+	}
+
+	//A live proxy reaching FLT_MAX ties with destroyed endpoints, removal mustn't take its endpoints instead
+	bounds[1] = AABB2(Vec2(WORLD_SIZE * 0.5f, 0.f), Vec2(FLT_MAX, WORLD_SIZE));
+
+	bool arePairsExact = true;
+	bool areQueriesExact = true;
+	bool isOrderStable = true;
+
+	BroadphasePairList pairs;
+	std::vector<uint64_t> foundKeys;
+	std::vector<uint64_t> expectedKeys;
+	std::vector<Collider2D*> queryResults;
+	std::vector<Collider2D*> expectedResults;
+	for (uint round = 0; round < NUM_ROUNDS; ++round)
+	{
+		//Everything comes in at once the first round, which takes the full rebuild. After that a handful come and go
+		//each round and the rest move, which takes the insertion sort
+		for (uint slot = 0; slot < NUM_PROXIES; ++slot)
+		{
+			seed = seed * 1664525U + 1013904223U;
+			if (round > 0U && !isStatic[slot] && slot != 1U)
+			{
+				if ((seed >> 28U) == 0U)
+				{
+					sweepAndPrune.DestroyProxy(proxyIds[slot]);
+					proxyIds[slot] = INVALID_BROADPHASE_PROXY;
+				}
+
+				Vec2 step((float)((seed >> 8U) & 0xFFU) / 255.f - 0.5f, (float)(seed & 0xFFU) / 255.f - 0.5f);
+				bounds[slot] = AABB2(bounds[slot].m_minBounds + step, bounds[slot].m_maxBounds + step);
+			}
+
+			if (proxyIds[slot] == INVALID_BROADPHASE_PROXY)
+			{
+				proxyIds[slot] = sweepAndPrune.CreateProxy((Collider2D*)(uintptr_t)(slot + 1U), bounds[slot], isStatic[slot]);
+			}
+			else
+			{
+				sweepAndPrune.MoveProxy(proxyIds[slot], bounds[slot]);
+			}
+		}
+
+		sweepAndPrune.GetCandidatePairs(pairs);
+
+		//Pairs come out once each, dynamic side first, in ascending proxy id order
+		foundKeys.clear();
+		uint64_t lastIdKey = 0U;
+		for (size_t pairIndex = 0; pairIndex < pairs.size(); ++pairIndex)
+		{
+			uint slotA = (uint)((uintptr_t)pairs[pairIndex].m_colliderA - 1U);
+			uint slotB = (uint)((uintptr_t)pairs[pairIndex].m_colliderB - 1U);
+			arePairsExact = arePairsExact && !(isStatic[slotA] && !isStatic[slotB]);
+			foundKeys.push_back((slotA < slotB) ? ((uint64_t)slotA << 32U) | slotB : ((uint64_t)slotB << 32U) | slotA);
+
+			uint idA = proxyIds[slotA];
+			uint idB = proxyIds[slotB];
+			uint64_t idKey = (idA < idB) ? ((uint64_t)idA << 32U) | idB : ((uint64_t)idB << 32U) | idA;
+			isOrderStable = isOrderStable && (pairIndex == 0U || idKey > lastIdKey);
+			lastIdKey = idKey;
+		}
+		std::sort(foundKeys.begin(), foundKeys.end());
+
+		expectedKeys.clear();
+		for (uint slotA = 0; slotA < NUM_PROXIES; ++slotA)
+		{
+			for (uint slotB = slotA + 1U; slotB < NUM_PROXIES; ++slotB)
+			{
+				const AABB2& boundsA = bounds[slotA];
+				const AABB2& boundsB = bounds[slotB];
+				bool isOverlapping = boundsA.m_minBounds.x <= boundsB.m_maxBounds.x && boundsB.m_minBounds.x <= boundsA.m_maxBounds.x 
+					&& boundsA.m_minBounds.y <= boundsB.m_maxBounds.y && boundsB.m_minBounds.y <= boundsA.m_maxBounds.y;
+
+				//Statics never move after the first round
+				if (isOverlapping && (round == 0U || !isStatic[slotA] || !isStatic[slotB]))
+				{
+					expectedKeys.push_back(((uint64_t)slotA << 32U) | slotB);
+				}
+			}
+		}
+		arePairsExact = arePairsExact && foundKeys == expectedKeys;
+
+		seed = seed * 1664525U + 1013904223U;
+		Vec2 queryMin((float)(seed >> 8U) / 16777216.f * WORLD_SIZE, (float)(seed & 0xFFFFU) / 65536.f * WORLD_SIZE);
+		AABB2 query(queryMin, queryMin + Vec2(4.f, 6.f));
+
+		queryResults.clear();
+		sweepAndPrune.QueryAABB(query, queryResults);
+		std::sort(queryResults.begin(), queryResults.end());
+
+		//Queries reach the margin past the proxies
+		AABB2 reach(query.m_minBounds - Vec2(BROADPHASE_QUERY_MARGIN, BROADPHASE_QUERY_MARGIN), query.m_maxBounds + Vec2(BROADPHASE_QUERY_MARGIN, BROADPHASE_QUERY_MARGIN));
+		expectedResults.clear();
+		for (uint slot = 0; slot < NUM_PROXIES; ++slot)
+		{
+			if (bounds[slot].m_minBounds.x <= reach.m_maxBounds.x && reach.m_minBounds.x <= bounds[slot].m_maxBounds.x 
+				&& bounds[slot].m_minBounds.y <= reach.m_maxBounds.y && reach.m_minBounds.y <= bounds[slot].m_maxBounds.y)
+			{
+				expectedResults.push_back((Collider2D*)(uintptr_t)(slot + 1U));
+			}
+		}
+		areQueriesExact = areQueriesExact && queryResults == expectedResults;
+	}
+
+	CONFIRM(!expectedKeys.empty());
+	CONFIRM(arePairsExact);
+	CONFIRM(isOrderStable);
+	CONFIRM(areQueriesExact);
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+UNITTEST("SweepAndPruneNonFinite", "Physics", 100)
+{
+	constexpr uint NUM_PROXIES = 40U;
+	constexpr uint NUM_ROUNDS = 16U;
+	constexpr float WORLD_SIZE = 12.f;
+	const float nan = nanf("");
+	const float inf = INFINITY;
+
+	SweepAndPruneBroadphase sweepAndPrune;
+	std::vector<AABB2> bounds(NUM_PROXIES);
+	std::vector<uint> proxyIds(NUM_PROXIES, INVALID_BROADPHASE_PROXY);
+
+	//Slot 0 is a static strip running off to infinity both ways, it pairs with everything crossing its rows
+	bounds[0] = AABB2(Vec2(-inf, 4.f), Vec2(inf, 5.f));
+	proxyIds[0] = sweepAndPrune.CreateProxy((Collider2D*)(uintptr_t)1U, bounds[0], true);
+
+	bool arePairsExact = true;
+	bool areQueriesExact = true;
+	uint numOffAxisRounds = 0U;
+
+	BroadphasePairList pairs;
+	std::vector<uint64_t> foundKeys;
+	std::vector<uint64_t> expectedKeys;
+	std::vector<Collider2D*> queryResults;
+	std::vector<Collider2D*> expectedResults;
+	uint seed = 4242U;
+	for (uint round = 0; round < NUM_ROUNDS; ++round)
+	{
+		//Everything is new the first round, which takes the full rebuild with NaNs in it. Later rounds take the insertion sort
+		//with bodies going non finite and coming back
+		bool hasOffAxis = false;
+		for (uint slot = 1U; slot < NUM_PROXIES; ++slot)
+		{
+			seed = seed * 1664525U + 1013904223U;
+			Vec2 position((float)(seed >> 8U) / 16777216.f * WORLD_SIZE, (float)(seed & 0xFFFFU) / 65536.f * WORLD_SIZE);
+			bounds[slot] = AABB2(position, position + Vec2(1.5f, 1.5f));
+
+			uint shape = (seed >> 4U) % 8U;
+			if (shape == 0U)
+			{
+				bounds[slot].m_minBounds.x = nan;
+			}
+			else if (shape == 1U)
+			{
+				bounds[slot].m_maxBounds.y = nan;
+			}
+			else if (shape == 2U)
+			{
+				bounds[slot].m_maxBounds.x = inf;
+			}
+			else if (shape == 3U)
+			{
+				//Inverted on X
+				std::swap(bounds[slot].m_minBounds.x, bounds[slot].m_maxBounds.x);
+			}
+			hasOffAxis = hasOffAxis || shape < 4U;
+
+			if (proxyIds[slot] == INVALID_BROADPHASE_PROXY)
+			{
+				proxyIds[slot] = sweepAndPrune.CreateProxy((Collider2D*)(uintptr_t)(slot + 1U), bounds[slot], false);
+			}
+			else if ((seed >> 28U) == 0U)
+			{
+				sweepAndPrune.DestroyProxy(proxyIds[slot]);
+				proxyIds[slot] = sweepAndPrune.CreateProxy((Collider2D*)(uintptr_t)(slot + 1U), bounds[slot], false);
+			}
+			else
+			{
+				sweepAndPrune.MoveProxy(proxyIds[slot], bounds[slot]);
+			}
+		}
+		numOffAxisRounds += hasOffAxis ? 1U : 0U;
+
+		sweepAndPrune.GetCandidatePairs(pairs);
+
+		foundKeys.clear();
+		for (const BroadphasePair_T& pair : pairs)
+		{
+			uint slotA = (uint)((uintptr_t)pair.m_colliderA - 1U);
+			uint slotB = (uint)((uintptr_t)pair.m_colliderB - 1U);
+			arePairsExact = arePairsExact && slotA != 0U;
+			foundKeys.push_back((slotA < slotB) ? ((uint64_t)slotA << 32U) | slotB : ((uint64_t)slotB << 32U) | slotA);
+		}
+		std::sort(foundKeys.begin(), foundKeys.end());
+
+		//Same test the broadphase uses for off axis proxies, a NaN overlaps nothing
+		expectedKeys.clear();
+		for (uint slotA = 0; slotA < NUM_PROXIES; ++slotA)
+		{
+			for (uint slotB = slotA + 1U; slotB < NUM_PROXIES; ++slotB)
+			{
+				const AABB2& boundsA = bounds[slotA];
+				const AABB2& boundsB = bounds[slotB];
+				if (boundsA.m_minBounds.x <= boundsB.m_maxBounds.x && boundsB.m_minBounds.x <= boundsA.m_maxBounds.x
+					&& boundsA.m_minBounds.y <= boundsB.m_maxBounds.y && boundsB.m_minBounds.y <= boundsA.m_maxBounds.y)
+				{
+					expectedKeys.push_back(((uint64_t)slotA << 32U) | slotB);
+				}
+			}
+		}
+		arePairsExact = arePairsExact && foundKeys == expectedKeys;
+
+		AABB2 query(Vec2(2.f, 2.f), Vec2(8.f, 6.f));
+		queryResults.clear();
+		sweepAndPrune.QueryAABB(query, queryResults);
+		std::sort(queryResults.begin(), queryResults.end());
+
+		//Queries reach the margin past the proxies
+		AABB2 reach(query.m_minBounds - Vec2(BROADPHASE_QUERY_MARGIN, BROADPHASE_QUERY_MARGIN), query.m_maxBounds + Vec2(BROADPHASE_QUERY_MARGIN, BROADPHASE_QUERY_MARGIN));
+		expectedResults.clear();
+		for (uint slot = 0; slot < NUM_PROXIES; ++slot)
+		{
+			if (bounds[slot].m_minBounds.x <= reach.m_maxBounds.x && reach.m_minBounds.x <= bounds[slot].m_maxBounds.x
+				&& bounds[slot].m_minBounds.y <= reach.m_maxBounds.y && reach.m_minBounds.y <= bounds[slot].m_maxBounds.y)
+			{
+				expectedResults.push_back((Collider2D*)(uintptr_t)(slot + 1U));
+			}
+		}
+		areQueriesExact = areQueriesExact && queryResults == expectedResults;
+	}
+
+	CONFIRM(numOffAxisRounds == NUM_ROUNDS);
+	CONFIRM(arePairsExact);
+	CONFIRM(areQueriesExact);
+	return true;
+}
@@ -0,0 +1,73 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+#include "Engine/Math/Broadphase2D.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include <set>
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct SweepAndPruneProxy_T
+{
+	Collider2D*		m_collider = nullptr;			//nullptr while the slot is free
+	Vec2			m_min;
+	Vec2			m_max;
+	uint			m_minEndpoint = 0U;				//Where the proxy's endpoints currently sit in the sorted array
+	uint			m_maxEndpoint = 0U;
+	bool			m_isStatic = false;
+	bool			m_hasMoved = false;
+	bool			m_isBeingRemoved = false;
+	bool			m_isOffAxis = false;			//Non finite or inverted bounds, kept off the sort and paired by checking every proxy
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+struct SweepAndPruneEndpoint_T
+{
+	float			m_value;
+	uint			m_proxyId;
+	bool			m_isMax;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Sort and sweep on the X axis. The min/max endpoints of every proxy stay sorted between steps and are re-sorted with an
+// insertion sort, which is close to linear when bodies barely move. Every swap of a min past a max starts or ends an
+// X overlap, those events keep a persistent overlap set so nothing is swept from scratch.
+// Pairs come out in proxy id order which keeps the solver deterministic from run to run. A NaN endpoint would break the
+// ordering the sorts rely on, so proxies with non finite bounds park their endpoints at FLT_MAX and are paired separately
+//------------------------------------------------------------------------------------------------------------------------------
+class SweepAndPruneBroadphase : public Broadphase2D
+{
+public:
+	SweepAndPruneBroadphase();
+	~SweepAndPruneBroadphase();
+
+	virtual uint								CreateProxy(Collider2D* collider, const AABB2& bounds, bool isStatic) final;
+	virtual void								DestroyProxy(uint proxyId) final;
+	virtual void								MoveProxy(uint proxyId, const AABB2& bounds) final;
+
+	virtual void								GetCandidatePairs(BroadphasePairList& outPairs) final;
+
+	// Walks the sorted X endpoints up to the box's right edge
+	virtual void								QueryAABB(const AABB2& queryBounds, std::vector<Collider2D*>& outColliders) const final;
+
+	size_t										GetXOverlapCount() const	{ return m_xOverlaps.size(); }
+
+private:
+	void										SortEndpoints();
+	void										RebuildOverlaps();
+	void										RemoveDestroyedProxies();
+	void										SetProxyBounds(uint proxyId, const AABB2& bounds);
+	void										GetOffAxisPairs(BroadphasePairList& outPairs) const;
+
+	static uint64_t								GetPairKey(uint proxyIdA, uint proxyIdB);
+
+private:
+	std::vector<SweepAndPruneProxy_T>			m_proxies;
+	std::vector<uint>							m_freeProxies;
+	std::vector<uint>							m_destroyedProxies;		//Swept off the end on the next step before their ids are reused
+	uint										m_newProxyCount = 0U;
+
+	std::vector<SweepAndPruneEndpoint_T>		m_endpoints;
+	std::vector<uint>							m_offAxisProxyIds;
+
+	//Pairs overlapping on X, lower proxy id in the high 32 bits. Ordered so iterating it gives stable pair order
+	std::set<uint64_t>							m_xOverlaps;
+};
@@ -8,7 +8,6 @@
 
 class Collider2D;
 class RenderContext;
-class TriggerTouch2D;
 struct Rgba;
 
 //------------------------------------------------------------------------------------------------------------------------------
@@ -18,10 +17,6 @@ public:
 	Trigger2D(PhysicsSystem* physicsSystem, eSimulationType simType);
 	~Trigger2D();
 
-	//Update
-	void									Update(uint frameNumber);
-	void									UpdateTouchesArray(Rigidbody2D* rb, uint frameNumber);
-
 	//Render
 	void									DebugRender(RenderContext* renderContext, const Rgba& color) const;
 
@@ -45,7 +40,8 @@ public:
 	std::string								m_onEnterEvent = "";
 	std::string								m_onExitEvent = "";
 
+	bool									m_isQueuedForDestroy = false;	// waiting in the system's destroy queue
+
 private:
 	eSimulationType							m_simulationType = TYPE_UNKOWN;
-	std::vector<TriggerTouch2D*>			m_touches;
 };
\ No newline at end of file
@@ -3,8 +3,9 @@
 #include "Engine/Math/Collider2D.hpp"
 
 //------------------------------------------------------------------------------------------------------------------------------
-TriggerTouch2D::TriggerTouch2D(Collider2D* collider, uint entryFrame)
+TriggerTouch2D::TriggerTouch2D(Trigger2D* trigger, Collider2D* collider, uint entryFrame)
 {
+	m_trigger = trigger;
 	m_collider = collider;
 	m_entryFrame = entryFrame;
 	m_currentFrame = entryFrame;
@@ -16,10 +17,3 @@ TriggerTouch2D::~TriggerTouch2D()
 
 }
 
-//------------------------------------------------------------------------------------------------------------------------------
-void TriggerTouch2D::Destroy()
-{
-	delete m_collider;
-	m_collider = nullptr;
-}
-
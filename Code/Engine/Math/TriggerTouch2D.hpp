@@ -3,24 +3,25 @@
 //------------------------------------------------------------------------------------------------------------------------------
 typedef unsigned int uint;
 class Collider2D;
+class Trigger2D;
 
 //------------------------------------------------------------------------------------------------------------------------------
 class TriggerTouch2D
 {
 public:
-	explicit TriggerTouch2D(Collider2D* collider, uint entryFrame);
+	explicit TriggerTouch2D(Trigger2D* trigger, Collider2D* collider, uint entryFrame);
 	~TriggerTouch2D();
 
 	inline void				SetCurrentFrame(uint frameNumber) { m_currentFrame = frameNumber; }
 
-	inline Collider2D*		GetCollider() { return m_collider; }
-	inline uint				GetCurrentFrame() { return m_currentFrame; }
-	inline uint				GetEntryFrame() { return m_entryFrame; }
-
-	void					Destroy();
+	inline Trigger2D*		GetTrigger() const { return m_trigger; }
+	inline Collider2D*		GetCollider() const { return m_collider; }
+	inline uint				GetCurrentFrame() const { return m_currentFrame; }
+	inline uint				GetEntryFrame() const { return m_entryFrame; }
 
 private:
+	Trigger2D*		m_trigger;
 	Collider2D*		m_collider;
 	uint			m_entryFrame;
 	uint			m_currentFrame;
-};
\ No newline at end of file
+};
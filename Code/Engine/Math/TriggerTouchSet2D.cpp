@@ -0,0 +1,251 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#include "Engine/Math/TriggerTouchSet2D.hpp"
+#include "Engine/Commons/UnitTest.hpp"
+
+//------------------------------------------------------------------------------------------------------------------------------
+constexpr uint MIN_TRIGGER_TOUCH_SLOTS = 64U;
+
+//------------------------------------------------------------------------------------------------------------------------------
+TriggerTouchSet2D::TriggerTouchSet2D()
+{
+	m_slots.resize(MIN_TRIGGER_TOUCH_SLOTS, INVALID_TRIGGER_TOUCH);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+TriggerTouchSet2D::~TriggerTouchSet2D()
+{
+
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+bool TriggerTouchSet2D::Touch(Trigger2D* trigger, Collider2D* collider, uint frameNumber)
+{
+	uint slotIndex = FindSlot(trigger, collider);
+	if (m_slots[slotIndex] != INVALID_TRIGGER_TOUCH)
+	{
+		m_touches[m_slots[slotIndex]].SetCurrentFrame(frameNumber);
+		return false;
+	}
+
+	m_slots[slotIndex] = (uint)m_touches.size();
+	m_touches.push_back(TriggerTouch2D(trigger, collider, frameNumber));
+
+	if (m_touches.size() * 2U > m_slots.size())
+	{
+		Rehash((uint)m_slots.size() * 2U);
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void TriggerTouchSet2D::CollectExits(uint frameNumber, std::vector<TriggerTouch2D>& outExits)
+{
+	outExits.clear();
+
+	uint touchIndex = 0U;
+	while (touchIndex < (uint)m_touches.size())
+	{
+		const TriggerTouch2D& touch = m_touches[touchIndex];
+
+		//A touch only seen on the frame it entered stays until it is seen again, like the old per trigger touch lists
+		if (touch.GetCurrentFrame() == frameNumber || touch.GetCurrentFrame() == touch.GetEntryFrame())
+		{
+			touchIndex++;
+			continue;
+		}
+
+		//The last touch moves into this slot so check the same index again
+		outExits.push_back(touch);
+		RemoveTouch(touchIndex);
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint TriggerTouchSet2D::FindSlot(const Trigger2D* trigger, const Collider2D* collider) const
+{
+	uint slotMask = (uint)m_slots.size() - 1U;
+	uint slotIndex = HashPair(trigger, collider) & slotMask;
+
+	//Never more than half full so there is always an empty slot to stop at
+	while (m_slots[slotIndex] != INVALID_TRIGGER_TOUCH)
+	{
+		const TriggerTouch2D& touch = m_touches[m_slots[slotIndex]];
+		if (touch.GetTrigger() == trigger && touch.GetCollider() == collider)
+		{
+			break;
+		}
+
+		slotIndex = (slotIndex + 1U) & slotMask;
+	}
+
+	return slotIndex;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void TriggerTouchSet2D::RemoveTouch(uint touchIndex)
+{
+	const TriggerTouch2D& touch = m_touches[touchIndex];
+	EraseSlot(FindSlot(touch.GetTrigger(), touch.GetCollider()));
+
+	//Swap and pop, the moved touch's slot has to point at its new index
+	uint lastIndex = (uint)m_touches.size() - 1U;
+	if (touchIndex != lastIndex)
+	{
+		m_touches[touchIndex] = m_touches[lastIndex];
+		m_slots[FindSlot(m_touches[touchIndex].GetTrigger(), m_touches[touchIndex].GetCollider())] = touchIndex;
+	}
+
+	m_touches.pop_back();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void TriggerTouchSet2D::EraseSlot(uint slotIndex)
+{
+	//Shift the rest of the probe run back so lookups never stop early at the hole
+	uint slotMask = (uint)m_slots.size() - 1U;
+	uint holeIndex = slotIndex;
+	uint nextIndex = (holeIndex + 1U) & slotMask;
+
+	while (m_slots[nextIndex] != INVALID_TRIGGER_TOUCH)
+	{
+		const TriggerTouch2D& touch = m_touches[m_slots[nextIndex]];
+		uint homeIndex = HashPair(touch.GetTrigger(), touch.GetCollider()) & slotMask;
+
+		//Only move it if its home slot isn't between the hole and where it sits now
+		if (((nextIndex - homeIndex) & slotMask) >= ((nextIndex - holeIndex) & slotMask))
+		{
+			m_slots[holeIndex] = m_slots[nextIndex];
+			holeIndex = nextIndex;
+		}
+
+		nextIndex = (nextIndex + 1U) & slotMask;
+	}
+
+	m_slots[holeIndex] = INVALID_TRIGGER_TOUCH;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+void TriggerTouchSet2D::Rehash(uint slotCount)
+{
+	m_slots.assign(slotCount, INVALID_TRIGGER_TOUCH);
+
+	for (uint touchIndex = 0U; touchIndex < (uint)m_touches.size(); ++touchIndex)
+	{
+		m_slots[FindSlot(m_touches[touchIndex].GetTrigger(), m_touches[touchIndex].GetCollider())] = touchIndex;
+	}
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+uint TriggerTouchSet2D::HashPair(const Trigger2D* trigger, const Collider2D* collider)
+{
+	uint64_t hash = (uint64_t)(uintptr_t)trigger * 0x9E3779B97F4A7C15ULL;
+	hash ^= (uint64_t)(uintptr_t)collider * 0xC2B2AE3D27D4EB4FULL;
+	hash ^= hash >> 29U;
+	return (uint)hash;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------
+// UNIT TEST
+//------------------------------------------------------------------------------------------------------------------------------
+UNITTEST("TriggerTouchSet", "Physics", 100)
+{
+	//Few triggers against many colliders keeps the table busy enough for long probe runs to form and be cut into
+	constexpr uint NUM_TRIGGERS = 8U;
+	constexpr uint NUM_COLLIDERS = 96U;
+	constexpr uint NUM_ROUNDS = 400U;
+	constexpr uint ENTRY_FRAME = 1U;
+
+	TriggerTouchSet2D touchSet;
+	std::vector<bool> isTouching(NUM_TRIGGERS * NUM_COLLIDERS, false);
+	uint numTouching = 0U;
+
+	//Fake pointers, the set only hashes and compares them
+	uint seed = 1234U;
+	for (uint roundIndex = 0U; roundIndex < NUM_ROUNDS; ++roundIndex)
+	{
+		seed = seed * 1664525U + 1013904223U;
+		uint action = (seed >> 24U) % 16U;
+		uint triggerIndex = (seed >> 8U) % NUM_TRIGGERS;
+		uint colliderIndex = (seed >> 12U) % NUM_COLLIDERS;
+		Trigger2D* trigger = (Trigger2D*)(uintptr_t)(triggerIndex + 1U);
+		Collider2D* collider = (Collider2D*)(uintptr_t)(colliderIndex + 1U);
+
+		if (action == 0U)
+		{
+			//A collider and a trigger destroyed in the same step go in the same sweep
+			touchSet.RemoveTouchesIf([collider, trigger](const TriggerTouch2D& touch) { return touch.GetCollider() == collider || touch.GetTrigger() == trigger; });
+			for (uint pairIndex = 0U; pairIndex < NUM_TRIGGERS * NUM_COLLIDERS; ++pairIndex)
+			{
+				if (isTouching[pairIndex] && (pairIndex % NUM_COLLIDERS == colliderIndex || pairIndex / NUM_COLLIDERS == triggerIndex))
+				{
+					numTouching--;
+					isTouching[pairIndex] = false;
+				}
+			}
+		}
+		else if (action == 1U)
+		{
+			touchSet.RemoveTouchesIf([trigger](const TriggerTouch2D& touch) { return touch.GetTrigger() == trigger; });
+			for (uint otherCollider = 0U; otherCollider < NUM_COLLIDERS; ++otherCollider)
+			{
+				numTouching -= isTouching[triggerIndex * NUM_COLLIDERS + otherCollider] ? 1U : 0U;
+				isTouching[triggerIndex * NUM_COLLIDERS + otherCollider] = false;
+			}
+		}
+		else
+		{
+			//A run of touches, each new pair has to be reported as new exactly once
+			for (uint touchIndex = 0U; touchIndex < 24U; ++touchIndex)
+			{
+				uint pairIndex = (triggerIndex * NUM_COLLIDERS + colliderIndex + touchIndex * 37U) % (NUM_TRIGGERS * NUM_COLLIDERS);
+				bool isNew = touchSet.Touch((Trigger2D*)(uintptr_t)(pairIndex / NUM_COLLIDERS + 1U), (Collider2D*)(uintptr_t)(pairIndex % NUM_COLLIDERS + 1U), ENTRY_FRAME);
+				CONFIRM(isNew == !isTouching[pairIndex]);
+				numTouching += isNew ? 1U : 0U;
+				isTouching[pairIndex] = true;
+			}
+		}
+
+		//Every pair left after the backward shifts is still found, and nothing removed came back
+		CONFIRM(touchSet.GetTouchCount() == numTouching);
+		for (const TriggerTouch2D& touch : touchSet.GetTouches())
+		{
+			uint pairIndex = ((uint)(uintptr_t)touch.GetTrigger() - 1U) * NUM_COLLIDERS + (uint)(uintptr_t)touch.GetCollider() - 1U;
+			CONFIRM(isTouching[pairIndex]);
+		}
+		for (uint pairIndex = 0U; pairIndex < NUM_TRIGGERS * NUM_COLLIDERS; ++pairIndex)
+		{
+			if (isTouching[pairIndex])
+			{
+				CONFIRM(!touchSet.Touch((Trigger2D*)(uintptr_t)(pairIndex / NUM_COLLIDERS + 1U), (Collider2D*)(uintptr_t)(pairIndex % NUM_COLLIDERS + 1U), ENTRY_FRAME));
+			}
+		}
+	}
+
+	//Every other pair is seen again on the next frame, the frame after that only those ones leave
+	uint numSeen = 0U;
+	for (uint pairIndex = 0U; pairIndex < NUM_TRIGGERS * NUM_COLLIDERS; pairIndex += 2U)
+	{
+		if (isTouching[pairIndex])
+		{
+			touchSet.Touch((Trigger2D*)(uintptr_t)(pairIndex / NUM_COLLIDERS + 1U), (Collider2D*)(uintptr_t)(pairIndex % NUM_COLLIDERS + 1U), ENTRY_FRAME + 1U);
+			isTouching[pairIndex] = false;
+			numSeen++;
+		}
+	}
+
+	std::vector<TriggerTouch2D> exits;
+	touchSet.CollectExits(ENTRY_FRAME + 2U, exits);
+	CONFIRM(numSeen > 0U);
+	CONFIRM((uint)exits.size() == numSeen);
+	CONFIRM(touchSet.GetTouchCount() == numTouching - numSeen);
+	for (uint pairIndex = 0U; pairIndex < NUM_TRIGGERS * NUM_COLLIDERS; ++pairIndex)
+	{
+		if (isTouching[pairIndex])
+		{
+			CONFIRM(!touchSet.Touch((Trigger2D*)(uintptr_t)(pairIndex / NUM_COLLIDERS + 1U), (Collider2D*)(uintptr_t)(pairIndex % NUM_COLLIDERS + 1U), ENTRY_FRAME));
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,67 @@
+//------------------------------------------------------------------------------------------------------------------------------
+#pragma once
+#include "Engine/Math/TriggerTouch2D.hpp"
+#include <stdint.h>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------------
+constexpr uint INVALID_TRIGGER_TOUCH = 0xFFFFFFFFU;
+
+//------------------------------------------------------------------------------------------------------------------------------
+// Every (trigger, collider) pair that is touching, stamped with the last frame it was seen. The touches are kept packed
+// so walking them only visits real overlaps, an open addressed table (linear probing) maps the pair to its slot.
+// Each step Touch refreshes the pairs that overlap and CollectExits takes out the ones that weren't refreshed
+//------------------------------------------------------------------------------------------------------------------------------
+class TriggerTouchSet2D
+{
+public:
+	TriggerTouchSet2D();
+	~TriggerTouchSet2D();
+
+	// Stamps the pair with frameNumber, returns true if it wasn't touching before
+	bool								Touch(Trigger2D* trigger, Collider2D* collider, uint frameNumber);
+	// Moves every touch that wasn't stamped with frameNumber into outExits
+	void								CollectExits(uint frameNumber, std::vector<TriggerTouch2D>& outExits);
+
+	// Drops every touch isRemoved(touch) is true for without firing anything, in one pass. For the destroy queue, so freeing
+	// a batch of triggers and bodies walks the touches once rather than once per object
+	template <typename IS_REMOVED>
+	void								RemoveTouchesIf(IS_REMOVED isRemoved);
+
+	uint								GetTouchCount() const		{ return (uint)m_touches.size(); }
+	const std::vector<TriggerTouch2D>&	GetTouches() const			{ return m_touches; }
+
+private:
+	// Slot holding the pair, or the empty slot it would go in
+	uint								FindSlot(const Trigger2D* trigger, const Collider2D* collider) const;
+	void								RemoveTouch(uint touchIndex);
+	void								EraseSlot(uint slotIndex);
+	void								Rehash(uint slotCount);
+
+	static uint							HashPair(const Trigger2D* trigger, const Collider2D* collider);
+
+private:
+	std::vector<TriggerTouch2D>			m_touches;
+	std::vector<uint>					m_slots;			//Indices into m_touches, power of 2 sized and at most half full
+};
+
+//------------------------------------------------------------------------------------------------------------------------------
+template <typename IS_REMOVED>
+void TriggerTouchSet2D::RemoveTouchesIf(IS_REMOVED isRemoved)
+{
+	//Pack the kept touches to the front in order, then cut the rest and rebuild the table once rather than erasing slot by slot
+	uint keptCount = 0U;
+	for (uint touchIndex = 0U; touchIndex < (uint)m_touches.size(); ++touchIndex)
+	{
+		if (!isRemoved(m_touches[touchIndex]))
+		{
+			m_touches[keptCount++] = m_touches[touchIndex];
+		}
+	}
+
+	if (keptCount != (uint)m_touches.size())
+	{
+		m_touches.erase(m_touches.begin() + keptCount, m_touches.end());
+		Rehash((uint)m_slots.size());
+	}
+}